@@ -632,6 +632,28 @@ Scalar_ 's.
 CV_EXPORTS_W void meanStdDev(InputArray src, OutputArray mean, OutputArray stddev,
                              InputArray mask=noArray());
 
+/** @brief Calculates the mean, standard deviation, minimum, maximum and number of non-zero elements of
+an array in a single pass.
+
+The function computes independently for each channel the values meanStdDev, minMaxLoc and
+countNonZero would give, but reads the array only once, which is cheaper when several statistics
+of the same array are needed. Only the elements selected by the mask are taken into account. Each
+requested output is a column of cn values of type CV_64F; as with meanStdDev, a fixed-size output
+may be longer, the rest of it is filled with zeros. When all the mask elements are 0's, all the
+outputs are zeros.
+@param src input array that should have from 1 to 4 channels.
+@param mean output parameter: calculated mean value.
+@param stddev output parameter: calculated standard deviation.
+@param minVal output parameter: minimum values of the channels.
+@param maxVal output parameter: maximum values of the channels.
+@param nonZero output parameter: number of non-zero elements in every channel.
+@param mask optional operation mask.
+@sa  meanStdDev, minMaxLoc, countNonZero
+*/
+CV_EXPORTS_W void computeStatistics(InputArray src, OutputArray mean, OutputArray stddev,
+                                    OutputArray minVal, OutputArray maxVal, OutputArray nonZero,
+                                    InputArray mask=noArray());
+
 /** @brief Calculates the  absolute norm of an array.
 
 This version of #norm calculates the absolute norm of src1. The type of norm to calculate is specified using #NormTypes.
@@ -2175,6 +2197,49 @@ the convolution sample in dft description.
 */
 CV_EXPORTS_W void idft(InputArray src, OutputArray dst, int flags = 0, int nonzeroRows = 0);
 
+/** @brief Discrete Fourier transform of the arrays of a fixed size and type, prepared once and applied many times.
+
+cv::dft factorizes the transform size and computes the twiddle factors on every call. The plan does it
+when it is created, so the repeated transforms of the same size (e.g. the spectral filtering of video
+frames or the phase correlation of many patches) only pay for the transform itself.
+With the built-in implementation the rows and the columns of a large transform are processed in
+parallel, and applyBatch transforms the arrays of a batch in parallel. When the transform is provided
+by IPP or by a HAL replacement, the arrays of a batch are transformed one after another.
+@sa dft
+*/
+class CV_EXPORTS DFTPlan
+{
+public:
+    virtual ~DFTPlan();
+
+    /** @brief Creates the plan.
+    @param size size of the arrays to transform.
+    @param type type of the input arrays: CV_32FC1, CV_32FC2, CV_64FC1 or CV_64FC2.
+    @param flags transformation flags, see dft and #DftFlags.
+    @param nonzeroRows see dft.
+    */
+    static Ptr<DFTPlan> create(Size size, int type, int flags = 0, int nonzeroRows = 0);
+
+    /** @brief Transforms the array, as dft does with the flags of the plan.
+    @param src input array of the size and type of the plan.
+    @param dst output array, it can be the same as src.
+    */
+    virtual void apply(InputArray src, OutputArray dst) const = 0;
+
+    /** @brief Transforms every array of the batch, in parallel when the transform allows it.
+    @param src vector of the input arrays of the size and type of the plan.
+    @param dst vector of the output arrays.
+    */
+    virtual void applyBatch(InputArrayOfArrays src, OutputArrayOfArrays dst) const = 0;
+
+    virtual Size getSize() const = 0;
+    //! type of the input arrays
+    virtual int getType() const = 0;
+    //! type of the output arrays
+    virtual int getDstType() const = 0;
+    virtual int getFlags() const = 0;
+};
+
 /** @brief Performs a forward or inverse discrete Cosine transform of 1D or 2D array.
 
 The function cv::dct performs a forward or inverse discrete Cosine transform (DCT) of a 1D or 2D
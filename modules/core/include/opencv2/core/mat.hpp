@@ -492,6 +492,32 @@ public:
     virtual BufferPoolController* getBufferPoolController(const char* id = NULL) const;
 };
 
+/** @brief Replaces the default allocator of the calling thread for the lifetime of the object
+
+While the object exists, the arrays created by the thread without an explicitly specified allocator
+are allocated by the given allocator instead of the one returned by Mat::getDefaultAllocator. Other
+threads, including the worker threads of parallel_for_, are not affected. The scopes can be nested.
+
+\code
+{
+    MatAllocatorScope scope(Mat::getPoolAllocator());
+    for (;;) { ... } // the temporary arrays of the loop are recycled by the pool
+}
+\endcode
+*/
+class CV_EXPORTS MatAllocatorScope
+{
+public:
+    explicit MatAllocatorScope(MatAllocator* allocator);
+    ~MatAllocatorScope();
+
+private:
+    MatAllocatorScope(const MatAllocatorScope&);
+    MatAllocatorScope& operator=(const MatAllocatorScope&);
+
+    MatAllocator* prev;
+};
+
 
 //////////////////////////////// MatCommaInitializer //////////////////////////////////
 
@@ -2099,6 +2125,17 @@ public:
     static MatAllocator* getStdAllocator();
     static MatAllocator* getDefaultAllocator();
     static void setDefaultAllocator(MatAllocator* allocator);
+    /** @brief Returns the pooled allocator
+
+    The allocator recycles the freed buffers instead of returning them to the system: the buffers are
+    rounded up to size classes (4 per power of two, up to 64MB; larger buffers are not pooled) and
+    kept in a small per-thread cache backed by a shared pool. The amount of the cached memory is
+    bounded by the limit of the BufferPoolController returned by getBufferPoolController() (256MB
+    by default, OPENCV_POOL_ALLOCATOR_MAX_RESERVED_SIZE environment variable), which also releases
+    the cached buffers. Install it with setDefaultAllocator() or MatAllocatorScope, its statistics
+    are returned by utils::getPoolAllocatorStatistics().
+    */
+    static MatAllocator* getPoolAllocator();
 
     //! internal use method: updates the continuity flag
     void updateContinuityFlag();
@@ -3513,6 +3550,16 @@ Here are examples of matrix expressions:
     Mat sharpened = img*(1+amount) + blurred*(-amount);
     img.copyTo(sharpened, lowContrastMask);
 @endcode
+
+The elementwise arithmetic, min/max and absolute difference operations applied to other expressions
+are not evaluated one by one: the whole chain, e.g. `(a - mean).mul(scale) + bias`, is evaluated in
+a single parallel pass when it is assigned, without materializing the intermediate arrays. The
+comparisons of arrays can start such a chain, e.g. `(a > b)*0.5`, while the operands of a comparison
+are computed before it. The result is converted to the type of the destination, e.g. in
+`Mat_<float> d = (a - b).mul(c)`, in the same pass. The intermediate results are saturated to their
+types, but they are computed in float (in double for 32-bit integers and doubles), so where an
+operation rounds, e.g. a scaled product or a division, the result may differ by one from the
+step-by-step computation, and a floating-point result may differ in the last bits.
 */
 class CV_EXPORTS MatExpr
 {
@@ -100,6 +100,8 @@ JSON.
 #include "opencv2/core/types.hpp"
 #include "opencv2/core/mat.hpp"
 
+#include <functional>
+
 namespace cv {
 
 /** @addtogroup core_xml
@@ -380,6 +382,28 @@ public:
      */
     CV_WRAP virtual String releaseAndGetString();
 
+    //! the function receiving the nodes read by FileStorage::readNodes
+    typedef std::function<void(const FileNode& node)> NodeCallback;
+
+    /** @brief Reads a file node by node, without keeping the whole content in memory.
+
+     The file is parsed incrementally. Every element of the top-level mapping (or sequence) is passed to the
+     callback as soon as it has been read and is dropped after the callback returns, so, unlike
+     FileStorage::open, the memory taken by the parsed data is bounded by the largest top-level element
+     rather than by the whole file. The node and the nodes obtained from it are valid only until the
+     callback returns; the data that is needed later should be read into the user structures (e.g. with
+     `node >> mat`) inside the callback.
+     @param filename Name of the file to read or the text string to read the data from (with
+     FileStorage::MEMORY in flags). See FileStorage::open.
+     @param callback The function called for every top-level element, in the file order. Use FileNode::name()
+     to find out which element it is.
+     @param flags FileStorage::READ, optionally combined with FileStorage::MEMORY.
+     @param encoding Encoding of the file, see FileStorage::open.
+     @returns true if the file has been parsed successfully.
+     */
+    static bool readNodes(const String& filename, const NodeCallback& callback, int flags=READ,
+                          const String& encoding=String());
+
     /** @brief Returns the first element of the top-level mapping.
      @returns The first element of the top-level mapping.
      */
@@ -24,6 +24,29 @@ public:
     virtual void resetPeakUsage() = 0;
 };
 
+/** Statistics of the pooled Mat allocator (see cv::Mat::getPoolAllocator).
+
+The usage counters of the base interface account the blocks handed out to the arrays, rounded up
+to the pool size classes.
+*/
+class PoolAllocatorStatisticsInterface : public AllocatorStatisticsInterface
+{
+protected:
+    PoolAllocatorStatisticsInterface() {}
+    virtual ~PoolAllocatorStatisticsInterface() {}
+public:
+    /** number of allocations served by the blocks cached in the pool */
+    virtual uint64_t getNumberOfHits() const = 0;
+    /** number of allocations passed to the system allocator */
+    virtual uint64_t getNumberOfMisses() const = 0;
+    /** size of the blocks cached in the pool for reuse, including the per-thread caches */
+    virtual uint64_t getReservedSize() const = 0;
+    virtual uint64_t getPeakReservedSize() const = 0;
+};
+
+/** Returns the statistics of the pooled Mat allocator */
+CV_EXPORTS PoolAllocatorStatisticsInterface& getPoolAllocatorStatistics();
+
 }} // namespace
 
 #endif // OPENCV_CORE_ALLOCATOR_STATS_HPP
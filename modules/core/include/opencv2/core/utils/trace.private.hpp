@@ -15,6 +15,7 @@
 
 //! @cond IGNORED
 
+#include <atomic>
 #include <deque>
 #include <ostream>
 
@@ -53,6 +54,7 @@ namespace details {
 enum RegionFlag {
     REGION_FLAG__NEED_STACK_POP = (1 << 0),
     REGION_FLAG__ACTIVE = (1 << 1),
+    REGION_FLAG__LATENCY_SAMPLE = (1 << 2),
 
     ENUM_REGION_FLAG_IMPL_FORCE_INT = INT_MAX
 };
@@ -323,6 +325,57 @@ struct TraceManagerThreadLocal
     inline int getCurrentDepth() const { return (int)stack.size(); }
 };
 
+enum {
+    LATENCY_MAX_SHIFT = 40, // 2^41 ns (36 minutes) and longer durations share the last bucket
+    LATENCY_BUCKETS = 4 + (LATENCY_MAX_SHIFT - 1)*4,
+    LATENCY_CHUNK_SIZE = 32,
+    LATENCY_MAX_CHUNKS = 2048,
+    LATENCY_MAX_DEPTH = 64
+};
+
+//! Latency statistics of one region in the table of one thread.
+//! Only the owner thread writes them, the other threads may read them at any time.
+struct LatencyData
+{
+    std::atomic<unsigned> epoch; // the data of the old epochs is discarded, see resetLatencyStatistics
+    std::atomic<uint64> count;
+    std::atomic<uint64> totalTime;
+    std::atomic<uint64> maxTime;
+    std::atomic<uint64> histogram[LATENCY_BUCKETS];
+
+    LatencyData() { clear(0); }
+    void clear(unsigned newEpoch);
+    void add(uint64 duration);
+};
+
+//! Latency statistics table of a thread, indexed by the location id
+struct LatencyThreadLocal
+{
+    struct Sample
+    {
+        LatencyData* data;
+        int64 beginTimestamp;
+    };
+
+    int sampleCountdown;
+    int depth;
+    Sample samples[LATENCY_MAX_DEPTH]; // the sampled regions entered by the thread
+    std::atomic<LatencyData*> chunks[LATENCY_MAX_CHUNKS];
+
+    LatencyThreadLocal() : sampleCountdown(1), depth(0)
+    {
+        for (int i = 0; i < LATENCY_MAX_CHUNKS; i++)
+            chunks[i].store(NULL, std::memory_order_relaxed);
+    }
+    ~LatencyThreadLocal()
+    {
+        for (int i = 0; i < LATENCY_MAX_CHUNKS; i++)
+            delete[] chunks[i].load(std::memory_order_relaxed);
+    }
+
+    LatencyData* getData(int location_id);
+};
+
 class CV_EXPORTS TraceManager
 {
 public:
@@ -335,6 +388,7 @@ public:
     Mutex mutexCount;
 
     TLSDataAccumulator<TraceManagerThreadLocal> tls;
+    TLSDataAccumulator<LatencyThreadLocal> latency_tls;
 
     cv::Ptr<TraceStorage> trace_storage;
 private:
@@ -0,0 +1,76 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_TRACE_STATS_HPP
+#define OPENCV_CORE_TRACE_STATS_HPP
+
+#include "../cvdef.h"
+
+#include <string>
+#include <vector>
+
+namespace cv { namespace utils { namespace trace {
+
+//! @addtogroup core_logging
+//! @{
+
+/** @brief Latency statistics of a traced code region (see CV_TRACE_FUNCTION, CV_TRACE_REGION).
+
+The durations are counted in the histogram buckets covering [0, 4) ns one by one and then 4 buckets per
+power of two, so the duration is known within 25%.
+*/
+struct CV_EXPORTS RegionLatencyStatistics
+{
+    std::string name;      //!< function signature or region name
+    std::string filename;  //!< source file of the region
+    int line;              //!< source line of the region
+    uint64 count;          //!< number of the sampled calls
+    uint64 totalTime;      //!< total duration of the sampled calls, in nanoseconds
+    uint64 maxTime;        //!< the longest sampled call, in nanoseconds
+    std::vector<uint64> histogram; //!< number of the sampled calls per duration bucket
+
+    RegionLatencyStatistics() : line(0), count(0), totalTime(0), maxTime(0) {}
+
+    /** @brief Returns the duration (in nanoseconds) that is not exceeded by the given part of the sampled calls.
+    @param q The part of the calls, e.g. 0.5 for the median or 0.99.
+    */
+    uint64 percentile(double q) const;
+
+    //! returns the shortest duration (in nanoseconds) counted in the histogram bucket
+    static uint64 getBucketLowerBound(int bucket);
+};
+
+/** @brief Enables collection of the latency statistics of the traced regions.
+
+Every samplingPeriod-th traced region entered by a thread is timed, and its duration is added to the
+histogram of its region in the per-thread tables. The tables are updated by their threads only, without
+locks or atomic read-modify-write operations, so with the sampling the collection can be left enabled in
+production. The collection does not need the trace files (OPENCV_TRACE) or ITT.
+The initial period is taken from the OPENCV_TRACE_LATENCY environment variable.
+@param samplingPeriod 1 to time every call, 0 to disable the collection.
+*/
+CV_EXPORTS void setLatencySampling(int samplingPeriod);
+
+//! returns the sampling period of the latency statistics, 0 if the collection is disabled
+CV_EXPORTS int getLatencySampling();
+
+/** @brief Returns the latency statistics collected by all the threads since the last reset.
+
+The statistics are merged from the per-thread tables while the threads keep running, sorted by the total
+time in the descending order. Only the regions with the sampled calls are returned.
+*/
+CV_EXPORTS void getLatencyStatistics(std::vector<RegionLatencyStatistics>& stats);
+
+/** @brief Discards the collected latency statistics.
+
+Every thread clears its table on the next sample, so the statistics of the calls active during the reset
+are counted after it.
+*/
+CV_EXPORTS void resetLatencyStatistics();
+
+//! @}
+
+}}} // namespace
+
+#endif // OPENCV_CORE_TRACE_STATS_HPP
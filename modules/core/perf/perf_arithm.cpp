@@ -400,4 +400,12 @@ INSTANTIATE_TEST_CASE_P(/*nothing*/ , BinaryOpTest,
     )
 );
 
+// large frames and tensors are split among threads, run with --perf_threads to see the scaling
+INSTANTIATE_TEST_CASE_P(Large, BinaryOpTest,
+    testing::Combine(
+        testing::Values(sz2160p, sz4320p),
+        testing::Values(CV_8UC1, CV_8UC3, CV_16SC1, CV_32FC1)
+    )
+);
+
 } // namespace
@@ -38,4 +38,53 @@ PERF_TEST_P( Size_DepthSrc_DepthDst_Channels_alpha, convertTo,
     SANITY_CHECK(dst, eps);
 }
 
+
+PERF_TEST_P( Size_DepthSrc_DepthDst_Channels_alpha, convertTo_large,
+             testing::Combine
+             (
+                 testing::Values(sz2160p, sz4320p),
+                 testing::Values(CV_8U, CV_16U, CV_32F),
+                 testing::Values(CV_8U, CV_32F),
+                 testing::Values(1, 3),
+                 testing::Values(1.0, 1./255)
+             )
+           )
+{
+    Size sz = get<0>(GetParam());
+    int depthSrc = get<1>(GetParam());
+    int depthDst = get<2>(GetParam());
+    int channels = get<3>(GetParam());
+    double alpha = get<4>(GetParam());
+
+    Mat src(sz, CV_MAKETYPE(depthSrc, channels));
+    randu(src, 0, 255);
+    Mat dst(sz, CV_MAKETYPE(depthDst, channels));
+
+    TEST_CYCLE() src.convertTo(dst, depthDst, alpha);
+
+    SANITY_CHECK_NOTHING();
+}
+
+typedef tuple<Size, MatType> Size_SrcType_t;
+typedef perf::TestBaseWithParam<Size_SrcType_t> Size_SrcType;
+
+PERF_TEST_P( Size_SrcType, convertScaleAbs_large,
+             testing::Combine
+             (
+                 testing::Values(sz2160p, sz4320p),
+                 testing::Values(CV_16SC1, CV_32FC1, CV_32FC3)
+             )
+           )
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+
+    Mat src(sz, type), dst(sz, CV_MAKETYPE(CV_8U, CV_MAT_CN(type)));
+    randu(src, -1000, 1000);
+
+    TEST_CYCLE() convertScaleAbs(src, dst, 0.25, 10);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
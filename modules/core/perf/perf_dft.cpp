@@ -36,6 +36,46 @@ PERF_TEST_P(Size_MatType_FlagsType_NzeroRows, dft, TEST_MATS_DFT)
     SANITY_CHECK(dst, 1e-5, ERROR_RELATIVE);
 }
 
+typedef tuple<Size, MatType, bool> Size_MatType_Batch_t;
+typedef perf::TestBaseWithParam<Size_MatType_Batch_t> Size_MatType_Batch;
+
+// the repeated transforms of the same size that reuse the prepared plan
+PERF_TEST_P(Size_MatType_Batch, dftPlan, testing::Combine(
+                                    testing::Values(cv::Size(256, 256), cv::Size(1024, 1)),
+                                    testing::Values(CV_32FC1, CV_32FC2),
+                                    testing::Bool()))
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    bool batch = get<2>(GetParam());
+    const int n = 64;
+
+    std::vector<Mat> src(n), dst(n);
+    for (int i = 0; i < n; i++)
+    {
+        src[i].create(sz, type);
+        randu(src[i], -1, 1);
+    }
+    Ptr<DFTPlan> plan = DFTPlan::create(sz, type);
+
+    declare.time(60);
+
+    if (batch)
+    {
+        TEST_CYCLE() plan->applyBatch(src, dst);
+    }
+    else
+    {
+        TEST_CYCLE()
+        {
+            for (int i = 0; i < n; i++)
+                dft(src[i], dst[i]);
+        }
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 ///////////////////////////////////////////////////////dct//////////////////////////////////////////////////////
 
 CV_ENUM(DCT_FlagsType, 0, DCT_INVERSE , DCT_ROWS, DCT_INVERSE|DCT_ROWS)
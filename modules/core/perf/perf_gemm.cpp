@@ -0,0 +1,63 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "perf_precomp.hpp"
+
+namespace opencv_test
+{
+using namespace perf;
+
+CV_FLAGS(GemmFlags, 0, GEMM_1_T, GEMM_2_T, GEMM_3_T)
+
+typedef tuple<int, MatType, GemmFlags> Gemm_Size_MatType_Flags_t;
+typedef TestBaseWithParam<Gemm_Size_MatType_Flags_t> Gemm_Size_MatType_Flags;
+
+PERF_TEST_P(Gemm_Size_MatType_Flags, gemm,
+            testing::Combine(
+                testing::Values(64, 128, 256, 512, 1024),
+                testing::Values(CV_32FC1, CV_64FC1),
+                testing::Values(0, (int)GEMM_1_T, (int)GEMM_2_T, (int)(GEMM_1_T | GEMM_2_T))
+                ))
+{
+    int n = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    int flags = get<2>(GetParam());
+
+    Mat a(n, n, type), b(n, n, type), c(n, n, type), d(n, n, type);
+    // random bit patterns would bring denormals and NaNs into the timing
+    randu(a, -1, 1);
+    randu(b, -1, 1);
+    randu(c, -1, 1);
+    declare.in(a, b, c).out(d);
+    declare.time(100);
+
+    TEST_CYCLE() cv::gemm(a, b, 1.5, c, 0.5, d, flags);
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Gemm_Size_MatType_Flags, gemm_rect,
+            testing::Combine(
+                testing::Values(100, 300),
+                testing::Values(CV_32FC1, CV_64FC1),
+                testing::Values(0, (int)GEMM_2_T)
+                ))
+{
+    int n = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    int flags = get<2>(GetParam());
+
+    // a tall-skinny product, like the ones in PCA projection
+    Mat a(n*20, n, type), b(n, n/2, type), d;
+    if( flags & GEMM_2_T )
+        b = Mat(n/2, n, type);
+    randu(a, -1, 1);
+    randu(b, -1, 1);
+    declare.in(a, b);
+
+    TEST_CYCLE() cv::gemm(a, b, 1, noArray(), 0, d, flags);
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
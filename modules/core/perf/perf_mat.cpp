@@ -166,4 +166,61 @@ PERF_TEST_P(Size_MatType, Mat_Transform,
     SANITY_CHECK(dst, 1e-6, ERROR_RELATIVE);
 }
 
+typedef perf::TestBaseWithParam< std::tuple<Size, bool> > Size_Pooled;
+
+// a chain of operations creating fresh temporary arrays, like the per-frame code of a video pipeline
+PERF_TEST_P(Size_Pooled, Mat_TemporariesChurn,
+            testing::Combine(testing::Values(szVGA, sz1080p),
+                             testing::Bool())
+             )
+{
+    Size size = get<0>(GetParam());
+    bool pooled = get<1>(GetParam());
+    Mat src(size, CV_8UC3), dst;
+    declare.in(src, WARMUP_RNG);
+
+    MatAllocatorScope scope(pooled ? Mat::getPoolAllocator() : Mat::getStdAllocator());
+    TEST_CYCLE_MULTIRUN(10)
+    {
+        Mat t1, t2, t3;
+        cv::add(src, Scalar::all(1), t1);
+        src.convertTo(t2, CV_16U, 2);
+        t2.convertTo(t3, CV_8U, 0.5);
+        cv::subtract(t3, t1, dst);
+    }
+    Mat::getPoolAllocator()->getBufferPoolController()->freeAllReservedBuffers();
+
+    SANITY_CHECK_NOTHING();
+}
+
+typedef perf::TestBaseWithParam< std::tuple<Size, MatType, bool> > Size_MatType_Fused;
+
+// the normalization of a network input: a single pass when fused, three passes over memory otherwise
+PERF_TEST_P(Size_MatType_Fused, MatExpr_Normalize,
+            testing::Combine(testing::Values(sz1080p, sz2160p),
+                             testing::Values(CV_8UC3, CV_32FC3),
+                             testing::Bool())
+             )
+{
+    Size size = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    bool fused = get<2>(GetParam());
+    Mat src(size, type), scale(size, type), bias(size, type), dst(size, type);
+    declare.in(src, scale, bias, WARMUP_RNG).out(dst);
+    Scalar mean(104, 117, 123);
+
+    TEST_CYCLE()
+    {
+        if( fused )
+            dst = (src - mean).mul(scale) + bias;
+        else
+        {
+            Mat t1 = src - mean, t2 = t1.mul(scale);
+            dst = t2 + bias;
+        }
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -37,4 +37,31 @@ PERF_TEST_P( Size_SrcDepth_DstChannels, merge,
     SANITY_CHECK(dst, eps);
 }
 
+
+PERF_TEST_P( Size_SrcDepth_DstChannels, merge_large,
+             testing::Combine
+             (
+                 testing::Values(sz2160p, sz4320p),
+                 testing::Values(CV_8U, CV_32F),
+                 testing::Values(3, 4)
+             )
+           )
+{
+    Size sz = get<0>(GetParam());
+    int srcDepth = get<1>(GetParam());
+    int dstChannels = get<2>(GetParam());
+
+    vector<Mat> mv;
+    for( int i = 0; i < dstChannels; ++i )
+    {
+        mv.push_back( Mat(sz, CV_MAKETYPE(srcDepth, 1)) );
+        randu(mv[i], 0, 255);
+    }
+
+    Mat dst;
+    TEST_CYCLE() merge( (vector<Mat> &)mv, dst );
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
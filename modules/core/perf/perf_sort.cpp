@@ -47,4 +47,33 @@ PERF_TEST_P(sortIdxFixture, sorIdx, TYPICAL_MATS_SORT)
     SANITY_CHECK_NOTHING();
 }
 
+typedef tuple<Size, MatType, bool> sortLongParams;
+typedef TestBaseWithParam<sortLongParams> sortLongFixture;
+
+// the lines of scores that are sorted with a few threads per line
+PERF_TEST_P(sortLongFixture, sortLongRows, testing::Combine(
+    testing::Values(Size(1 << 20, 1), Size(1 << 18, 4)),
+    testing::Values(CV_32SC1, CV_32FC1, CV_64FC1),
+    testing::Bool()))
+{
+    const Size sz = get<0>(GetParam());
+    const int type = get<1>(GetParam());
+    const bool idx = get<2>(GetParam());
+
+    cv::Mat a(sz, type), b(sz, idx ? CV_32SC1 : type);
+
+    declare.in(a, WARMUP_RNG).out(b);
+
+    if (idx)
+    {
+        TEST_CYCLE() cv::sortIdx(a, b, SORT_EVERY_ROW | SORT_DESCENDING);
+    }
+    else
+    {
+        TEST_CYCLE() cv::sort(a, b, SORT_EVERY_ROW | SORT_DESCENDING);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -30,4 +30,27 @@ PERF_TEST_P( Size_Depth_Channels, split,
     SANITY_CHECK(mv, 2e-5);
 }
 
+
+PERF_TEST_P( Size_Depth_Channels, split_large,
+             testing::Combine
+             (
+                 testing::Values(sz2160p, sz4320p),
+                 testing::Values(CV_8U, CV_32F),
+                 testing::Values(3, 4)
+             )
+           )
+{
+    Size sz = get<0>(GetParam());
+    int depth = get<1>(GetParam());
+    int channels = get<2>(GetParam());
+
+    Mat m(sz, CV_MAKETYPE(depth, channels));
+    randu(m, 0, 255);
+
+    vector<Mat> mv;
+    TEST_CYCLE() split(m, (vector<Mat>&)mv);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -101,4 +101,45 @@ PERF_TEST_P(Size_MatType, countNonZero, testing::Combine( testing::Values( TYPIC
     SANITY_CHECK(cnt);
 }
 
+#define STATISTICS_MATS testing::Combine( testing::Values( sz1080p, sz2160p ), testing::Values( CV_8UC1, CV_16UC1, CV_32FC1 ) )
+
+PERF_TEST_P(Size_MatType, computeStatistics, STATISTICS_MATS)
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+
+    Mat src(sz, matType);
+    Mat mean, dev, minVal, maxVal, nonZero;
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() computeStatistics(src, mean, dev, minVal, maxVal, nonZero);
+
+    SANITY_CHECK_NOTHING();
+}
+
+// the same statistics computed by the separate functions, for comparison with computeStatistics
+PERF_TEST_P(Size_MatType, separateStatistics, STATISTICS_MATS)
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+
+    Mat src(sz, matType);
+    Mat mean, dev;
+    double minVal = 0, maxVal = 0;
+    int nonZero = 0;
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE()
+    {
+        meanStdDev(src, mean, dev);
+        minMaxLoc(src, &minVal, &maxVal);
+        nonZero = countNonZero(src);
+    }
+    CV_UNUSED(nonZero);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -66,6 +66,15 @@
 #include <map>
 #endif
 
+#if defined __linux__ && !defined __ANDROID__ && !defined OPENCV_DISABLE_LARGE_BUFFER_ALLOCATION
+#define OPENCV_ALLOC_LARGE_BUFFERS 1
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <atomic>
+#include <map>
+#endif
+
 namespace cv {
 
 static void* OutOfMemoryError(size_t size)
@@ -121,6 +130,216 @@ static const bool g_force_initialization_memalign_flag
 
 #endif
 
+#ifdef OPENCV_ALLOC_LARGE_BUFFERS
+
+// The buffers of at least OPENCV_ALLOC_LARGE_BUFFER_THRESHOLD bytes (4MB by default, 1MB at least)
+// can be mapped directly and
+//  - backed by huge pages to reduce the TLB misses: OPENCV_ALLOC_HUGE_PAGES=transparent advises
+//    the kernel to use the transparent huge pages, OPENCV_ALLOC_HUGE_PAGES=explicit takes them from
+//    the reserved hugetlbfs pool (and falls back to the transparent ones when it is exhausted);
+//  - spread over the NUMA nodes: OPENCV_ALLOC_NUMA=interleave places the pages on all the nodes
+//    round-robin, so the row-parallel functions do not all read from the node of the allocating thread.
+// Both are disabled by default.
+enum { LARGE_BUFFER_HUGE_PAGES_NONE = 0, LARGE_BUFFER_HUGE_PAGES_TRANSPARENT = 1, LARGE_BUFFER_HUGE_PAGES_EXPLICIT = 2 };
+enum { LARGE_BUFFER_NUMA_NONE = 0, LARGE_BUFFER_NUMA_INTERLEAVE = 1 };
+
+// the huge page size of x86-64 and of aarch64 with 4K pages
+static const size_t LARGE_BUFFER_ALIGN = (size_t)2 << 20;
+
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE 3
+#endif
+
+// the bit mask of the online NUMA nodes
+static unsigned long readOnlineNumaNodes()
+{
+    unsigned long mask = 0;
+    FILE* f = fopen("/sys/devices/system/node/online", "r");
+    if (!f)
+        return 0;
+    int first = 0, last = 0;
+    char sep = 0;
+    while (fscanf(f, "%d", &first) == 1)
+    {
+        last = first;
+        if (fscanf(f, "%c", &sep) == 1 && sep == '-')
+        {
+            if (fscanf(f, "%d", &last) != 1)
+                break;
+            sep = 0;
+            if (fscanf(f, "%c", &sep) != 1)
+                sep = 0;
+        }
+        for (int i = std::max(first, 0); i <= last && i < (int)sizeof(mask)*8; i++)
+            mask |= 1ul << i;
+        if (sep != ',')
+            break;
+    }
+    fclose(f);
+    return mask;
+}
+
+struct LargeBufferParams
+{
+    LargeBufferParams()
+    {
+        cv::String hp = cv::utils::getConfigurationParameterString("OPENCV_ALLOC_HUGE_PAGES", "");
+        hugePages = hp == "transparent" ? LARGE_BUFFER_HUGE_PAGES_TRANSPARENT :
+                    hp == "explicit" ? LARGE_BUFFER_HUGE_PAGES_EXPLICIT : LARGE_BUFFER_HUGE_PAGES_NONE;
+        if (!hp.empty() && hp != "none" && hugePages == LARGE_BUFFER_HUGE_PAGES_NONE)
+            CV_LOG_WARNING(NULL, "alloc.cpp: unknown OPENCV_ALLOC_HUGE_PAGES value: " << hp);
+
+        cv::String numaMode = cv::utils::getConfigurationParameterString("OPENCV_ALLOC_NUMA", "");
+        numa = numaMode == "interleave" ? LARGE_BUFFER_NUMA_INTERLEAVE : LARGE_BUFFER_NUMA_NONE;
+        if (!numaMode.empty() && numaMode != "none" && numa == LARGE_BUFFER_NUMA_NONE)
+            CV_LOG_WARNING(NULL, "alloc.cpp: unknown OPENCV_ALLOC_NUMA value: " << numaMode);
+
+        init(cv::utils::getConfigurationParameterSizeT("OPENCV_ALLOC_LARGE_BUFFER_THRESHOLD", (size_t)4 << 20));
+    }
+
+    LargeBufferParams(int _hugePages, int _numa, size_t _threshold) : hugePages(_hugePages), numa(_numa)
+    {
+        init(_threshold);
+    }
+
+    void init(size_t _threshold)
+    {
+        nodeMask = 0;
+        if (numa == LARGE_BUFFER_NUMA_INTERLEAVE)
+        {
+            nodeMask = readOnlineNumaNodes();
+            if ((nodeMask & (nodeMask - 1)) == 0) // a single node
+                numa = LARGE_BUFFER_NUMA_NONE;
+        }
+
+        threshold = std::max(_threshold, LARGE_BUFFER_ALIGN/2);
+        enabled = hugePages != LARGE_BUFFER_HUGE_PAGES_NONE || numa != LARGE_BUFFER_NUMA_NONE;
+    }
+
+    int hugePages;
+    int numa;
+    unsigned long nodeMask;
+    size_t threshold;
+    bool enabled;
+};
+
+static const LargeBufferParams& getLargeBufferParams()
+{
+    static LargeBufferParams params;
+    return params;
+}
+
+// the mapped buffers and their lengths
+static std::atomic<int> g_numLargeBuffers(0);
+
+static Mutex& getLargeBuffersMutex()
+{
+    static Mutex* p_mutex = allocSingletonNew<Mutex>();
+    return *p_mutex;
+}
+
+static std::map<void*, size_t>& getLargeBuffers()
+{
+    static std::map<void*, size_t>* p_buffers = allocSingletonNew< std::map<void*, size_t> >();
+    return *p_buffers;
+}
+
+static void* largeBufferAllocate(size_t size, const LargeBufferParams& params)
+{
+    size_t len = alignSize(size, LARGE_BUFFER_ALIGN);
+    void* ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (params.hugePages == LARGE_BUFFER_HUGE_PAGES_EXPLICIT)
+        ptr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (ptr == MAP_FAILED)
+    {
+        // the mapping is aligned to the huge page size for the transparent huge pages to cover it
+        size_t mapLen = len + LARGE_BUFFER_ALIGN;
+        uchar* base = (uchar*)mmap(NULL, mapLen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == (uchar*)MAP_FAILED)
+            return NULL;
+        uchar* aligned = alignPtr(base, (int)LARGE_BUFFER_ALIGN);
+        if (aligned > base)
+            munmap(base, aligned - base);
+        if (base + mapLen > aligned + len)
+            munmap(aligned + len, (base + mapLen) - (aligned + len));
+        ptr = aligned;
+#ifdef MADV_HUGEPAGE
+        if (params.hugePages != LARGE_BUFFER_HUGE_PAGES_NONE)
+            madvise(ptr, len, MADV_HUGEPAGE);
+#endif
+    }
+
+#ifdef SYS_mbind
+    if (params.numa == LARGE_BUFFER_NUMA_INTERLEAVE)
+        syscall(SYS_mbind, ptr, len, MPOL_INTERLEAVE, &params.nodeMask, sizeof(params.nodeMask)*8 + 1, 0);
+#endif
+
+    {
+        cv::AutoLock lock(getLargeBuffersMutex());
+        getLargeBuffers()[ptr] = len;
+        g_numLargeBuffers++;
+    }
+    return ptr;
+}
+
+static bool largeBufferFree(void* ptr)
+{
+    // the mapped buffers are aligned to the huge page size, the check is skipped for the other ones
+    if (((size_t)ptr & (LARGE_BUFFER_ALIGN - 1)) != 0 || g_numLargeBuffers.load() == 0)
+        return false;
+    size_t len = 0;
+    {
+        cv::AutoLock lock(getLargeBuffersMutex());
+        std::map<void*, size_t>& buffers = getLargeBuffers();
+        std::map<void*, size_t>::iterator i = buffers.find(ptr);
+        if (i == buffers.end())
+            return false;
+        len = i->second;
+        buffers.erase(i);
+        g_numLargeBuffers--;
+    }
+    munmap(ptr, len);
+    return true;
+}
+
+// returns NULL if the buffer is not mapped, fastMalloc allocates it from the heap then
+static void* largeBufferMalloc(size_t size, const LargeBufferParams& params)
+{
+    if (!params.enabled || size < params.threshold)
+        return NULL;
+    return largeBufferAllocate(size, params);
+}
+
+#endif // OPENCV_ALLOC_LARGE_BUFFERS
+
+// The modes of the large buffers are read from the configuration once, so the tests go through them with these:
+// testLargeBufferMalloc maps the buffer as fastMalloc would with the given modes (NULL if it is not mapped),
+// testLargeBufferFree releases a mapped buffer and returns false for any other one.
+CV_EXPORTS void* testLargeBufferMalloc(size_t size, int hugePages, int numa, size_t threshold);
+CV_EXPORTS bool testLargeBufferFree(void* ptr);
+
+void* testLargeBufferMalloc(size_t size, int hugePages, int numa, size_t threshold)
+{
+#ifdef OPENCV_ALLOC_LARGE_BUFFERS
+    return largeBufferMalloc(size, LargeBufferParams(hugePages, numa, threshold));
+#else
+    CV_UNUSED(size); CV_UNUSED(hugePages); CV_UNUSED(numa); CV_UNUSED(threshold);
+    return NULL;
+#endif
+}
+
+bool testLargeBufferFree(void* ptr)
+{
+#ifdef OPENCV_ALLOC_LARGE_BUFFERS
+    return largeBufferFree(ptr);
+#else
+    CV_UNUSED(ptr);
+    return false;
+#endif
+}
+
 #ifdef OPENCV_ALLOC_ENABLE_STATISTICS
 static inline
 void* fastMalloc_(size_t size)
@@ -128,6 +347,14 @@ void* fastMalloc_(size_t size)
 void* fastMalloc(size_t size)
 #endif
 {
+#ifdef OPENCV_ALLOC_LARGE_BUFFERS
+    if (size >= LARGE_BUFFER_ALIGN/2)
+    {
+        void* ptr = largeBufferMalloc(size, getLargeBufferParams());
+        if (ptr)
+            return ptr;
+    }
+#endif
 #ifdef HAVE_POSIX_MEMALIGN
     if (isAlignedAllocationEnabled())
     {
@@ -162,6 +389,10 @@ void fastFree_(void* ptr)
 void fastFree(void* ptr)
 #endif
 {
+#ifdef OPENCV_ALLOC_LARGE_BUFFERS
+    if (ptr && largeBufferFree(ptr))
+        return;
+#endif
 #if defined HAVE_POSIX_MEMALIGN || defined HAVE_MEMALIGN
     if (isAlignedAllocationEnabled())
     {
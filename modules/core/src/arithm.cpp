@@ -209,7 +209,12 @@ static void binary_op( InputArray _src1, InputArray _src2, OutputArray _dst,
         if (len < INT_MAX)  // FIXIT similar code below doesn't have that check
         {
             sz.width = (int)len;
-            func(src1.ptr(), src1.step, src2.ptr(), src2.step, dst.ptr(), dst.step, sz.width, sz.height, 0);
+            size_t esz1 = CV_ELEM_SIZE(type1)/cn;
+            parallelForElemwise(sz, esz1*3, [&](const Rect& r)
+            {
+                size_t ofs1 = r.y*src1.step + r.x*esz1, ofs2 = r.y*src2.step + r.x*esz1, dofs = r.y*dst.step + r.x*esz1;
+                func(src1.ptr() + ofs1, src1.step, src2.ptr() + ofs2, src2.step, dst.ptr() + dofs, dst.step, r.width, r.height, 0);
+            });
             return;
         }
     }
@@ -637,7 +642,13 @@ static void arithm_op(InputArray _src1, InputArray _src2, OutputArray _dst,
 
         Mat src1 = psrc1->getMat(), src2 = psrc2->getMat(), dst = _dst.getMat();
         Size sz = getContinuousSize2D(src1, src2, dst, src1.channels());
-        tab[depth1](src1.ptr(), src1.step, src2.ptr(), src2.step, dst.ptr(), dst.step, sz.width, sz.height, usrdata);
+        BinaryFuncC func = tab[depth1];
+        size_t esz1 = CV_ELEM_SIZE1(type1);
+        parallelForElemwise(sz, esz1*3, [&](const Rect& r)
+        {
+            size_t ofs1 = r.y*src1.step + r.x*esz1, ofs2 = r.y*src2.step + r.x*esz1, dofs = r.y*dst.step + r.x*esz1;
+            func(src1.ptr() + ofs1, src1.step, src2.ptr() + ofs2, src2.step, dst.ptr() + dofs, dst.step, r.width, r.height, usrdata);
+        });
         return;
     }
 
@@ -210,7 +210,12 @@ void Mat::convertTo(OutputArray _dst, int _type, double alpha, double beta) cons
     if( dims <= 2 )
     {
         Size sz = getContinuousSize2D(src, dst, cn);
-        func( src.data, src.step, 0, 0, dst.data, dst.step, sz, scale );
+        size_t sesz1 = src.elemSize1(), desz1 = dst.elemSize1();
+        parallelForElemwise(sz, sesz1 + desz1, [&](const Rect& r)
+        {
+            func( src.data + r.y*src.step + r.x*sesz1, src.step, 0, 0,
+                  dst.data + r.y*dst.step + r.x*desz1, dst.step, r.size(), scale );
+        });
     }
     else
     {
@@ -103,7 +103,12 @@ void convertScaleAbs(InputArray _src, OutputArray _dst, double alpha, double bet
     if( src.dims <= 2 )
     {
         Size sz = getContinuousSize2D(src, dst, cn);
-        func( src.ptr(), src.step, 0, 0, dst.ptr(), dst.step, sz, scale );
+        size_t sesz1 = src.elemSize1();
+        parallelForElemwise(sz, sesz1 + 1, [&](const Rect& r)
+        {
+            func( src.ptr() + r.y*src.step + r.x*sesz1, src.step, 0, 0,
+                  dst.ptr() + r.y*dst.step + r.x, dst.step, r.size(), scale );
+        });
     }
     else
     {
@@ -142,6 +142,17 @@ int countNonZero(InputArray _src)
     Mat src = _src.getMat();
     CV_IPP_RUN_FAST(ipp_countNonZero(src, res), res);
 
+    ReduceStripes stripes(src);
+    if( stripes.count() > 1 )
+    {
+        std::vector<int> partial;
+        stripes.run(partial, [&](int i) { return countNonZero(stripes.stripe(src, i)); });
+        int nz = 0;
+        for( size_t i = 0; i < partial.size(); i++ )
+            nz += partial[i];
+        return nz;
+    }
+
     CountNonZeroFunc func = getCountNonZeroTab(src.depth());
     CV_Assert( func != 0 );
 
@@ -1261,11 +1261,15 @@ RealDFT(const OcvDftOptions & c, const T* src, T* dst)
         T scale2 = scale*(T)0.5;
         int n2 = n >> 1;
 
-        c.factors[0] >>= 1;
+        // the half-length transform gets its own copy of the factors,
+        // the options may be shared by the threads transforming different rows
+        int factors[34];
+        memcpy(factors, c.factors, c.nf*sizeof(factors[0]));
+        factors[0] >>= 1;
 
         OcvDftOptions sub_c = c;
-        sub_c.factors += (c.factors[0] == 1);
-        sub_c.nf -= (c.factors[0] == 1);
+        sub_c.factors = factors + (factors[0] == 1);
+        sub_c.nf -= (factors[0] == 1);
         sub_c.isComplex = false;
         sub_c.isInverse = false;
         sub_c.noPermute = false;
@@ -1274,8 +1278,6 @@ RealDFT(const OcvDftOptions & c, const T* src, T* dst)
 
         DFT(sub_c, (Complex<T>*)src, (Complex<T>*)dst);
 
-        c.factors[0] <<= 1;
-
         t = dst[0] - dst[1];
         dst[0] = (dst[0] + dst[1])*scale;
         dst[1] = t*scale;
@@ -1476,11 +1478,15 @@ CCSIDFT(const OcvDftOptions & c, const T* src, T* dst)
             }
         }
 
-        c.factors[0] >>= 1;
+        // the half-length transform gets its own copy of the factors,
+        // the options may be shared by the threads transforming different rows
+        int factors[34];
+        memcpy(factors, c.factors, c.nf*sizeof(factors[0]));
+        factors[0] >>= 1;
 
         OcvDftOptions sub_c = c;
-        sub_c.factors += (c.factors[0] == 1);
-        sub_c.nf -= (c.factors[0] == 1);
+        sub_c.factors = factors + (factors[0] == 1);
+        sub_c.nf -= (factors[0] == 1);
         sub_c.isComplex = false;
         sub_c.isInverse = false;
         sub_c.noPermute = !inplace;
@@ -1489,8 +1495,6 @@ CCSIDFT(const OcvDftOptions & c, const T* src, T* dst)
 
         DFT(sub_c, (Complex<T>*)dst, (Complex<T>*)dst);
 
-        c.factors[0] <<= 1;
-
         for( j = 0; j < n; j += 2 )
         {
             t0 = dst[j]*scale;
@@ -2778,6 +2782,26 @@ inline DftDims determineDims(int rows, int cols, bool isRowWise, bool isContinuo
     return InvalidDim;
 }
 
+static bool isReentrant(const hal::DFT1D* context);
+
+// The buffers of a column transform: buf0 and buf1 receive the columns and dbuf0 and dbuf1 the results.
+// If the transform cannot be done in place, the result of the second column goes to an extra buffer
+// and the result of the first one goes to buf1, which is free by then.
+struct ColumnBuffers
+{
+    ColumnBuffers(uchar* data, size_t size, bool needBuffer)
+    {
+        buf0 = dbuf0 = data;
+        buf1 = dbuf1 = data + size;
+        if( needBuffer )
+        {
+            dbuf1 = data + size*2;
+            dbuf0 = buf1;
+        }
+    }
+    uchar *buf0, *buf1, *dbuf0, *dbuf1;
+};
+
 class OcvDftImpl CV_FINAL : public hal::DFT2D
 {
 protected:
@@ -2800,11 +2824,9 @@ protected:
     bool useIpp;
     int src_channels;
     int dst_channels;
-
-    AutoBuffer<uchar> tmp_bufA;
-    AutoBuffer<uchar> tmp_bufB;
-    AutoBuffer<uchar> buf0;
-    AutoBuffer<uchar> buf1;
+    // the rows (columns) are transformed in parallel if the 1D transform can be applied concurrently
+    bool parallelA;
+    bool parallelB;
 
 public:
     OcvDftImpl()
@@ -2825,6 +2847,14 @@ public:
         useIpp = false;
         src_channels = 0;
         dst_channels = 0;
+        parallelA = false;
+        parallelB = false;
+    }
+
+    // whether apply can be called by several threads at once
+    bool isConcurrent() const
+    {
+        return !useIpp && (!contextA || parallelA) && (!contextB || parallelB);
     }
 
     void init(int _width, int _height, int _depth, int _src_channels, int _dst_channels, int flags, int _nonzero_rows)
@@ -2931,8 +2961,7 @@ public:
                 }
                 needBufferA = isInplace;
                 contextA = hal::DFT1D::create(len, count, depth, f, &needBufferA);
-                if (needBufferA)
-                    tmp_bufA.allocate(len * complex_elem_size);
+                parallelA = isReentrant(contextA.get());
             }
             else
             {
@@ -2941,11 +2970,7 @@ public:
                 f |= CV_HAL_DFT_STAGE_COLS;
                 needBufferB = isInplace;
                 contextB = hal::DFT1D::create(len, count, depth, f, &needBufferB);
-                if (needBufferB)
-                    tmp_bufB.allocate(len * complex_elem_size);
-
-                buf0.allocate(len * complex_elem_size);
-                buf1.allocate(len * complex_elem_size);
+                parallelB = isReentrant(contextB.get());
             }
         }
     }
@@ -3058,23 +3083,31 @@ protected:
         if( nz <= 0 || nz > count )
             nz = count;
 
-        int i;
-        for( i = 0; i < nz; i++ )
+        // the scratch buffers are allocated per stripe, so the transform can be applied by several threads at once
+        auto body = [&](const Range& range)
         {
-            const uchar* sptr = src_data + src_step * i;
-            uchar* dptr0 = dst_data + dst_step * i;
-            uchar* dptr = dptr0;
+            AutoBuffer<uchar> tmp_buf(needBufferA ? len * complex_elem_size : 0);
+            for( int i = range.start; i < range.end; i++ )
+            {
+                const uchar* sptr = src_data + src_step * i;
+                uchar* dptr0 = dst_data + dst_step * i;
+                uchar* dptr = dptr0;
 
-            if( needBufferA )
-                dptr = tmp_bufA.data();
+                if( needBufferA )
+                    dptr = tmp_buf.data();
 
-            contextA->apply(sptr, dptr);
+                contextA->apply(sptr, dptr);
 
-            if( needBufferA )
-                memcpy( dptr0, dptr + dptr_offset, dst_full_len );
-        }
+                if( needBufferA )
+                    memcpy( dptr0, dptr + dptr_offset, dst_full_len );
+            }
+        };
+        if( parallelA && nz > 1 )
+            parallel_for_(Range(0, nz), body, (double)nz * len / (1 << 12));
+        else
+            body(Range(0, nz));
 
-        for( ; i < count; i++ )
+        for( int i = nz; i < count; i++ )
         {
             uchar* dptr0 = dst_data + dst_step * i;
             memset( dptr0, 0, dst_full_len );
@@ -3088,62 +3121,58 @@ protected:
         int len = height;
         int count = width;
         int a = 0, b = count;
-        uchar *dbuf0, *dbuf1;
         const uchar* sptr0 = src_data;
         uchar* dptr0 = dst_data;
-
-        dbuf0 = buf0.data(), dbuf1 = buf1.data();
-
-        if( needBufferB )
-        {
-            dbuf1 = tmp_bufB.data();
-            dbuf0 = buf1.data();
-        }
+        size_t bufSize = (size_t)len * complex_elem_size;
 
         if( real_transform )
         {
+            AutoBuffer<uchar> _buf(bufSize * 3);
+            ColumnBuffers buf(_buf.data(), bufSize, needBufferB);
+            uchar *buf0 = buf.buf0, *buf1 = buf.buf1, *dbuf0 = buf.dbuf0, *dbuf1 = buf.dbuf1;
+
             int even;
             a = 1;
             even = (count & 1) == 0;
             b = (count+1)/2;
             if( !inv )
             {
-                memset( buf0.data(), 0, len*complex_elem_size );
-                CopyColumn( sptr0, src_step, buf0.data(), complex_elem_size, len, elem_size );
+                memset( buf0, 0, len*complex_elem_size );
+                CopyColumn( sptr0, src_step, buf0, complex_elem_size, len, elem_size );
                 sptr0 += stage_dst_channels*elem_size;
                 if( even )
                 {
-                    memset( buf1.data(), 0, len*complex_elem_size );
+                    memset( buf1, 0, len*complex_elem_size );
                     CopyColumn( sptr0 + (count-2)*elem_size, src_step,
-                                buf1.data(), complex_elem_size, len, elem_size );
+                                buf1, complex_elem_size, len, elem_size );
                 }
             }
             else if( stage_src_channels == 1 )
             {
-                CopyColumn( sptr0, src_step, buf0.data(), elem_size, len, elem_size );
-                ExpandCCS( buf0.data(), len, elem_size );
+                CopyColumn( sptr0, src_step, buf0, elem_size, len, elem_size );
+                ExpandCCS( buf0, len, elem_size );
                 if( even )
                 {
                     CopyColumn( sptr0 + (count-1)*elem_size, src_step,
-                                buf1.data(), elem_size, len, elem_size );
-                    ExpandCCS( buf1.data(), len, elem_size );
+                                buf1, elem_size, len, elem_size );
+                    ExpandCCS( buf1, len, elem_size );
                 }
                 sptr0 += elem_size;
             }
             else
             {
-                CopyColumn( sptr0, src_step, buf0.data(), complex_elem_size, len, complex_elem_size );
+                CopyColumn( sptr0, src_step, buf0, complex_elem_size, len, complex_elem_size );
                 if( even )
                 {
                     CopyColumn( sptr0 + b*complex_elem_size, src_step,
-                                   buf1.data(), complex_elem_size, len, complex_elem_size );
+                                   buf1, complex_elem_size, len, complex_elem_size );
                 }
                 sptr0 += complex_elem_size;
             }
 
             if( even )
-                contextB->apply(buf1.data(), dbuf1);
-            contextB->apply(buf0.data(), dbuf0);
+                contextB->apply(buf1, dbuf1);
+            contextB->apply(buf0, dbuf0);
 
             if( stage_dst_channels == 1 )
             {
@@ -3186,25 +3215,37 @@ protected:
             }
         }
 
-        for(int i = a; i < b; i += 2 )
+        // the rest of the columns are transformed in pairs, the pairs are distributed between the threads
+        int npairs = (b - a + 1)/2;
+        auto body = [&](const Range& range)
         {
-            if( i+1 < b )
+            AutoBuffer<uchar> _buf(bufSize * 3);
+            ColumnBuffers buf(_buf.data(), bufSize, needBufferB);
+            for( int p = range.start; p < range.end; p++ )
             {
-                CopyFrom2Columns( sptr0, src_step, buf0.data(), buf1.data(), len, complex_elem_size );
-                contextB->apply(buf1.data(), dbuf1);
-            }
-            else
-                CopyColumn( sptr0, src_step, buf0.data(), complex_elem_size, len, complex_elem_size );
+                int i = a + p*2;
+                const uchar* sptr = sptr0 + (size_t)p*2*complex_elem_size;
+                uchar* dptr = dptr0 + (size_t)p*2*complex_elem_size;
+                if( i+1 < b )
+                {
+                    CopyFrom2Columns( sptr, src_step, buf.buf0, buf.buf1, len, complex_elem_size );
+                    contextB->apply(buf.buf1, buf.dbuf1);
+                }
+                else
+                    CopyColumn( sptr, src_step, buf.buf0, complex_elem_size, len, complex_elem_size );
 
-            contextB->apply(buf0.data(), dbuf0);
+                contextB->apply(buf.buf0, buf.dbuf0);
 
-            if( i+1 < b )
-                CopyTo2Columns( dbuf0, dbuf1, dptr0, dst_step, len, complex_elem_size );
-            else
-                CopyColumn( dbuf0, complex_elem_size, dptr0, dst_step, len, complex_elem_size );
-            sptr0 += 2*complex_elem_size;
-            dptr0 += 2*complex_elem_size;
-        }
+                if( i+1 < b )
+                    CopyTo2Columns( buf.dbuf0, buf.dbuf1, dptr, dst_step, len, complex_elem_size );
+                else
+                    CopyColumn( buf.dbuf0, complex_elem_size, dptr, dst_step, len, complex_elem_size );
+            }
+        };
+        if( parallelB && npairs > 1 )
+            parallel_for_(Range(0, npairs), body, (double)npairs * 2 * len / (1 << 12));
+        else
+            body(Range(0, npairs));
         if(isLastStage && mode == FwdRealToComplex)
             complementComplexOutput(depth, dst_data, dst_step, count, len, 2);
     }
@@ -3373,6 +3414,19 @@ public:
     void free() {}
 };
 
+// the HAL replacements are not known to support the concurrent calls, and neither does IPP with its work buffer
+static bool isReentrant(const hal::DFT1D* context)
+{
+    const OcvDftBasicImpl* impl = dynamic_cast<const OcvDftBasicImpl*>(context);
+    return impl && !impl->opt.useIpp;
+}
+
+static bool isReentrant(const hal::DFT2D* context)
+{
+    const OcvDftImpl* impl = dynamic_cast<const OcvDftImpl*>(context);
+    return impl && impl->isConcurrent();
+}
+
 struct ReplacementDFT1D : public hal::DFT1D
 {
     cvhalDFT *context;
@@ -3483,6 +3537,43 @@ Ptr<DFT2D> DFT2D::create(int width, int height, int depth,
 } // cv::
 
 
+namespace cv {
+
+static int getDftDstType(int type, int flags)
+{
+    int depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+    bool inv = (flags & DFT_INVERSE) != 0;
+
+    CV_Assert( type == CV_32FC1 || type == CV_32FC2 || type == CV_64FC1 || type == CV_64FC2 );
+
+    // Fail if DFT_COMPLEX_INPUT is specified, but src is not 2 channels.
+    CV_Assert( !((flags & DFT_COMPLEX_INPUT) && cn != 2) );
+
+    if( !inv && cn == 1 && (flags & DFT_COMPLEX_OUTPUT) )
+        return CV_MAKETYPE(depth, 2);
+    if( inv && cn == 2 && (flags & DFT_REAL_OUTPUT) )
+        return depth;
+    return type;
+}
+
+static int getDftHalFlags(int flags, bool isContinuous, bool isInplace)
+{
+    int f = 0;
+    if (isContinuous)
+        f |= CV_HAL_DFT_IS_CONTINUOUS;
+    if (flags & DFT_INVERSE)
+        f |= CV_HAL_DFT_INVERSE;
+    if (flags & DFT_ROWS)
+        f |= CV_HAL_DFT_ROWS;
+    if (flags & DFT_SCALE)
+        f |= CV_HAL_DFT_SCALE;
+    if (isInplace)
+        f |= CV_HAL_DFT_IS_INPLACE;
+    return f;
+}
+
+}
+
 void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
 {
     CV_INSTRUMENT_REGION();
@@ -3499,35 +3590,13 @@ void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
 #endif
 
     Mat src0 = _src0.getMat(), src = src0;
-    bool inv = (flags & DFT_INVERSE) != 0;
-    int type = src.type();
     int depth = src.depth();
 
-    CV_Assert( type == CV_32FC1 || type == CV_32FC2 || type == CV_64FC1 || type == CV_64FC2 );
-
-    // Fail if DFT_COMPLEX_INPUT is specified, but src is not 2 channels.
-    CV_Assert( !((flags & DFT_COMPLEX_INPUT) && src.channels() != 2) );
-
-    if( !inv && src.channels() == 1 && (flags & DFT_COMPLEX_OUTPUT) )
-        _dst.create( src.size(), CV_MAKETYPE(depth, 2) );
-    else if( inv && src.channels() == 2 && (flags & DFT_REAL_OUTPUT) )
-        _dst.create( src.size(), depth );
-    else
-        _dst.create( src.size(), type );
+    _dst.create( src.size(), getDftDstType(src.type(), flags) );
 
     Mat dst = _dst.getMat();
 
-    int f = 0;
-    if (src.isContinuous() && dst.isContinuous())
-        f |= CV_HAL_DFT_IS_CONTINUOUS;
-    if (inv)
-        f |= CV_HAL_DFT_INVERSE;
-    if (flags & DFT_ROWS)
-        f |= CV_HAL_DFT_ROWS;
-    if (flags & DFT_SCALE)
-        f |= CV_HAL_DFT_SCALE;
-    if (src.data == dst.data)
-        f |= CV_HAL_DFT_IS_INPLACE;
+    int f = getDftHalFlags(flags, src.isContinuous() && dst.isContinuous(), src.data == dst.data);
     Ptr<hal::DFT2D> c = hal::DFT2D::create(src.cols, src.rows, depth, src.channels(), dst.channels(), f, nonzero_rows);
     c->apply(src.data, src.step, dst.data, dst.step);
 }
@@ -3540,6 +3609,107 @@ void cv::idft( InputArray src, OutputArray dst, int flags, int nonzero_rows )
     dft( src, dst, flags | DFT_INVERSE, nonzero_rows );
 }
 
+namespace cv {
+
+DFTPlan::~DFTPlan() {}
+
+// The transform contexts depend on whether the arrays are continuous and whether the transform
+// is in-place, so the plan keeps one for each of these cases, created on the first use.
+class DFTPlanImpl CV_FINAL : public DFTPlan
+{
+public:
+    DFTPlanImpl(Size _size, int _type, int _flags, int _nonzeroRows)
+        : size(_size), type(_type), flags(_flags), nonzeroRows(_nonzeroRows)
+    {
+        CV_Assert( size.width > 0 && size.height > 0 );
+        dstType = getDftDstType(type, flags);
+        // the most common case is prepared right away, it also checks the parameters
+        getContext(true, false);
+    }
+
+    void apply(InputArray _src, OutputArray _dst) const CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        Mat src = _src.getMat();
+        CV_Assert( src.size() == size && src.type() == type );
+        _dst.create(size, dstType);
+        Mat dst = _dst.getMat();
+        applyMat(src, dst);
+    }
+
+    void applyBatch(InputArrayOfArrays _src, OutputArrayOfArrays _dst) const CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        std::vector<Mat> src;
+        _src.getMatVector(src);
+        int n = (int)src.size();
+        for( int i = 0; i < n; i++ )
+            CV_Assert( src[i].size() == size && src[i].type() == type );
+
+        _dst.create(n, 1, dstType, -1, true);
+        std::vector<Mat> dst(n);
+        for( int i = 0; i < n; i++ )
+        {
+            _dst.create(size, dstType, i);
+            dst[i] = _dst.getMat(i);
+        }
+
+        // every transform runs in one thread, the rows and the columns are not split any further;
+        // the contexts are shared, so the arrays are processed one by one unless they are reentrant
+        bool parallel = true;
+        for( int i = 0; i < n && parallel; i++ )
+            parallel = isReentrant(getContext(src[i].isContinuous() && dst[i].isContinuous(), src[i].data == dst[i].data).get());
+        auto body = [&](const Range& range)
+        {
+            for( int i = range.start; i < range.end; i++ )
+                applyMat(src[i], dst[i]);
+        };
+        if( parallel && n > 1 )
+            parallel_for_(Range(0, n), body);
+        else
+            body(Range(0, n));
+    }
+
+    Size getSize() const CV_OVERRIDE { return size; }
+    int getType() const CV_OVERRIDE { return type; }
+    int getDstType() const CV_OVERRIDE { return dstType; }
+    int getFlags() const CV_OVERRIDE { return flags; }
+
+private:
+    void applyMat(const Mat& src, Mat& dst) const
+    {
+        const Ptr<hal::DFT2D>& c = getContext(src.isContinuous() && dst.isContinuous(), src.data == dst.data);
+        c->apply(src.data, src.step, dst.data, dst.step);
+    }
+
+    const Ptr<hal::DFT2D>& getContext(bool isContinuous, bool isInplace) const
+    {
+        AutoLock lock(mutex);
+        Ptr<hal::DFT2D>& c = contexts[(isContinuous ? 1 : 0) + (isInplace ? 2 : 0)];
+        if( !c )
+            c = hal::DFT2D::create(size.width, size.height, CV_MAT_DEPTH(type), CV_MAT_CN(type),
+                                   CV_MAT_CN(dstType), getDftHalFlags(flags, isContinuous, isInplace), nonzeroRows);
+        return c;
+    }
+
+    Size size;
+    int type;
+    int dstType;
+    int flags;
+    int nonzeroRows;
+    mutable Mutex mutex;
+    mutable Ptr<hal::DFT2D> contexts[4];
+};
+
+Ptr<DFTPlan> DFTPlan::create(Size size, int type, int flags, int nonzeroRows)
+{
+    return makePtr<DFTPlanImpl>(size, type, flags, nonzeroRows);
+}
+
+}
+
 #ifdef HAVE_OPENCL
 
 namespace cv {
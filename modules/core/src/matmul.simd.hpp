@@ -43,9 +43,6 @@
 
 #include "precomp.hpp"
 
-#ifdef HAVE_LAPACK
-#define CV_GEMM_BASELINE_ONLY
-#endif
 #define CV_MAHALANOBIS_BASELINE_ONLY
 #define CV_MULTRANSPOSED_BASELINE_ONLY
 
@@ -96,7 +93,6 @@ double dotProd_64f(const double* src1, const double* src2, int len);
 
 #ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
 
-#if !defined(CV_GEMM_BASELINE_ONLY) || defined(CV_CPU_BASELINE_MODE)
 /****************************************************************************************\
 *                                         GEMM                                           *
 \****************************************************************************************/
@@ -741,6 +737,223 @@ static void GEMMStore_64fc( const Complexd* c_data, size_t c_step,
     GEMMStore(c_data, c_step, d_buf, d_buf_step, d_data, d_step, d_size, alpha, beta, flags);
 }
 
+#if CV_SIMD
+
+/* Cache-blocked GEMM for the real types.
+
+   D is split into GEMM_BLOCK_M x GEMM_BLOCK_N tiles that are computed in parallel. For every
+   GEMM_BLOCK_K slice of the inner dimension, a tile packs op(A) into panels of GEMM_MR rows and
+   op(B) into panels of GEMM_NR columns, both laid out in the order the microkernel reads them,
+   so the transposition flags only affect the packing. The microkernel keeps a GEMM_MR x GEMM_NR
+   block of sums in vector registers. Every element of D is computed by a single tile in a fixed
+   order, so the result does not depend on the number of threads. As in the unblocked path, the
+   32F products are summed in double: the microkernel sums at most GEMM_BLOCK_K of them in float,
+   and these partial sums are accumulated in double, so the error does not grow with K. */
+
+static inline v_float32 v_gemm_setall(float v) { return vx_setall_f32(v); }
+#if CV_SIMD_64F
+static inline v_float64 v_gemm_setall(double v) { return vx_setall_f64(v); }
+#endif
+
+enum { GEMM_MR = 4, GEMM_BLOCK_M = 64, GEMM_BLOCK_K = 256 };
+
+template<typename T> struct GEMMBlockedTraits
+{
+    typedef decltype(vx_load((const T*)0)) VT;
+    typedef double WT;
+    enum { NR = VT::nlanes*2, BLOCK_N = NR*(CV_SIMD_WIDTH >= 32 ? 16 : 32) };
+};
+
+// packs the mc x kc block of op(A) whose element (i, k) is at a + i*step0 + k*step1
+template<typename T> static void
+GEMMPackA( const uchar* a, size_t step0, size_t step1, int mc, int kc, T* dst )
+{
+    for( int i = 0; i < mc; i += GEMM_MR, dst += GEMM_MR*kc )
+    {
+        int mr = std::min((int)GEMM_MR, mc - i);
+        for( int k = 0; k < kc; k++ )
+        {
+            const uchar* src = a + i*step0 + k*step1;
+            int r = 0;
+            for( ; r < mr; r++ )
+                dst[k*GEMM_MR + r] = *(const T*)(src + r*step0);
+            for( ; r < GEMM_MR; r++ )
+                dst[k*GEMM_MR + r] = 0;
+        }
+    }
+}
+
+// packs the kc x nc block of op(B) whose element (k, j) is at b + k*step0 + j*step1
+template<typename T> static void
+GEMMPackB( const uchar* b, size_t step0, size_t step1, int kc, int nc, T* dst )
+{
+    const int NR = GEMMBlockedTraits<T>::NR;
+    for( int j = 0; j < nc; j += NR, dst += NR*kc )
+    {
+        int nr = std::min(NR, nc - j);
+        for( int k = 0; k < kc; k++ )
+        {
+            const uchar* src = b + k*step0 + j*step1;
+            T* d = dst + k*NR;
+            int c = 0;
+            if( step1 == sizeof(T) )
+                for( ; c < nr; c++ )
+                    d[c] = ((const T*)src)[c];
+            else
+                for( ; c < nr; c++ )
+                    d[c] = *(const T*)(src + c*step1);
+            for( ; c < NR; c++ )
+                d[c] = 0;
+        }
+    }
+}
+
+// adds the product of a packed GEMM_MR x kc panel and a packed kc x NR panel to the block at c
+template<typename T> static void
+GEMMMicroKernel( int kc, const T* a, const T* b, T* c, size_t ldc )
+{
+    typedef typename GEMMBlockedTraits<T>::VT VT;
+    const int NL = VT::nlanes;
+
+    VT c00 = vx_load(c), c01 = vx_load(c + NL);
+    VT c10 = vx_load(c + ldc), c11 = vx_load(c + ldc + NL);
+    VT c20 = vx_load(c + ldc*2), c21 = vx_load(c + ldc*2 + NL);
+    VT c30 = vx_load(c + ldc*3), c31 = vx_load(c + ldc*3 + NL);
+
+    for( int k = 0; k < kc; k++, a += GEMM_MR, b += NL*2 )
+    {
+        VT b0 = vx_load(b), b1 = vx_load(b + NL);
+        VT a0 = v_gemm_setall(a[0]);
+        c00 = v_fma(a0, b0, c00); c01 = v_fma(a0, b1, c01);
+        a0 = v_gemm_setall(a[1]);
+        c10 = v_fma(a0, b0, c10); c11 = v_fma(a0, b1, c11);
+        a0 = v_gemm_setall(a[2]);
+        c20 = v_fma(a0, b0, c20); c21 = v_fma(a0, b1, c21);
+        a0 = v_gemm_setall(a[3]);
+        c30 = v_fma(a0, b0, c30); c31 = v_fma(a0, b1, c31);
+    }
+
+    v_store(c, c00); v_store(c + NL, c01);
+    v_store(c + ldc, c10); v_store(c + ldc + NL, c11);
+    v_store(c + ldc*2, c20); v_store(c + ldc*2 + NL, c21);
+    v_store(c + ldc*3, c30); v_store(c + ldc*3 + NL, c31);
+}
+
+template<typename T> class GEMMBlockedInvoker : public ParallelLoopBody
+{
+public:
+    GEMMBlockedInvoker( const Mat& A, const Mat& B, const Mat& C, Mat& D, double alpha, double beta,
+                        int len, int flags )
+        : A_(&A), B_(&B), C_(&C), D_(&D), alpha_(alpha), beta_(beta), len_(len), flags_(flags)
+    {
+        tilesN_ = (D.cols + GEMMBlockedTraits<T>::BLOCK_N - 1)/GEMMBlockedTraits<T>::BLOCK_N;
+    }
+
+    int getTileCount() const
+    {
+        return (D_->rows + GEMM_BLOCK_M - 1)/GEMM_BLOCK_M*tilesN_;
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        const int NR = GEMMBlockedTraits<T>::NR, BLOCK_N = GEMMBlockedTraits<T>::BLOCK_N;
+        const size_t esz = sizeof(T);
+        const Mat& A = *A_;
+        const Mat& B = *B_;
+        const Mat& C = *C_;
+        Mat& D = *D_;
+
+        size_t a_step0 = A.step, a_step1 = esz, b_step0 = B.step, b_step1 = esz;
+        if( flags_ & GEMM_1_T )
+            std::swap(a_step0, a_step1);
+        if( flags_ & GEMM_2_T )
+            std::swap(b_step0, b_step1);
+
+        int kc0 = std::min((int)GEMM_BLOCK_K, len_);
+        size_t ldd = BLOCK_N;
+        // the partial sums of T are accumulated in wbuf when T is narrower than WT
+        typedef typename GEMMBlockedTraits<T>::WT WT;
+        const bool wide = sizeof(T) < sizeof(WT);
+        AutoBuffer<T> _abuf((size_t)GEMM_BLOCK_M*kc0), _bbuf((size_t)kc0*BLOCK_N), _dbuf(GEMM_BLOCK_M*ldd);
+        AutoBuffer<WT> _wbuf(wide ? GEMM_BLOCK_M*ldd : 1);
+        T *abuf = _abuf.data(), *bbuf = _bbuf.data(), *dbuf = _dbuf.data();
+        WT* wbuf = _wbuf.data();
+
+        for( int t = range.start; t < range.end; t++ )
+        {
+            int i0 = (t / tilesN_)*GEMM_BLOCK_M, j0 = (t % tilesN_)*BLOCK_N;
+            int mc = std::min((int)GEMM_BLOCK_M, D.rows - i0), nc = std::min(BLOCK_N, D.cols - j0);
+
+            if( wide )
+                std::fill(wbuf, wbuf + GEMM_BLOCK_M*ldd, WT(0));
+            for( int k0 = 0; k0 < len_; k0 += kc0 )
+            {
+                int kc = std::min(kc0, len_ - k0);
+                if( wide || k0 == 0 )
+                    std::fill(dbuf, dbuf + GEMM_BLOCK_M*ldd, T(0));
+                GEMMPackA(A.ptr() + i0*a_step0 + k0*a_step1, a_step0, a_step1, mc, kc, abuf);
+                GEMMPackB(B.ptr() + k0*b_step0 + j0*b_step1, b_step0, b_step1, kc, nc, bbuf);
+
+                for( int j = 0; j < nc; j += NR )
+                    for( int i = 0; i < mc; i += GEMM_MR )
+                        GEMMMicroKernel(kc, abuf + i*kc, bbuf + j*kc, dbuf + i*ldd + j, ldd);
+
+                if( wide )
+                    for( int i = 0; i < mc; i++ )
+                        for( int j = 0; j < nc; j++ )
+                            wbuf[i*ldd + j] += dbuf[i*ldd + j];
+            }
+
+            for( int i = 0; i < mc; i++ )
+            {
+                T* d = D.ptr<T>(i0 + i) + j0;
+                if( wide )
+                    storeRow(wbuf + i*ldd, d, C, i0 + i, j0, nc);
+                else
+                    storeRow(dbuf + i*ldd, d, C, i0 + i, j0, nc);
+            }
+        }
+    }
+
+private:
+    // d = s*alpha + op(C)*beta for the row i of D, starting from the column j0
+    template<typename ST> void storeRow( const ST* s, T* d, const Mat& C, int i, int j0, int nc ) const
+    {
+        if( C.empty() )
+            for( int j = 0; j < nc; j++ )
+                d[j] = (T)(s[j]*alpha_);
+        else if( !(flags_ & GEMM_3_T) )
+        {
+            const T* c = C.ptr<T>(i) + j0;
+            for( int j = 0; j < nc; j++ )
+                d[j] = (T)(s[j]*alpha_ + c[j]*beta_);
+        }
+        else
+        {
+            for( int j = 0; j < nc; j++ )
+                d[j] = (T)(s[j]*alpha_ + C.at<T>(j0 + j, i)*beta_);
+        }
+    }
+
+    const Mat* A_;
+    const Mat* B_;
+    const Mat* C_;
+    Mat* D_;
+    double alpha_, beta_;
+    int len_;
+    int flags_;
+    int tilesN_;
+};
+
+template<typename T> static void
+gemmBlocked( const Mat& A, const Mat& B, double alpha, const Mat& C, double beta, Mat& D, int len, int flags )
+{
+    GEMMBlockedInvoker<T> invoker(A, B, C, D, alpha, beta, len, flags);
+    parallel_for_(Range(0, invoker.getTileCount()), invoker);
+}
+
+#endif // CV_SIMD
+
 static void gemmImpl( Mat A, Mat B, double alpha,
            Mat C, double beta, Mat D, int flags )
 {
@@ -1069,6 +1282,25 @@ static void gemmImpl( Mat A, Mat B, double alpha,
         storeFunc = (GEMMStoreFunc)GEMMStore_64fc;
     }
 
+#if CV_SIMD
+    if( d_size.width >= 16 && d_size.height >= GEMM_MR && len >= 16 &&
+        (double)d_size.width*d_size.height*len >= 65536 )
+    {
+        if( type == CV_32FC1 )
+        {
+            gemmBlocked<float>(A, B, alpha, C, beta, D, len, flags);
+            return;
+        }
+#if CV_SIMD_64F
+        if( type == CV_64FC1 )
+        {
+            gemmBlocked<double>(A, B, alpha, C, beta, D, len, flags);
+            return;
+        }
+#endif
+    }
+#endif
+
     if( (d_size.width == 1 || len == 1) && !(flags & GEMM_2_T) && B.isContinuous() )
     {
         b_step = d_size.width == 1 ? 0 : CV_ELEM_SIZE(type);
@@ -1382,7 +1614,6 @@ void gemm64fc(const double* src1, size_t src1_step, const double* src2, size_t s
     callGemmImpl(src1, src1_step, src2, src2_step, alpha, src3, src3_step, beta, dst, dst_step, m_a, n_a, n_d, flags, CV_64FC2);
 }
 
-#endif // !defined(CV_GEMM_BASELINE_ONLY) || defined(CV_CPU_BASELINE_MODE)
 
 
 
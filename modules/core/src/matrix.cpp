@@ -4,6 +4,9 @@
 
 #include "precomp.hpp"
 #include "bufferpool.impl.hpp"
+#include "opencv2/core/utils/tls.hpp"
+
+#include <atomic>
 
 namespace cv {
 
@@ -179,10 +182,45 @@ public:
 namespace
 {
     MatAllocator* volatile g_matAllocator = NULL;
+
+    struct ScopedMatAllocator
+    {
+        ScopedMatAllocator() : allocator(NULL) {}
+        MatAllocator* allocator;
+    };
+
+    // the number of the existing MatAllocatorScope objects; without them the TLS lookup is skipped
+    std::atomic<int> g_matAllocatorScopes(0);
+
+    TLSData<ScopedMatAllocator>& getScopedMatAllocatorTLS()
+    {
+        CV_SINGLETON_LAZY_INIT_REF(TLSData<ScopedMatAllocator>, new TLSData<ScopedMatAllocator>())
+    }
+}
+
+MatAllocatorScope::MatAllocatorScope(MatAllocator* allocator)
+{
+    CV_Assert(allocator);
+    ScopedMatAllocator& scoped = getScopedMatAllocatorTLS().getRef();
+    prev = scoped.allocator;
+    scoped.allocator = allocator;
+    g_matAllocatorScopes++;
+}
+
+MatAllocatorScope::~MatAllocatorScope()
+{
+    getScopedMatAllocatorTLS().getRef().allocator = prev;
+    g_matAllocatorScopes--;
 }
 
 MatAllocator* Mat::getDefaultAllocator()
 {
+    if (g_matAllocatorScopes.load(std::memory_order_relaxed) > 0)
+    {
+        MatAllocator* scoped = getScopedMatAllocatorTLS().getRef().allocator;
+        if (scoped)
+            return scoped;
+    }
     if (g_matAllocator == NULL)
     {
         cv::AutoLock lock(cv::getInitializationMutex());
@@ -1361,4 +1399,35 @@ Size getContinuousSize2D(Mat& m1, Mat& m2, Mat& m3, int widthScale)
                               m1.cols, m1.rows, widthScale);
 }
 
+void parallelForElemwise(Size sz, size_t bytesPerElem, const std::function<void(const Rect&)>& body)
+{
+    double bytes = (double)sz.width*sz.height*bytesPerElem;
+    double nstripes = bytes/ELEMWISE_STRIPE_BYTES;
+
+    if( bytes < ELEMWISE_PARALLEL_MIN_BYTES || nstripes < 2 )
+    {
+        body(Rect(Point(), sz));
+        return;
+    }
+
+    if( sz.height > 1 )
+    {
+        parallel_for_(Range(0, sz.height), [&](const Range& r)
+        {
+            body(Rect(0, r.start, sz.width, r.size()));
+        }, nstripes);
+    }
+    else
+    {
+        // a continuous array is cut into chunks that keep the vector loops of the kernels busy
+        int nchunks = (sz.width + ELEMWISE_CHUNK - 1)/ELEMWISE_CHUNK;
+        parallel_for_(Range(0, nchunks), [&](const Range& r)
+        {
+            int x0 = (int)((int64)r.start*ELEMWISE_CHUNK);
+            int x1 = (int)std::min((int64)r.end*ELEMWISE_CHUNK, (int64)sz.width);
+            body(Rect(x0, 0, x1 - x0, 1));
+        }, nstripes);
+    }
+}
+
 } // cv::
@@ -11,6 +11,10 @@
 
 #include "precomp.hpp"
 #include <opencv2/core/utils/logger.hpp>
+#include "matrix_expressions.hpp"
+
+#include "matrix_expressions.simd.hpp"
+#include "matrix_expressions.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
 
 namespace cv
 {
@@ -103,6 +107,70 @@ public:
 
 static MatOp_Cmp g_MatOp_Cmp;
 
+// A chain of elementwise operations evaluated in a single pass, see MatExprGraph
+class MatOp_Fused CV_FINAL : public MatOp
+{
+public:
+    MatOp_Fused() {}
+    virtual ~MatOp_Fused() {}
+
+    bool elementWise(const MatExpr& /*expr*/) const CV_OVERRIDE { return true; }
+    void assign(const MatExpr& expr, Mat& m, int type=-1) const CV_OVERRIDE;
+
+    void roi(const MatExpr& expr, const Range& rowRange, const Range& colRange, MatExpr& res) const CV_OVERRIDE;
+    void diag(const MatExpr& expr, int d, MatExpr& res) const CV_OVERRIDE;
+
+    Size size(const MatExpr& expr) const CV_OVERRIDE;
+    int type(const MatExpr& expr) const CV_OVERRIDE;
+
+    // The functions below return false, leaving res untouched, when the operands cannot be fused.
+    // They combine the operands in the same way as the corresponding MatOp methods do.
+    static bool makeAddExpr(MatExpr& res, const MatExpr& e1, const MatExpr& e2, double sign);
+    static bool makeMulExpr(MatExpr& res, const MatExpr& e1, const MatExpr& e2, double scale);
+    static bool makeDivExpr(MatExpr& res, const MatExpr& e1, const MatExpr& e2, double scale);
+    static bool makeExpr(MatExpr& res, int op, const MatExpr& e, double alpha, double beta, const Scalar& s);
+
+    // The graph is kept in the buffer of MatExpr::c. The buffer is allocated by graphAllocator,
+    // so the copies of an expression share its graph and the last of them destroys it.
+    static MatExprGraph* createGraph(Mat& holder);
+    static const MatExprGraph& graph(const MatExpr& expr) { return *(const MatExprGraph*)expr.c.data; }
+
+    class GraphAllocator CV_FINAL : public MatAllocator
+    {
+    public:
+        UMatData* allocate(int dims, const int* sizes, int type,
+                           void* data0, size_t* step, AccessFlag /*flags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+        {
+            CV_Assert( dims == 2 && sizes[0] == 1 && sizes[1] == (int)sizeof(MatExprGraph) && type == CV_8U && !data0 );
+            step[0] = sizeof(MatExprGraph);
+            step[1] = 1;
+            UMatData* u = new UMatData(this);
+            u->data = u->origdata = (uchar*)new MatExprGraph;
+            u->size = sizeof(MatExprGraph);
+            return u;
+        }
+
+        bool allocate(UMatData* u, AccessFlag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+        {
+            return u != 0;
+        }
+
+        void deallocate(UMatData* u) const CV_OVERRIDE
+        {
+            if( !u )
+                return;
+
+            CV_Assert( u->urefcount == 0 && u->refcount == 0 );
+            delete (MatExprGraph*)u->origdata;
+            delete u;
+        }
+    };
+
+    GraphAllocator graphAllocator;
+};
+
+static MatOp_Fused g_MatOp_Fused;
+
 class MatOp_GEMM CV_FINAL : public MatOp
 {
 public:
@@ -205,6 +273,7 @@ static inline bool isAddEx(const MatExpr& e) { return e.op == &g_MatOp_AddEx; }
 static inline bool isScaled(const MatExpr& e) { return isAddEx(e) && (!e.b.data || e.beta == 0) && e.s == Scalar(); }
 static inline bool isBin(const MatExpr& e, char c) { return e.op == &g_MatOp_Bin && e.flags == c; }
 static inline bool isCmp(const MatExpr& e) { return e.op == &g_MatOp_Cmp; }
+static inline bool isFused(const MatExpr& e) { return e.op == &g_MatOp_Fused; }
 static inline bool isReciprocal(const MatExpr& e) { return isBin(e,'/') && (!e.b.data || e.beta == 0); }
 static inline bool isT(const MatExpr& e) { return e.op == &g_MatOp_T; }
 static inline bool isInv(const MatExpr& e) { return e.op == &g_MatOp_Invert; }
@@ -329,6 +398,9 @@ void MatOp::add(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 
     if( this == e2.op )
     {
+        if( MatOp_Fused::makeAddExpr(res, e1, e2, 1) )
+            return;
+
         double alpha = 1, beta = 1;
         Scalar s;
         Mat m1, m2;
@@ -360,6 +432,9 @@ void MatOp::add(const MatExpr& expr1, const Scalar& s, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( !isIdentity(expr1) && MatOp_Fused::makeExpr(res, MatExprGraph::ADDW, expr1, 1, 0, s) )
+        return;
+
     Mat m1;
     expr1.op->assign(expr1, m1);
     MatOp_AddEx::makeExpr(res, m1, Mat(), 1, 0, s);
@@ -372,6 +447,9 @@ void MatOp::subtract(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 
     if( this == e2.op )
     {
+        if( MatOp_Fused::makeAddExpr(res, e1, e2, -1) )
+            return;
+
         double alpha = 1, beta = -1;
         Scalar s;
         Mat m1, m2;
@@ -403,6 +481,9 @@ void MatOp::subtract(const Scalar& s, const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( !isIdentity(expr) && MatOp_Fused::makeExpr(res, MatExprGraph::ADDW, expr, -1, 0, s) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_AddEx::makeExpr(res, m, Mat(), -1, 0, s);
@@ -415,6 +496,9 @@ void MatOp::multiply(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double
 
     if( this == e2.op )
     {
+        if( MatOp_Fused::makeMulExpr(res, e1, e2, scale) )
+            return;
+
         Mat m1, m2;
 
         if( isReciprocal(e1) )
@@ -466,6 +550,9 @@ void MatOp::multiply(const MatExpr& expr, double s, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( !isIdentity(expr) && MatOp_Fused::makeExpr(res, MatExprGraph::ADDW, expr, s, 0, Scalar()) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_AddEx::makeExpr(res, m, Mat(), s, 0);
@@ -480,7 +567,7 @@ void MatOp::divide(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double sc
     {
         if( isReciprocal(e1) && isReciprocal(e2) )
             MatOp_Bin::makeExpr(res, '/', e2.a, e1.a, e1.alpha/e2.alpha);
-        else
+        else if( !MatOp_Fused::makeDivExpr(res, e1, e2, scale) )
         {
             Mat m1, m2;
             char op = '/';
@@ -518,6 +605,9 @@ void MatOp::divide(double s, const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( !isIdentity(expr) && MatOp_Fused::makeExpr(res, MatExprGraph::RECIP, expr, s, 0, Scalar()) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_Bin::makeExpr(res, '/', m, Mat(), s);
@@ -528,6 +618,9 @@ void MatOp::abs(const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( !isIdentity(expr) && MatOp_Fused::makeExpr(res, MatExprGraph::ABSDIFF, expr, 1, 0, Scalar()) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_Bin::makeExpr(res, 'a', m, Mat());
@@ -1522,6 +1615,392 @@ inline void MatOp_Cmp::makeExpr(MatExpr& res, int cmpop, const Mat& a, double al
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// the arithmetic functions round the scalar they apply to an integer array to an integer,
+// the result is saturated to the array depth afterwards
+static Scalar roundScalar(const Scalar& s, int depth)
+{
+    if( depth > CV_32S )
+        return s;
+    Scalar r;
+    for( int i = 0; i < 4; i++ )
+        r[i] = saturate_cast<int>(s[i]);
+    return r;
+}
+
+static int addFusedNode(MatExprGraph& g, int op, int depth, int src0, int src1,
+                        double alpha=1, double beta=0, const Scalar& s=Scalar(), int cmpop=0)
+{
+    if( (int)g.nodes.size() >= MatExprGraph::MAX_NODES )
+        return -1;
+    MatExprGraph::Node n;
+    n.op = op;
+    n.depth = depth;
+    n.src0 = src0;
+    n.src1 = src1;
+    n.input = -1;
+    n.cmpop = cmpop;
+    n.alpha = alpha;
+    n.beta = beta;
+    n.s = s;
+    g.nodes.push_back(n);
+    return (int)g.nodes.size() - 1;
+}
+
+// all the inputs of a graph have the same size and number of channels
+static int addFusedInput(MatExprGraph& g, const Mat& m)
+{
+    int cn = m.channels();
+    if( m.empty() || m.dims > 2 || m.depth() == CV_16F || cn > MatExprGraph::MAX_CHANNELS )
+        return -1;
+    if( !g.inputs.empty() && (m.size() != g.inputs[0].size() || cn != g.inputs[0].channels()) )
+        return -1;
+    for( size_t k = 0; k < g.nodes.size(); k++ )
+    {
+        const MatExprGraph::Node& n = g.nodes[k];
+        if( n.op == MatExprGraph::LOAD )
+        {
+            const Mat& in = g.inputs[n.input];
+            if( in.data == m.data && in.step[0] == m.step[0] && in.type() == m.type() )
+                return (int)k;
+        }
+    }
+    int k = addFusedNode(g, MatExprGraph::LOAD, m.depth(), -1, -1);
+    if( k >= 0 )
+    {
+        g.nodes[k].input = (int)g.inputs.size();
+        g.inputs.push_back(m);
+    }
+    return k;
+}
+
+// x*alpha + y*beta + s evaluated as MatOp_AddEx::assign does it; y is -1 when there is no second array
+static int lowerFusedAddEx(MatExprGraph& g, int x, int y, double alpha, double beta, const Scalar& s)
+{
+    int depth = g.nodes[x].depth;
+    if( y >= 0 )
+    {
+        if( g.nodes[y].depth != depth )
+            return -1;
+        if( s.isReal() && s != Scalar() )
+            return addFusedNode(g, MatExprGraph::ADDW, depth, x, y, alpha, beta, Scalar::all(s[0]));
+        int r = addFusedNode(g, MatExprGraph::ADDW, depth, x, y, alpha, beta);
+        if( r >= 0 && !s.isReal() )
+            r = addFusedNode(g, MatExprGraph::ADDW, depth, r, -1, 1, 0, roundScalar(s, depth));
+        return r;
+    }
+    if( s.isReal() && fabs(alpha) != 1 )
+        return addFusedNode(g, MatExprGraph::ADDW, depth, x, -1, alpha, 0, Scalar::all(s[0]));
+    if( fabs(alpha) == 1 )
+        return addFusedNode(g, MatExprGraph::ADDW, depth, x, -1, alpha, 0, roundScalar(s, depth));
+    int r = addFusedNode(g, MatExprGraph::ADDW, depth, x, -1, alpha, 0);
+    return r >= 0 ? addFusedNode(g, MatExprGraph::ADDW, depth, r, -1, 1, 0, roundScalar(s, depth)) : -1;
+}
+
+// appends the operations of the expression to the graph, returns the index of its result node or -1
+static int lowerFusedExpr(MatExprGraph& g, const MatExpr& e)
+{
+    if( isIdentity(e) )
+        return addFusedInput(g, e.a);
+
+    if( isFused(e) )
+    {
+        const MatExprGraph& src = MatOp_Fused::graph(e);
+        std::vector<int> idx(src.nodes.size());
+        for( size_t k = 0; k < src.nodes.size(); k++ )
+        {
+            const MatExprGraph::Node& n = src.nodes[k];
+            if( n.op == MatExprGraph::LOAD )
+                idx[k] = addFusedInput(g, src.inputs[n.input]);
+            else
+                idx[k] = addFusedNode(g, n.op, n.depth, idx[n.src0], n.src1 >= 0 ? idx[n.src1] : -1,
+                                      n.alpha, n.beta, n.s, n.cmpop);
+            if( idx[k] < 0 )
+                return -1;
+        }
+        return idx.back();
+    }
+
+    if( !isAddEx(e) && !isCmp(e) && e.op != &g_MatOp_Bin )
+        return -1;
+
+    int x = addFusedInput(g, e.a), y = -1;
+    if( x < 0 || (e.b.data && (y = addFusedInput(g, e.b)) < 0) )
+        return -1;
+    int depth = g.nodes[x].depth;
+
+    if( isAddEx(e) )
+        return lowerFusedAddEx(g, x, y, e.alpha, e.beta, e.s);
+
+    if( y >= 0 && g.nodes[y].depth != depth )
+        return -1;
+
+    if( isCmp(e) )
+        return addFusedNode(g, MatExprGraph::CMP, CV_8U, x, y, 1, 0, Scalar::all(e.alpha), e.flags);
+
+    switch( e.flags )
+    {
+    case '*':
+        return y >= 0 ? addFusedNode(g, MatExprGraph::MUL, depth, x, y, e.alpha) : -1;
+    case '/':
+        return y >= 0 ? addFusedNode(g, MatExprGraph::DIV, depth, x, y, e.alpha) :
+                        addFusedNode(g, MatExprGraph::RECIP, depth, x, -1, e.alpha);
+    case 'm':
+    case 'M':
+        return y >= 0 ? addFusedNode(g, e.flags == 'm' ? MatExprGraph::MIN : MatExprGraph::MAX, depth, x, y) : -1;
+    case 'n':
+    case 'N':
+        // cv::min() and cv::max() with a number are fused for single-channel arrays only
+        if( g.inputs[0].channels() > 1 )
+            return -1;
+        return addFusedNode(g, e.flags == 'n' ? MatExprGraph::MIN : MatExprGraph::MAX, depth, x, -1,
+                            1, 0, roundScalar(Scalar::all(e.s[0]), depth));
+    case 'a':
+        return addFusedNode(g, MatExprGraph::ABSDIFF, depth, x, y, 1, 0,
+                            y >= 0 ? Scalar() : roundScalar(e.s, depth));
+    default:
+        // the bitwise operations are not fused
+        return -1;
+    }
+}
+
+MatExprGraph* MatOp_Fused::createGraph(Mat& holder)
+{
+    holder.release();
+    holder.allocator = &g_MatOp_Fused.graphAllocator;
+    holder.create(1, (int)sizeof(MatExprGraph), CV_8U);
+    CV_Assert( holder.u->currAllocator == &g_MatOp_Fused.graphAllocator );
+    return (MatExprGraph*)holder.data;
+}
+
+static void makeFusedExpr(MatExpr& res, const Mat& holder)
+{
+    res = MatExpr(&g_MatOp_Fused, 0, Mat(), Mat(), holder);
+}
+
+static void runFusedExpr(const MatExprGraph& g, Mat& dst, const Rect& r, bool wide)
+{
+    CV_CPU_DISPATCH(runFusedExpr, (g, dst, r, wide),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+void MatOp_Fused::assign(const MatExpr& e, Mat& m, int _type) const
+{
+    CV_INSTRUMENT_REGION();
+
+    // the graph keeps the inputs alive when m is one of them and gets reallocated
+    Mat holder = e.c;
+    const MatExprGraph* g = &graph(e);
+    int cn = g->inputs[0].channels();
+    if( _type == -1 )
+        _type = type(e);
+    CV_Assert( CV_MAT_CN(_type) == cn );
+    m.create(g->inputs[0].size(), _type);
+
+    // the operations are computed in float unless there are 32-bit integers or doubles
+    bool wide = false, continuous = m.isContinuous();
+    size_t bytesPerElem = m.elemSize1();
+    for( size_t k = 0; k < g->nodes.size(); k++ )
+        wide |= g->nodes[k].depth == CV_32S || g->nodes[k].depth == CV_64F;
+    for( size_t i = 0; i < g->inputs.size(); i++ )
+    {
+        continuous &= g->inputs[i].isContinuous();
+        bytesPerElem += g->inputs[i].elemSize1();
+    }
+
+    Size sz = continuous ? Size((int)m.total()*cn, 1) : Size(m.cols*cn, m.rows);
+    parallelForElemwise(sz, bytesPerElem, [&](const Rect& r)
+    {
+        runFusedExpr(*g, m, r, wide);
+    });
+}
+
+void MatOp_Fused::roi(const MatExpr& e, const Range& rowRange, const Range& colRange, MatExpr& res) const
+{
+    Mat holder;
+    MatExprGraph* g = createGraph(holder);
+    *g = graph(e);
+    for( size_t i = 0; i < g->inputs.size(); i++ )
+        g->inputs[i] = g->inputs[i](rowRange, colRange);
+    makeFusedExpr(res, holder);
+}
+
+void MatOp_Fused::diag(const MatExpr& e, int d, MatExpr& res) const
+{
+    Mat holder;
+    MatExprGraph* g = createGraph(holder);
+    *g = graph(e);
+    for( size_t i = 0; i < g->inputs.size(); i++ )
+        g->inputs[i] = g->inputs[i].diag(d);
+    makeFusedExpr(res, holder);
+}
+
+Size MatOp_Fused::size(const MatExpr& e) const
+{
+    return graph(e).inputs[0].size();
+}
+
+int MatOp_Fused::type(const MatExpr& e) const
+{
+    const MatExprGraph& g = graph(e);
+    return CV_MAKETYPE(g.nodes.back().depth, g.inputs[0].channels());
+}
+
+bool MatOp_Fused::makeAddExpr(MatExpr& res, const MatExpr& e1, const MatExpr& e2, double sign)
+{
+    // the scaled arrays are combined by MatOp_AddEx without temporary arrays
+    bool scaled1 = isAddEx(e1) && (!e1.b.data || e1.beta == 0);
+    bool scaled2 = isAddEx(e2) && (!e2.b.data || e2.beta == 0);
+    if( (isIdentity(e1) || scaled1) && (isIdentity(e2) || scaled2) )
+        return false;
+
+    Mat holder;
+    MatExprGraph* g = createGraph(holder);
+    double alpha = 1, beta = sign;
+    Scalar s;
+    int x, y;
+    if( scaled1 )
+    {
+        x = addFusedInput(*g, e1.a);
+        alpha = e1.alpha;
+        s = e1.s;
+    }
+    else
+        x = lowerFusedExpr(*g, e1);
+    if( x < 0 )
+        return false;
+
+    if( scaled2 )
+    {
+        y = addFusedInput(*g, e2.a);
+        beta = sign*e2.alpha;
+        s += e2.s*sign;
+    }
+    else
+        y = lowerFusedExpr(*g, e2);
+    if( y < 0 || lowerFusedAddEx(*g, x, y, alpha, beta, s) < 0 )
+        return false;
+
+    makeFusedExpr(res, holder);
+    return true;
+}
+
+bool MatOp_Fused::makeMulExpr(MatExpr& res, const MatExpr& e1, const MatExpr& e2, double scale)
+{
+    bool direct2 = isIdentity(e2) || isScaled(e2);
+    if( (isReciprocal(e1) && direct2) || ((isIdentity(e1) || isScaled(e1)) && (direct2 || isReciprocal(e2))) )
+        return false;
+
+    Mat holder;
+    MatExprGraph* g = createGraph(holder);
+    int x, y, op = MatExprGraph::MUL;
+    if( isReciprocal(e1) )
+    {
+        if( isScaled(e2) )
+        {
+            scale *= e2.alpha;
+            x = addFusedInput(*g, e2.a);
+        }
+        else
+            x = lowerFusedExpr(*g, e2);
+        y = x >= 0 ? addFusedInput(*g, e1.a) : -1;
+        scale /= e1.alpha;
+        op = MatExprGraph::DIV;
+    }
+    else
+    {
+        if( isScaled(e1) )
+        {
+            x = addFusedInput(*g, e1.a);
+            scale *= e1.alpha;
+        }
+        else
+            x = lowerFusedExpr(*g, e1);
+        if( x < 0 )
+            return false;
+
+        if( isScaled(e2) )
+        {
+            y = addFusedInput(*g, e2.a);
+            scale *= e2.alpha;
+        }
+        else if( isReciprocal(e2) )
+        {
+            op = MatExprGraph::DIV;
+            y = addFusedInput(*g, e2.a);
+            scale *= e2.alpha;
+        }
+        else
+            y = lowerFusedExpr(*g, e2);
+    }
+
+    if( x < 0 || y < 0 || g->nodes[x].depth != g->nodes[y].depth ||
+        addFusedNode(*g, op, g->nodes[x].depth, x, y, scale) < 0 )
+        return false;
+
+    makeFusedExpr(res, holder);
+    return true;
+}
+
+bool MatOp_Fused::makeDivExpr(MatExpr& res, const MatExpr& e1, const MatExpr& e2, double scale)
+{
+    if( (isIdentity(e1) || isScaled(e1)) && (isIdentity(e2) || isScaled(e2) || isReciprocal(e2)) )
+        return false;
+
+    Mat holder;
+    MatExprGraph* g = createGraph(holder);
+    int x, y, op = MatExprGraph::DIV;
+    if( isScaled(e1) )
+    {
+        x = addFusedInput(*g, e1.a);
+        scale *= e1.alpha;
+    }
+    else
+        x = lowerFusedExpr(*g, e1);
+    if( x < 0 )
+        return false;
+
+    if( isScaled(e2) )
+    {
+        y = addFusedInput(*g, e2.a);
+        scale /= e2.alpha;
+    }
+    else if( isReciprocal(e2) )
+    {
+        y = addFusedInput(*g, e2.a);
+        scale /= e2.alpha;
+        op = MatExprGraph::MUL;
+    }
+    else
+        y = lowerFusedExpr(*g, e2);
+
+    if( y < 0 || g->nodes[x].depth != g->nodes[y].depth ||
+        addFusedNode(*g, op, g->nodes[x].depth, x, y, scale) < 0 )
+        return false;
+
+    makeFusedExpr(res, holder);
+    return true;
+}
+
+bool MatOp_Fused::makeExpr(MatExpr& res, int op, const MatExpr& e, double alpha, double beta, const Scalar& s)
+{
+    Mat holder;
+    MatExprGraph* g = createGraph(holder);
+    int x = lowerFusedExpr(*g, e);
+    if( x < 0 )
+        return false;
+
+    int depth = g->nodes[x].depth;
+    int r = op == MatExprGraph::ADDW ? lowerFusedAddEx(*g, x, -1, alpha, beta, s) :
+            addFusedNode(*g, op, depth, x, -1, alpha, beta, roundScalar(s, depth));
+    if( r < 0 )
+        return false;
+
+    makeFusedExpr(res, holder);
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void MatOp_T::assign(const MatExpr& e, Mat& m, int _type) const
 {
     Mat temp, &dst = _type == -1 || _type == e.a.type() ? m : temp;
@@ -0,0 +1,54 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+
+#ifndef SRC_MATRIX_EXPRESSIONS_HPP
+#define SRC_MATRIX_EXPRESSIONS_HPP
+
+#include "opencv2/core/mat.hpp"
+
+namespace cv {
+
+// The elementwise operations of a fused expression. The nodes are in the evaluation order, the last
+// one is the result; every node is computed for a block of elements in a small buffer that stays
+// in cache, so the intermediate arrays are never materialized. The nodes are computed in float, or in
+// double when there are 32-bit integers or doubles, and every result is saturated to the depth of
+// the node as the function the unfused expression would call does.
+class MatExprGraph
+{
+public:
+    enum
+    {
+        LOAD,    // an input array
+        ADDW,    // src0*alpha + src1*beta + s
+        MUL,     // alpha*src0*src1
+        DIV,     // src0*alpha/src1, 0 where an integer src1 is 0
+        RECIP,   // alpha/src0, 0 where an integer src0 is 0
+        MIN,
+        MAX,
+        ABSDIFF,
+        CMP      // 255 where "src0 cmpop src1" holds, 0 otherwise
+    };
+
+    enum { MAX_NODES = 32, MAX_CHANNELS = 4 };
+
+    struct Node
+    {
+        int op;
+        int depth;   // the depth the result is saturated to
+        int src0;
+        int src1;    // -1 when the second operand is the scalar s
+        int input;   // the index of the input array for LOAD
+        int cmpop;
+        double alpha, beta;
+        Scalar s;
+    };
+
+    std::vector<Mat> inputs;
+    std::vector<Node> nodes;
+};
+
+} // namespace cv
+
+#endif // SRC_MATRIX_EXPRESSIONS_HPP
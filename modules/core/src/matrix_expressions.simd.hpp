@@ -0,0 +1,364 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+
+#include "precomp.hpp"
+#include "matrix_expressions.hpp"
+
+namespace cv {
+
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// evaluates the rectangle of the fused expression, r is in the elements of all the channels
+void runFusedExpr(const MatExprGraph& g, Mat& dst, const Rect& r, bool wide);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+///////////////////////////// Operations //////////////////////////////////
+
+// Every operation is computed by r() for the scalars and by vr() for the vectors of the working type.
+// The operands are combined in the order of the vectorized loops of arithm.simd.hpp.
+
+static inline float fused_round(float a) { return (float)cvRound(a); }
+static inline double fused_round(double a) { return (double)cvRound(a); }
+#if CV_SIMD
+static inline v_float32 fused_round(const v_float32& a) { return v_cvt_f32(v_round(a)); }
+#endif
+#if CV_SIMD_64F
+static inline v_float64 fused_round(const v_float64& a) { return v_cvt_f64(v_round(a)); }
+#endif
+
+// a*alpha + b, b is the scalar operand
+struct op_fused_scale_add
+{
+    template<typename T> static inline T r(T a, T b, T, T alpha, T)
+    { return a*alpha + b; }
+    template<typename V> static inline V vr(const V& a, const V& b, const V&, const V& alpha, const V&)
+    { return a*alpha + b; }
+};
+
+// a*alpha + b*beta + c, c is the scalar operand
+struct op_fused_add_weighted
+{
+    template<typename T> static inline T r(T a, T b, T c, T alpha, T beta)
+    { return a*alpha + b*beta + c; }
+    template<typename V> static inline V vr(const V& a, const V& b, const V& c, const V& alpha, const V& beta)
+    { return a*alpha + b*beta + c; }
+};
+
+struct op_fused_mul
+{
+    template<typename T> static inline T r(T a, T b, T, T alpha, T)
+    { return alpha*a*b; }
+    template<typename V> static inline V vr(const V& a, const V& b, const V&, const V& alpha, const V&)
+    { return alpha*a*b; }
+};
+
+struct op_fused_div
+{
+    template<typename T> static inline T r(T a, T b, T, T alpha, T)
+    { return a*alpha/b; }
+    template<typename V> static inline V vr(const V& a, const V& b, const V&, const V& alpha, const V&)
+    { return a*alpha/b; }
+};
+
+// the integer division gives 0 where the denominator is 0
+struct op_fused_div_int
+{
+    template<typename T> static inline T r(T a, T b, T, T alpha, T)
+    { return b != 0 ? a*alpha/b : (T)0; }
+    template<typename V> static inline V vr(const V& a, const V& b, const V& zero, const V& alpha, const V&)
+    { return v_select(b == zero, zero, a*alpha/b); }
+};
+
+struct op_fused_recip
+{
+    template<typename T> static inline T r(T a, T, T, T alpha, T)
+    { return alpha/a; }
+    template<typename V> static inline V vr(const V& a, const V&, const V&, const V& alpha, const V&)
+    { return alpha/a; }
+};
+
+struct op_fused_recip_int
+{
+    template<typename T> static inline T r(T a, T, T, T alpha, T)
+    { return a != 0 ? alpha/a : (T)0; }
+    template<typename V> static inline V vr(const V& a, const V&, const V& zero, const V& alpha, const V&)
+    { return v_select(a == zero, zero, alpha/a); }
+};
+
+struct op_fused_min
+{
+    template<typename T> static inline T r(T a, T b, T, T, T)
+    { return std::min(a, b); }
+    template<typename V> static inline V vr(const V& a, const V& b, const V&, const V&, const V&)
+    { return v_min(a, b); }
+};
+
+struct op_fused_max
+{
+    template<typename T> static inline T r(T a, T b, T, T, T)
+    { return std::max(a, b); }
+    template<typename V> static inline V vr(const V& a, const V& b, const V&, const V&, const V&)
+    { return v_max(a, b); }
+};
+
+struct op_fused_absdiff
+{
+    template<typename T> static inline T r(T a, T b, T, T, T)
+    { return std::abs(a - b); }
+    template<typename V> static inline V vr(const V& a, const V& b, const V&, const V&, const V&)
+    { return v_absdiff(a, b); }
+};
+
+// 255 where the comparison holds, 0 otherwise
+template<int cmpop> struct op_fused_cmp
+{
+    template<typename T> static inline T r(T a, T b, T, T, T)
+    {
+        bool f = cmpop == CMP_EQ ? a == b : cmpop == CMP_GT ? a > b : cmpop == CMP_GE ? a >= b :
+                 cmpop == CMP_LT ? a < b : cmpop == CMP_LE ? a <= b : a != b;
+        return f ? (T)255 : (T)0;
+    }
+    template<typename V> static inline V vr(const V& a, const V& b, const V&, const V& v255, const V&)
+    {
+        V m = cmpop == CMP_EQ ? a == b : cmpop == CMP_GT ? a > b : cmpop == CMP_GE ? a >= b :
+              cmpop == CMP_LT ? a < b : cmpop == CMP_LE ? a <= b : a != b;
+        return m & v255;
+    }
+};
+
+// saturates an integer result that cannot be fractional: the value is clamped to [alpha, beta]
+struct op_fused_clamp
+{
+    template<typename T> static inline T r(T a, T, T, T alpha, T beta)
+    { return std::min(std::max(a, alpha), beta); }
+    template<typename V> static inline V vr(const V& a, const V&, const V&, const V& alpha, const V& beta)
+    { return v_min(v_max(a, alpha), beta); }
+};
+
+// saturates an integer result: the value is clamped and rounded to the nearest even integer
+struct op_fused_round
+{
+    template<typename T> static inline T r(T a, T, T, T alpha, T beta)
+    { return fused_round(std::min(std::max(a, alpha), beta)); }
+    template<typename V> static inline V vr(const V& a, const V&, const V&, const V& alpha, const V& beta)
+    { return fused_round(v_min(v_max(a, alpha), beta)); }
+};
+
+//////////////////////////// Loops /////////////////////////////////
+
+// the vectorized part of the loop, returns the number of the processed elements
+template<class Op, typename WT> static inline int
+fusedLoopSimd(WT*, const WT*, const WT*, const WT*, int, WT, WT)
+{
+    return 0;
+}
+
+#if CV_SIMD
+template<class Op> static inline int
+fusedLoopSimd(float* d, const float* a, const float* b, const float* c, int len, float alpha, float beta)
+{
+    const v_float32 v_alpha = vx_setall_f32(alpha), v_beta = vx_setall_f32(beta), v_zero = vx_setzero_f32();
+    int i = 0;
+    for( ; i <= len - v_float32::nlanes; i += v_float32::nlanes )
+        v_store(d + i, Op::vr(vx_load(a + i), vx_load(b + i), c ? vx_load(c + i) : v_zero, v_alpha, v_beta));
+    return i;
+}
+#endif
+
+#if CV_SIMD_64F
+template<class Op> static inline int
+fusedLoopSimd(double* d, const double* a, const double* b, const double* c, int len, double alpha, double beta)
+{
+    const v_float64 v_alpha = vx_setall_f64(alpha), v_beta = vx_setall_f64(beta), v_zero = vx_setzero_f64();
+    int i = 0;
+    for( ; i <= len - v_float64::nlanes; i += v_float64::nlanes )
+        v_store(d + i, Op::vr(vx_load(a + i), vx_load(b + i), c ? vx_load(c + i) : v_zero, v_alpha, v_beta));
+    return i;
+}
+#endif
+
+// d = op(a, b, c), b and c may be null when the operation does not use them
+template<class Op, typename WT> static void
+fusedLoop(WT* d, const WT* a, const WT* b, const WT* c, int len, WT alpha, WT beta)
+{
+    if( !b )
+        b = a;
+    int i = fusedLoopSimd<Op>(d, a, b, c, len, alpha, beta);
+    for( ; i < len; i++ )
+        d[i] = Op::r(a[i], b[i], c ? c[i] : (WT)0, alpha, beta);
+}
+
+template<typename WT> static void
+runFusedExpr_(const MatExprGraph& g, Mat& dst, const Rect& r)
+{
+    enum { BLOCK_SIZE = 512, PATTERN_SIZE = BLOCK_SIZE + MatExprGraph::MAX_CHANNELS };
+
+    const std::vector<MatExprGraph::Node>& nodes = g.nodes;
+    int nnodes = (int)nodes.size(), cn = dst.channels(), wdepth = DataType<WT>::depth;
+
+    // The values of the nodes, the scalar operands repeated along the block and the way the results
+    // are saturated. The integer results are clamped and, unless they are integers already, rounded;
+    // the result stored to an array of its own depth is saturated by the conversion.
+    enum { SAT_NONE, SAT_CLAMP, SAT_ROUND, SAT_CONVERT };
+    static const double intRanges[][2] = { {0, UCHAR_MAX}, {SCHAR_MIN, SCHAR_MAX}, {0, USHRT_MAX},
+                                           {SHRT_MIN, SHRT_MAX}, {INT_MIN, INT_MAX} };
+    AutoBuffer<WT> _buf(nnodes*(BLOCK_SIZE + PATTERN_SIZE));
+    WT *buf = _buf.data(), *patterns = buf + nnodes*BLOCK_SIZE;
+    AutoBuffer<double> _satbuf(BLOCK_SIZE);
+    uchar* satbuf = (uchar*)_satbuf.data();
+    AutoBuffer<const WT*> vals(nnodes);
+    AutoBuffer<BinaryFunc> toDepth(nnodes), fromDepth(nnodes);
+    AutoBuffer<int> satMode(nnodes);
+
+    for( int k = 0; k < nnodes; k++ )
+    {
+        const MatExprGraph::Node& n = nodes[k];
+        toDepth[k] = fromDepth[k] = 0;
+        satMode[k] = SAT_NONE;
+        if( n.op == MatExprGraph::LOAD )
+        {
+            if( n.depth != wdepth )
+                fromDepth[k] = getConvertFunc(n.depth, wdepth);
+            continue;
+        }
+        if( n.op == MatExprGraph::CMP || (k == nnodes - 1 && n.depth == dst.depth()) )
+            ;
+        else if( n.depth <= CV_32S )
+        {
+            bool integral = n.op != MatExprGraph::DIV && n.op != MatExprGraph::RECIP &&
+                std::floor(n.alpha) == n.alpha && std::floor(n.beta) == n.beta;
+            for( int j = 0; j < 4; j++ )
+                integral = integral && std::floor(n.s[j]) == n.s[j];
+            satMode[k] = integral ? SAT_CLAMP : SAT_ROUND;
+        }
+        else if( n.depth != wdepth )
+        {
+            satMode[k] = SAT_CONVERT;
+            toDepth[k] = getConvertFunc(wdepth, n.depth);
+            fromDepth[k] = getConvertFunc(n.depth, wdepth);
+        }
+        WT* p = patterns + k*PATTERN_SIZE;
+        for( int j = 0; j < PATTERN_SIZE; j++ )
+            p[j] = saturate_cast<WT>(n.s[j % cn]);
+    }
+    BinaryFunc store = dst.depth() != wdepth ? getConvertFunc(wdepth, dst.depth()) : 0;
+
+    for( int y = r.y; y < r.y + r.height; y++ )
+    {
+        for( int x = r.x; x < r.x + r.width; x += BLOCK_SIZE )
+        {
+            int len = std::min(r.x + r.width - x, (int)BLOCK_SIZE);
+            Size bsz(len, 1);
+
+            for( int k = 0; k < nnodes; k++ )
+            {
+                const MatExprGraph::Node& n = nodes[k];
+                WT* d = buf + k*BLOCK_SIZE;
+                if( n.op == MatExprGraph::LOAD )
+                {
+                    const Mat& in = g.inputs[n.input];
+                    const uchar* p = in.data + y*in.step[0] + x*in.elemSize1();
+                    if( fromDepth[k] )
+                        fromDepth[k](p, 0, 0, 0, (uchar*)d, 0, bsz, 0);
+                    vals[k] = fromDepth[k] ? d : (const WT*)p;
+                    continue;
+                }
+
+                const WT* a = vals[n.src0];
+                const WT* p = patterns + k*PATTERN_SIZE + x % cn;
+                const WT* b = n.src1 >= 0 ? vals[n.src1] : p;
+                WT alpha = (WT)n.alpha, beta = (WT)n.beta;
+                bool intDiv = n.depth <= CV_32S;
+
+                switch( n.op )
+                {
+                case MatExprGraph::ADDW:
+                    if( n.src1 < 0 )
+                        fusedLoop<op_fused_scale_add>(d, a, p, (const WT*)0, len, alpha, beta);
+                    else
+                        fusedLoop<op_fused_add_weighted>(d, a, b, p, len, alpha, beta);
+                    break;
+                case MatExprGraph::MUL:
+                    fusedLoop<op_fused_mul>(d, a, b, (const WT*)0, len, alpha, beta);
+                    break;
+                case MatExprGraph::DIV:
+                    if( intDiv )
+                        fusedLoop<op_fused_div_int>(d, a, b, (const WT*)0, len, alpha, beta);
+                    else
+                        fusedLoop<op_fused_div>(d, a, b, (const WT*)0, len, alpha, beta);
+                    break;
+                case MatExprGraph::RECIP:
+                    if( intDiv )
+                        fusedLoop<op_fused_recip_int>(d, a, (const WT*)0, (const WT*)0, len, alpha, beta);
+                    else
+                        fusedLoop<op_fused_recip>(d, a, (const WT*)0, (const WT*)0, len, alpha, beta);
+                    break;
+                case MatExprGraph::MIN:
+                    fusedLoop<op_fused_min>(d, a, b, (const WT*)0, len, alpha, beta);
+                    break;
+                case MatExprGraph::MAX:
+                    fusedLoop<op_fused_max>(d, a, b, (const WT*)0, len, alpha, beta);
+                    break;
+                case MatExprGraph::ABSDIFF:
+                    fusedLoop<op_fused_absdiff>(d, a, b, (const WT*)0, len, alpha, beta);
+                    break;
+                case MatExprGraph::CMP:
+                    switch( n.cmpop )
+                    {
+                    case CMP_EQ: fusedLoop<op_fused_cmp<CMP_EQ> >(d, a, b, (const WT*)0, len, (WT)255, (WT)0); break;
+                    case CMP_GT: fusedLoop<op_fused_cmp<CMP_GT> >(d, a, b, (const WT*)0, len, (WT)255, (WT)0); break;
+                    case CMP_GE: fusedLoop<op_fused_cmp<CMP_GE> >(d, a, b, (const WT*)0, len, (WT)255, (WT)0); break;
+                    case CMP_LT: fusedLoop<op_fused_cmp<CMP_LT> >(d, a, b, (const WT*)0, len, (WT)255, (WT)0); break;
+                    case CMP_LE: fusedLoop<op_fused_cmp<CMP_LE> >(d, a, b, (const WT*)0, len, (WT)255, (WT)0); break;
+                    default: fusedLoop<op_fused_cmp<CMP_NE> >(d, a, b, (const WT*)0, len, (WT)255, (WT)0); break;
+                    }
+                    break;
+                default:
+                    CV_Error(Error::StsInternal, "Unknown fused operation");
+                }
+
+                if( satMode[k] == SAT_CLAMP || satMode[k] == SAT_ROUND )
+                {
+                    WT lo = (WT)intRanges[n.depth][0], hi = (WT)intRanges[n.depth][1];
+                    if( satMode[k] == SAT_CLAMP )
+                        fusedLoop<op_fused_clamp>(d, d, (const WT*)0, (const WT*)0, len, lo, hi);
+                    else
+                        fusedLoop<op_fused_round>(d, d, (const WT*)0, (const WT*)0, len, lo, hi);
+                }
+                else if( satMode[k] == SAT_CONVERT )
+                {
+                    toDepth[k]((const uchar*)d, 0, 0, 0, satbuf, 0, bsz, 0);
+                    fromDepth[k](satbuf, 0, 0, 0, (uchar*)d, 0, bsz, 0);
+                }
+                vals[k] = d;
+            }
+
+            uchar* q = dst.data + y*dst.step[0] + x*dst.elemSize1();
+            if( store )
+                store((const uchar*)vals[nnodes-1], 0, 0, 0, q, 0, bsz, 0);
+            else
+                memcpy(q, vals[nnodes-1], len*sizeof(WT));
+        }
+    }
+#if CV_SIMD
+    vx_cleanup();
+#endif
+}
+
+void runFusedExpr(const MatExprGraph& g, Mat& dst, const Rect& r, bool wide)
+{
+    CV_INSTRUMENT_REGION();
+
+    if( wide )
+        runFusedExpr_<double>(g, dst, r);
+    else
+        runFusedExpr_<float>(g, dst, r);
+}
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+} // namespace cv
@@ -1115,7 +1115,20 @@ void cv::reduce(InputArray _src, OutputArray _dst, int dim, int op, int dtype)
         CV_Error( CV_StsUnsupportedFormat,
                   "Unsupported combination of input and output array formats" );
 
-    func( src, temp );
+    // every output element is computed by one thread, so the result does not depend on the split
+    size_t esz = src.elemSize();
+    if( dim == 0 )
+        parallelForElemwise(Size(src.cols, 1), esz*src.rows, [&](const Rect& r)
+        {
+            Mat tempPart = temp.colRange(r.x, r.x + r.width);
+            func( src.colRange(r.x, r.x + r.width), tempPart );
+        });
+    else
+        parallelForElemwise(Size(1, src.rows), esz*src.cols, [&](const Rect& r)
+        {
+            Mat tempPart = temp.rowRange(r.y, r.y + r.height);
+            func( src.rowRange(r.y, r.y + r.height), tempPart );
+        });
 
     if( op0 == CV_REDUCE_AVG )
         temp.convertTo(dst, dst.type(), 1./(dim == 0 ? src.rows : src.cols));
@@ -1127,53 +1140,349 @@ void cv::reduce(InputArray _src, OutputArray _dst, int dim, int op, int dtype)
 namespace cv
 {
 
-template<typename T> static void sort_( const Mat& src, Mat& dst, int flags )
+enum
 {
-    AutoBuffer<T> buf;
-    int n, len;
-    bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
-    bool inplace = src.data == dst.data;
-    bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
-
-    if( sortRows )
-        n = src.rows, len = src.cols;
-    else
+    // the shorter lines are sorted by comparisons
+    SORT_RADIX_MIN_LEN = 64,
+    // a line is sorted by several threads if it is at least that long and there are too few lines to keep all the threads busy
+    SORT_PARALLEL_MIN_LEN = 1 << 16,
+    SORT_MAX_STRIPES = 16
+};
+
+// Maps the values to the unsigned integers of the same size ordered the same way, so they can be sorted by digits
+template<typename T> struct SortKey;
+
+template<> struct SortKey<uchar>
+{
+    typedef uchar key_type;
+    static uchar toKey(uchar v) { return v; }
+    static uchar fromKey(uchar k) { return k; }
+};
+
+template<> struct SortKey<schar>
+{
+    typedef uchar key_type;
+    static uchar toKey(schar v) { return (uchar)(v ^ 0x80); }
+    static schar fromKey(uchar k) { return (schar)(k ^ 0x80); }
+};
+
+template<> struct SortKey<ushort>
+{
+    typedef ushort key_type;
+    static ushort toKey(ushort v) { return v; }
+    static ushort fromKey(ushort k) { return k; }
+};
+
+template<> struct SortKey<short>
+{
+    typedef ushort key_type;
+    static ushort toKey(short v) { return (ushort)(v ^ 0x8000); }
+    static short fromKey(ushort k) { return (short)(k ^ 0x8000); }
+};
+
+template<> struct SortKey<int>
+{
+    typedef unsigned key_type;
+    static unsigned toKey(int v) { return (unsigned)v ^ 0x80000000u; }
+    static int fromKey(unsigned k) { return (int)(k ^ 0x80000000u); }
+};
+
+// all the bits of the negative numbers are inverted, so that the larger magnitudes go first,
+// and only the sign bit of the positive ones
+template<> struct SortKey<float>
+{
+    typedef unsigned key_type;
+    static unsigned toKey(float v)
+    {
+        Cv32suf u; u.f = v;
+        return u.u ^ ((unsigned)(u.i >> 31) | 0x80000000u);
+    }
+    static float fromKey(unsigned k)
     {
-        n = src.cols, len = src.rows;
-        buf.allocate(len);
+        Cv32suf u; u.u = k ^ (((k >> 31) - 1) | 0x80000000u);
+        return u.f;
     }
-    T* bptr = buf.data();
+};
 
-    for( int i = 0; i < n; i++ )
+template<> struct SortKey<double>
+{
+    typedef uint64 key_type;
+    static uint64 toKey(double v)
+    {
+        Cv64suf u; u.f = v;
+        return u.u ^ ((uint64)(u.i >> 63) | CV_BIG_UINT(0x8000000000000000));
+    }
+    static double fromKey(uint64 k)
     {
-        T* ptr = bptr;
-        if( sortRows )
+        Cv64suf u; u.u = k ^ (((k >> 63) - 1) | CV_BIG_UINT(0x8000000000000000));
+        return u.f;
+    }
+};
+
+// orders the equal keys by their indices, so the result is the same as of the radix sort
+template<typename K> class LessThanKeyIdx
+{
+public:
+    LessThanKeyIdx( const K* _keys ) : keys(_keys) {}
+    bool operator()(int a, int b) const { return keys[a] < keys[b] || (keys[a] == keys[b] && a < b); }
+    const K* keys;
+};
+
+template<typename K> static inline int sortDigit(K k, int shift) { return (int)(k >> shift) & 255; }
+
+// Stable LSD radix sort of the keys (and of the indices moved with them, if idx is not NULL) by 8-bit digits.
+// kbuf and ibuf are the scratch buffers of len elements; the result is stored back to keys and idx.
+template<typename K> static void radixSort( K* keys, int* idx, K* kbuf, int* ibuf, int len )
+{
+    const int ndigits = (int)sizeof(K);
+    int hist[sizeof(K)][256];
+    memset(hist, 0, sizeof(hist));
+
+    for( int i = 0; i < len; i++ )
+    {
+        K k = keys[i];
+        for( int d = 0; d < ndigits; d++ )
+            hist[d][sortDigit(k, d*8)]++;
+    }
+
+    K *src = keys, *dst = kbuf;
+    int *isrc = idx, *idst = ibuf;
+    for( int d = 0; d < ndigits; d++ )
+    {
+        int* h = hist[d];
+        int shift = d*8;
+        // the pass would not move anything if all the keys have the same digit
+        if( h[sortDigit(src[0], shift)] == len )
+            continue;
+        for( int j = 0, sum = 0; j < 256; j++ )
+        {
+            int c = h[j];
+            h[j] = sum;
+            sum += c;
+        }
+        if( idx )
         {
-            T* dptr = dst.ptr<T>(i);
-            if( !inplace )
+            for( int i = 0; i < len; i++ )
             {
-                const T* sptr = src.ptr<T>(i);
-                memcpy(dptr, sptr, sizeof(T) * len);
+                K k = src[i];
+                int pos = h[sortDigit(k, shift)]++;
+                dst[pos] = k;
+                idst[pos] = isrc[i];
             }
-            ptr = dptr;
         }
         else
         {
-            for( int j = 0; j < len; j++ )
-                ptr[j] = src.ptr<T>(j)[i];
+            for( int i = 0; i < len; i++ )
+            {
+                K k = src[i];
+                dst[h[sortDigit(k, shift)]++] = k;
+            }
         }
+        std::swap(src, dst);
+        std::swap(isrc, idst);
+    }
 
-        std::sort( ptr, ptr + len );
-        if( sortDescending )
+    if( src != keys )
+    {
+        memcpy(keys, src, len*sizeof(K));
+        if( idx )
+            memcpy(idx, isrc, len*sizeof(int));
+    }
+}
+
+// The same as radixSort, but every pass is split between the threads: each stripe of the array is counted
+// and then scattered by its own thread into the ranges that follow the ones of the previous stripes.
+// The stripes keep the sort stable, so the result does not depend on the number of threads.
+template<typename K> static void parallelRadixSort( K* keys, int* idx, K* kbuf, int* ibuf, int len )
+{
+    const int ndigits = (int)sizeof(K);
+    int nstripes = std::max(std::min((int)SORT_MAX_STRIPES, len / (SORT_PARALLEL_MIN_LEN/4)), 1);
+    int stripeLen = (len + nstripes - 1)/nstripes;
+    std::vector<int> hist((size_t)nstripes*ndigits*256, 0), total(ndigits*256, 0);
+
+    parallel_for_(Range(0, nstripes), [&](const Range& r)
+    {
+        for( int s = r.start; s < r.end; s++ )
         {
-            for( int j = 0; j < len/2; j++ )
-                std::swap(ptr[j], ptr[len-1-j]);
+            int* h = &hist[(size_t)s*ndigits*256];
+            for( int i = s*stripeLen, i1 = std::min(i + stripeLen, len); i < i1; i++ )
+            {
+                K k = keys[i];
+                for( int d = 0; d < ndigits; d++ )
+                    h[d*256 + sortDigit(k, d*8)]++;
+            }
         }
+    });
+    for( int s = 0; s < nstripes; s++ )
+        for( int j = 0; j < ndigits*256; j++ )
+            total[j] += hist[(size_t)s*ndigits*256 + j];
+
+    K *src = keys, *dst = kbuf;
+    int *isrc = idx, *idst = ibuf;
+    bool moved = false;
+    for( int d = 0; d < ndigits; d++ )
+    {
+        int shift = d*8;
+        if( total[d*256 + sortDigit(src[0], shift)] == len )
+            continue;
 
-        if( !sortRows )
+        // the stripe histograms of the other digits are outdated once the keys have been moved
+        if( moved )
+        {
+            parallel_for_(Range(0, nstripes), [&](const Range& r)
+            {
+                for( int s = r.start; s < r.end; s++ )
+                {
+                    int* h = &hist[((size_t)s*ndigits + d)*256];
+                    memset(h, 0, 256*sizeof(h[0]));
+                    for( int i = s*stripeLen, i1 = std::min(i + stripeLen, len); i < i1; i++ )
+                        h[sortDigit(src[i], shift)]++;
+                }
+            });
+        }
+
+        for( int j = 0, sum = 0; j < 256; j++ )
+        {
+            for( int s = 0; s < nstripes; s++ )
+            {
+                int& h = hist[((size_t)s*ndigits + d)*256 + j];
+                int c = h;
+                h = sum;
+                sum += c;
+            }
+        }
+
+        parallel_for_(Range(0, nstripes), [&](const Range& r)
+        {
+            for( int s = r.start; s < r.end; s++ )
+            {
+                int* h = &hist[((size_t)s*ndigits + d)*256];
+                for( int i = s*stripeLen, i1 = std::min(i + stripeLen, len); i < i1; i++ )
+                {
+                    K k = src[i];
+                    int pos = h[sortDigit(k, shift)]++;
+                    dst[pos] = k;
+                    if( idx )
+                        idst[pos] = isrc[i];
+                }
+            }
+        });
+        std::swap(src, dst);
+        std::swap(isrc, idst);
+        moved = true;
+    }
+
+    if( src != keys )
+    {
+        memcpy(keys, src, len*sizeof(K));
+        if( idx )
+            memcpy(idx, isrc, len*sizeof(int));
+    }
+}
+
+// Sorts every row or column of src. The values are converted to the keys (inverted for the descending order)
+// right in the destination rows, or gathered into a buffer for the columns, sorted by digits and converted back.
+// sortIdx sorts the keys together with the indices, which are stored directly to the destination rows.
+template<typename T> class SortInvoker : public ParallelLoopBody
+{
+public:
+    typedef typename SortKey<T>::key_type K;
+
+    SortInvoker( const Mat& _src, Mat& _dst, int flags, bool _sortIdx, bool _parallelLine )
+        : src(&_src), dst(&_dst), sortIdx(_sortIdx), parallelLine(_parallelLine)
+    {
+        sortRows = (flags & 1) == SORT_EVERY_ROW;
+        flip = (flags & SORT_DESCENDING) != 0 ? (K)~(K)0 : (K)0;
+        len = sortRows ? src->cols : src->rows;
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        bool radix = len >= SORT_RADIX_MIN_LEN;
+        bool keyBuf = sortIdx || !sortRows;
+        AutoBuffer<K> _kbuf((keyBuf ? len : 0) + (radix ? len : 0));
+        AutoBuffer<int> _ibuf(sortIdx ? (sortRows ? 0 : len) + (radix ? len : 0) : 0);
+        K* kbuf = _kbuf.data();
+        int* ibuf = _ibuf.data();
+        size_t sstep = src->step/sizeof(T), dstep = dst->step/sizeof(T), istep = dst->step/sizeof(int);
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const T* sptr = sortRows ? src->ptr<T>(i) : src->ptr<T>(0) + i;
+            size_t sdelta = sortRows ? 1 : sstep;
+            K* keys = keyBuf ? kbuf : (K*)dst->ptr<T>(i);
+            int* idx = 0;
+            if( sortIdx )
+            {
+                idx = sortRows ? dst->ptr<int>(i) : ibuf;
+                for( int j = 0; j < len; j++ )
+                    idx[j] = j;
+            }
+            // in-place sorting of the rows converts every element right where it is read from
             for( int j = 0; j < len; j++ )
-                dst.ptr<T>(j)[i] = ptr[j];
+                keys[j] = SortKey<T>::toKey(sptr[j*sdelta]) ^ flip;
+
+            K* kscratch = keyBuf ? kbuf + len : kbuf;
+            int* iscratch = sortIdx && !sortRows ? ibuf + len : ibuf;
+            if( !radix )
+            {
+                if( idx )
+                    std::sort(idx, idx + len, LessThanKeyIdx<K>(keys));
+                else
+                    std::sort(keys, keys + len);
+            }
+            else if( parallelLine )
+                parallelRadixSort(keys, idx, kscratch, iscratch, len);
+            else
+                radixSort(keys, idx, kscratch, iscratch, len);
+
+            if( sortIdx )
+            {
+                if( !sortRows )
+                {
+                    int* iptr = dst->ptr<int>(0) + i;
+                    for( int j = 0; j < len; j++ )
+                        iptr[j*istep] = idx[j];
+                }
+            }
+            else
+            {
+                T* dptr = sortRows ? (T*)keys : dst->ptr<T>(0) + i;
+                size_t ddelta = sortRows ? 1 : dstep;
+                for( int j = 0; j < len; j++ )
+                    dptr[j*ddelta] = SortKey<T>::fromKey(keys[j] ^ flip);
+            }
+        }
     }
+
+private:
+    const Mat* src;
+    Mat* dst;
+    bool sortRows;
+    bool sortIdx;
+    bool parallelLine;
+    K flip;
+    int len;
+};
+
+template<typename T> static void sortLines_( const Mat& src, Mat& dst, int flags, bool sortIdx )
+{
+    bool sortRows = (flags & 1) == SORT_EVERY_ROW;
+    int n = sortRows ? src.rows : src.cols, len = sortRows ? src.cols : src.rows;
+    if( n <= 0 || len <= 0 )
+        return;
+
+    // a few long lines are sorted one by one, each of them by all the threads
+    if( len >= SORT_PARALLEL_MIN_LEN && n < getNumThreads() )
+        SortInvoker<T>(src, dst, flags, sortIdx, true)(Range(0, n));
+    else
+        parallel_for_(Range(0, n), SortInvoker<T>(src, dst, flags, sortIdx, false),
+                      (double)n*len/(1 << 16));
+}
+
+template<typename T> static void sort_( const Mat& src, Mat& dst, int flags )
+{
+    sortLines_<T>(src, dst, flags, false);
 }
 
 #ifdef HAVE_IPP
@@ -1264,64 +1573,10 @@ static bool ipp_sort(const Mat& src, Mat& dst, int flags)
 }
 #endif
 
-template<typename _Tp> class LessThanIdx
-{
-public:
-    LessThanIdx( const _Tp* _arr ) : arr(_arr) {}
-    bool operator()(int a, int b) const { return arr[a] < arr[b]; }
-    const _Tp* arr;
-};
-
 template<typename T> static void sortIdx_( const Mat& src, Mat& dst, int flags )
 {
-    AutoBuffer<T> buf;
-    AutoBuffer<int> ibuf;
-    bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
-    bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
-
     CV_Assert( src.data != dst.data );
-
-    int n, len;
-    if( sortRows )
-        n = src.rows, len = src.cols;
-    else
-    {
-        n = src.cols, len = src.rows;
-        buf.allocate(len);
-        ibuf.allocate(len);
-    }
-    T* bptr = buf.data();
-    int* _iptr = ibuf.data();
-
-    for( int i = 0; i < n; i++ )
-    {
-        T* ptr = bptr;
-        int* iptr = _iptr;
-
-        if( sortRows )
-        {
-            ptr = (T*)(src.data + src.step*i);
-            iptr = dst.ptr<int>(i);
-        }
-        else
-        {
-            for( int j = 0; j < len; j++ )
-                ptr[j] = src.ptr<T>(j)[i];
-        }
-        for( int j = 0; j < len; j++ )
-            iptr[j] = j;
-
-        std::sort( iptr, iptr + len, LessThanIdx<T>(ptr) );
-        if( sortDescending )
-        {
-            for( int j = 0; j < len/2; j++ )
-                std::swap(iptr[j], iptr[len-1-j]);
-        }
-
-        if( !sortRows )
-            for( int j = 0; j < len; j++ )
-                dst.ptr<int>(j)[i] = iptr[j];
-    }
+    sortLines_<T>(src, dst, flags, true);
 }
 
 #ifdef HAVE_IPP
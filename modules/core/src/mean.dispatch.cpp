@@ -118,18 +118,10 @@ static bool ipp_mean( Mat &src, Mat &mask, Scalar &ret )
 }
 #endif
 
-Scalar mean(InputArray _src, InputArray _mask)
+// sums the elements of src selected by mask and returns the number of the selected elements
+static size_t sumMasked(const Mat& src, const Mat& mask, Scalar& s)
 {
-    CV_INSTRUMENT_REGION();
-
-    Mat src = _src.getMat(), mask = _mask.getMat();
-    CV_Assert( mask.empty() || mask.type() == CV_8U );
-
     int k, cn = src.channels(), depth = src.depth();
-    Scalar s;
-
-    CV_IPP_RUN(IPP_VERSION_X100 >= 700, ipp_mean(src, mask, s), s)
-
     SumFunc func = getSumFunc(depth);
 
     CV_Assert( cn <= 4 && func != 0 );
@@ -178,7 +170,41 @@ Scalar mean(InputArray _src, InputArray _mask)
                 ptrs[1] += bsz;
         }
     }
-    return s*(nz0 ? 1./nz0 : 0);
+    return nz0;
+}
+
+Scalar mean(InputArray _src, InputArray _mask)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat(), mask = _mask.getMat();
+    CV_Assert( mask.empty() || mask.type() == CV_8U );
+
+    Scalar s;
+
+    CV_IPP_RUN(IPP_VERSION_X100 >= 700, ipp_mean(src, mask, s), s)
+
+    size_t nz = 0;
+    ReduceStripes stripes(src, mask);
+    if( stripes.count() > 1 )
+    {
+        std::vector<std::pair<Scalar, size_t> > partial;
+        stripes.run(partial, [&](int i)
+        {
+            Scalar ps;
+            size_t pnz = sumMasked(stripes.stripe(src, i), stripes.stripe(mask, i), ps);
+            return std::make_pair(ps, pnz);
+        });
+        for( size_t i = 0; i < partial.size(); i++ )
+        {
+            s += partial[i].first;
+            nz += partial[i].second;
+        }
+    }
+    else
+        nz = sumMasked(src, mask, s);
+
+    return s*(nz ? 1./nz : 0);
 }
 
 static SumSqrFunc getSumSqrFunc(int depth)
@@ -509,23 +535,11 @@ static bool ipp_meanStdDev(Mat& src, OutputArray _mean, OutputArray _sdv, Mat& m
 }
 #endif
 
-void meanStdDev(InputArray _src, OutputArray _mean, OutputArray _sdv, InputArray _mask)
+// computes the sums s[] and the sums of squares sq[] of the elements of src selected by mask and
+// returns the number of those elements; sq is s + cn and the buffer holds cn*4 values, the tail
+// keeps the integer block sums
+static size_t sumSqrMasked(const Mat& src, const Mat& mask, double* s, double* sq)
 {
-    CV_INSTRUMENT_REGION();
-
-    CV_Assert(!_src.empty());
-    CV_Assert( _mask.empty() || _mask.type() == CV_8UC1 );
-
-    CV_OCL_RUN(OCL_PERFORMANCE_CHECK(_src.isUMat()) && _src.dims() <= 2,
-               ocl_meanStdDev(_src, _mean, _sdv, _mask))
-
-    Mat src = _src.getMat(), mask = _mask.getMat();
-
-    CV_OVX_RUN(!ovx::skipSmallImages<VX_KERNEL_MEAN_STDDEV>(src.cols, src.rows),
-               openvx_meanStdDev(src, _mean, _sdv, mask))
-
-    CV_IPP_RUN(IPP_VERSION_X100 >= 700, ipp_meanStdDev(src, _mean, _sdv, mask));
-
     int k, cn = src.channels(), depth = src.depth();
 
     SumSqrFunc func = getSumSqrFunc(depth);
@@ -536,9 +550,8 @@ void meanStdDev(InputArray _src, OutputArray _mean, OutputArray _sdv, InputArray
     uchar* ptrs[2] = {};
     NAryMatIterator it(arrays, ptrs);
     int total = (int)it.size, blockSize = total, intSumBlockSize = 0;
-    int j, count = 0, nz0 = 0;
-    AutoBuffer<double> _buf(cn*4);
-    double *s = (double*)_buf.data(), *sq = s + cn;
+    int j, count = 0;
+    size_t nz0 = 0;
     int *sbuf = (int*)s, *sqbuf = (int*)sq;
     bool blockSum = depth <= CV_16S, blockSqSum = depth <= CV_8S;
     size_t esz = 0;
@@ -589,6 +602,57 @@ void meanStdDev(InputArray _src, OutputArray _mean, OutputArray _sdv, InputArray
         }
     }
 
+    return nz0;
+}
+
+void meanStdDev(InputArray _src, OutputArray _mean, OutputArray _sdv, InputArray _mask)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert(!_src.empty());
+    CV_Assert( _mask.empty() || _mask.type() == CV_8UC1 );
+
+    CV_OCL_RUN(OCL_PERFORMANCE_CHECK(_src.isUMat()) && _src.dims() <= 2,
+               ocl_meanStdDev(_src, _mean, _sdv, _mask))
+
+    Mat src = _src.getMat(), mask = _mask.getMat();
+
+    CV_OVX_RUN(!ovx::skipSmallImages<VX_KERNEL_MEAN_STDDEV>(src.cols, src.rows),
+               openvx_meanStdDev(src, _mean, _sdv, mask))
+
+    CV_IPP_RUN(IPP_VERSION_X100 >= 700, ipp_meanStdDev(src, _mean, _sdv, mask));
+
+    int k, j, cn = src.channels();
+    AutoBuffer<double> _buf(cn*4);
+    double *s = (double*)_buf.data(), *sq = s + cn;
+    size_t nz0 = 0;
+
+    ReduceStripes stripes(src, mask);
+    if( stripes.count() > 1 )
+    {
+        // every partial holds the sums, the sums of squares and the number of the selected elements
+        std::vector<std::vector<double> > partial;
+        stripes.run(partial, [&](int i)
+        {
+            std::vector<double> p(cn*4 + 1);
+            p[cn*4] = (double)sumSqrMasked(stripes.stripe(src, i), stripes.stripe(mask, i), &p[0], &p[cn]);
+            return p;
+        });
+        for( k = 0; k < cn; k++ )
+            s[k] = sq[k] = 0;
+        for( size_t i = 0; i < partial.size(); i++ )
+        {
+            for( k = 0; k < cn; k++ )
+            {
+                s[k] += partial[i][k];
+                sq[k] += partial[i][cn + k];
+            }
+            nz0 += (size_t)partial[i][cn*4];
+        }
+    }
+    else
+        nz0 = sumSqrMasked(src, mask, s, sq);
+
     double scale = nz0 ? 1./nz0 : 0.;
     for( k = 0; k < cn; k++ )
     {
@@ -617,4 +681,235 @@ void meanStdDev(InputArray _src, OutputArray _mean, OutputArray _sdv, InputArray
     }
 }
 
+// the statistics of a part of an array: the sums, the sums of squares, the extremums and the numbers
+// of non-zero elements of every channel, and the number of the elements selected by the mask
+struct StatisticsAccum
+{
+    StatisticsAccum() : count(0)
+    {
+        for( int k = 0; k < 4; k++ )
+        {
+            s[k] = sq[k] = nz[k] = 0;
+            minv[k] = std::numeric_limits<double>::infinity();
+            maxv[k] = -minv[k];
+        }
+    }
+
+    void merge(const StatisticsAccum& b, int cn)
+    {
+        for( int k = 0; k < cn; k++ )
+        {
+            s[k] += b.s[k];
+            sq[k] += b.sq[k];
+            nz[k] += b.nz[k];
+            minv[k] = std::min(minv[k], b.minv[k]);
+            maxv[k] = std::max(maxv[k], b.maxv[k]);
+        }
+        count += b.count;
+    }
+
+    double s[4], sq[4], nz[4], minv[4], maxv[4];
+    double count;
+};
+
+// the block is short enough for ST and SQT to accumulate it exactly for the integer types
+enum { STATISTICS_BLOCK_SIZE = 1 << 12 };
+
+// the vectorized part of an unmasked single-channel block; returns the number of processed elements
+template<typename T, typename ST, typename SQT> static inline int
+statisticsBlockVec_( const T*, int, ST&, SQT&, T&, T&, int& )
+{
+    return 0;
+}
+
+#if CV_SIMD
+template<> inline int
+statisticsBlockVec_<uchar, int, int>( const uchar* src, int len, int& s, int& sq, uchar& mn, uchar& mx, int& nz )
+{
+    const int step = v_uint8::nlanes;
+    v_int32 vs = vx_setzero_s32(), vsq = vx_setzero_s32(), vz = vx_setzero_s32();
+    v_uint8 vmn = vx_setall_u8(255), vmx = vx_setzero_u8(), vzero = vx_setzero_u8(), vone = vx_setall_u8(1);
+    v_int16 vone16 = vx_setall_s16(1);
+    int i = 0;
+    for( ; i <= len - step; i += step )
+    {
+        v_uint8 v = vx_load(src + i);
+        vmn = v_min(vmn, v);
+        vmx = v_max(vmx, v);
+        v_uint16 a0, a1, z0, z1;
+        v_expand(v, a0, a1);
+        v_expand((v == vzero) & vone, z0, z1);
+        v_int16 b0 = v_reinterpret_as_s16(a0), b1 = v_reinterpret_as_s16(a1);
+        vs += v_dotprod(b0, vone16) + v_dotprod(b1, vone16);
+        vsq += v_dotprod(b0, b0) + v_dotprod(b1, b1);
+        vz += v_dotprod(v_reinterpret_as_s16(z0 + z1), vone16);
+    }
+    if( i > 0 )
+    {
+        s += v_reduce_sum(vs);
+        sq += v_reduce_sum(vsq);
+        nz += i - v_reduce_sum(vz);
+        mn = std::min(mn, v_reduce_min(vmn));
+        mx = std::max(mx, v_reduce_max(vmx));
+    }
+    vx_cleanup();
+    return i;
+}
+#endif
+
+template<typename T, typename ST, typename SQT> static void
+statisticsBlock_( const T* src, const uchar* mask, int len, int cn, StatisticsAccum& acc )
+{
+    const T minInit = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+    const T maxInit = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+    int count = 0;
+
+    for( int k = 0; k < cn; k++ )
+    {
+        ST s = 0;
+        SQT sq = 0;
+        T mn = minInit, mx = maxInit;
+        int nz = 0;
+        count = 0;
+
+        if( !mask )
+        {
+            int i = cn == 1 ? statisticsBlockVec_<T, ST, SQT>(src, len, s, sq, mn, mx, nz) : 0;
+            for( ; i < len; i++ )
+            {
+                T v = src[i*cn + k];
+                s += v;
+                sq += (SQT)v*v;
+                mn = std::min(mn, v);
+                mx = std::max(mx, v);
+                nz += v != 0;
+            }
+            count = len;
+        }
+        else
+        {
+            for( int i = 0; i < len; i++ )
+            {
+                if( !mask[i] )
+                    continue;
+                T v = src[i*cn + k];
+                s += v;
+                sq += (SQT)v*v;
+                mn = std::min(mn, v);
+                mx = std::max(mx, v);
+                nz += v != 0;
+                count++;
+            }
+        }
+
+        acc.s[k] += (double)s;
+        acc.sq[k] += (double)sq;
+        acc.nz[k] += nz;
+        if( count > 0 )
+        {
+            acc.minv[k] = std::min(acc.minv[k], (double)mn);
+            acc.maxv[k] = std::max(acc.maxv[k], (double)mx);
+        }
+    }
+    acc.count += count;
+}
+
+typedef void (*StatisticsFunc)( const uchar* src, const uchar* mask, int len, int cn, StatisticsAccum& acc );
+
+static StatisticsFunc getStatisticsFunc(int depth)
+{
+    static StatisticsFunc statisticsTab[] =
+    {
+        (StatisticsFunc)statisticsBlock_<uchar, int, int>, (StatisticsFunc)statisticsBlock_<schar, int, int>,
+        (StatisticsFunc)statisticsBlock_<ushort, int, int64>, (StatisticsFunc)statisticsBlock_<short, int, int64>,
+        (StatisticsFunc)statisticsBlock_<int, int64, double>, (StatisticsFunc)statisticsBlock_<float, double, double>,
+        (StatisticsFunc)statisticsBlock_<double, double, double>, 0
+    };
+    return statisticsTab[depth];
+}
+
+static StatisticsAccum computeStatistics_(const Mat& src, const Mat& mask, StatisticsFunc func)
+{
+    const Mat* arrays[] = {&src, &mask, 0};
+    uchar* ptrs[2] = {};
+    NAryMatIterator it(arrays, ptrs);
+    int total = (int)it.size;
+    size_t esz = src.elemSize();
+    StatisticsAccum acc;
+
+    for( size_t i = 0; i < it.nplanes; i++, ++it )
+    {
+        for( int j = 0; j < total; j += STATISTICS_BLOCK_SIZE )
+        {
+            int bsz = std::min(total - j, (int)STATISTICS_BLOCK_SIZE);
+            func( ptrs[0] + j*esz, ptrs[1] ? ptrs[1] + j : 0, bsz, src.channels(), acc );
+        }
+    }
+    return acc;
+}
+
+void computeStatistics(InputArray _src, OutputArray _mean, OutputArray _sdv,
+                       OutputArray _minVal, OutputArray _maxVal, OutputArray _nonZero, InputArray _mask)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !_src.empty() );
+    CV_Assert( _mask.empty() || _mask.type() == CV_8UC1 );
+
+    Mat src = _src.getMat(), mask = _mask.getMat();
+    int k, cn = src.channels();
+    CV_Assert( cn <= 4 );
+    CV_Assert( mask.empty() || mask.size == src.size );
+
+    StatisticsFunc func = getStatisticsFunc(src.depth());
+    CV_Assert( func != 0 );
+
+    StatisticsAccum acc;
+    ReduceStripes stripes(src, mask);
+    if( stripes.count() > 1 )
+    {
+        std::vector<StatisticsAccum> partial;
+        stripes.run(partial, [&](int i)
+        {
+            return computeStatistics_(stripes.stripe(src, i), stripes.stripe(mask, i), func);
+        });
+        for( size_t i = 0; i < partial.size(); i++ )
+            acc.merge(partial[i], cn);
+    }
+    else
+        acc = computeStatistics_(src, mask, func);
+
+    double stat[5][4];
+    double scale = acc.count > 0 ? 1./acc.count : 0.;
+    for( k = 0; k < cn; k++ )
+    {
+        double m = acc.s[k]*scale;
+        stat[0][k] = m;
+        stat[1][k] = std::sqrt(std::max(acc.sq[k]*scale - m*m, 0.));
+        stat[2][k] = acc.count > 0 ? acc.minv[k] : 0.;
+        stat[3][k] = acc.count > 0 ? acc.maxv[k] : 0.;
+        stat[4][k] = acc.nz[k];
+    }
+
+    const _OutputArray* outputs[] = { &_mean, &_sdv, &_minVal, &_maxVal, &_nonZero };
+    for( int j = 0; j < 5; j++ )
+    {
+        const _OutputArray& _dst = *outputs[j];
+        if( !_dst.needed() )
+            continue;
+
+        if( !_dst.fixedSize() )
+            _dst.create(cn, 1, CV_64F, -1, true);
+        Mat dst = _dst.getMat();
+        int dcn = (int)dst.total();
+        CV_Assert( dst.type() == CV_64F && dst.isContinuous() &&
+                   (dst.cols == 1 || dst.rows == 1) && dcn >= cn );
+        double* dptr = dst.ptr<double>();
+        for( k = 0; k < cn; k++ )
+            dptr[k] = stat[j][k];
+        for( ; k < dcn; k++ )
+            dptr[k] = 0;
+    }
+}
+
 } // namespace
@@ -165,6 +165,31 @@ void merge(const Mat* mv, size_t n, OutputArray _dst)
     CV_Assert( func != 0 );
 
     size_t esz = dst.elemSize(), esz1 = dst.elemSize1();
+
+    // with more than 4 channels the kernels make several passes over the data,
+    // so those keep the cache-sized blocks of the generic loop below
+    if( dst.dims <= 2 && cn <= 4 )
+    {
+        bool continuous = dst.isContinuous();
+        for( k = 0; k < cn; k++ )
+            continuous = continuous && mv[k].isContinuous();
+        Size sz = continuous ? Size((int)std::min(dst.total(), (size_t)INT_MAX), 1) : dst.size();
+        if( sz.width > 0 && (size_t)sz.width*sz.height == dst.total() && sz.width <= CV_SPLIT_MERGE_MAX_BLOCK_SIZE(cn) )
+        {
+            parallelForElemwise(sz, esz*2, [&](const Rect& r)
+            {
+                const uchar* sptrs[4];
+                for( int y = r.y; y < r.y + r.height; y++ )
+                {
+                    for( int t = 0; t < cn; t++ )
+                        sptrs[t] = mv[t].ptr(y) + r.x*esz1;
+                    func( sptrs, dst.ptr(y) + r.x*esz, r.width, cn );
+                }
+            });
+            return;
+        }
+    }
+
     size_t blocksize0 = (int)((BLOCK_SIZE + esz-1)/esz);
     AutoBuffer<uchar> _buf((cn+1)*(sizeof(Mat*) + sizeof(uchar*)) + 16);
     const Mat** arrays = (const Mat**)_buf.data();
@@ -1484,6 +1484,49 @@ static bool ipp_minMaxIdx(Mat &src, double* _minVal, double* _maxVal, int* _minI
 
 }
 
+namespace cv
+{
+
+struct MinMaxIdxResult
+{
+    MinMaxIdxResult() : minval(std::numeric_limits<double>::infinity()), maxval(-minval), minidx(0), maxidx(0) {}
+    double minval, maxval;
+    size_t minidx, maxidx; // 1-based linear indices, 0 when nothing has been found
+};
+
+static MinMaxIdxResult minMaxIdx_(const Mat& src, const Mat& mask, MinMaxIdxFunc func, size_t startidx)
+{
+    int depth = src.depth(), cn = src.channels();
+    const Mat* arrays[] = {&src, &mask, 0};
+    uchar* ptrs[2] = {};
+    NAryMatIterator it(arrays, ptrs);
+
+    MinMaxIdxResult res;
+    int iminval = INT_MAX, imaxval = INT_MIN;
+    float  fminval = std::numeric_limits<float>::infinity(),  fmaxval = -fminval;
+    double dminval = std::numeric_limits<double>::infinity(), dmaxval = -dminval;
+    int *minval = &iminval, *maxval = &imaxval;
+    int planeSize = (int)it.size*cn;
+
+    if( depth == CV_32F )
+        minval = (int*)&fminval, maxval = (int*)&fmaxval;
+    else if( depth == CV_64F )
+        minval = (int*)&dminval, maxval = (int*)&dmaxval;
+
+    for( size_t i = 0; i < it.nplanes; i++, ++it, startidx += planeSize )
+        func( ptrs[0], ptrs[1], minval, maxval, &res.minidx, &res.maxidx, planeSize, startidx );
+
+    if( depth == CV_32F )
+        dminval = fminval, dmaxval = fmaxval;
+    else if( depth <= CV_32S )
+        dminval = iminval, dmaxval = imaxval;
+    res.minval = dminval;
+    res.maxval = dmaxval;
+    return res;
+}
+
+}
+
 void cv::minMaxIdx(InputArray _src, double* minVal,
                    double* maxVal, int* minIdx, int* maxIdx,
                    InputArray _mask)
@@ -1511,25 +1554,30 @@ void cv::minMaxIdx(InputArray _src, double* minVal,
     MinMaxIdxFunc func = getMinmaxTab(depth);
     CV_Assert( func != 0 );
 
-    const Mat* arrays[] = {&src, &mask, 0};
-    uchar* ptrs[2] = {};
-    NAryMatIterator it(arrays, ptrs);
-
-    size_t minidx = 0, maxidx = 0;
-    int iminval = INT_MAX, imaxval = INT_MIN;
-    float  fminval = std::numeric_limits<float>::infinity(),  fmaxval = -fminval;
-    double dminval = std::numeric_limits<double>::infinity(), dmaxval = -dminval;
-    size_t startidx = 1;
-    int *minval = &iminval, *maxval = &imaxval;
-    int planeSize = (int)it.size*cn;
-
-    if( depth == CV_32F )
-        minval = (int*)&fminval, maxval = (int*)&fmaxval;
-    else if( depth == CV_64F )
-        minval = (int*)&dminval, maxval = (int*)&dmaxval;
+    MinMaxIdxResult res;
+    ReduceStripes stripes(src, mask);
+    if( stripes.count() > 1 )
+    {
+        std::vector<MinMaxIdxResult> partial;
+        stripes.run(partial, [&](int i)
+        {
+            return minMaxIdx_(stripes.stripe(src, i), stripes.stripe(mask, i), func, stripes.offset(i)*cn + 1);
+        });
+        // the stripes are merged in order, so the first of the equal extremums wins as in a single pass
+        for( size_t i = 0; i < partial.size(); i++ )
+        {
+            const MinMaxIdxResult& p = partial[i];
+            if( p.minidx != 0 && (res.minidx == 0 || p.minval < res.minval) )
+                res.minval = p.minval, res.minidx = p.minidx;
+            if( p.maxidx != 0 && (res.maxidx == 0 || p.maxval > res.maxval) )
+                res.maxval = p.maxval, res.maxidx = p.maxidx;
+        }
+    }
+    else
+        res = minMaxIdx_(src, mask, func, 1);
 
-    for( size_t i = 0; i < it.nplanes; i++, ++it, startidx += planeSize )
-        func( ptrs[0], ptrs[1], minval, maxval, &minidx, &maxidx, planeSize, startidx );
+    size_t minidx = res.minidx, maxidx = res.maxidx;
+    double dminval = res.minval, dmaxval = res.maxval;
 
     if (!src.empty() && mask.empty())
     {
@@ -1541,10 +1589,6 @@ void cv::minMaxIdx(InputArray _src, double* minVal,
 
     if( minidx == 0 )
         dminval = dmaxval = 0;
-    else if( depth == CV_32F )
-        dminval = fminval, dmaxval = fmaxval;
-    else if( depth <= CV_32S )
-        dminval = iminval, dmaxval = imaxval;
 
     if( minVal )
         *minVal = dminval;
@@ -621,6 +621,22 @@ double cv::norm( InputArray _src, int normType, InputArray _mask )
     Mat src = _src.getMat(), mask = _mask.getMat();
     CV_IPP_RUN(IPP_VERSION_X100 >= 700, ipp_norm(src, normType, mask, _result), _result);
 
+    ReduceStripes stripes(src, mask);
+    if( stripes.count() > 1 )
+    {
+        // the L2 norm is merged from the squared norms of the stripes
+        int stripeNormType = normType == NORM_L2 ? NORM_L2SQR : normType;
+        std::vector<double> partial;
+        stripes.run(partial, [&](int i)
+        {
+            return norm(stripes.stripe(src, i), stripeNormType, stripes.stripe(mask, i));
+        });
+        double result = 0;
+        for( size_t i = 0; i < partial.size(); i++ )
+            result = normType == NORM_INF ? std::max(result, partial[i]) : result + partial[i];
+        return normType == NORM_L2 ? std::sqrt(result) : result;
+    }
+
     int depth = src.depth(), cn = src.channels();
     if( src.isContinuous() && mask.empty() )
     {
@@ -1120,6 +1136,21 @@ double cv::norm( InputArray _src1, InputArray _src2, int normType, InputArray _m
                normType == NORM_L2 || normType == NORM_L2SQR ||
               ((normType == NORM_HAMMING || normType == NORM_HAMMING2) && src1.type() == CV_8U) );
 
+    ReduceStripes stripes(src1, src2, mask);
+    if( stripes.count() > 1 )
+    {
+        int stripeNormType = normType == NORM_L2 ? NORM_L2SQR : normType;
+        std::vector<double> partial;
+        stripes.run(partial, [&](int i)
+        {
+            return norm(stripes.stripe(src1, i), stripes.stripe(src2, i), stripeNormType, stripes.stripe(mask, i));
+        });
+        double result = 0;
+        for( size_t i = 0; i < partial.size(); i++ )
+            result = normType == NORM_INF ? std::max(result, partial[i]) : result + partial[i];
+        return normType == NORM_L2 ? std::sqrt(result) : result;
+    }
+
     if( src1.isContinuous() && src2.isContinuous() && mask.empty() )
     {
         size_t len = src1.total()*src1.channels();
@@ -376,6 +376,14 @@ public:
 
         filename.clear();
         lineno = 0;
+
+        streamCollection = FileNode();
+        streamNode = FileNode();
+
+        write_base64 = false;
+        base64_pending = false;
+        base64_dt.clear();
+        base64_tail_len = 0;
     }
 
     Impl(FileStorage* _fs)
@@ -448,6 +456,7 @@ public:
 
     bool open( const char* filename_or_buf, int _flags, const char* encoding )
     {
+        bool base64 = (_flags & FileStorage::BASE64) != 0;
         _flags &= ~FileStorage::BASE64;
 
         bool ok = true;
@@ -457,6 +466,7 @@ public:
         mem_mode = (_flags & FileStorage::MEMORY) != 0;
 
         write_mode = (_flags & 3) != 0;
+        write_base64 = base64 && write_mode;
 
         bool isGZ = false;
         size_t fnamelen = 0;
@@ -468,9 +478,9 @@ public:
             if( !params.empty() )
                 filename = params[0];
 
-            /*if( !write_base64 && params.size() >= 2 &&
+            if( !write_base64 && params.size() >= 2 &&
                 std::find(params.begin()+1, params.end(), std::string("base64")) != params.end())
-                write_base64 = (write_mode || append);*/
+                write_base64 = write_mode;
         }
 
         if( filename.size() == 0 && !mem_mode && !write_mode )
@@ -971,6 +981,11 @@ public:
         CV_Assert( write_mode );
         CV_Assert( !write_stack.empty() );
 
+        if( !base64_dt.empty() )
+            finishBase64();
+        else
+            startPendingStruct(); // an empty sequence
+
         FStructData& current_struct = write_stack.back();
         if( fmt == FileStorage::FORMAT_JSON && !FileNode::isFlow(current_struct.flags) && write_stack.size() > 1 )
             current_struct.indent = write_stack[write_stack.size() - 2].indent;
@@ -986,6 +1001,7 @@ public:
                            const char* type_name )
     {
         CV_Assert( write_mode );
+        startPendingStruct();
 
         struct_flags = (struct_flags & (FileNode::TYPE_MASK|FileNode::FLOW)) | FileNode::EMPTY;
         if( !FileNode::isCollection(struct_flags))
@@ -995,6 +1011,17 @@ public:
         if( type_name && type_name[0] == '\0' )
             type_name = 0;
 
+        // In the base64 mode a flow sequence is not written until it is known whether it only gets the raw data
+        // (e.g. the elements of a matrix), which are then encoded as a single base64 block. The sequence is kept
+        // on the stack, so that it is closed as usual.
+        if( write_base64 && FileNode::isSeq(struct_flags) && FileNode::isFlow(struct_flags) && !type_name &&
+            !FileNode::isFlow(write_stack.back().flags) )
+        {
+            write_stack.push_back(FStructData(key ? key : "", struct_flags, 0));
+            base64_pending = true;
+            return;
+        }
+
         FStructData s = emitter->startWriteStruct( write_stack.back(), key, struct_flags, type_name );
         write_stack.push_back(s);
         size_t write_stack_size = write_stack.size();
@@ -1013,6 +1040,7 @@ public:
     void writeComment( const char* comment, bool eol_comment )
     {
         CV_Assert(write_mode);
+        startPendingStruct();
         emitter->writeComment( comment, eol_comment );
     }
 
@@ -1034,18 +1062,21 @@ public:
     void write( const String& key, int value )
     {
         CV_Assert(write_mode);
+        startPendingStruct();
         emitter->write(key.c_str(), value);
     }
 
     void write( const String& key, double value )
     {
         CV_Assert(write_mode);
+        startPendingStruct();
         emitter->write(key.c_str(), value);
     }
 
     void write( const String& key, const String& value )
     {
         CV_Assert(write_mode);
+        startPendingStruct();
         emitter->write(key.c_str(), value.c_str(), false);
     }
 
@@ -1055,6 +1086,9 @@ public:
 
         size_t elemSize = fs::calcStructSize(dt.c_str(), 0);
         CV_Assert( len % elemSize == 0 );
+
+        if( len > 0 && (base64_pending || !base64_dt.empty()) && writeRawDataBase64(_data, len, dt) )
+            return;
         len /= elemSize;
 
         bool explicitZero = fmt == FileStorage::FORMAT_JSON;
@@ -1138,9 +1172,174 @@ public:
         }
     }
 
-    void writeRawDataBase64(const void* /*data*/, int /*len*/, const char* /*dt*/ )
+    // starts the flow sequence that was delayed in the base64 mode as a regular one
+    void startPendingStruct()
+    {
+        if( !base64_dt.empty() )
+            CV_Error( CV_StsError, "Only the raw data can be written into a base64-encoded sequence" );
+        if( !base64_pending )
+            return;
+        FStructData s = write_stack.back();
+        write_stack.pop_back();
+        base64_pending = false;
+        write_stack.push_back(emitter->startWriteStruct(write_stack.back(), s.tag.empty() ? 0 : s.tag.c_str(), s.flags));
+        write_stack[write_stack.size()-2].flags &= ~FileNode::EMPTY;
+    }
+
+    bool writeRawDataBase64( const void* data, size_t len, const std::string& dt )
     {
+        // the header of the base64 block is the format string padded with spaces
+        const int BASE64_HDR_SIZE = 24;
+
+        if( base64_pending )
+        {
+            if( dt.size() >= (size_t)BASE64_HDR_SIZE )
+            {
+                startPendingStruct();
+                return false;
+            }
+            FStructData s = write_stack.back();
+            write_stack.pop_back();
+            base64_pending = false;
+
+            FStructData b = emitter->startWriteStruct(write_stack.back(), s.tag.empty() ? 0 : s.tag.c_str(),
+                                                      FileNode::SEQ, "binary");
+            write_stack.back().flags &= ~FileNode::EMPTY;
+            write_stack.push_back(b);
+            if( fmt != FileStorage::FORMAT_JSON )
+                flush();
+
+            base64_dt = dt;
+            base64_tail_len = 0;
+            char hdr[BASE64_HDR_SIZE];
+            memset(hdr, ' ', BASE64_HDR_SIZE);
+            memcpy(hdr, dt.c_str(), dt.size());
+            writeBase64Bytes((const uchar*)hdr, BASE64_HDR_SIZE);
+        }
+        else if( dt != base64_dt )
+            CV_Error_( CV_StsBadArg, ("The format '%s' of the raw data does not match the format '%s' of the "
+                                      "base64 block being written", dt.c_str(), base64_dt.c_str()) );
+
+        // the elements are stored without the alignment gaps between them
+        int fmt_pairs[CV_FS_MAX_FMT_PAIRS*2];
+        int fmt_pair_count = fs::decodeFormat( dt.c_str(), fmt_pairs, CV_FS_MAX_FMT_PAIRS );
+        size_t elemSize = fs::calcStructSize( dt.c_str(), 0 ), packedSize = 0;
+        for( int k = 0; k < fmt_pair_count; k++ )
+            packedSize += fmt_pairs[k*2]*CV_ELEM_SIZE(fmt_pairs[k*2+1]);
+
+        if( packedSize == elemSize )
+            writeBase64Bytes((const uchar*)data, len);
+        else
+        {
+            std::vector<uchar> packed(packedSize);
+            for( const uchar* data0 = (const uchar*)data; len > 0; len -= elemSize, data0 += elemSize )
+            {
+                size_t offset = 0, packedOffset = 0;
+                for( int k = 0; k < fmt_pair_count; k++ )
+                {
+                    size_t elem_size = CV_ELEM_SIZE(fmt_pairs[k*2+1]), sz = fmt_pairs[k*2]*elem_size;
+                    offset = alignSize( offset, elem_size );
+                    memcpy(&packed[packedOffset], data0 + offset, sz);
+                    offset += sz;
+                    packedOffset += sz;
+                }
+                writeBase64Bytes(&packed[0], packedSize);
+            }
+        }
+        return true;
+    }
+
+    // YAML and XML base64 blocks are split into lines, JSON one is a single string
+    void writeBase64Chars( const char* chars, int n )
+    {
+        const int BASE64_LINE_LEN = 76;
+        char* ptr = bufferPtr();
+        if( fmt != FileStorage::FORMAT_JSON )
+        {
+            int linelen = (int)(ptr - bufferStart()) - space;
+            if( linelen + n > BASE64_LINE_LEN )
+            {
+                int n0 = BASE64_LINE_LEN - linelen;
+                memcpy(ptr, chars, n0);
+                setBufferPtr(ptr + n0);
+                ptr = flush();
+                chars += n0;
+                n -= n0;
+            }
+        }
+        else if( ptr + n + 16 > bufferEnd() )
+        {
+            // the line is output partially, so the buffer is not grown to the size of the whole string
+            *ptr = '\0';
+            puts( bufferStart() );
+            ptr = bufferStart();
+            space = 0;
+        }
+        memcpy(ptr, chars, n);
+        setBufferPtr(ptr + n);
+    }
+
+    void writeBase64Bytes( const uchar* data, size_t len )
+    {
+        static const char base64chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        char chars[76];
+        int n = 0;
+
+        while( len > 0 )
+        {
+            while( base64_tail_len < 3 && len > 0 )
+            {
+                base64_tail[base64_tail_len++] = *data++;
+                len--;
+            }
+            if( base64_tail_len < 3 )
+                break;
+            // the bulk of the data is encoded without copying it to the tail
+            for( ;; )
+            {
+                const uchar* t = base64_tail;
+                chars[n] = base64chars[t[0] >> 2];
+                chars[n+1] = base64chars[((t[0] & 3) << 4) | (t[1] >> 4)];
+                chars[n+2] = base64chars[((t[1] & 15) << 2) | (t[2] >> 6)];
+                chars[n+3] = base64chars[t[2] & 63];
+                n += 4;
+                if( n == (int)sizeof(chars) )
+                {
+                    writeBase64Chars(chars, n);
+                    n = 0;
+                }
+                if( len < 3 )
+                    break;
+                base64_tail[0] = data[0];
+                base64_tail[1] = data[1];
+                base64_tail[2] = data[2];
+                data += 3;
+                len -= 3;
+            }
+            base64_tail_len = 0;
+        }
+        if( n > 0 )
+            writeBase64Chars(chars, n);
+    }
 
+    void finishBase64()
+    {
+        if( base64_tail_len > 0 )
+        {
+            static const char base64chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            uchar t0 = base64_tail[0], t1 = base64_tail_len > 1 ? base64_tail[1] : 0;
+            char chars[4];
+            chars[0] = base64chars[t0 >> 2];
+            chars[1] = base64chars[((t0 & 3) << 4) | (t1 >> 4)];
+            chars[2] = base64_tail_len > 1 ? base64chars[(t1 & 15) << 2] : '=';
+            chars[3] = '=';
+            writeBase64Chars(chars, 4);
+        }
+        base64_dt.clear();
+        base64_tail_len = 0;
+        // the XML closing tag would be taken for the base64 data on the same line
+        if( fmt == FileStorage::FORMAT_XML )
+            flush();
     }
 
     String releaseAndGetString();
@@ -1386,6 +1585,10 @@ public:
                        int elem_type, const void* value, int len )
     {
         FileStorage_API* fs = this;
+        bool streamed = isStreamedCollection(collection);
+        if( streamed )
+            passStreamedNode();
+
         bool noname = key.empty() || (fmt == FileStorage::FORMAT_XML && strcmp(key.c_str(), "_") == 0);
         convertToCollection( noname ? FileNode::SEQ : FileNode::MAP, collection );
 
@@ -1440,11 +1643,71 @@ public:
         int nelems = readInt(cp + 5);
         writeInt(cp + 5, nelems + 1);
 
+        if( streamed )
+        {
+            if( collection.blockIdx == 0 && collection.ofs == 0 )
+                streamCollection = node; // the root collection of the next document
+            else
+            {
+                streamCollection = collection;
+                streamNode = node;
+            }
+        }
+
         return node;
     }
 
+    // The streaming read mode passes every complete element of the top-level collections to the callback and
+    // then drops it. The element and its children are the last nodes added, so the storage is just rewound
+    // to the beginning of the element, and the peak memory is taken by the largest element, not the file.
+    bool isStreamedCollection( const FileNode& collection ) const
+    {
+        if( !streamCallback )
+            return false;
+        if( collection.blockIdx == 0 && collection.ofs == 0 )
+            return true; // the next document starts, so the last element of the previous one is complete
+        if( streamCollection.empty() )
+            return false;
+        // the collection could be moved to a new block when it was converted from an empty node
+        size_t blockIdx0 = collection.blockIdx, ofs0 = collection.ofs;
+        size_t blockIdx1 = streamCollection.blockIdx, ofs1 = streamCollection.ofs;
+        normalizeNodeOfs(blockIdx0, ofs0);
+        normalizeNodeOfs(blockIdx1, ofs1);
+        return blockIdx0 == blockIdx1 && ofs0 == ofs1;
+    }
+
+    void passStreamedNode()
+    {
+        if( streamNode.empty() )
+            return;
+        FileNode node = streamNode;
+        streamNode = FileNode();
+        normalizeNodeOfs(node.blockIdx, node.ofs);
+
+        streamCallback(node);
+
+        // the beginning of a block is the end of the previous one, which is kept, so that
+        // the space taken by the collection is computed from the same block in finalizeCollection()
+        size_t blockIdx = node.blockIdx, ofs = node.ofs;
+        if( ofs == 0 && blockIdx > 0 )
+            ofs = fs_data_blksz[--blockIdx];
+        fs_data.resize(blockIdx + 1);
+        fs_data_ptrs.resize(blockIdx + 1);
+        fs_data_blksz.resize(blockIdx + 1);
+        freeSpaceOfs = ofs;
+
+        FileNode collection = streamCollection;
+        normalizeNodeOfs(collection.blockIdx, collection.ofs);
+        uchar* cp = collection.ptr();
+        if( *cp & FileNode::NAMED )
+            cp += 4;
+        writeInt(cp + 5, readInt(cp + 5) - 1);
+    }
+
     void finalizeCollection( FileNode& collection )
     {
+        if( isStreamedCollection(collection) )
+            passStreamedNode();
         if( !collection.isSeq() && !collection.isMap() )
             return;
         uchar* ptr0 = collection.ptr(), *ptr = ptr0 + 1;
@@ -1657,6 +1920,12 @@ public:
         int ival = 0;
         double fval = 0;
 
+        // The elements are written directly into the node storage, a chunk at a time, since addNode()
+        // per element takes several times longer than the decoding itself
+        const size_t chunkSize = 1 << 16;
+        uchar *dst = 0, *dstEnd = 0;
+        int nelems = 0;
+
         for(;;)
         {
             for( k = 0; k < fmt_pair_count; k++ )
@@ -1706,14 +1975,44 @@ public:
 
                     if( base64decoder.endOfStream() )
                         break;
-                    addNode(collection, std::string(), node_type,
-                            node_type == FileNode::INT ? (void*)&ival : (void*)&fval, -1);
+
+                    if( dst + 9 > dstEnd )
+                    {
+                        if( dst )
+                            freeSpaceOfs -= dstEnd - dst;
+                        else
+                            convertToCollection(FileNode::SEQ, collection);
+                        FileNode chunk(fs_ext, fs_data_ptrs.size() - 1, freeSpaceOfs);
+                        dst = reserveNodeSpace(chunk, chunkSize);
+                        dstEnd = dst + chunkSize;
+                    }
+                    *dst = (uchar)node_type;
+                    if( node_type == FileNode::INT )
+                    {
+                        writeInt(dst + 1, ival);
+                        dst += 5;
+                    }
+                    else
+                    {
+                        writeReal(dst + 1, fval);
+                        dst += 9;
+                    }
+                    nelems++;
                 }
             }
             if( base64decoder.endOfStream() )
                 break;
         }
 
+        if( dst )
+        {
+            freeSpaceOfs -= dstEnd - dst;
+            uchar* cp = collection.ptr();
+            if( *cp & FileNode::NAMED )
+                cp += 4;
+            writeInt(cp + 5, readInt(cp + 5) + nelems);
+        }
+
         finalizeCollection(collection);
         return base64decoder.getPtr();
     }
@@ -1781,6 +2080,16 @@ public:
     size_t strbufsize;
     size_t strbufpos;
     int lineno;
+
+    FileStorage::NodeCallback streamCallback;
+    FileNode streamCollection;
+    FileNode streamNode;
+
+    bool write_base64;
+    bool base64_pending;
+    std::string base64_dt;
+    uchar base64_tail[3];
+    int base64_tail_len;
 };
 
 FileStorage::FileStorage()
@@ -1837,6 +2146,16 @@ bool FileStorage::open(const String& filename, int flags, const String& encoding
     }
 }
 
+bool FileStorage::readNodes(const String& filename, const NodeCallback& callback, int flags, const String& encoding)
+{
+    CV_Assert( callback );
+    CV_Assert( (flags & 3) == READ );
+
+    FileStorage fs;
+    fs.p->streamCallback = callback;
+    return fs.p->open(filename.c_str(), flags, encoding.c_str());
+}
+
 bool FileStorage::isOpened() const { return p->is_opened; }
 
 void FileStorage::release()
@@ -2493,12 +2812,18 @@ FileNodeIterator& FileNodeIterator::readRaw( const String& fmt, void* _data0, si
                 offset = alignSize( offset, elem_size );
                 uchar* data = data0 + offset;
 
-                for( int i = 0; i < count; i++, ++(*this) )
+                // the nodes are accessed directly rather than through FileNode, which is
+                // several times faster on the large arrays
+                for( int i = 0; i < count; i++ )
                 {
-                    FileNode node = *(*this);
-                    if( node.isInt() )
+                    const uchar* p = idx < nodeNElems ? fs->fs_data_ptrs[blockIdx] + ofs : 0;
+                    int tag = p ? (int)*p : (int)FileNode::NONE;
+                    int tp = tag & FileNode::TYPE_MASK;
+                    size_t hdrsz = (tag & FileNode::NAMED) ? 5 : 1;
+                    if( tp == FileNode::INT )
                     {
-                        int ival = (int)node;
+                        int ival = readInt(p + hdrsz);
+                        ofs += hdrsz + 4;
                         switch( elem_type )
                         {
                         case CV_8U:
@@ -2537,9 +2862,10 @@ FileNodeIterator& FileNodeIterator::readRaw( const String& fmt, void* _data0, si
                             CV_Error( Error::StsUnsupportedFormat, "Unsupported type" );
                         }
                     }
-                    else if( node.isReal() )
+                    else if( tp == FileNode::REAL )
                     {
-                        double fval = (double)node;
+                        double fval = readReal(p + hdrsz);
+                        ofs += hdrsz + 8;
 
                         switch( elem_type )
                         {
@@ -2581,6 +2907,13 @@ FileNodeIterator& FileNodeIterator::readRaw( const String& fmt, void* _data0, si
                     }
                     else
                         CV_Error( Error::StsError, "readRawData can only be used to read plain sequences of numbers" );
+
+                    idx++;
+                    if( ofs >= blockSize )
+                    {
+                        fs->normalizeNodeOfs(blockIdx, ofs);
+                        blockSize = fs->fs_data_blksz[blockIdx];
+                    }
                 }
                 offset = (int)(data - data0);
             }
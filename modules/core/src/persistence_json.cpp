@@ -32,8 +32,9 @@ public:
         bool is_real_collection = true;
         if (type_name && memcmp(type_name, "binary", 6) == 0)
         {
+            /* base64 data is written as a string, see endWriteStruct */
             struct_flags = FileNode::STR;
-            data[0] = '\0';
+            strcpy(data, "\"$base64$");
             is_real_collection = false;
         }
 
@@ -53,6 +54,13 @@ public:
     void endWriteStruct(const FStructData& current_struct)
     {
         int struct_flags = current_struct.flags;
+        if( struct_flags == FileNode::STR )
+        {
+            char* ptr = fs->bufferPtr();
+            *ptr++ = '\"';
+            fs->setBufferPtr(ptr);
+            return;
+        }
         CV_Assert( FileNode::isCollection(struct_flags) );
 
         if( !FileNode::isFlow(struct_flags) )
@@ -0,0 +1,348 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/bufferpool.hpp"
+#include "opencv2/core/utils/allocator_stats.impl.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
+#include "opencv2/core/utils/tls.hpp"
+
+#include <atomic>
+
+namespace cv {
+
+// The blocks are rounded up to size classes: 64 bytes and then 4 classes per power of two
+// (which bounds the waste by 25%) up to 64MB.
+enum
+{
+    POOL_MIN_BLOCK_SHIFT = 6,
+    POOL_MAX_BLOCK_SHIFT = 26,
+    POOL_CLASSES_PER_DOUBLING = 4,
+    POOL_NUM_CLASSES = 1 + (POOL_MAX_BLOCK_SHIFT - POOL_MIN_BLOCK_SHIFT)*POOL_CLASSES_PER_DOUBLING,
+    POOL_THREAD_CACHE_BLOCKS = 4
+};
+
+// returns -1 for the blocks that are too large to be pooled
+static int poolSizeClass(size_t size, size_t& blockSize)
+{
+    if (size <= ((size_t)1 << POOL_MIN_BLOCK_SHIFT))
+    {
+        blockSize = (size_t)1 << POOL_MIN_BLOCK_SHIFT;
+        return 0;
+    }
+    if (size > ((size_t)1 << POOL_MAX_BLOCK_SHIFT))
+    {
+        blockSize = size;
+        return -1;
+    }
+    int k = POOL_MIN_BLOCK_SHIFT; // size is in (2^k, 2^(k+1)]
+    while (((size - 1) >> (k + 1)) != 0)
+        k++;
+    int shift = k - 2;
+    size_t j = (size + ((size_t)1 << shift) - 1) >> shift; // 5..8
+    blockSize = j << shift;
+    return 1 + (k - POOL_MIN_BLOCK_SHIFT)*POOL_CLASSES_PER_DOUBLING + (int)(j - 5);
+}
+
+// the counters rely on the zero initialization of the static storage, as utils::AllocatorStatistics does
+class PoolAllocatorStatistics CV_FINAL : public utils::PoolAllocatorStatisticsInterface
+{
+public:
+    uint64_t getCurrentUsage() const CV_OVERRIDE { return usage.getCurrentUsage(); }
+    uint64_t getTotalUsage() const CV_OVERRIDE { return usage.getTotalUsage(); }
+    uint64_t getNumberOfAllocations() const CV_OVERRIDE { return usage.getNumberOfAllocations(); }
+    uint64_t getPeakUsage() const CV_OVERRIDE { return usage.getPeakUsage(); }
+    uint64_t getNumberOfHits() const CV_OVERRIDE { return (uint64_t)hits.load(); }
+    uint64_t getNumberOfMisses() const CV_OVERRIDE { return (uint64_t)misses.load(); }
+    uint64_t getReservedSize() const CV_OVERRIDE { return (uint64_t)reserved.load(); }
+    uint64_t getPeakReservedSize() const CV_OVERRIDE { return (uint64_t)peakReserved.load(); }
+
+    void resetPeakUsage() CV_OVERRIDE
+    {
+        usage.resetPeakUsage();
+        peakReserved.store(reserved.load());
+    }
+
+    void onAllocate(size_t sz, bool hit)
+    {
+        usage.onAllocate(sz);
+        if (hit)
+        {
+            hits++;
+            reserved -= (int64)sz;
+        }
+        else
+            misses++;
+    }
+
+    void onFree(size_t sz) { usage.onFree(sz); }
+
+    // accounts a block kept for reuse if it fits into the limit
+    bool tryReserve(size_t sz, size_t limit)
+    {
+        int64 prev = reserved.load();
+        do
+        {
+            if ((uint64_t)prev + sz > (uint64_t)limit)
+                return false;
+        }
+        while (!reserved.compare_exchange_weak(prev, prev + (int64)sz));
+
+        int64 newReserved = prev + (int64)sz, prevPeak = peakReserved.load();
+        while (prevPeak < newReserved && !peakReserved.compare_exchange_weak(prevPeak, newReserved))
+            ;
+        return true;
+    }
+
+    void onRelease(size_t sz) { reserved -= (int64)sz; }
+
+private:
+    utils::AllocatorStatistics usage;
+    std::atomic<int64> hits, misses, reserved, peakReserved;
+};
+
+static PoolAllocatorStatistics pool_allocator_stats;
+
+utils::PoolAllocatorStatisticsInterface& utils::getPoolAllocatorStatistics()
+{
+    return pool_allocator_stats;
+}
+
+class PoolMatAllocator;
+
+// A few blocks of every size class owned by one thread, so the steady state of a loop allocating
+// the same temporary arrays takes no locks
+struct PoolThreadCache
+{
+    PoolThreadCache() : owner(NULL), epoch(0)
+    {
+        memset(counts, 0, sizeof(counts));
+    }
+    ~PoolThreadCache();
+
+    void releaseAll();
+
+    PoolMatAllocator* owner;
+    unsigned epoch;
+    int counts[POOL_NUM_CLASSES];
+    void* blocks[POOL_NUM_CLASSES][POOL_THREAD_CACHE_BLOCKS];
+};
+
+class PoolMatAllocator CV_FINAL : public MatAllocator, public BufferPoolController
+{
+public:
+    PoolMatAllocator() : stats(pool_allocator_stats),
+        maxReservedSize(utils::getConfigurationParameterSizeT("OPENCV_POOL_ALLOCATOR_MAX_RESERVED_SIZE", (size_t)256 << 20)),
+        epoch(0)
+    {
+    }
+
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, AccessFlag /*flags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for( int i = dims-1; i >= 0; i-- )
+        {
+            if( step )
+            {
+                if( data0 && step[i] != CV_AUTOSTEP )
+                {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else
+                    step[i] = total;
+            }
+            total *= sizes[i];
+        }
+        uchar* data = data0 ? (uchar*)data0 : (uchar*)allocateBlock(total);
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = data;
+        u->size = total;
+        if(data0)
+            u->flags |= UMatData::USER_ALLOCATED;
+
+        return u;
+    }
+
+    bool allocate(UMatData* u, AccessFlag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        if(!u) return false;
+        return true;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        if( !(u->flags & UMatData::USER_ALLOCATED) )
+        {
+            deallocateBlock(u->origdata, u->size);
+            u->origdata = 0;
+        }
+        delete u;
+    }
+
+    BufferPoolController* getBufferPoolController(const char* id) const CV_OVERRIDE
+    {
+        CV_UNUSED(id);
+        return const_cast<PoolMatAllocator*>(this);
+    }
+
+    size_t getReservedSize() const CV_OVERRIDE { return (size_t)stats.getReservedSize(); }
+    size_t getMaxReservedSize() const CV_OVERRIDE { return maxReservedSize; }
+
+    void setMaxReservedSize(size_t size) CV_OVERRIDE
+    {
+        size_t prev = maxReservedSize.exchange(size);
+        if (size < prev)
+            freeAllReservedBuffers();
+    }
+
+    // The shared pool and the cache of the calling thread are released immediately, the caches of
+    // the other threads are released on their next use of the allocator.
+    void freeAllReservedBuffers() CV_OVERRIDE
+    {
+        {
+            AutoLock lock(mutex);
+            for (int c = 0; c < POOL_NUM_CLASSES; c++)
+            {
+                std::vector<void*>& bin = bins[c];
+                for (size_t i = 0; i < bin.size(); i++)
+                    releaseBlock(bin[i], classBlockSize(c));
+                std::vector<void*>().swap(bin);
+            }
+            epoch++;
+        }
+        getThreadCache();
+    }
+
+    void releaseBlock(void* ptr, size_t blockSize) const
+    {
+        fastFree(ptr);
+        stats.onRelease(blockSize);
+    }
+
+    void returnBlock(void* ptr, int c) const
+    {
+        AutoLock lock(mutex);
+        bins[c].push_back(ptr);
+    }
+
+private:
+    static size_t classBlockSize(int c)
+    {
+        if (c == 0)
+            return (size_t)1 << POOL_MIN_BLOCK_SHIFT;
+        int k = (c - 1)/POOL_CLASSES_PER_DOUBLING + POOL_MIN_BLOCK_SHIFT;
+        size_t j = (size_t)((c - 1) % POOL_CLASSES_PER_DOUBLING) + 5;
+        return j << (k - 2);
+    }
+
+    PoolThreadCache& getThreadCache() const
+    {
+        PoolThreadCache& tc = threadCaches.getRef();
+        unsigned currentEpoch = epoch.load(std::memory_order_relaxed);
+        if (tc.owner == NULL)
+        {
+            tc.owner = const_cast<PoolMatAllocator*>(this);
+            tc.epoch = currentEpoch;
+        }
+        else if (tc.epoch != currentEpoch)
+        {
+            tc.releaseAll();
+            tc.epoch = currentEpoch;
+        }
+        return tc;
+    }
+
+    void* allocateBlock(size_t size) const
+    {
+        size_t blockSize = 0;
+        int c = poolSizeClass(size, blockSize);
+        void* ptr = NULL;
+        if (c >= 0)
+        {
+            PoolThreadCache& tc = getThreadCache();
+            if (tc.counts[c] > 0)
+                ptr = tc.blocks[c][--tc.counts[c]];
+            else
+            {
+                AutoLock lock(mutex);
+                std::vector<void*>& bin = bins[c];
+                if (!bin.empty())
+                {
+                    ptr = bin.back();
+                    bin.pop_back();
+                }
+            }
+        }
+        bool hit = ptr != NULL;
+        if (!hit)
+            ptr = fastMalloc(blockSize);
+        stats.onAllocate(blockSize, hit);
+        return ptr;
+    }
+
+    void deallocateBlock(void* ptr, size_t size) const
+    {
+        size_t blockSize = 0;
+        int c = poolSizeClass(size, blockSize);
+        stats.onFree(blockSize);
+        if (c < 0 || !stats.tryReserve(blockSize, maxReservedSize))
+        {
+            fastFree(ptr);
+            return;
+        }
+        PoolThreadCache& tc = getThreadCache();
+        if (tc.counts[c] < POOL_THREAD_CACHE_BLOCKS)
+            tc.blocks[c][tc.counts[c]++] = ptr;
+        else
+            returnBlock(ptr, c);
+    }
+
+    friend struct PoolThreadCache;
+
+    PoolAllocatorStatistics& stats;
+    // read by the deallocating threads
+    std::atomic<size_t> maxReservedSize;
+    std::atomic<unsigned> epoch;
+    mutable Mutex mutex;
+    mutable std::vector<void*> bins[POOL_NUM_CLASSES];
+    TLSData<PoolThreadCache> threadCaches;
+};
+
+void PoolThreadCache::releaseAll()
+{
+    for (int c = 0; c < POOL_NUM_CLASSES; c++)
+    {
+        size_t blockSize = PoolMatAllocator::classBlockSize(c);
+        for (int i = 0; i < counts[c]; i++)
+            owner->releaseBlock(blocks[c][i], blockSize);
+        counts[c] = 0;
+    }
+}
+
+// the blocks of a finished thread are handed over to the other threads through the shared pool
+PoolThreadCache::~PoolThreadCache()
+{
+    if (!owner)
+        return;
+    for (int c = 0; c < POOL_NUM_CLASSES; c++)
+    {
+        for (int i = 0; i < counts[c]; i++)
+            owner->returnBlock(blocks[c][i], c);
+        counts[c] = 0;
+    }
+}
+
+MatAllocator* Mat::getPoolAllocator()
+{
+    CV_SINGLETON_LAZY_INIT(MatAllocator, new PoolMatAllocator())
+}
+
+} // namespace
@@ -251,6 +251,15 @@ Size getContinuousSize2D(Mat& m1, int widthScale=1);
 Size getContinuousSize2D(Mat& m1, Mat& m2, int widthScale=1);
 Size getContinuousSize2D(Mat& m1, Mat& m2, Mat& m3, int widthScale=1);
 
+// Elementwise kernels are memory bound: splitting them among threads pays off only when
+// the processed data is well beyond the cache, and each stripe should stream a large chunk.
+enum { ELEMWISE_PARALLEL_MIN_BYTES = 1 << 20, ELEMWISE_STRIPE_BYTES = 1 << 18, ELEMWISE_CHUNK = 256 };
+
+// Runs body over the sz.height x sz.width block of elements (as returned by getContinuousSize2D),
+// splitting it by rows, or by chunks of a single continuous row, when the block is large enough.
+// bytesPerElem is the total size of one element in all the arrays the kernel reads and writes.
+void parallelForElemwise(Size sz, size_t bytesPerElem, const std::function<void(const Rect&)>& body);
+
 void setSize( Mat& m, int _dims, const int* _sz, const size_t* _steps, bool autoSteps=false );
 void finalizeHdr(Mat& m);
 int updateContinuityFlag(int flags, int dims, const int* size, const size_t* step);
@@ -138,6 +138,31 @@ void split(const Mat& src, Mat* mv)
     CV_Assert( func != 0 );
 
     size_t esz = src.elemSize(), esz1 = src.elemSize1();
+
+    // with more than 4 channels the kernels make several passes over the data,
+    // so those keep the cache-sized blocks of the generic loop below
+    if( src.dims <= 2 && cn <= 4 )
+    {
+        bool continuous = src.isContinuous();
+        for( k = 0; k < cn; k++ )
+            continuous = continuous && mv[k].isContinuous();
+        Size sz = continuous ? Size((int)std::min(src.total(), (size_t)INT_MAX), 1) : src.size();
+        if( sz.width > 0 && (size_t)sz.width*sz.height == src.total() && sz.width <= CV_SPLIT_MERGE_MAX_BLOCK_SIZE(cn) )
+        {
+            parallelForElemwise(sz, esz*2, [&](const Rect& r)
+            {
+                uchar* dptrs[4];
+                for( int y = r.y; y < r.y + r.height; y++ )
+                {
+                    for( int t = 0; t < cn; t++ )
+                        dptrs[t] = mv[t].ptr(y) + r.x*esz1;
+                    func( src.ptr(y) + r.x*esz, dptrs, r.width, cn );
+                }
+            });
+            return;
+        }
+    }
+
     size_t blocksize0 = (BLOCK_SIZE + esz-1)/esz;
     AutoBuffer<uchar> _buf((cn+1)*(sizeof(Mat*) + sizeof(uchar*)) + 16);
     const Mat** arrays = (const Mat**)_buf.data();
@@ -38,6 +38,41 @@ template <typename T> Scalar ocl_part_sum(Mat m)
 typedef int (*SumFunc)(const uchar*, const uchar* mask, uchar*, int, int);
 SumFunc getSumFunc(int depth);
 
+// The reductions split large arrays into stripes whose number and bounds depend only on the
+// array size, compute the partial results of the stripes in parallel and merge them in stripe
+// order, so the results are the same for any number of threads.
+class ReduceStripes
+{
+public:
+    // a and the optional b, c are arrays of the same size that are processed together
+    ReduceStripes(const Mat& a, const Mat& b = Mat(), const Mat& c = Mat());
+
+    int count() const { return nstripes; }
+
+    // a part of the single row a continuous array is viewed as, or a range of rows;
+    // an empty array (e.g. no mask) gives an empty stripe
+    Mat stripe(const Mat& m, int i) const;
+
+    // linear index of the first element of the i-th stripe
+    size_t offset(int i) const;
+
+    template<typename T, typename Func> void run(std::vector<T>& partial, const Func& func) const
+    {
+        partial.resize(nstripes);
+        parallel_for_(Range(0, nstripes), [&](const Range& r)
+        {
+            for( int i = r.start; i < r.end; i++ )
+                partial[i] = func(i);
+        }, nstripes);
+    }
+
+private:
+    int nstripes;
+    bool continuous;
+    size_t total;
+    int rows, cols;
+};
+
 }
 
 #endif // SRC_STAT_HPP
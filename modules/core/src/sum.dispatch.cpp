@@ -26,6 +26,52 @@ SumFunc getSumFunc(int depth)
         CV_CPU_DISPATCH_MODES_ALL);
 }
 
+ReduceStripes::ReduceStripes(const Mat& a, const Mat& b, const Mat& c)
+    : nstripes(1), continuous(true), total(a.total()), rows(a.rows), cols(a.cols)
+{
+    const Mat* arrays[] = { &a, &b, &c };
+    size_t esz = 0;
+    for( int k = 0; k < 3; k++ )
+    {
+        if( arrays[k]->empty() )
+            continue;
+        if( arrays[k]->size != a.size )
+            return; // let the serial code report the mismatch
+        esz += arrays[k]->elemSize();
+        continuous = continuous && arrays[k]->isContinuous();
+    }
+    if( total*a.channels() > (size_t)INT_MAX )
+        continuous = false;
+    if( total == 0 || (!continuous && a.dims > 2) )
+        return;
+
+    double bytes = (double)total*esz;
+    if( bytes < ELEMWISE_PARALLEL_MIN_BYTES )
+        return;
+    double n = bytes/ELEMWISE_STRIPE_BYTES;
+    if( !continuous )
+        n = std::min(n, (double)rows);
+    nstripes = std::max((int)n, 1);
+}
+
+Mat ReduceStripes::stripe(const Mat& m, int i) const
+{
+    if( m.empty() || nstripes == 1 )
+        return m;
+    if( continuous )
+        return m.reshape(0, 1).colRange((int)offset(i), (int)offset(i + 1));
+    return m.rowRange((int)((int64)rows*i/nstripes), (int)((int64)rows*(i + 1)/nstripes));
+}
+
+size_t ReduceStripes::offset(int i) const
+{
+    if( i >= nstripes )
+        return total;
+    if( continuous )
+        return (total*i/nstripes) & ~(size_t)63; // keep the chunks aligned for the vector loops
+    return (size_t)((int64)rows*i/nstripes)*cols;
+}
+
 #ifdef HAVE_OPENCL
 
 bool ocl_sum( InputArray _src, Scalar & res, int sum_op, InputArray _mask,
@@ -196,6 +242,17 @@ Scalar sum(InputArray _src)
     Mat src = _src.getMat();
     CV_IPP_RUN(IPP_VERSION_X100 >= 700, ipp_sum(src, _res), _res);
 
+    ReduceStripes stripes(src);
+    if( stripes.count() > 1 )
+    {
+        std::vector<Scalar> partial;
+        stripes.run(partial, [&](int i) { return sum(stripes.stripe(src, i)); });
+        Scalar s;
+        for( size_t i = 0; i < partial.size(); i++ )
+            s += partial[i];
+        return s;
+    }
+
     int k, cn = src.channels(), depth = src.depth();
     SumFunc func = getSumFunc(depth);
     CV_Assert( cn <= 4 && func != 0 );
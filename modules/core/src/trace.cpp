@@ -6,6 +6,7 @@
 
 #include <opencv2/core/utils/trace.hpp>
 #include <opencv2/core/utils/trace.private.hpp>
+#include <opencv2/core/utils/trace_stats.hpp>
 #include <opencv2/core/utils/configuration.private.hpp>
 
 #include <opencv2/core/opencl/ocl_defs.hpp>
@@ -93,6 +94,10 @@ static const cv::String& getParameterTraceLocation()
 static bool param_synchronizeOpenCL = utils::getConfigurationParameterBool("OPENCV_TRACE_SYNC_OPENCL", false);
 #endif
 
+// sampling period of the latency statistics, 0 - disabled
+static std::atomic<int> g_latencySamplingPeriod((int)utils::getConfigurationParameterSizeT("OPENCV_TRACE_LATENCY", 0));
+static std::atomic<unsigned> g_latencyEpoch(0);
+
 #ifdef OPENCV_WITH_ITT
 static bool param_ITT_registerParentScope = utils::getConfigurationParameterBool("OPENCV_TRACE_ITT_PARENT", false);
 #endif
@@ -232,11 +237,22 @@ static bool isITTEnabled()
 #endif
 
 
+// the locations indexed by global_location_id - 1, guarded by the initialization mutex
+static std::vector<const Region::LocationStaticStorage*>& getLocations()
+{
+    static std::vector<const Region::LocationStaticStorage*> locations;
+    return locations;
+}
+
 Region::LocationExtraData::LocationExtraData(const LocationStaticStorage& location)
 {
     CV_UNUSED(location);
     static int g_location_id_counter = 0;
     global_location_id = CV_XADD(&g_location_id_counter, 1) + 1;
+    std::vector<const LocationStaticStorage*>& locations = getLocations();
+    if (locations.size() < (size_t)global_location_id)
+        locations.resize(global_location_id, NULL);
+    locations[global_location_id - 1] = &location;
     CV_LOG("Register location: " << global_location_id << " (" << (void*)&location << ")"
             << std::endl << "    file: " << location.filename
             << std::endl << "    line: " << location.line
@@ -438,10 +454,105 @@ void RegionStatisticsStatus::checkResetSkipMode(int leaveDepth)
     }
 }
 
+static int latencyBucket(uint64 t)
+{
+    if (t < 4)
+        return (int)t;
+    if ((t >> (LATENCY_MAX_SHIFT + 1)) != 0)
+        return LATENCY_BUCKETS - 1;
+#if defined __GNUC__
+    int k = 63 - __builtin_clzll((unsigned long long)t);
+#else
+    int k = 2;
+    while ((t >> (k + 1)) != 0)
+        k++;
+#endif
+    return (k - 1)*4 + (int)((t >> (k - 2)) & 3);
+}
+
+void LatencyData::clear(unsigned newEpoch)
+{
+    count.store(0, std::memory_order_relaxed);
+    totalTime.store(0, std::memory_order_relaxed);
+    maxTime.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+        histogram[i].store(0, std::memory_order_relaxed);
+    epoch.store(newEpoch, std::memory_order_release);
+}
+
+// The data has a single writer, so the loads and stores are not combined into the (locked) atomic
+// read-modify-write operations; the atomics only keep the concurrent snapshots well-defined.
+void LatencyData::add(uint64 duration)
+{
+    unsigned currentEpoch = g_latencyEpoch.load(std::memory_order_relaxed);
+    if (epoch.load(std::memory_order_relaxed) != currentEpoch)
+        clear(currentEpoch);
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totalTime.store(totalTime.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+    if (duration > maxTime.load(std::memory_order_relaxed))
+        maxTime.store(duration, std::memory_order_relaxed);
+    std::atomic<uint64>& h = histogram[latencyBucket(duration)];
+    h.store(h.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+LatencyData* LatencyThreadLocal::getData(int location_id)
+{
+    int c = location_id / LATENCY_CHUNK_SIZE;
+    if (location_id <= 0 || c >= LATENCY_MAX_CHUNKS)
+        return NULL;
+    LatencyData* chunk = chunks[c].load(std::memory_order_relaxed);
+    if (!chunk)
+    {
+        chunk = new LatencyData[LATENCY_CHUNK_SIZE];
+        chunks[c].store(chunk, std::memory_order_release);
+    }
+    return chunk + location_id % LATENCY_CHUNK_SIZE;
+}
+
+static inline LatencyThreadLocal& getLatencyThreadLocal()
+{
+    return getTraceManager().latency_tls.getRef();
+}
+
+// The sampled regions are stacked per thread, as the Region objects themselves are.
+// The regions closed by CV_TRACE_REGION_NEXT are not sampled: without the full trace
+// there is no way to find the region that is closed.
+static void beginLatencySample(Region& region, const Region::LocationStaticStorage& location)
+{
+    LatencyThreadLocal& tl = getLatencyThreadLocal();
+    if (--tl.sampleCountdown > 0)
+        return;
+    tl.sampleCountdown = g_latencySamplingPeriod.load(std::memory_order_relaxed);
+    if (tl.depth >= LATENCY_MAX_DEPTH)
+        return;
+    LatencyData* data = tl.getData(Region::LocationExtraData::init(location)->global_location_id);
+    if (!data)
+        return;
+    LatencyThreadLocal::Sample& sample = tl.samples[tl.depth++];
+    sample.data = data;
+    sample.beginTimestamp = getTimestamp();
+    region.implFlags |= REGION_FLAG__LATENCY_SAMPLE;
+}
+
+static void endLatencySample()
+{
+    int64 endTimestamp = getTimestamp();
+    LatencyThreadLocal& tl = getLatencyThreadLocal();
+    CV_DbgAssert(tl.depth > 0);
+    const LatencyThreadLocal::Sample& sample = tl.samples[--tl.depth];
+    sample.data->add((uint64)std::max(endTimestamp - sample.beginTimestamp, (int64)0));
+}
+
 Region::Region(const LocationStaticStorage& location) :
     pImpl(NULL),
     implFlags(0)
 {
+    if (g_latencySamplingPeriod.load(std::memory_order_relaxed) > 0 && !cv::__termination &&
+        (location.flags & REGION_FLAG_REGION_NEXT) == 0)
+    {
+        beginLatencySample(*this, location);
+    }
+
     // Checks:
     // - global enable flag
     // - parent region is disabled
@@ -599,6 +710,14 @@ void Region::destroy()
 {
     CV_DbgAssert(implFlags != 0);
 
+    if (implFlags & REGION_FLAG__LATENCY_SAMPLE)
+    {
+        endLatencySample();
+        implFlags &= ~REGION_FLAG__LATENCY_SAMPLE;
+        if (implFlags == 0)
+            return;
+    }
+
     TraceManagerThreadLocal& ctx = getTraceManager().tls.getRef();
     CV_LOG(_spaces(ctx.getCurrentDepth()*4) << "Region::destruct(): " << (void*)this << " pImpl=" << pImpl << " implFlags=" << implFlags << ' ' << (ctx.stackTopLocation() ? ctx.stackTopLocation()->name : "<unknown>"));
 
@@ -1152,4 +1271,126 @@ void traceArg(const TraceArg&, double) {};
 
 #endif
 
-}}}} // namespace
+} // namespace details
+
+uint64 RegionLatencyStatistics::getBucketLowerBound(int bucket)
+{
+    CV_Assert(bucket >= 0);
+    if (bucket < 4)
+        return (uint64)bucket;
+    int k = bucket/4 + 1;
+    return (uint64)(4 + bucket % 4) << (k - 2);
+}
+
+uint64 RegionLatencyStatistics::percentile(double q) const
+{
+    uint64 total = 0;
+    for (size_t i = 0; i < histogram.size(); i++)
+        total += histogram[i];
+    if (total == 0)
+        return 0;
+    uint64 target = std::max((uint64)std::ceil(std::min(std::max(q, 0.), 1.)*total), (uint64)1);
+    uint64 acc = 0;
+    for (size_t i = 0; i < histogram.size(); i++)
+    {
+        acc += histogram[i];
+        if (acc >= target)
+        {
+            // the upper bound of the bucket
+            if (i + 1 < histogram.size())
+                return std::min(getBucketLowerBound((int)i + 1) - 1, maxTime);
+            break;
+        }
+    }
+    return maxTime;
+}
+
+#ifdef OPENCV_TRACE
+
+void setLatencySampling(int samplingPeriod)
+{
+    CV_Assert(samplingPeriod >= 0);
+    details::g_latencySamplingPeriod.store(samplingPeriod);
+}
+
+int getLatencySampling()
+{
+    return details::g_latencySamplingPeriod.load();
+}
+
+void getLatencyStatistics(std::vector<RegionLatencyStatistics>& stats)
+{
+    using namespace details;
+    stats.clear();
+
+    std::vector<const Region::LocationStaticStorage*> locations;
+    {
+        cv::AutoLock lock(cv::getInitializationMutex());
+        locations = getLocations();
+    }
+    std::vector<LatencyThreadLocal*> threads;
+    getTraceManager().latency_tls.gather(threads);
+    unsigned epoch = g_latencyEpoch.load(std::memory_order_acquire);
+
+    std::vector<RegionLatencyStatistics> merged(locations.size());
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        if (!threads[t])
+            continue;
+        for (int c = 0; c < LATENCY_MAX_CHUNKS; c++)
+        {
+            const LatencyData* chunk = threads[t]->chunks[c].load(std::memory_order_acquire);
+            if (!chunk)
+                continue;
+            for (int j = 0; j < LATENCY_CHUNK_SIZE; j++)
+            {
+                size_t id = (size_t)c*LATENCY_CHUNK_SIZE + j;
+                const LatencyData& d = chunk[j];
+                if (id == 0 || id > locations.size() || d.epoch.load(std::memory_order_acquire) != epoch)
+                    continue;
+                uint64 count = d.count.load(std::memory_order_relaxed);
+                if (count == 0)
+                    continue;
+                RegionLatencyStatistics& r = merged[id - 1];
+                if (r.histogram.empty())
+                    r.histogram.resize(LATENCY_BUCKETS, 0);
+                r.count += count;
+                r.totalTime += d.totalTime.load(std::memory_order_relaxed);
+                r.maxTime = std::max(r.maxTime, (uint64)d.maxTime.load(std::memory_order_relaxed));
+                for (int i = 0; i < LATENCY_BUCKETS; i++)
+                    r.histogram[i] += d.histogram[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < merged.size(); i++)
+    {
+        const Region::LocationStaticStorage* location = locations[i];
+        if (merged[i].count == 0 || !location)
+            continue;
+        merged[i].name = location->name ? location->name : "";
+        merged[i].filename = location->filename ? location->filename : "";
+        merged[i].line = location->line;
+        stats.push_back(merged[i]);
+    }
+    std::sort(stats.begin(), stats.end(), [](const RegionLatencyStatistics& a, const RegionLatencyStatistics& b)
+    {
+        return a.totalTime > b.totalTime;
+    });
+}
+
+void resetLatencyStatistics()
+{
+    details::g_latencyEpoch++;
+}
+
+#else
+
+void setLatencySampling(int) {}
+int getLatencySampling() { return 0; }
+void getLatencyStatistics(std::vector<RegionLatencyStatistics>& stats) { stats.clear(); }
+void resetLatencyStatistics() {}
+
+#endif
+
+}}} // namespace
@@ -2455,5 +2455,192 @@ TEST(Core_MinMaxIdx, rows_overflow)
     }
 }
 
+static void runElemwiseOps(const Mat& a, const Mat& b, std::vector<Mat>& results)
+{
+    results.assign(9, Mat());
+    cv::add(a, b, results[0]);
+    cv::subtract(a, b, results[1]);
+    cv::multiply(a, b, results[2], 0.5);
+    cv::absdiff(a, b, results[3]);
+    cv::bitwise_xor(a, b, results[4]);
+    a.convertTo(results[5], CV_32F, 0.25, 3);
+    cv::convertScaleAbs(a, results[6], 2, -7);
+    std::vector<Mat> planes;
+    cv::split(a, planes);
+    cv::merge(planes, results[7]);
+    results[8] = planes.back();
+}
+
+TEST(Core_Arithm, parallel_large_arrays)
+{
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16SC4, CV_32FC1, CV_64FC2 };
+    const int nthreads = cv::getNumThreads();
+    RNG& rng = theRNG();
+
+    for( size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++ )
+    {
+        for( int roi = 0; roi < 2; roi++ )
+        {
+            SCOPED_TRACE(cv::format("type=%s roi=%d", typeToString(types[t]).c_str(), roi));
+            Size sz(1031, 677);
+            Mat a0(sz.height + 8, sz.width + 8, types[t]), b0(a0.size(), types[t]);
+            rng.fill(a0, RNG::UNIFORM, -100, 100);
+            rng.fill(b0, RNG::UNIFORM, -100, 100);
+            Rect r = roi ? Rect(Point(3, 5), sz) : Rect(Point(), a0.size());
+            Mat a = a0(r), b = b0(r);
+
+            std::vector<Mat> ref, res;
+            cv::setNumThreads(1);
+            runElemwiseOps(a, b, ref);
+            cv::setNumThreads(4);
+            runElemwiseOps(a, b, res);
+            cv::setNumThreads(nthreads);
+
+            for( size_t i = 0; i < ref.size(); i++ )
+                EXPECT_EQ(0, cvtest::norm(ref[i], res[i], NORM_INF)) << "op " << i;
+            EXPECT_EQ(0, cvtest::norm(res[7], a, NORM_INF));
+        }
+    }
+}
+
+static void runReductions(const Mat& a, const Mat& b, const Mat& mask, std::vector<double>& results)
+{
+    results.clear();
+    Scalar s = cv::sum(a), m = cv::mean(a, mask), mm, sd;
+    cv::meanStdDev(a, mm, sd, mask);
+    for( int k = 0; k < 4; k++ )
+    {
+        results.push_back(s[k]);
+        results.push_back(m[k]);
+        results.push_back(mm[k]);
+        results.push_back(sd[k]);
+    }
+    const int normTypes[] = { NORM_INF, NORM_L1, NORM_L2, NORM_L2SQR };
+    for( int k = 0; k < 4; k++ )
+    {
+        results.push_back(cv::norm(a, normTypes[k], mask));
+        results.push_back(cv::norm(a, b, normTypes[k], mask));
+    }
+    if( a.channels() == 1 )
+    {
+        double minVal = 0, maxVal = 0;
+        int minIdx[2] = {}, maxIdx[2] = {};
+        cv::minMaxIdx(a, &minVal, &maxVal, minIdx, maxIdx, mask);
+        results.push_back(minVal);
+        results.push_back(maxVal);
+        results.push_back(minIdx[0]*a.cols + minIdx[1]);
+        results.push_back(maxIdx[0]*a.cols + maxIdx[1]);
+        results.push_back(cv::countNonZero(a));
+    }
+    if( a.depth() == CV_32S )
+        return;
+    Mat r0, r1;
+    cv::reduce(a, r0, 0, REDUCE_SUM, CV_64F);
+    cv::reduce(a, r1, 1, REDUCE_MAX);
+    results.push_back(cv::sum(r0)[0]);
+    results.push_back(cv::sum(r1)[0]);
+}
+
+TEST(Core_Reductions, parallel_deterministic)
+{
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16SC1, CV_32SC1, CV_32FC1, CV_64FC4 };
+    const int nthreads = cv::getNumThreads();
+    RNG& rng = theRNG();
+
+    for( size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++ )
+    {
+        for( int roi = 0; roi < 2; roi++ )
+        {
+            for( int useMask = 0; useMask < 2; useMask++ )
+            {
+                SCOPED_TRACE(cv::format("type=%s roi=%d mask=%d", typeToString(types[t]).c_str(), roi, useMask));
+                Size sz(1289, 743);
+                Mat a0(sz.height + 4, sz.width + 4, types[t]), b0(a0.size(), types[t]), mask0(a0.size(), CV_8U);
+                rng.fill(a0, RNG::UNIFORM, -100, 100);
+                rng.fill(b0, RNG::UNIFORM, -100, 100);
+                rng.fill(mask0, RNG::UNIFORM, 0, 2);
+                Rect r = roi ? Rect(Point(1, 2), sz) : Rect(Point(), a0.size());
+                Mat a = a0(r), b = b0(r), mask = useMask ? mask0(r) : Mat();
+
+                std::vector<double> ref, res;
+                cv::setNumThreads(1);
+                runReductions(a, b, mask, ref);
+                cv::setNumThreads(4);
+                runReductions(a, b, mask, res);
+                cv::setNumThreads(nthreads);
+
+                ASSERT_EQ(ref.size(), res.size());
+                for( size_t i = 0; i < ref.size(); i++ )
+                    EXPECT_EQ(ref[i], res[i]) << "result " << i;
+
+                if( CV_MAT_DEPTH(types[t]) <= CV_32S )
+                {
+                    // the integer sums are exact
+                    Mat a64;
+                    a.convertTo(a64, CV_64F);
+                    Scalar s;
+                    for( int y = 0; y < a64.rows; y++ )
+                        for( int x = 0; x < a64.cols*a64.channels(); x++ )
+                            s[x % a64.channels()] += a64.ptr<double>(y)[x];
+                    EXPECT_EQ(s, cv::sum(a));
+                }
+            }
+        }
+    }
+}
+
+TEST(Core_ComputeStatistics, same_as_separate_functions)
+{
+    const int types[] = { CV_8UC1, CV_8SC2, CV_16UC1, CV_16SC3, CV_32SC1, CV_32FC4, CV_64FC1 };
+    RNG& rng = theRNG();
+
+    for( size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++ )
+    {
+        for( int useMask = 0; useMask < 3; useMask++ )
+        {
+            SCOPED_TRACE(cv::format("type=%s mask=%d", typeToString(types[t]).c_str(), useMask));
+            int type = types[t], cn = CV_MAT_CN(type);
+            Mat src(811, 1303, type), mask;
+            rng.fill(src, RNG::UNIFORM, -1000, 1000);
+            src.rowRange(0, 100).setTo(Scalar::all(0));
+            if( useMask == 1 )
+            {
+                mask.create(src.size(), CV_8U);
+                rng.fill(mask, RNG::UNIFORM, 0, 2);
+            }
+            else if( useMask == 2 )
+                mask = Mat::zeros(src.size(), CV_8U);
+
+            Mat mean, sdv, minVal, maxVal, nonZero;
+            cv::computeStatistics(src, mean, sdv, minVal, maxVal, nonZero, mask);
+            ASSERT_EQ(Size(1, cn), mean.size());
+            ASSERT_EQ(CV_64FC1, nonZero.type());
+
+            Scalar refMean, refSdv;
+            cv::meanStdDev(src, refMean, refSdv, mask);
+            std::vector<Mat> planes;
+            cv::split(src, planes);
+            for( int k = 0; k < cn; k++ )
+            {
+                double refMin = 0, refMax = 0;
+                cv::minMaxLoc(planes[k], &refMin, &refMax, 0, 0, mask);
+                Mat selected;
+                if( !mask.empty() )
+                {
+                    selected.create(planes[k].size(), planes[k].type());
+                    selected.setTo(Scalar::all(0));
+                    planes[k].copyTo(selected, mask);
+                }
+                else
+                    selected = planes[k];
+                EXPECT_NEAR(refMean[k], mean.at<double>(k), 1e-6*(1 + fabs(refMean[k])));
+                EXPECT_NEAR(refSdv[k], sdv.at<double>(k), 1e-6*(1 + fabs(refSdv[k])));
+                EXPECT_EQ(refMin, minVal.at<double>(k));
+                EXPECT_EQ(refMax, maxVal.at<double>(k));
+                EXPECT_EQ(cv::countNonZero(selected), nonZero.at<double>(k));
+            }
+        }
+    }
+}
 
 }} // namespace
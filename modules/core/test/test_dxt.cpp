@@ -983,4 +983,75 @@ protected:
 TEST(Core_DFT, reverse) { Core_DXTReverseTest test(Core_DXTReverseTest::ModeDFT); test.safe_run(); }
 TEST(Core_DCT, reverse) { Core_DXTReverseTest test(Core_DXTReverseTest::ModeDCT); test.safe_run(); }
 
+typedef testing::TestWithParam<tuple<MatType, int> > Core_DFTPlan;
+
+TEST_P(Core_DFTPlan, matches_dft)
+{
+    const int type = get<0>(GetParam());
+    const int flags = get<1>(GetParam());
+    const int nthreads = cv::getNumThreads();
+    cv::setNumThreads(4);
+
+    RNG& rng = theRNG();
+    const Size sizes[] = { Size(1, 1), Size(17, 1), Size(64, 48), Size(300, 127), Size(512, 512) };
+    for (size_t si = 0; si < sizeof(sizes)/sizeof(sizes[0]); si++)
+    {
+        const Size sz = sizes[si];
+        const int nonzeroRows = sz.height > 2 ? sz.height / 3 : 0;
+        SCOPED_TRACE(cv::format("size=%dx%d", sz.width, sz.height));
+
+        Ptr<DFTPlan> plan = DFTPlan::create(sz, type, flags, nonzeroRows);
+        ASSERT_EQ(sz, plan->getSize());
+        ASSERT_EQ(type, plan->getType());
+        ASSERT_EQ(flags, plan->getFlags());
+
+        std::vector<Mat> src(5), expected(5);
+        for (size_t i = 0; i < src.size(); i++)
+        {
+            src[i].create(sz, type);
+            cvtest::randUni(rng, src[i], Scalar::all(-1.), Scalar::all(1.));
+            cv::dft(src[i], expected[i], flags, nonzeroRows);
+        }
+        ASSERT_EQ(expected[0].type(), plan->getDstType());
+
+        Mat dst;
+        plan->apply(src[0], dst);
+        EXPECT_EQ(0, cvtest::norm(expected[0], dst, NORM_INF));
+
+        // in-place and non-continuous arrays use their own transform contexts
+        if (plan->getDstType() == type)
+        {
+            Mat inplace = src[1].clone();
+            plan->apply(inplace, inplace);
+            EXPECT_EQ(0, cvtest::norm(expected[1], inplace, NORM_INF));
+        }
+        Mat big(sz.height + 2, sz.width + 3, type, Scalar::all(0));
+        Mat roi = big(Rect(1, 1, sz.width, sz.height));
+        src[2].copyTo(roi);
+        plan->apply(roi, dst);
+        EXPECT_EQ(0, cvtest::norm(expected[2], dst, NORM_INF));
+
+        std::vector<Mat> batch;
+        plan->applyBatch(src, batch);
+        ASSERT_EQ(src.size(), batch.size());
+        for (size_t i = 0; i < src.size(); i++)
+            EXPECT_EQ(0, cvtest::norm(expected[i], batch[i], NORM_INF)) << "item " << i;
+    }
+
+    cv::setNumThreads(nthreads);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Core_DFTPlan, testing::Combine(
+    testing::Values(CV_32FC1, CV_32FC2, CV_64FC1, CV_64FC2),
+    testing::Values(0, (int)DFT_ROWS, (int)DFT_COMPLEX_OUTPUT, (int)(DFT_INVERSE | DFT_SCALE),
+                    (int)(DFT_ROWS | DFT_INVERSE | DFT_SCALE))));
+
+TEST(Core_DFTPlan_Args, wrong_size)
+{
+    Ptr<DFTPlan> plan = DFTPlan::create(Size(16, 16), CV_32FC1);
+    Mat src(Size(16, 8), CV_32FC1, Scalar::all(1)), dst;
+    EXPECT_THROW(plan->apply(src, dst), cv::Exception);
+    EXPECT_THROW(DFTPlan::create(Size(16, 16), CV_8UC1), cv::Exception);
+}
+
 }} // namespace
@@ -757,27 +757,27 @@ TEST(Core_InputOutput, filestorage_base64_basic_read_JSON)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".json", false);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_rw_XML)
+TEST(Core_InputOutput, filestorage_base64_basic_rw_XML)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".xml", true);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_rw_YAML)
+TEST(Core_InputOutput, filestorage_base64_basic_rw_YAML)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".yml", true);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_rw_JSON)
+TEST(Core_InputOutput, filestorage_base64_basic_rw_JSON)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".json", true);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_memory_XML)
+TEST(Core_InputOutput, filestorage_base64_basic_memory_XML)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".xml", true, true);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_memory_YAML)
+TEST(Core_InputOutput, filestorage_base64_basic_memory_YAML)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".yml", true, true);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_memory_JSON)
+TEST(Core_InputOutput, filestorage_base64_basic_memory_JSON)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".json", true, true);
 }
@@ -1811,4 +1811,111 @@ TEST(Core_InputOutput, FileStorage_copy_constructor_17412_heap)
     EXPECT_EQ(0, remove(fname.c_str()));
 }
 
+typedef testing::TestWithParam<std::string> FileStorage_readNodes;
+
+TEST_P(FileStorage_readNodes, matches_open)
+{
+    std::string fname = tempfile(GetParam().c_str());
+    RNG& rng = theRNG();
+    Mat m8u(300, 200, CV_8UC3), m32f(120, 170, CV_32F), m16s(50, 40, CV_16SC2);
+    rng.fill(m8u, RNG::UNIFORM, 0, 256);
+    rng.fill(m32f, RNG::UNIFORM, -1, 1);
+    rng.fill(m16s, RNG::UNIFORM, -30000, 30000);
+    std::vector<Point3f> pts(1000);
+    for (size_t i = 0; i < pts.size(); i++)
+        pts[i] = Point3f(rng.uniform(-1.f, 1.f), rng.uniform(-1.f, 1.f), (float)i);
+
+    for (int base64 = 0; base64 < 2; base64++)
+    {
+        SCOPED_TRACE(base64 ? "base64" : "text");
+        {
+            FileStorage fs(fname, base64 ? FileStorage::WRITE_BASE64 : FileStorage::WRITE);
+            fs << "name" << "model";
+            fs << "m8u" << m8u;
+            fs << "params" << "{" << "alpha" << 0.5 << "n" << 7 << "sub" << "{" << "m16s" << m16s << "}" << "}";
+            fs << "pts" << pts;
+            fs << "m32f" << m32f;
+            fs << "last" << 42;
+        }
+
+        std::vector<std::string> names;
+        Mat r8u, r32f, r16s;
+        std::vector<Point3f> rpts;
+        double alpha = 0;
+        int n = 0, last = 0;
+        std::string name;
+        ASSERT_TRUE(FileStorage::readNodes(fname, [&](const FileNode& node)
+        {
+            names.push_back(node.name());
+            if (node.name() == "name")
+                node >> name;
+            else if (node.name() == "m8u")
+                node >> r8u;
+            else if (node.name() == "params")
+            {
+                node["alpha"] >> alpha;
+                node["n"] >> n;
+                node["sub"]["m16s"] >> r16s;
+            }
+            else if (node.name() == "pts")
+                node >> rpts;
+            else if (node.name() == "m32f")
+                r32f = node.mat();
+            else if (node.name() == "last")
+                last = (int)node;
+        }));
+
+        std::vector<std::string> expected_names;
+        FileStorage fs(fname, FileStorage::READ);
+        expected_names = fs.root().keys();
+        EXPECT_EQ(expected_names, names);
+        EXPECT_EQ("model", name);
+        EXPECT_EQ(0.5, alpha);
+        EXPECT_EQ(7, n);
+        EXPECT_EQ(42, last);
+        EXPECT_EQ(0, cvtest::norm(m8u, r8u, NORM_INF));
+        EXPECT_EQ(0, cvtest::norm(m16s, r16s, NORM_INF));
+        EXPECT_LE(cvtest::norm(m32f, r32f, NORM_INF), 1e-6);
+        EXPECT_LE(cvtest::norm(Mat(pts).reshape(1), Mat(rpts).reshape(1), NORM_INF), 1e-6);
+
+        Mat o32f, o16s;
+        fs["m32f"] >> o32f;
+        fs["params"]["sub"]["m16s"] >> o16s;
+        EXPECT_EQ(0, cvtest::norm(r32f, o32f, NORM_INF));
+        EXPECT_EQ(0, cvtest::norm(r16s, o16s, NORM_INF));
+    }
+    EXPECT_EQ(0, remove(fname.c_str()));
+}
+
+INSTANTIATE_TEST_CASE_P(Core_InputOutput, FileStorage_readNodes, testing::Values(".yml", ".xml", ".json", ".yml.gz"));
+
+TEST(Core_InputOutput, FileStorage_readNodes_memory_multiple_documents)
+{
+    const std::string content =
+        "%YAML:1.0\n"
+        "---\n"
+        "a: 1\n"
+        "b: [ 1, 2, 3 ]\n"
+        "...\n"
+        "---\n"
+        "c: { d: 4.5 }\n";
+    std::vector<std::string> names;
+    std::vector<int> sizes;
+    ASSERT_TRUE(FileStorage::readNodes(content, [&](const FileNode& node)
+        {
+            names.push_back(node.name());
+            sizes.push_back((int)node.size());
+        }, FileStorage::READ | FileStorage::MEMORY));
+    ASSERT_EQ(3u, names.size());
+    EXPECT_EQ("a", names[0]);
+    EXPECT_EQ("b", names[1]);
+    EXPECT_EQ("c", names[2]);
+    EXPECT_EQ(3, sizes[1]);
+    EXPECT_EQ(1, sizes[2]);
+
+    // the exceptions thrown by the callback abort the reading
+    EXPECT_ANY_THROW(FileStorage::readNodes(content, [&](const FileNode&) { throw std::runtime_error("stop"); },
+                                            FileStorage::READ | FileStorage::MEMORY));
+}
+
 }} // namespace
@@ -2,6 +2,7 @@
 // It is subject to the license terms in the LICENSE file found in the top-level directory
 // of this distribution and at http://opencv.org/license.html.
 #include "test_precomp.hpp"
+#include "opencv2/core/utils/allocator_stats.hpp"
 
 #ifdef HAVE_EIGEN
 #include <Eigen/Core>
@@ -2203,4 +2204,104 @@ TEST(Mat, regression_18473)
 }
 
 
+TEST(Core_PoolAllocator, reuse_and_statistics)
+{
+    MatAllocator* pool = Mat::getPoolAllocator();
+    BufferPoolController* controller = pool->getBufferPoolController();
+    utils::PoolAllocatorStatisticsInterface& stats = utils::getPoolAllocatorStatistics();
+    controller->freeAllReservedBuffers();
+    {
+        MatAllocatorScope scope(pool);
+        uint64_t hits0 = stats.getNumberOfHits(), misses0 = stats.getNumberOfMisses();
+
+        Mat a(480, 640, CV_8UC3);
+        ASSERT_EQ(pool, a.u->currAllocator);
+        const uchar* data = a.data;
+        EXPECT_LE((uint64_t)a.total()*a.elemSize(), stats.getCurrentUsage());
+        a.release();
+        EXPECT_EQ(0u, stats.getCurrentUsage());
+        EXPECT_LT(0u, controller->getReservedSize());
+
+        // a slightly different size falls into the same size class
+        Mat b(479, 641, CV_8UC3);
+        EXPECT_EQ(data, b.data);
+        EXPECT_EQ(hits0 + 1, stats.getNumberOfHits());
+        EXPECT_EQ(misses0 + 1, stats.getNumberOfMisses());
+        b.setTo(Scalar::all(7));
+        EXPECT_EQ(0, cvtest::norm(b, Mat(b.size(), b.type(), Scalar::all(7)), NORM_INF));
+
+        {
+            MatAllocatorScope nested(Mat::getStdAllocator());
+            Mat c(10, 10, CV_8U);
+            EXPECT_EQ(Mat::getStdAllocator(), c.u->currAllocator);
+        }
+        Mat d(10, 10, CV_8U);
+        EXPECT_EQ(pool, d.u->currAllocator);
+
+        // user data is not owned by the pool
+        uchar buf[16];
+        Mat e(4, 4, CV_8U, buf);
+        EXPECT_EQ(buf, e.data);
+    }
+    Mat f(10, 10, CV_8U);
+    EXPECT_NE(pool, f.u->currAllocator);
+
+    controller->freeAllReservedBuffers();
+    EXPECT_EQ(0u, controller->getReservedSize());
+    EXPECT_EQ(0u, stats.getCurrentUsage());
+}
+
+TEST(Core_PoolAllocator, reserved_size_limit)
+{
+    MatAllocator* pool = Mat::getPoolAllocator();
+    BufferPoolController* controller = pool->getBufferPoolController();
+    size_t maxReserved = controller->getMaxReservedSize();
+    controller->setMaxReservedSize(1 << 20);
+    {
+        MatAllocatorScope scope(pool);
+        std::vector<Mat> mats;
+        for (int i = 0; i < 8; i++)
+            mats.push_back(Mat(512, 512, CV_8U)); // 256KB
+        mats.clear();
+        EXPECT_EQ((size_t)1 << 20, controller->getReservedSize());
+
+        Mat large(8193, 8192, CV_8U); // too large to be pooled
+        large.release();
+        EXPECT_EQ((size_t)1 << 20, controller->getReservedSize());
+    }
+    controller->setMaxReservedSize(maxReserved);
+    controller->freeAllReservedBuffers();
+    EXPECT_EQ(0u, controller->getReservedSize());
+}
+
+TEST(Core_PoolAllocator, default_allocator_in_parallel)
+{
+    MatAllocator* prev = Mat::getDefaultAllocator();
+    const int nthreads = cv::getNumThreads();
+    Mat::setDefaultAllocator(Mat::getPoolAllocator());
+    cv::setNumThreads(4);
+    int errors = 0;
+    Mutex mutex;
+    parallel_for_(Range(0, 64), [&](const Range& r)
+    {
+        for (int i = r.start; i < r.end; i++)
+        {
+            std::vector<Mat> mats;
+            for (int k = 0; k < 16; k++)
+                mats.push_back(Mat(16 + (i*7 + k*13) % 200, 16 + k*5, CV_32SC1, Scalar::all(i*16 + k)));
+            int err = 0;
+            for (int k = 0; k < 16; k++)
+                err += countNonZero(mats[k] != i*16 + k);
+            AutoLock lock(mutex);
+            errors += err;
+        }
+    });
+    cv::setNumThreads(nthreads);
+    Mat::setDefaultAllocator(prev);
+    EXPECT_EQ(0, errors);
+    EXPECT_EQ(0u, utils::getPoolAllocatorStatistics().getCurrentUsage());
+    Mat::getPoolAllocator()->getBufferPoolController()->freeAllReservedBuffers();
+}
+
+
 }} // namespace
@@ -2761,6 +2761,70 @@ TEST(Core_SolvePoly, accuracy) { Core_SolvePolyTest test; test.safe_run(); }
 TEST(Core_Phase, accuracy32f) { Core_PhaseTest test(CV_32FC1); test.safe_run(); }
 TEST(Core_Phase, accuracy64f) { Core_PhaseTest test(CV_64FC1); test.safe_run(); }
 
+TEST(Core_GEMM, blocked_large)
+{
+    const int types[] = { CV_32F, CV_64F };
+    const int flagsList[] = { 0, GEMM_1_T, GEMM_2_T, GEMM_1_T | GEMM_2_T, GEMM_3_T };
+    const int sizes[][3] = { { 131, 67, 517 }, { 300, 257, 64 }, { 17, 1000, 33 } }; // m, n, k
+    int threads = getNumThreads();
+    RNG& rng = theRNG();
+    for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++)
+    {
+        for (size_t f = 0; f < sizeof(flagsList)/sizeof(flagsList[0]); f++)
+        {
+            for (size_t s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++)
+            {
+                int type = types[t], flags = flagsList[f];
+                int m = sizes[s][0], n = sizes[s][1], k = sizes[s][2];
+                Mat a = (flags & GEMM_1_T) ? Mat(k, m, type) : Mat(m, k, type);
+                Mat b = (flags & GEMM_2_T) ? Mat(n, k, type) : Mat(k, n, type);
+                Mat c = (flags & GEMM_3_T) ? Mat(n, m, type) : Mat(m, n, type);
+                rng.fill(a, RNG::UNIFORM, -1, 1);
+                rng.fill(b, RNG::UNIFORM, -1, 1);
+                rng.fill(c, RNG::UNIFORM, -1, 1);
+
+                Mat ref, a64, b64, c64;
+                a.convertTo(a64, CV_64F);
+                b.convertTo(b64, CV_64F);
+                c.convertTo(c64, CV_64F);
+                cvtest::gemm(a64, b64, 0.75, c64, -1.25, ref, flags);
+                ref.convertTo(ref, type);
+
+                setNumThreads(1);
+                Mat d1;
+                cv::gemm(a, b, 0.75, c, -1.25, d1, flags);
+                setNumThreads(4);
+                Mat d4;
+                cv::gemm(a, b, 0.75, c, -1.25, d4, flags);
+                setNumThreads(threads);
+
+                double eps = type == CV_32F ? 1e-5*k : 1e-12*k;
+                EXPECT_LE(cvtest::norm(d1, ref, NORM_INF, noArray()), eps) << "type=" << type << " flags=" << flags << " m=" << m;
+                EXPECT_EQ(0, cvtest::norm(d1, d4, NORM_INF)) << "type=" << type << " flags=" << flags << " m=" << m;
+            }
+        }
+    }
+}
+
+TEST(Core_GEMM, blocked_long_32f)
+{
+    // summed in float over the whole K, the error would be about 3e-6
+    const int m = 70, n = 45, k = 4096;
+    Mat a(m, k, CV_32F), b(k, n, CV_32F);
+    theRNG().fill(a, RNG::UNIFORM, 0, 1);
+    theRNG().fill(b, RNG::UNIFORM, 0, 1);
+
+    Mat a64, b64, ref;
+    a.convertTo(a64, CV_64F);
+    b.convertTo(b64, CV_64F);
+    cv::gemm(a64, b64, 1, noArray(), 0, ref);
+
+    Mat d, d64;
+    cv::gemm(a, b, 1, noArray(), 0, d);
+    d.convertTo(d64, CV_64F);
+    EXPECT_LE(cvtest::norm(d64, ref, NORM_INF | NORM_RELATIVE), 1e-6);
+}
+
 TEST(Core_SVD, flt)
 {
     float a[] = {
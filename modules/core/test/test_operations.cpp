@@ -1489,10 +1489,95 @@ INSTANTIATE_TEST_CASE_P(Core, sortIdx, Combine(
         Values(CV_8U, CV_8S, CV_16S, CV_32S, CV_32F, CV_64F), // depth
         Values(SORT_EVERY_COLUMN, SORT_EVERY_ROW),
         Values(SORT_ASCENDING, SORT_DESCENDING),
-        Values(Size(3, 3), Size(16, 8)),
+        Values(Size(3, 3), Size(16, 8), Size(100, 70)),
         ::testing::Bool()
 ));
 
+// the result of sortIdx is stable, so it is compared with the exact reference
+template<typename T> static void sortReference(const Mat& src, Mat& dstValues, Mat& dstIdx, int flags)
+{
+    bool sortRows = (flags & 1) == SORT_EVERY_ROW;
+    bool descending = (flags & SORT_DESCENDING) != 0;
+    Mat s = sortRows ? src : src.t();
+    Mat v(s.size(), s.type()), idx(s.size(), CV_32S);
+    for (int i = 0; i < s.rows; i++)
+    {
+        const T* sptr = s.ptr<T>(i);
+        int* iptr = idx.ptr<int>(i);
+        for (int j = 0; j < s.cols; j++)
+            iptr[j] = j;
+        std::stable_sort(iptr, iptr + s.cols, [&](int a, int b)
+        {
+            return descending ? sptr[b] < sptr[a] : sptr[a] < sptr[b];
+        });
+        for (int j = 0; j < s.cols; j++)
+            v.at<T>(i, j) = sptr[iptr[j]];
+    }
+    dstValues = sortRows ? v : Mat(v.t());
+    dstIdx = sortRows ? idx : Mat(idx.t());
+}
+
+typedef testing::TestWithParam<tuple<MatDepth, Size, int> > Core_sort_radix;
+
+TEST_P(Core_sort_radix, matches_stable_sort)
+{
+    int depth = get<0>(GetParam());
+    Size size = get<1>(GetParam());
+    int nthreads = get<2>(GetParam());
+    int prevThreads = getNumThreads();
+    setNumThreads(nthreads);
+
+    RNG& rng = theRNG();
+    Mat src(size, CV_MAKETYPE(depth, 1));
+    // a narrow range gives many equal keys, which checks the stability
+    cvtest::randUni(rng, src, Scalar::all(depth == CV_8U || depth == CV_16U ? 0 : -1000), Scalar::all(1000));
+    if (depth == CV_32F || depth == CV_64F)
+    {
+        Mat tmp;
+        src.convertTo(tmp, CV_64F, 0.01);
+        tmp.at<double>(0) = -0.;
+        tmp.at<double>(1) = std::numeric_limits<double>::infinity();
+        tmp.at<double>(2) = -std::numeric_limits<double>::infinity();
+        tmp.at<double>(3) = 1e-30;
+        tmp.at<double>(4) = -1e-30;
+        tmp.convertTo(src, depth);
+    }
+
+    const int flagsList[] = { SORT_EVERY_ROW | SORT_ASCENDING, SORT_EVERY_ROW | SORT_DESCENDING,
+                              SORT_EVERY_COLUMN | SORT_ASCENDING, SORT_EVERY_COLUMN | SORT_DESCENDING };
+    for (size_t k = 0; k < sizeof(flagsList)/sizeof(flagsList[0]); k++)
+    {
+        int flags = flagsList[k];
+        SCOPED_TRACE(cv::format("flags=%d", flags));
+        Mat refValues, refIdx, values, idx;
+        switch (depth)
+        {
+        case CV_8U: sortReference<uchar>(src, refValues, refIdx, flags); break;
+        case CV_8S: sortReference<schar>(src, refValues, refIdx, flags); break;
+        case CV_16U: sortReference<ushort>(src, refValues, refIdx, flags); break;
+        case CV_16S: sortReference<short>(src, refValues, refIdx, flags); break;
+        case CV_32S: sortReference<int>(src, refValues, refIdx, flags); break;
+        case CV_32F: sortReference<float>(src, refValues, refIdx, flags); break;
+        case CV_64F: sortReference<double>(src, refValues, refIdx, flags); break;
+        }
+        cv::sort(src, values, flags);
+        cv::sortIdx(src, idx, flags);
+        EXPECT_EQ(0, cvtest::norm(refValues, values, NORM_INF));
+        EXPECT_EQ(0, cvtest::norm(refIdx, idx, NORM_INF));
+
+        Mat inplace = src.clone();
+        cv::sort(inplace, inplace, flags);
+        EXPECT_EQ(0, cvtest::norm(refValues, inplace, NORM_INF));
+    }
+    setNumThreads(prevThreads);
+}
+
+INSTANTIATE_TEST_CASE_P(Core, Core_sort_radix, Combine(
+        Values(CV_8U, CV_8S, CV_16U, CV_16S, CV_32S, CV_32F, CV_64F),
+        Values(Size(1000, 30), Size(100000, 2)),
+        Values(1, 4)
+));
+
 
 TEST(Core_sortIdx, regression_8941)
 {
@@ -1551,4 +1636,91 @@ TEST(Core_MatExpr, empty_check_15760)
     EXPECT_THROW(Mat c = Mat().cross(Mat()), cv::Exception);
 }
 
+static void checkFusedExpr(const MatExpr& e, const Mat& ref)
+{
+    Mat res = e;
+    ASSERT_EQ(ref.type(), res.type());
+    ASSERT_EQ(ref.size(), res.size());
+    EXPECT_EQ(0, cvtest::norm(res, ref, NORM_INF));
+}
+
+TEST(Core_MatExpr, fused_elementwise)
+{
+    RNG& rng = theRNG();
+    const int depths[] = { CV_8U, CV_16S, CV_32S, CV_32F, CV_64F };
+    for (size_t di = 0; di < sizeof(depths)/sizeof(depths[0]); di++)
+    {
+        for (int cn = 1; cn <= 3; cn += 2)
+        {
+            int depth = depths[di], type = CV_MAKETYPE(depth, cn);
+            SCOPED_TRACE(cv::format("type=%d", type));
+            Size sz(100 + rng.uniform(0, 100), 50 + rng.uniform(0, 20));
+            Mat a(sz, type), b(sz, type), c(sz, type);
+            cvtest::randUni(rng, a, Scalar::all(0), Scalar::all(200));
+            cvtest::randUni(rng, b, Scalar::all(0), Scalar::all(200));
+            cvtest::randUni(rng, c, Scalar::all(-3), Scalar::all(3));
+            Scalar mean(90.5, 110, -20), bias(7, 3.25, 1);
+
+            // the reference computes every operation separately, in the same way
+            Mat t1 = a - mean, t2 = t1.mul(c), ref = t2 + b;
+            checkFusedExpr((a - mean).mul(c) + b, ref);
+
+            t1 = abs(a - b), t2 = max(t1, c), ref = min(t2, a);
+            checkFusedExpr(min(max(abs(a - b), c), a), ref);
+
+            MatExpr cmp1 = a > b, cmp2 = a <= c;
+            t1 = cmp1, t2 = cmp2, ref = t1*0.5 + t2*0.5;
+            checkFusedExpr(cmp1*0.5 + cmp2*0.5, ref);
+
+            t1 = a*0.5 - b, t2 = t1 + bias, ref = t2.mul(c, 2);
+            checkFusedExpr((a*0.5 - b + bias).mul(c, 2), ref);
+
+            // the scale of a divisor is moved to the quotient as without the fusion
+            t1 = a + b;
+            cv::divide(t1, c, ref, 1./3);
+            checkFusedExpr((a + b) / (c*3), ref);
+
+            t1 = a - b, ref = 100 / t1;
+            checkFusedExpr(100 / (a - b), ref);
+
+            // the sub-arrays of a fused expression are the fused sub-arrays of its operands
+            Rect roi(3, 5, sz.width - 10, sz.height - 7);
+            t1 = a.mul(b), t2 = t1 - c;
+            checkFusedExpr((a.mul(b) - c)(roi), t2(roi));
+
+            // the result can be written to one of the operands
+            t1 = a - b, t2 = t1.mul(c), ref = t2 + a;
+            Mat a1 = a.clone();
+            a1 = (a1 - b).mul(c) + a1;
+            EXPECT_EQ(0, cvtest::norm(a1, ref, NORM_INF));
+
+            // and converted to another type in the same pass
+            if (cn == 1)
+            {
+                Mat_<double> r64 = (a - b).mul(c) + a;
+                Mat ref64;
+                ref.convertTo(ref64, CV_64F);
+                EXPECT_EQ(0, cvtest::norm(r64, ref64, NORM_INF));
+            }
+        }
+    }
+}
+
+TEST(Core_MatExpr, fused_elementwise_fallback)
+{
+    Mat a(10, 20, CV_8UC1, Scalar(100)), b(10, 20, CV_8UC1, Scalar(30));
+    Mat af, bf;
+    a.convertTo(af, CV_32F);
+    b.convertTo(bf, CV_32F);
+
+    // the bitwise operations are evaluated one by one
+    EXPECT_EQ(0, cvtest::norm(Mat((a - b) & b), Mat(a.size(), CV_8U, Scalar(70 & 30)), NORM_INF));
+
+    // the operands of the comparisons are computed before the comparison
+    EXPECT_EQ(0, cvtest::norm(Mat(abs(b - a) > 60), Mat(a.size(), CV_8U, Scalar(255)), NORM_INF));
+
+    // the operands of different types are not fused and keep being rejected
+    EXPECT_THROW(Mat c = (af - bf).mul(b), cv::Exception);
+}
+
 }} // namespace
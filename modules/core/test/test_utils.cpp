@@ -7,9 +7,16 @@
 #define CV_LOG_STRIP_LEVEL CV_LOG_LEVEL_VERBOSE + 1
 #include "opencv2/core/utils/logger.hpp"
 #include "opencv2/core/utils/buffer_area.private.hpp"
+#include "opencv2/core/utils/trace_stats.hpp"
 
 #include "test_utils_tls.impl.hpp"
 
+namespace cv {
+// alloc.cpp
+CV_EXPORTS void* testLargeBufferMalloc(size_t size, int hugePages, int numa, size_t threshold);
+CV_EXPORTS bool testLargeBufferFree(void* ptr);
+}
+
 namespace opencv_test { namespace {
 
 static const char * const keys =
@@ -496,5 +503,140 @@ TEST_P(BufferArea, bad)
 
 INSTANTIATE_TEST_CASE_P(/**/, BufferArea, testing::Values(true, false));
 
+static int latencyTracedFunction(int v)
+{
+    CV_TRACE_FUNCTION();
+    return v*3 + 1;
+}
+
+static const utils::trace::RegionLatencyStatistics* findLatencyStatistics(
+        const std::vector<utils::trace::RegionLatencyStatistics>& stats, const char* name)
+{
+    for (size_t i = 0; i < stats.size(); i++)
+        if (stats[i].name.find(name) != std::string::npos)
+            return &stats[i];
+    return NULL;
+}
+
+TEST(Core_Trace, latency_statistics)
+{
+    using namespace cv::utils::trace;
+#if defined(OPENCV_DISABLE_TRACE)
+    throw SkipTestException("The trace is disabled");
+#endif
+    int prevSampling = getLatencySampling();
+    setLatencySampling(1);
+    resetLatencyStatistics();
+
+    int sum = 0;
+    for (int i = 0; i < 100; i++)
+        sum += latencyTracedFunction(i);
+    parallel_for_(Range(0, 64), [](const Range& r)
+    {
+        for (int i = r.start; i < r.end; i++)
+        {
+            CV_TRACE_REGION("test_latency_parallel_region");
+        }
+    });
+
+    std::vector<RegionLatencyStatistics> stats;
+    getLatencyStatistics(stats);
+    const RegionLatencyStatistics* f = findLatencyStatistics(stats, "latencyTracedFunction");
+    ASSERT_TRUE(f != NULL);
+    EXPECT_EQ(100u, f->count);
+    EXPECT_NE(std::string::npos, f->filename.find("test_utils.cpp"));
+    uint64 histogramSum = 0;
+    for (size_t i = 0; i < f->histogram.size(); i++)
+        histogramSum += f->histogram[i];
+    EXPECT_EQ(100u, histogramSum);
+    EXPECT_LE(f->maxTime, f->totalTime);
+    EXPECT_LE(f->percentile(0.5), f->percentile(0.99));
+    EXPECT_EQ(f->maxTime, f->percentile(1.0));
+
+    const RegionLatencyStatistics* r = findLatencyStatistics(stats, "test_latency_parallel_region");
+    ASSERT_TRUE(r != NULL);
+    EXPECT_EQ(64u, r->count);
+
+    // every 10th call
+    resetLatencyStatistics();
+    setLatencySampling(10);
+    for (int i = 0; i < 100; i++)
+        sum += latencyTracedFunction(i);
+    getLatencyStatistics(stats);
+    f = findLatencyStatistics(stats, "latencyTracedFunction");
+    ASSERT_TRUE(f != NULL);
+    EXPECT_NEAR(10, (int)f->count, 1);
+
+    resetLatencyStatistics();
+    getLatencyStatistics(stats);
+    EXPECT_TRUE(findLatencyStatistics(stats, "latencyTracedFunction") == NULL);
+
+    setLatencySampling(0);
+    for (int i = 0; i < 100; i++)
+        sum += latencyTracedFunction(i);
+    getLatencyStatistics(stats);
+    EXPECT_TRUE(findLatencyStatistics(stats, "latencyTracedFunction") == NULL);
+
+    setLatencySampling(prevSampling);
+    EXPECT_NE(0, sum);
+}
+
+TEST(Core_Trace, latency_histogram_buckets)
+{
+    using namespace cv::utils::trace;
+    for (int i = 1; i < 160; i++)
+        EXPECT_LT(RegionLatencyStatistics::getBucketLowerBound(i - 1), RegionLatencyStatistics::getBucketLowerBound(i)) << i;
+
+    RegionLatencyStatistics s;
+    s.histogram.assign(160, 0);
+    int b = 0;
+    while (RegionLatencyStatistics::getBucketLowerBound(b + 1) <= 1000)
+        b++;
+    s.histogram[b] = 99;
+    s.histogram[b + 12] = 1;
+    s.count = 100;
+    s.maxTime = 7500;
+    EXPECT_LE(800u, s.percentile(0.5));
+    EXPECT_GE(1250u, s.percentile(0.5));
+    EXPECT_EQ(s.percentile(0.5), s.percentile(0.99));
+    EXPECT_EQ(7500u, s.percentile(1.0));
+}
+
+
+TEST(Core_Allocation, large_buffer_modes)
+{
+    const size_t threshold = (size_t)1 << 20, largeSize = (size_t)5 << 20;
+    void* probe = testLargeBufferMalloc(largeSize, 1, 0, threshold);
+    if (!probe)
+        throw SkipTestException("The large buffers are not mapped on this platform");
+    EXPECT_TRUE(testLargeBufferFree(probe));
+
+    // huge pages: none, transparent, explicit; NUMA: none, interleave
+    for (int hugePages = 0; hugePages <= 2; hugePages++)
+    {
+        for (int numa = 0; numa <= 1; numa++)
+        {
+            void* small = testLargeBufferMalloc(threshold/2, hugePages, numa, threshold);
+            EXPECT_TRUE(small == NULL) << hugePages << " " << numa;
+
+            void* large = testLargeBufferMalloc(largeSize, hugePages, numa, threshold);
+            if (hugePages == 0 && numa == 0)
+            {
+                EXPECT_TRUE(large == NULL);
+            }
+            // the interleaving is disabled on a single NUMA node
+            if (!large)
+                continue;
+            memset(large, 1, largeSize);
+            EXPECT_TRUE(testLargeBufferFree(large)) << hugePages << " " << numa;
+        }
+    }
+
+    // the heap buffers are left to fastFree
+    void* small = fastMalloc(4096);
+    EXPECT_FALSE(testLargeBufferFree(small));
+    fastFree(small);
+}
+
 
 }} // namespace
@@ -208,6 +208,32 @@ public:
                                            OutputArray descriptors,
                                            bool useProvidedKeypoints=false );
 
+    /** @brief Detects keypoints and computes the descriptors for an image set.
+
+    With ORB, SIFT, AKAZE, KAZE and BRISK, whose single image detectAndCompute does not modify the
+    algorithm state, the images are processed concurrently when there are at least as many of them as
+    threads. The other algorithms process the images one by one. When descriptors are not needed, the
+    keypoints are found with detect, so the detectors without descriptors can be used as well. The
+    descriptors of all the images are stored in one matrix.
+
+    @param images Image set.
+    @param masks Masks for each input image specifying where to look for keypoints (optional).
+    masks[i] is a mask for images[i].
+    @param keypoints The detected keypoints, keypoints[i] is a set of keypoints detected in images[i].
+    With useProvidedKeypoints they are the input keypoints, which may be removed or duplicated as in
+    compute.
+    @param descriptors The descriptors of all the images, one after another.
+    @param descriptorOffsets nimages+1 row indices, the descriptors of images[i] are the rows from
+    descriptorOffsets[i] up to descriptorOffsets[i+1] of descriptors.
+    @param useProvidedKeypoints Compute the descriptors of the keypoints given in keypoints instead
+    of detecting them.
+    */
+    CV_WRAP void detectAndCompute( InputArrayOfArrays images, InputArrayOfArrays masks,
+                                   CV_OUT CV_IN_OUT std::vector<std::vector<KeyPoint> >& keypoints,
+                                   OutputArray descriptors,
+                                   CV_OUT std::vector<int>& descriptorOffsets,
+                                   bool useProvidedKeypoints=false );
+
     CV_WRAP virtual int descriptorSize() const;
     CV_WRAP virtual int descriptorType() const;
     CV_WRAP virtual int defaultNorm() const;
@@ -322,7 +348,10 @@ public:
     @param sigma The sigma of the Gaussian applied to the input image at the octave \#0. If your image
     is captured with a weak camera with soft lenses, you might want to reduce the number.
 
-    @param descriptorType The type of descriptors. Only CV_32F and CV_8U are supported.
+    @param descriptorType The type of descriptors. CV_32F, CV_16F and CV_8U are supported. The
+    descriptor values are integers in [0, 255] for any type, so CV_8U and CV_16F keep the same values
+    in a quarter and a half of the memory of CV_32F. CV_16F descriptors have to be converted to CV_32F
+    for matching, CV_8U descriptors can be matched with NORM_L2 directly.
     */
     CV_WRAP static Ptr<SIFT> create(int nfeatures, int nOctaveLayers,
         double contrastThreshold, double edgeThreshold,
@@ -1235,6 +1264,37 @@ protected:
     bool crossCheck;
 };
 
+/** @brief Brute-force matcher of binary descriptors that keeps the train descriptors in one packed store.
+
+The descriptors of all the added collections are copied into a single contiguous buffer, aligned to the cache
+lines, with every row padded to 16 bytes. New collections can be added and old ones removed at any time: the
+store is updated in place and nothing needs to be retrained, so the matcher suits large, growing databases.
+
+The matching computes the Hamming distances with SIMD popcount and keeps the k nearest descriptors in the same
+pass over the store, in parallel over the blocks of the query descriptors and the blocks of the store. The
+matches are the same as of BFMatcher with the same norm: the equal distances are ordered by the collection
+index and then by the descriptor index. Masks are supported, cross-check is not.
+ */
+class CV_EXPORTS_W PackedBFMatcher : public DescriptorMatcher
+{
+public:
+    /** @brief Creates the matcher.
+    @param normType NORM_HAMMING or NORM_HAMMING2 (see BFMatcher::create).
+     */
+    CV_WRAP static Ptr<PackedBFMatcher> create( int normType=NORM_HAMMING );
+
+    /** @brief Removes a train descriptor collection from the store.
+
+    The rest of the collections keep their indices; the removed collection stays in the list as an empty one.
+    The masks passed to the matching functions still have an entry for it, which is ignored whatever its size.
+    @param imgIdx Index of the collection, as in DMatch::imgIdx.
+     */
+    CV_WRAP virtual void remove( int imgIdx ) = 0;
+
+    //! Returns the number of the train descriptors in the store.
+    CV_WRAP virtual int getDescriptorCount() const = 0;
+};
+
 #if defined(HAVE_OPENCV_FLANN) || defined(CV_DOXYGEN)
 
 /** @brief Flann-based descriptor matcher.
@@ -0,0 +1,38 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "perf_precomp.hpp"
+
+namespace opencv_test
+{
+using namespace perf;
+
+typedef tuple<int, int, bool> MatcherParams_t;
+typedef perf::TestBaseWithParam<MatcherParams_t> KnnMatchFixture;
+
+// binary descriptors of ORB size matched against a large database
+PERF_TEST_P(KnnMatchFixture, knnMatchHamming, testing::Combine(
+    testing::Values(10000, 100000), testing::Values(1, 2), testing::Bool()))
+{
+    const int trainSize = get<0>(GetParam()), k = get<1>(GetParam());
+    const bool packed = get<2>(GetParam());
+
+    Mat query(1000, 32, CV_8U), train(trainSize, 32, CV_8U);
+    declare.in(query, train, WARMUP_RNG);
+
+    Ptr<DescriptorMatcher> matcher;
+    if (packed)
+        matcher = PackedBFMatcher::create(NORM_HAMMING);
+    else
+        matcher = BFMatcher::create(NORM_HAMMING);
+    matcher->add(train);
+    matcher->train();
+
+    vector<vector<DMatch> > matches;
+    TEST_CYCLE() matcher->knnMatch(query, matches, k);
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
@@ -0,0 +1,51 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "perf_precomp.hpp"
+
+namespace opencv_test
+{
+using namespace perf;
+
+typedef tuple<string, int, ORB::ScoreType> ORBParams_t;
+typedef perf::TestBaseWithParam<ORBParams_t> ORBFixture;
+
+#define ORB_IMAGES testing::Values(\
+    "cv/detectors_descriptors_evaluation/images_datasets/leuven/img1.png",\
+    "stitching/a3.png")
+
+PERF_TEST_P(ORBFixture, detect, testing::Combine(ORB_IMAGES, testing::Values(500, 3000),
+                                                 testing::Values(ORB::HARRIS_SCORE, ORB::FAST_SCORE)))
+{
+    Mat img = imread(getDataPath(get<0>(GetParam())), IMREAD_GRAYSCALE);
+    ASSERT_FALSE(img.empty());
+    Ptr<ORB> orb = ORB::create(get<1>(GetParam()), 1.2f, 8, 31, 0, 2, get<2>(GetParam()));
+
+    declare.in(img);
+    vector<KeyPoint> points;
+
+    TEST_CYCLE() orb->detect(img, points);
+
+    EXPECT_GT(points.size(), 20u);
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(ORBFixture, detectAndCompute, testing::Combine(ORB_IMAGES, testing::Values(500, 3000),
+                                                           testing::Values(ORB::HARRIS_SCORE, ORB::FAST_SCORE)))
+{
+    Mat img = imread(getDataPath(get<0>(GetParam())), IMREAD_GRAYSCALE);
+    ASSERT_FALSE(img.empty());
+    Ptr<ORB> orb = ORB::create(get<1>(GetParam()), 1.2f, 8, 31, 0, 2, get<2>(GetParam()));
+
+    declare.in(img);
+    vector<KeyPoint> points;
+    Mat descriptors;
+
+    TEST_CYCLE() orb->detectAndCompute(img, noArray(), points, descriptors);
+
+    EXPECT_EQ((size_t)descriptors.rows, points.size());
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
@@ -8011,30 +8011,44 @@ Ptr<AgastFeatureDetector> AgastFeatureDetector::create( int threshold, bool nonm
     return makePtr<AgastFeatureDetector_Impl>(threshold, nonmaxSuppression, type);
 }
 
-void AGAST(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, bool nonmax_suppression, AgastFeatureDetector::DetectorType type)
+// the detectors test the rows [border, rows - border) of the image
+static int getAgastBorder(AgastFeatureDetector::DetectorType type)
 {
-    CV_INSTRUMENT_REGION();
+    switch(type) {
+      case AgastFeatureDetector::AGAST_5_8:
+        return 1;
+      case AgastFeatureDetector::AGAST_7_12s:
+        return 2;
+      default:
+        return 3;
+    }
+}
 
-    std::vector<KeyPoint> kpts;
+static void AGAST_detectAndScore(const Mat& img, std::vector<KeyPoint>& kpts, int threshold,
+                                 AgastFeatureDetector::DetectorType type, int row0, int row1)
+{
+    const int border = getAgastBorder(type);
+
+    // the rows of a decision tree do not depend on each other,
+    // so the band with the border rows around [row0, row1) gives the corners of these rows
+    Mat band = img.rowRange(row0 - border, row1 + border);
 
     // detect
     switch(type) {
       case AgastFeatureDetector::AGAST_5_8:
-        AGAST_5_8(_img, kpts, threshold);
+        AGAST_5_8(band, kpts, threshold);
         break;
       case AgastFeatureDetector::AGAST_7_12d:
-        AGAST_7_12d(_img, kpts, threshold);
+        AGAST_7_12d(band, kpts, threshold);
         break;
       case AgastFeatureDetector::AGAST_7_12s:
-        AGAST_7_12s(_img, kpts, threshold);
+        AGAST_7_12s(band, kpts, threshold);
         break;
       case AgastFeatureDetector::OAST_9_16:
-        OAST_9_16(_img, kpts, threshold);
+        OAST_9_16(band, kpts, threshold);
         break;
     }
 
-    cv::Mat img = _img.getMat();
-
     // score
     int pixel_[16];
     makeAgastOffsets(pixel_, (int)img.step, type);
@@ -8042,6 +8056,7 @@ void AGAST(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, boo
     std::vector<KeyPoint>::iterator kpt;
     for(kpt = kpts.begin(); kpt != kpts.end(); ++kpt)
     {
+        kpt->pt.y += (float)(row0 - border);
         switch(type) {
           case AgastFeatureDetector::AGAST_5_8:
             kpt->response = (float)agast_cornerScore<AgastFeatureDetector::AGAST_5_8>
@@ -8061,6 +8076,47 @@ void AGAST(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, boo
             break;
         }
     }
+}
+
+// the corners are detected and scored in the horizontal stripes of at least this many rows in parallel
+static const int AGAST_STRIPE_ROWS = 64;
+
+void AGAST(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, bool nonmax_suppression, AgastFeatureDetector::DetectorType type)
+{
+    CV_INSTRUMENT_REGION();
+
+    std::vector<KeyPoint> kpts;
+
+    cv::Mat img = _img.getMat();
+    if(!img.isContinuous())
+      img = img.clone();
+
+    const int border = getAgastBorder(type);
+    int nrows = img.rows - border*2;
+    int nstripes = std::min(getNumThreads(), nrows / AGAST_STRIPE_ROWS);
+    if(nstripes <= 1)
+    {
+        if(nrows > 0)
+            AGAST_detectAndScore(img, kpts, threshold, type, border, img.rows - border);
+    }
+    else
+    {
+        // the stripes are concatenated in their order, so the corners are sorted by rows as the suppression expects
+        std::vector<std::vector<KeyPoint> > stripeKeypoints(nstripes);
+        parallel_for_(Range(0, nstripes), [&](const Range& range)
+        {
+            for(int s = range.start; s < range.end; s++)
+                AGAST_detectAndScore(img, stripeKeypoints[s], threshold, type,
+                                     border + nrows*s/nstripes, border + nrows*(s + 1)/nstripes);
+        }, nstripes);
+
+        size_t total = 0;
+        for(int s = 0; s < nstripes; s++)
+            total += stripeKeypoints[s].size();
+        kpts.reserve(total);
+        for(int s = 0; s < nstripes; s++)
+            kpts.insert(kpts.end(), stripeKeypoints[s].begin(), stripeKeypoints[s].end());
+    }
 
     // suppression
     if(nonmax_suppression)
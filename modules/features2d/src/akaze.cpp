@@ -245,6 +245,11 @@ namespace cv
                                    threshold, octaves, sublevels, diffusivity);
     }
 
+    bool isAKAZEImpl(const Feature2D* f)
+    {
+        return dynamic_cast<const AKAZE_Impl*>(f) != NULL;
+    }
+
     String AKAZE::getDefaultName() const
     {
         return (Feature2D::getDefaultName() + ".AKAZE");
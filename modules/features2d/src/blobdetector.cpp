@@ -41,6 +41,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include <opencv2/core/utils/tls.hpp>
 #include <iterator>
 #include <limits>
 
@@ -317,14 +318,28 @@ void SimpleBlobDetectorImpl::detect(InputArray image, std::vector<cv::KeyPoint>&
         CV_Error(Error::StsUnsupportedFormat, "Blob detector only supports 8-bit images!");
     }
 
-    std::vector < std::vector<Center> > centers;
+    std::vector<double> thresholds;
     for (double thresh = params.minThreshold; thresh < params.maxThreshold; thresh += params.thresholdStep)
+        thresholds.push_back(thresh);
+
+    // the levels are thresholded and searched for blobs concurrently, each thread reuses
+    // its binarized image, then the blobs are grouped level by level as before
+    std::vector < std::vector<Center> > levelCenters(thresholds.size());
+    TLSData<Mat> binarizedImages;
+    parallel_for_(Range(0, (int)thresholds.size()), [&](const Range& range)
     {
-        Mat binarizedImage;
-        threshold(grayscaleImage, binarizedImage, thresh, 255, THRESH_BINARY);
+        Mat& binarizedImage = binarizedImages.getRef();
+        for (int level = range.start; level < range.end; level++)
+        {
+            threshold(grayscaleImage, binarizedImage, thresholds[level], 255, THRESH_BINARY);
+            findBlobs(grayscaleImage, binarizedImage, levelCenters[level]);
+        }
+    });
 
-        std::vector < Center > curCenters;
-        findBlobs(grayscaleImage, binarizedImage, curCenters);
+    std::vector < std::vector<Center> > centers;
+    for (size_t level = 0; level < levelCenters.size(); level++)
+    {
+        const std::vector < Center >& curCenters = levelCenters[level];
         std::vector < std::vector<Center> > newCenters;
         for (size_t i = 0; i < curCenters.size(); i++)
         {
@@ -2387,6 +2387,11 @@ Ptr<BRISK> BRISK::create(int thresh, int octaves, const std::vector<float> &radi
     return makePtr<BRISK_Impl>(thresh, octaves, radiusList, numberList, dMax, dMin, indexChange);
 }
 
+bool isBRISKImpl(const Feature2D* f)
+{
+    return dynamic_cast<const BRISK_Impl*>(f) != NULL;
+}
+
 String BRISK::getDefaultName() const
 {
     return (Feature2D::getDefaultName() + ".BRISK");
@@ -54,12 +54,17 @@ The references are:
 namespace cv
 {
 
+// The corners are searched in the horizontal stripes of at least this many rows in parallel.
+// Every stripe also scores the rows next to it, so the non-maximum suppression across the stripe
+// borders gives the same keypoints as the single pass over the image.
+static const int FAST_STRIPE_ROWS = 64;
+
 template<int patternSize>
 void FAST_t(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, bool nonmax_suppression)
 {
     Mat img = _img.getMat();
     const int K = patternSize/2, N = patternSize + K + 1;
-    int i, j, k, pixel[25];
+    int pixel[25];
     makeOffsets(pixel, (int)img.step, patternSize);
 
 #if CV_SIMD128
@@ -67,7 +72,7 @@ void FAST_t(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, bo
     v_uint8x16 delta = v_setall_u8(0x80), t = v_setall_u8((char)threshold), K16 = v_setall_u8((char)K);
 #if CV_TRY_AVX2
     Ptr<opt_AVX2::FAST_t_patternSize16_AVX2> fast_t_impl_avx2;
-    if(CV_CPU_HAS_SUPPORT_AVX2)
+    if(CV_CPU_HAS_SUPPORT_AVX2 && patternSize == 16)
         fast_t_impl_avx2 = opt_AVX2::FAST_t_patternSize16_AVX2::getImpl(img.cols, threshold, nonmax_suppression, pixel);
 #endif
 
@@ -78,38 +83,40 @@ void FAST_t(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, bo
     threshold = std::min(std::max(threshold, 0), 255);
 
     uchar threshold_tab[512];
-    for( i = -255; i <= 255; i++ )
+    for( int i = -255; i <= 255; i++ )
         threshold_tab[i+255] = (uchar)(i < -threshold ? 1 : i > threshold ? 2 : 0);
 
-    uchar* buf[3] = { 0 };
-    int* cpbuf[3] = { 0 };
-    utils::BufferArea area;
-    for (unsigned idx = 0; idx < 3; ++idx)
-    {
-        area.allocate(buf[idx], img.cols);
-        area.allocate(cpbuf[idx], img.cols + 1);
-    }
-    area.commit();
-
-    for (unsigned idx = 0; idx < 3; ++idx)
+    // finds the corners in the rows [row0, row1), the scores of the rows row0-1 and row1 are computed for the NMS
+    auto detectRows = [&](int row0, int row1, std::vector<KeyPoint>& kpts)
     {
-        memset(buf[idx], 0, img.cols);
-    }
+        int i, j, k;
+        uchar* buf[3] = { 0 };
+        int* cpbuf[3] = { 0 };
+        utils::BufferArea area;
+        for (unsigned idx = 0; idx < 3; ++idx)
+        {
+            area.allocate(buf[idx], img.cols);
+            area.allocate(cpbuf[idx], img.cols + 1);
+        }
+        area.commit();
 
-    for(i = 3; i < img.rows-2; i++)
-    {
-        const uchar* ptr = img.ptr<uchar>(i) + 3;
-        uchar* curr = buf[(i - 3)%3];
-        int* cornerpos = cpbuf[(i - 3)%3] + 1; // cornerpos[-1] is used to store a value
-        memset(curr, 0, img.cols);
-        int ncorners = 0;
+        for (unsigned idx = 0; idx < 3; ++idx)
+        {
+            memset(buf[idx], 0, img.cols);
+        }
 
-        if( i < img.rows - 3 )
+        for(i = std::max(row0 - 1, 3); i < std::min(row1 + 1, img.rows - 2); i++)
         {
-            j = 3;
-#if CV_SIMD128
+            const uchar* ptr = img.ptr<uchar>(i) + 3;
+            uchar* curr = buf[(i - 3)%3];
+            int* cornerpos = cpbuf[(i - 3)%3] + 1; // cornerpos[-1] is used to store a value
+            memset(curr, 0, img.cols);
+            int ncorners = 0;
+
+            if( i < img.rows - 3 )
             {
-                if( patternSize == 16 )
+                j = 3;
+#if CV_SIMD128
                 {
 #if CV_TRY_AVX2
                     if (fast_t_impl_avx2)
@@ -165,7 +172,23 @@ void FAST_t(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, bo
                                 max1 = v_max(max1, v_reinterpret_as_u8(c1));
                             }
 
-                            max0 = K16 < v_max(max0, max1);
+                            if( patternSize == 16 )
+                                max0 = K16 < v_max(max0, max1);
+                            else
+                            {
+                                // The scalar code below tests the pairs of the pixels pixel[k] and pixel[k+8]
+                                // before the arc, which is stricter than the arc test for the smaller patterns.
+                                // The same test is applied to keep the results independent of the code path.
+                                v_int8x16 b = v_reinterpret_as_s8(v_setall_u8(0xff)), d = b;
+                                for( k = 0; k < 8; k++ )
+                                {
+                                    v_int8x16 x = v_reinterpret_as_s8(v_load(ptr + pixel[k]) ^ delta);
+                                    v_int8x16 y = v_reinterpret_as_s8(v_load(ptr + pixel[k + 8]) ^ delta);
+                                    b = b & ((v0 < x) | (v0 < y));
+                                    d = d & ((x < v1) | (y < v1));
+                                }
+                                max0 = ((K16 < max0) & v_reinterpret_as_u8(b)) | ((K16 < max1) & v_reinterpret_as_u8(d));
+                            }
                             unsigned int m = v_signmask(v_reinterpret_as_s8(max0));
 
                             for( k = 0; m > 0 && k < 16; k++, m >>= 1 )
@@ -173,7 +196,7 @@ void FAST_t(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, bo
                                 if( m & 1 )
                                 {
                                     cornerpos[ncorners++] = j+k;
-                                    if(nonmax_suppression)
+                                    if(nonmax_suppression && patternSize == 16)
                                     {
                                         short d[25];
                                         for (int _k = 0; _k < 25; _k++)
@@ -192,103 +215,129 @@ void FAST_t(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, bo
                                         }
                                         curr[j + k] = (uchar)(v_reduce_max(v_max(v_max(a0, a1), v_setzero_s16() - v_min(b0, b1))) - 1);
                                     }
+                                    else if(nonmax_suppression)
+                                        curr[j + k] = (uchar)cornerScore<patternSize>(ptr + k, pixel, threshold);
                                 }
                             }
                         }
                     }
                 }
-            }
 #endif
-            for( ; j < img.cols - 3; j++, ptr++ )
-            {
-                int v = ptr[0];
-                const uchar* tab = &threshold_tab[0] - v + 255;
-                int d = tab[ptr[pixel[0]]] | tab[ptr[pixel[8]]];
-
-                if( d == 0 )
-                    continue;
+                for( ; j < img.cols - 3; j++, ptr++ )
+                {
+                    int v = ptr[0];
+                    const uchar* tab = &threshold_tab[0] - v + 255;
+                    int d = tab[ptr[pixel[0]]] | tab[ptr[pixel[8]]];
 
-                d &= tab[ptr[pixel[2]]] | tab[ptr[pixel[10]]];
-                d &= tab[ptr[pixel[4]]] | tab[ptr[pixel[12]]];
-                d &= tab[ptr[pixel[6]]] | tab[ptr[pixel[14]]];
+                    if( d == 0 )
+                        continue;
 
-                if( d == 0 )
-                    continue;
+                    d &= tab[ptr[pixel[2]]] | tab[ptr[pixel[10]]];
+                    d &= tab[ptr[pixel[4]]] | tab[ptr[pixel[12]]];
+                    d &= tab[ptr[pixel[6]]] | tab[ptr[pixel[14]]];
 
-                d &= tab[ptr[pixel[1]]] | tab[ptr[pixel[9]]];
-                d &= tab[ptr[pixel[3]]] | tab[ptr[pixel[11]]];
-                d &= tab[ptr[pixel[5]]] | tab[ptr[pixel[13]]];
-                d &= tab[ptr[pixel[7]]] | tab[ptr[pixel[15]]];
+                    if( d == 0 )
+                        continue;
 
-                if( d & 1 )
-                {
-                    int vt = v - threshold, count = 0;
+                    d &= tab[ptr[pixel[1]]] | tab[ptr[pixel[9]]];
+                    d &= tab[ptr[pixel[3]]] | tab[ptr[pixel[11]]];
+                    d &= tab[ptr[pixel[5]]] | tab[ptr[pixel[13]]];
+                    d &= tab[ptr[pixel[7]]] | tab[ptr[pixel[15]]];
 
-                    for( k = 0; k < N; k++ )
+                    if( d & 1 )
                     {
-                        int x = ptr[pixel[k]];
-                        if(x < vt)
+                        int vt = v - threshold, count = 0;
+
+                        for( k = 0; k < N; k++ )
                         {
-                            if( ++count > K )
+                            int x = ptr[pixel[k]];
+                            if(x < vt)
                             {
-                                cornerpos[ncorners++] = j;
-                                if(nonmax_suppression)
-                                    curr[j] = (uchar)cornerScore<patternSize>(ptr, pixel, threshold);
-                                break;
+                                if( ++count > K )
+                                {
+                                    cornerpos[ncorners++] = j;
+                                    if(nonmax_suppression)
+                                        curr[j] = (uchar)cornerScore<patternSize>(ptr, pixel, threshold);
+                                    break;
+                                }
                             }
+                            else
+                                count = 0;
                         }
-                        else
-                            count = 0;
                     }
-                }
-
-                if( d & 2 )
-                {
-                    int vt = v + threshold, count = 0;
 
-                    for( k = 0; k < N; k++ )
+                    if( d & 2 )
                     {
-                        int x = ptr[pixel[k]];
-                        if(x > vt)
+                        int vt = v + threshold, count = 0;
+
+                        for( k = 0; k < N; k++ )
                         {
-                            if( ++count > K )
+                            int x = ptr[pixel[k]];
+                            if(x > vt)
                             {
-                                cornerpos[ncorners++] = j;
-                                if(nonmax_suppression)
-                                    curr[j] = (uchar)cornerScore<patternSize>(ptr, pixel, threshold);
-                                break;
+                                if( ++count > K )
+                                {
+                                    cornerpos[ncorners++] = j;
+                                    if(nonmax_suppression)
+                                        curr[j] = (uchar)cornerScore<patternSize>(ptr, pixel, threshold);
+                                    break;
+                                }
                             }
+                            else
+                                count = 0;
                         }
-                        else
-                            count = 0;
                     }
                 }
             }
-        }
 
-        cornerpos[-1] = ncorners;
+            cornerpos[-1] = ncorners;
 
-        if( i == 3 )
-            continue;
+            if( i <= row0 )
+                continue;
 
-        const uchar* prev = buf[(i - 4 + 3)%3];
-        const uchar* pprev = buf[(i - 5 + 3)%3];
-        cornerpos = cpbuf[(i - 4 + 3)%3] + 1; // cornerpos[-1] is used to store a value
-        ncorners = cornerpos[-1];
+            const uchar* prev = buf[(i - 4 + 3)%3];
+            const uchar* pprev = buf[(i - 5 + 3)%3];
+            cornerpos = cpbuf[(i - 4 + 3)%3] + 1; // cornerpos[-1] is used to store a value
+            ncorners = cornerpos[-1];
 
-        for( k = 0; k < ncorners; k++ )
-        {
-            j = cornerpos[k];
-            int score = prev[j];
-            if( !nonmax_suppression ||
-               (score > prev[j+1] && score > prev[j-1] &&
-                score > pprev[j-1] && score > pprev[j] && score > pprev[j+1] &&
-                score > curr[j-1] && score > curr[j] && score > curr[j+1]) )
+            for( k = 0; k < ncorners; k++ )
             {
-                keypoints.push_back(KeyPoint((float)j, (float)(i-1), 7.f, -1, (float)score));
+                j = cornerpos[k];
+                int score = prev[j];
+                if( !nonmax_suppression ||
+                   (score > prev[j+1] && score > prev[j-1] &&
+                    score > pprev[j-1] && score > pprev[j] && score > pprev[j+1] &&
+                    score > curr[j-1] && score > curr[j] && score > curr[j+1]) )
+                {
+                    kpts.push_back(KeyPoint((float)j, (float)(i-1), 7.f, -1, (float)score));
+                }
             }
         }
+    };
+
+    // the corners are found in the rows [3, rows - 3)
+    int nrows = img.rows - 6;
+    int nstripes = std::min(getNumThreads(), nrows / FAST_STRIPE_ROWS);
+    if( nstripes <= 1 )
+    {
+        detectRows(3, img.rows - 3, keypoints);
+        return;
     }
+
+    // the stripes are concatenated in their order, so the keypoints are sorted by rows as in the single pass
+    std::vector<std::vector<KeyPoint> > stripeKeypoints(nstripes);
+    parallel_for_(Range(0, nstripes), [&](const Range& range)
+    {
+        for( int s = range.start; s < range.end; s++ )
+            detectRows(3 + nrows*s/nstripes, 3 + nrows*(s + 1)/nstripes, stripeKeypoints[s]);
+    }, nstripes);
+
+    size_t total = 0;
+    for( int s = 0; s < nstripes; s++ )
+        total += stripeKeypoints[s].size();
+    keypoints.reserve(total);
+    for( int s = 0; s < nstripes; s++ )
+        keypoints.insert(keypoints.end(), stripeKeypoints[s].begin(), stripeKeypoints[s].end());
 }
 
 #ifdef HAVE_OPENCL
@@ -174,6 +174,98 @@ void Feature2D::detectAndCompute( InputArray, InputArray,
     CV_Error(Error::StsNotImplemented, "");
 }
 
+// The built-in algorithms known not to modify their state in detectAndCompute, only their images
+// are processed concurrently. The others, e.g. the ones that cache buffers in their members or the
+// user classes derived from these interfaces, get the images one by one.
+static bool isReentrantFeature2D(const Feature2D* f)
+{
+    return isORBImpl(f) || isSIFTImpl(f) || isAKAZEImpl(f) || isKAZEImpl(f) || isBRISKImpl(f);
+}
+
+void Feature2D::detectAndCompute( InputArrayOfArrays images, InputArrayOfArrays masks,
+                                  std::vector<std::vector<KeyPoint> >& keypoints,
+                                  OutputArray descriptors,
+                                  std::vector<int>& descriptorOffsets,
+                                  bool useProvidedKeypoints )
+{
+    CV_INSTRUMENT_REGION();
+
+    int nimages = (int)images.total();
+
+    if (!masks.empty())
+    {
+        CV_Assert(masks.total() == (size_t)nimages);
+    }
+    if (useProvidedKeypoints)
+    {
+        CV_Assert(keypoints.size() == (size_t)nimages);
+    }
+    keypoints.resize(nimages);
+
+    const bool needDescriptors = descriptors.needed();
+    std::vector<Mat> imageDescriptors(nimages);
+
+    auto processImage = [&](int i)
+    {
+        Mat image = images.getMat(i);
+        if (image.empty())
+        {
+            if (!useProvidedKeypoints)
+                keypoints[i].clear();
+            return;
+        }
+        Mat mask = masks.empty() ? Mat() : masks.getMat(i);
+        // the detectors that compute no descriptors only implement detect
+        if (needDescriptors)
+            detectAndCompute(image, mask, keypoints[i], imageDescriptors[i], useProvidedKeypoints);
+        else if (!useProvidedKeypoints)
+            detect(image, keypoints[i], mask);
+    };
+
+    // with fewer images than threads the parallel loops of the algorithm keep more threads busy
+    if (nimages > 1 && nimages >= getNumThreads() && isReentrantFeature2D(this))
+    {
+        parallel_for_(Range(0, nimages), [&](const Range& range)
+        {
+            for (int i = range.start; i < range.end; i++)
+                processImage(i);
+        });
+    }
+    else
+    {
+        for (int i = 0; i < nimages; i++)
+            processImage(i);
+    }
+
+    descriptorOffsets.resize(nimages + 1);
+    descriptorOffsets[0] = 0;
+    int cols = descriptorSize(), type = descriptorType();
+    for (int i = 0; i < nimages; i++)
+    {
+        const Mat& desc = imageDescriptors[i];
+        descriptorOffsets[i + 1] = descriptorOffsets[i] + desc.rows;
+        if (!desc.empty())
+        {
+            CV_Assert(desc.dims == 2 && desc.channels() == 1);
+            cols = desc.cols;
+            type = desc.type();
+        }
+    }
+    if (!needDescriptors)
+        return;
+
+    descriptors.create(descriptorOffsets[nimages], cols, type);
+    Mat result = descriptors.getMat();
+    for (int i = 0; i < nimages; i++)
+    {
+        const Mat& desc = imageDescriptors[i];
+        if (desc.empty())
+            continue;
+        CV_Assert(desc.cols == cols && desc.type() == type);
+        desc.copyTo(result.rowRange(descriptorOffsets[i], descriptorOffsets[i + 1]));
+    }
+}
+
 void Feature2D::write( const String& fileName ) const
 {
     FileStorage fs(fileName, FileStorage::WRITE);
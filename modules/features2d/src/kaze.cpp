@@ -197,6 +197,11 @@ namespace cv
         return makePtr<KAZE_Impl>(extended, upright, threshold, octaves, sublevels, diffusivity);
     }
 
+    bool isKAZEImpl(const Feature2D* f)
+    {
+        return dynamic_cast<const KAZE_Impl*>(f) != NULL;
+    }
+
     String KAZE::getDefaultName() const
     {
         return (Feature2D::getDefaultName() + ".KAZE");
@@ -45,6 +45,7 @@
 #endif
 #include <limits>
 #include "opencl_kernels_features2d.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 #if defined(HAVE_EIGEN) && EIGEN_WORLD_VERSION == 2
 #  if defined(_MSC_VER)
@@ -1014,6 +1015,407 @@ void BFMatcher::radiusMatchImpl( InputArray _queryDescriptors, std::vector<std::
     }
 }
 
+////////////////////////////////////////////////////// PackedBFMatcher /////////////////////////////////////////////////
+
+// the rows of the packed store and of the packed queries are padded with zeros to this many bytes,
+// so the distance kernel works on whole vectors
+static const int PACKED_ROW_ALIGN = 16;
+// the queries are matched in blocks of this size
+static const int PACKED_QUERY_BLOCK = 32;
+// the store is scanned in blocks of about this many bytes, so a block stays in the cache while
+// it is compared with all the queries of a block
+static const int PACKED_TRAIN_BLOCK_BYTES = 1 << 17;
+// the store is split into the parts matched in parallel only when there are few queries; every part
+// has at least this many rows, so the merging of the parts stays cheap
+static const int PACKED_MIN_PART_ROWS = 256;
+
+template<bool cell2> static inline int packedHammingDistance( const uchar* a, const uchar* b, int rowSize )
+{
+#if CV_SIMD128
+    v_uint64x2 t = v_setzero_u64();
+    for( int i = 0; i < rowSize; i += PACKED_ROW_ALIGN )
+    {
+        v_uint8x16 x = v_load(a + i) ^ v_load(b + i);
+        if( cell2 )
+        {
+            // every 2-bit cell counts once; the bits shifted across the bytes are masked out
+            v_uint16x8 y = v_reinterpret_as_u16(x);
+            x = v_reinterpret_as_u8((y | (y >> 1)) & v_setall_u16(0x5555));
+        }
+        t += v_popcount(v_reinterpret_as_u64(x));
+    }
+    return (int)v_reduce_sum(t);
+#else
+    return cell2 ? hal::normHamming(a, b, rowSize, 2) : hal::normHamming(a, b, rowSize);
+#endif
+}
+
+class PackedBFMatcherImpl CV_FINAL : public PackedBFMatcher
+{
+public:
+    explicit PackedBFMatcherImpl( int _normType ) : normType(_normType), descSize(0), rowSize(0), count(0)
+    {
+        CV_Assert( normType == NORM_HAMMING || normType == NORM_HAMMING2 );
+    }
+
+    void add( InputArrayOfArrays descriptors ) CV_OVERRIDE;
+    void clear() CV_OVERRIDE;
+    bool empty() const CV_OVERRIDE { return count == 0; }
+    bool isMaskSupported() const CV_OVERRIDE { return true; }
+    Ptr<DescriptorMatcher> clone( bool emptyTrainData=false ) const CV_OVERRIDE;
+
+    void remove( int imgIdx ) CV_OVERRIDE;
+    int getDescriptorCount() const CV_OVERRIDE { return count; }
+
+protected:
+    void knnMatchImpl( InputArray queryDescriptors, std::vector<std::vector<DMatch> >& matches, int k,
+        InputArrayOfArrays masks=noArray(), bool compactResult=false ) CV_OVERRIDE;
+    void radiusMatchImpl( InputArray queryDescriptors, std::vector<std::vector<DMatch> >& matches, float maxDistance,
+        InputArrayOfArrays masks=noArray(), bool compactResult=false ) CV_OVERRIDE;
+
+    // calls body(query, row, distance) for all the allowed pairs of the queries in [q0, q1) and the rows in [r0, r1)
+    template<bool cell2, typename Body>
+    void scan( const Mat& query, const std::vector<Mat>& masks, int q0, int q1, int r0, int r1, Body& body ) const;
+    template<typename Body>
+    void scanBlocks( const Mat& query, const std::vector<Mat>& masks, int q0, int q1, int r0, int r1, Body& body ) const;
+    void packQueries( InputArray queryDescriptors, Mat& packed ) const;
+    // splits the store into the parts matched in parallel, so that there are enough tasks for the threads
+    int getStorePartCount( int nqueries ) const;
+
+    int normType;
+    int descSize;  // the descriptor size in bytes
+    int rowSize;   // the row size in the store, descSize padded to PACKED_ROW_ALIGN
+    int count;     // the number of the used rows of the store
+    Mat store;     // the packed descriptors, the capacity is store.rows
+    std::vector<int> storeImgIdx, storeTrainIdx;
+};
+
+void PackedBFMatcherImpl::add( InputArrayOfArrays _descriptors )
+{
+    std::vector<Mat> descriptors;
+    if( _descriptors.isMatVector() || _descriptors.isUMatVector() )
+        _descriptors.getMatVector(descriptors);
+    else
+        descriptors.push_back(_descriptors.getMat());
+
+    int newCount = count;
+    for( size_t i = 0; i < descriptors.size(); i++ )
+    {
+        const Mat& d = descriptors[i];
+        if( d.empty() )
+            continue;
+        CV_Assert( d.type() == CV_8UC1 && d.dims == 2 );
+        if( descSize == 0 )
+        {
+            descSize = d.cols;
+            rowSize = alignSize(descSize, PACKED_ROW_ALIGN);
+        }
+        CV_Assert( d.cols == descSize );
+        newCount += d.rows;
+    }
+
+    if( newCount > store.rows )
+    {
+        // the capacity grows geometrically, so adding the descriptors one by one is amortized O(1)
+        Mat newStore(std::max(newCount, store.rows*2), rowSize, CV_8U, Scalar::all(0));
+        if( count > 0 )
+            store.rowRange(0, count).copyTo(newStore.rowRange(0, count));
+        store = newStore;
+    }
+    storeImgIdx.reserve(store.rows);
+    storeTrainIdx.reserve(store.rows);
+
+    for( size_t i = 0; i < descriptors.size(); i++ )
+    {
+        const Mat& d = descriptors[i];
+        int imgIdx = (int)trainDescCollection.size();
+        // the collection is kept for getTrainDescriptors() and the mask checks; an input backed by UMat is copied
+        trainDescCollection.push_back(_descriptors.isUMatVector() || _descriptors.isUMat() ? d.clone() : d);
+        for( int j = 0; j < d.rows; j++ )
+        {
+            memcpy(store.ptr(count), d.ptr(j), descSize);
+            storeImgIdx.push_back(imgIdx);
+            storeTrainIdx.push_back(j);
+            count++;
+        }
+    }
+}
+
+void PackedBFMatcherImpl::clear()
+{
+    DescriptorMatcher::clear();
+    store.release();
+    storeImgIdx.clear();
+    storeTrainIdx.clear();
+    count = descSize = rowSize = 0;
+}
+
+void PackedBFMatcherImpl::remove( int imgIdx )
+{
+    CV_Assert( 0 <= imgIdx && imgIdx < (int)trainDescCollection.size() );
+
+    // the remaining rows keep their order, so the equal distances are ordered as before
+    int j = 0;
+    for( int i = 0; i < count; i++ )
+    {
+        if( storeImgIdx[i] == imgIdx )
+            continue;
+        if( j < i )
+        {
+            memcpy(store.ptr(j), store.ptr(i), rowSize);
+            storeImgIdx[j] = storeImgIdx[i];
+            storeTrainIdx[j] = storeTrainIdx[i];
+        }
+        j++;
+    }
+    count = j;
+    storeImgIdx.resize(count);
+    storeTrainIdx.resize(count);
+    // the slot is kept, so the masks still have one entry per collection; checkMasks does not check the
+    // entry of an empty collection and no row of the store refers to it any more
+    trainDescCollection[imgIdx] = Mat();
+}
+
+Ptr<DescriptorMatcher> PackedBFMatcherImpl::clone( bool emptyTrainData ) const
+{
+    Ptr<PackedBFMatcherImpl> matcher = makePtr<PackedBFMatcherImpl>(normType);
+    if( !emptyTrainData )
+    {
+        matcher->trainDescCollection.resize(trainDescCollection.size());
+        std::transform( trainDescCollection.begin(), trainDescCollection.end(),
+                        matcher->trainDescCollection.begin(), clone_op );
+        matcher->descSize = descSize;
+        matcher->rowSize = rowSize;
+        matcher->count = count;
+        matcher->store = store.rowRange(0, count).clone();
+        matcher->storeImgIdx = storeImgIdx;
+        matcher->storeTrainIdx = storeTrainIdx;
+    }
+    return matcher;
+}
+
+void PackedBFMatcherImpl::packQueries( InputArray _queryDescriptors, Mat& packed ) const
+{
+    Mat query = _queryDescriptors.getMat();
+    CV_Assert( query.type() == CV_8UC1 && query.cols == descSize );
+    packed.create(query.rows, rowSize, CV_8U);
+    for( int i = 0; i < query.rows; i++ )
+    {
+        uchar* dst = packed.ptr(i);
+        memcpy(dst, query.ptr(i), descSize);
+        memset(dst + descSize, 0, rowSize - descSize);
+    }
+}
+
+int PackedBFMatcherImpl::getStorePartCount( int nqueries ) const
+{
+    int nqblocks = (nqueries + PACKED_QUERY_BLOCK - 1) / PACKED_QUERY_BLOCK;
+    int ntasks = getNumThreads() * 4;
+    return std::max(std::min(count / PACKED_MIN_PART_ROWS, (ntasks + nqblocks - 1) / nqblocks), 1);
+}
+
+template<bool cell2, typename Body>
+void PackedBFMatcherImpl::scan( const Mat& query, const std::vector<Mat>& masks,
+                                int q0, int q1, int r0, int r1, Body& body ) const
+{
+    for( int q = q0; q < q1; q++ )
+    {
+        const uchar* qptr = query.ptr(q);
+        for( int r = r0; r < r1; r++ )
+        {
+            if( !masks.empty() )
+            {
+                const Mat& mask = masks[storeImgIdx[r]];
+                if( !mask.empty() && !mask.at<uchar>(q, storeTrainIdx[r]) )
+                    continue;
+            }
+            body(q, r, packedHammingDistance<cell2>(qptr, store.ptr(r), rowSize));
+        }
+    }
+}
+
+template<typename Body>
+void PackedBFMatcherImpl::scanBlocks( const Mat& query, const std::vector<Mat>& masks,
+                                      int q0, int q1, int r0, int r1, Body& body ) const
+{
+    int trainBlockRows = std::max(PACKED_TRAIN_BLOCK_BYTES / rowSize, 1);
+    for( int r = r0; r < r1; r += trainBlockRows )
+    {
+        int rend = std::min(r + trainBlockRows, r1);
+        if( normType == NORM_HAMMING2 )
+            scan<true>(query, masks, q0, q1, r, rend, body);
+        else
+            scan<false>(query, masks, q0, q1, r, rend, body);
+    }
+}
+
+// keeps the k nearest rows of every query, the equal distances are ordered by the rows
+struct PackedKnnCollector
+{
+    PackedKnnCollector( int* _dist, int* _idx, int _q0, int _k ) : dist(_dist), idx(_idx), q0(_q0), k(_k) {}
+
+    inline void operator()( int q, int r, int d )
+    {
+        int* distptr = dist + (size_t)(q - q0)*k;
+        int* idxptr = idx + (size_t)(q - q0)*k;
+        if( d < distptr[k-1] )
+        {
+            int j = k - 2;
+            for( ; j >= 0 && distptr[j] > d; j-- )
+            {
+                idxptr[j+1] = idxptr[j];
+                distptr[j+1] = distptr[j];
+            }
+            idxptr[j+1] = r;
+            distptr[j+1] = d;
+        }
+    }
+
+    int* dist;
+    int* idx;
+    int q0, k;
+};
+
+void PackedBFMatcherImpl::knnMatchImpl( InputArray _queryDescriptors, std::vector<std::vector<DMatch> >& matches, int knn,
+                                        InputArrayOfArrays _masks, bool compactResult )
+{
+    CV_INSTRUMENT_REGION();
+
+    matches.clear();
+    if( _queryDescriptors.empty() || count == 0 )
+        return;
+
+    Mat query;
+    packQueries(_queryDescriptors, query);
+    std::vector<Mat> masks;
+    _masks.getMatVector(masks);
+
+    int nqueries = query.rows, nparts = getStorePartCount(nqueries);
+    int nqblocks = (nqueries + PACKED_QUERY_BLOCK - 1) / PACKED_QUERY_BLOCK;
+
+    // the k nearest rows of every query in every part of the store
+    Mat dist(nparts, nqueries*knn, CV_32S, Scalar::all(INT_MAX)), idx(nparts, nqueries*knn, CV_32S, Scalar::all(-1));
+
+    parallel_for_(Range(0, nqblocks*nparts), [&](const Range& range)
+    {
+        for( int task = range.start; task < range.end; task++ )
+        {
+            int part = task % nparts, q0 = (task / nparts)*PACKED_QUERY_BLOCK;
+            int q1 = std::min(q0 + PACKED_QUERY_BLOCK, nqueries);
+            PackedKnnCollector collector(dist.ptr<int>(part) + (size_t)q0*knn, idx.ptr<int>(part) + (size_t)q0*knn, q0, knn);
+            scanBlocks(query, masks, q0, q1, (int)((int64)count*part/nparts), (int)((int64)count*(part + 1)/nparts), collector);
+        }
+    }, nqblocks*nparts);
+
+    matches.reserve(nqueries);
+    std::vector<int> pos(nparts);
+    for( int q = 0; q < nqueries; q++ )
+    {
+        matches.push_back(std::vector<DMatch>());
+        std::vector<DMatch>& mq = matches.back();
+        mq.reserve(knn);
+
+        // the parts cover the ascending ranges of the rows, so preferring the earlier part on the equal distances
+        // gives the same order as a single pass over the store
+        std::fill(pos.begin(), pos.end(), 0);
+        for( int k = 0; k < knn; k++ )
+        {
+            int best = -1, bestDist = INT_MAX;
+            for( int part = 0; part < nparts; part++ )
+            {
+                int j = q*knn + pos[part];
+                if( pos[part] < knn && idx.at<int>(part, j) >= 0 && (best < 0 || dist.at<int>(part, j) < bestDist) )
+                {
+                    best = part;
+                    bestDist = dist.at<int>(part, j);
+                }
+            }
+            if( best < 0 )
+                break;
+            int r = idx.at<int>(best, q*knn + pos[best]++);
+            mq.push_back(DMatch(q, storeTrainIdx[r], storeImgIdx[r], (float)bestDist));
+        }
+
+        if( mq.empty() && compactResult )
+            matches.pop_back();
+    }
+}
+
+// collects the rows within the radius of every query
+struct PackedRadiusCollector
+{
+    PackedRadiusCollector( std::vector<std::vector<Vec2i> >& _found, int _maxDistance )
+        : found(_found), maxDistance(_maxDistance) {}
+
+    inline void operator()( int q, int r, int d )
+    {
+        if( d <= maxDistance )
+            found[q].push_back(Vec2i(d, r));
+    }
+
+    std::vector<std::vector<Vec2i> >& found;
+    int maxDistance;
+};
+
+void PackedBFMatcherImpl::radiusMatchImpl( InputArray _queryDescriptors, std::vector<std::vector<DMatch> >& matches,
+                                           float maxDistance, InputArrayOfArrays _masks, bool compactResult )
+{
+    CV_INSTRUMENT_REGION();
+
+    matches.clear();
+    if( _queryDescriptors.empty() || count == 0 )
+        return;
+
+    Mat query;
+    packQueries(_queryDescriptors, query);
+    std::vector<Mat> masks;
+    _masks.getMatVector(masks);
+
+    int nqueries = query.rows, nparts = getStorePartCount(nqueries);
+    int nqblocks = (nqueries + PACKED_QUERY_BLOCK - 1) / PACKED_QUERY_BLOCK;
+    // the distances are integer, so d <= maxDistance is the same as d <= floor(maxDistance)
+    int maxDist = (int)std::min(std::floor(maxDistance), (float)INT_MAX);
+
+    std::vector<std::vector<std::vector<Vec2i> > > found(nparts, std::vector<std::vector<Vec2i> >(nqueries));
+    parallel_for_(Range(0, nqblocks*nparts), [&](const Range& range)
+    {
+        for( int task = range.start; task < range.end; task++ )
+        {
+            int part = task % nparts, q0 = (task / nparts)*PACKED_QUERY_BLOCK;
+            int q1 = std::min(q0 + PACKED_QUERY_BLOCK, nqueries);
+            PackedRadiusCollector collector(found[part], maxDist);
+            scanBlocks(query, masks, q0, q1, (int)((int64)count*part/nparts), (int)((int64)count*(part + 1)/nparts), collector);
+        }
+    }, nqblocks*nparts);
+
+    matches.resize(nqueries);
+    int qIdx0 = 0;
+    for( int q = 0; q < nqueries; q++ )
+    {
+        std::vector<Vec2i> all;
+        for( int part = 0; part < nparts; part++ )
+            all.insert(all.end(), found[part][q].begin(), found[part][q].end());
+        if( all.empty() && compactResult )
+            continue;
+
+        // (distance, row) pairs, so the equal distances are ordered by the rows
+        std::sort(all.begin(), all.end(), [](const Vec2i& a, const Vec2i& b)
+        { return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]); });
+
+        std::vector<DMatch>& mq = matches[qIdx0++];
+        mq.clear();
+        mq.reserve(all.size());
+        for( size_t j = 0; j < all.size(); j++ )
+            mq.push_back(DMatch(q, storeTrainIdx[all[j][1]], storeImgIdx[all[j][1]], (float)all[j][0]));
+    }
+    matches.resize(qIdx0);
+}
+
+Ptr<PackedBFMatcher> PackedBFMatcher::create( int normType )
+{
+    return makePtr<PackedBFMatcherImpl>(normType);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /*
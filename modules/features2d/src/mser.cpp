@@ -367,27 +367,36 @@ public:
                         std::vector<Rect>& bboxes ) CV_OVERRIDE;
     void detect( InputArray _src, vector<KeyPoint>& keypoints, InputArray _mask ) CV_OVERRIDE;
 
-    void preprocess1( const Mat& img, int* level_size )
+    // the buffers of one pass; MSER- gets its own ones to run concurrently with MSER+, they are
+    // released after the call, so only the buffers of passbuf[0] are kept between the calls
+    struct PassBuffers
+    {
+        vector<Pixel> pixbuf;
+        vector<Pixel*> heapbuf;
+        vector<CompHistory> histbuf;
+    };
+
+    void preprocess( const Mat& img, int* level_size, PassBuffers& buf, bool brighterToDarker )
     {
         memset(level_size, 0, 256*sizeof(level_size[0]));
 
         int i, j, cols = img.cols, rows = img.rows;
         int step = cols;
-        pixbuf.resize(step*rows);
-        heapbuf.resize(cols*rows + 256);
-        histbuf.resize(cols*rows);
+        buf.pixbuf.resize(step*rows);
+        buf.heapbuf.resize(cols*rows + 256);
+        buf.histbuf.resize(cols*rows);
         Pixel borderpix;
         borderpix.setDir(5);
 
         for( j = 0; j < step; j++ )
         {
-            pixbuf[j] = pixbuf[j + (rows-1)*step] = borderpix;
+            buf.pixbuf[j] = buf.pixbuf[j + (rows-1)*step] = borderpix;
         }
 
         for( i = 1; i < rows-1; i++ )
         {
             const uchar* imgptr = img.ptr(i);
-            Pixel* pptr = &pixbuf[i*step];
+            Pixel* pptr = &buf.pixbuf[i*step];
             pptr[0] = pptr[cols-1] = borderpix;
             for( j = 1; j < cols-1; j++ )
             {
@@ -396,36 +405,20 @@ public:
                 pptr[j].val = 0;
             }
         }
-    }
 
-    void preprocess2( const Mat& img, int* level_size )
-    {
-        int i;
-
-        for( i = 0; i < 128; i++ )
-            std::swap(level_size[i], level_size[255-i]);
-
-        if( !params.pass2Only )
+        if( brighterToDarker )
         {
-            int j, cols = img.cols, rows = img.rows;
-            int step = cols;
-            for( i = 1; i < rows-1; i++ )
-            {
-                Pixel* pptr = &pixbuf[i*step];
-                for( j = 1; j < cols-1; j++ )
-                {
-                    pptr[j].val = 0;
-                }
-            }
+            for( i = 0; i < 128; i++ )
+                std::swap(level_size[i], level_size[255-i]);
         }
     }
 
     void pass( const Mat& img, vector<vector<Point> >& msers, vector<Rect>& bboxvec,
-              Size size, const int* level_size, int mask )
+              Size size, const int* level_size, int mask, PassBuffers& buf )
     {
-        CompHistory* histptr = &histbuf[0];
+        CompHistory* histptr = &buf.histbuf[0];
         int step = size.width;
-        Pixel *ptr0 = &pixbuf[0], *ptr = &ptr0[step+1];
+        Pixel *ptr0 = &buf.pixbuf[0], *ptr = &ptr0[step+1];
         const uchar* imgptr0 = img.ptr();
         Pixel** heap[256];
         ConnectedComp comp[257];
@@ -437,7 +430,7 @@ public:
         wp.pix0 = ptr0;
         wp.step = step;
 
-        heap[0] = &heapbuf[0];
+        heap[0] = &buf.heapbuf[0];
         heap[0][0] = 0;
 
         for( int i = 1; i < 256; i++ )
@@ -539,9 +532,7 @@ public:
     }
 
     Mat tempsrc;
-    vector<Pixel> pixbuf;
-    vector<Pixel*> heapbuf;
-    vector<CompHistory> histbuf;
+    PassBuffers passbuf[2];
 
     Params params;
 };
@@ -723,45 +714,39 @@ static int preprocessMSER_8uC3( MSCRNode* node,
                                int Ne,
                                int edgeBlurSize )
 {
-    int srccpt = (int)(src.step-src.cols*3);
-    const uchar* srcptr = src.ptr();
-    const uchar* lastptr = srcptr+3;
-    double* dxptr = dx.ptr<double>();
-    for ( int i = 0; i < src.rows; i++ )
-    {
-        for ( int j = 0; j < src.cols-1; j++ )
-        {
-            *dxptr = ChiSquaredDistance( srcptr, lastptr );
-            dxptr++;
-            srcptr += 3;
-            lastptr += 3;
-        }
-        srcptr += srccpt+3;
-        lastptr += srccpt+3;
-    }
-    srcptr = src.ptr();
-    lastptr = srcptr+src.step;
-    double* dyptr = dy.ptr<double>();
-    for ( int i = 0; i < src.rows-1; i++ )
+    // the distances and their blur are computed for the rows and for dx and dy concurrently,
+    // only the edge list below has to be built serially
+    parallel_for_(Range(0, src.rows), [&](const Range& range)
     {
-        for ( int j = 0; j < src.cols; j++ )
+        for ( int i = range.start; i < range.end; i++ )
         {
-            *dyptr = ChiSquaredDistance( srcptr, lastptr );
-            dyptr++;
-            srcptr += 3;
-            lastptr += 3;
+            const uchar* srcptr = src.ptr(i);
+            double* dxptr = dx.ptr<double>(i);
+            for ( int j = 0; j < src.cols-1; j++, srcptr += 3 )
+                dxptr[j] = ChiSquaredDistance( srcptr, srcptr+3 );
+            if ( i < src.rows-1 )
+            {
+                srcptr = src.ptr(i);
+                double* dyptr = dy.ptr<double>(i);
+                for ( int j = 0; j < src.cols; j++, srcptr += 3 )
+                    dyptr[j] = ChiSquaredDistance( srcptr, srcptr+src.step );
+            }
         }
-        srcptr += srccpt;
-        lastptr += srccpt;
-    }
+    });
     // get dx and dy and blur it
     if ( edgeBlurSize >= 1 )
     {
-        GaussianBlur( dx, dx, Size(edgeBlurSize, edgeBlurSize), 0 );
-        GaussianBlur( dy, dy, Size(edgeBlurSize, edgeBlurSize), 0 );
+        parallel_for_(Range(0, 2), [&](const Range& range)
+        {
+            for ( int k = range.start; k < range.end; k++ )
+            {
+                Mat& d = k == 0 ? dx : dy;
+                GaussianBlur( d, d, Size(edgeBlurSize, edgeBlurSize), 0 );
+            }
+        });
     }
-    dxptr = dx.ptr<double>();
-    dyptr = dy.ptr<double>();
+    double* dxptr = dx.ptr<double>();
+    double* dyptr = dy.ptr<double>();
     // assian dx, dy to proper edge list and initialize mscr node
     // the nasty code here intended to avoid extra loops
     MSCRNode* nodeptr = node;
@@ -1057,13 +1042,32 @@ void MSER_Impl::detectRegions( InputArray _src, vector<vector<Point> >& msers, v
             src = tempsrc;
         }
 
-        // darker to brighter (MSER+)
-        preprocess1( src, level_size );
-        if( !params.pass2Only )
-            pass( src, msers, bboxes, size, level_size, 0 );
-        // brighter to darker (MSER-)
-        preprocess2( src, level_size );
-        pass( src, msers, bboxes, size, level_size, 255 );
+        if( params.pass2Only )
+        {
+            // brighter to darker (MSER-)
+            preprocess( src, level_size, passbuf[0], true );
+            pass( src, msers, bboxes, size, level_size, 255, passbuf[0] );
+        }
+        else
+        {
+            // darker to brighter (MSER+) and brighter to darker (MSER-) are independent,
+            // so they run concurrently and their regions are concatenated in the same order
+            vector<vector<Point> > msers2;
+            vector<Rect> bboxes2;
+            parallel_for_(Range(0, 2), [&](const Range& range)
+            {
+                for( int p = range.start; p < range.end; p++ )
+                {
+                    int plevel_size[256];
+                    preprocess( src, plevel_size, passbuf[p], p == 1 );
+                    pass( src, p == 0 ? msers : msers2, p == 0 ? bboxes : bboxes2,
+                          size, plevel_size, p == 0 ? 0 : 255, passbuf[p] );
+                }
+            });
+            passbuf[1] = PassBuffers();
+            msers.insert(msers.end(), msers2.begin(), msers2.end());
+            bboxes.insert(bboxes.end(), bboxes2.begin(), bboxes2.end());
+        }
     }
     else
     {
@@ -48,6 +48,8 @@ namespace cv
 {
 
 const float HARRIS_K = 0.04f;
+// the keypoints are processed in parallel by the stripes of about this size
+const int ORB_POINTS_PER_STRIPE = 128;
 
 template<typename _Tp> inline void copyVectorToUMat(const std::vector<_Tp>& v, OutputArray um)
 {
@@ -133,7 +135,7 @@ HarrisResponses(const Mat& img, const std::vector<Rect>& layerinfo,
 {
     CV_Assert( img.type() == CV_8UC1 && blockSize*blockSize <= 2048 );
 
-    size_t ptidx, ptsize = pts.size();
+    int ptsize = (int)pts.size();
 
     const uchar* ptr00 = img.ptr<uchar>();
     int step = (int)(img.step/img.elemSize1());
@@ -148,27 +150,30 @@ HarrisResponses(const Mat& img, const std::vector<Rect>& layerinfo,
         for( int j = 0; j < blockSize; j++ )
             ofs[i*blockSize + j] = (int)(i*step + j);
 
-    for( ptidx = 0; ptidx < ptsize; ptidx++ )
+    parallel_for_(Range(0, ptsize), [&](const Range& range)
     {
-        int x0 = cvRound(pts[ptidx].pt.x);
-        int y0 = cvRound(pts[ptidx].pt.y);
-        int z = pts[ptidx].octave;
+        for( int ptidx = range.start; ptidx < range.end; ptidx++ )
+        {
+            int x0 = cvRound(pts[ptidx].pt.x);
+            int y0 = cvRound(pts[ptidx].pt.y);
+            int z = pts[ptidx].octave;
 
-        const uchar* ptr0 = ptr00 + (y0 - r + layerinfo[z].y)*step + x0 - r + layerinfo[z].x;
-        int a = 0, b = 0, c = 0;
+            const uchar* ptr0 = ptr00 + (y0 - r + layerinfo[z].y)*step + x0 - r + layerinfo[z].x;
+            int a = 0, b = 0, c = 0;
 
-        for( int k = 0; k < blockSize*blockSize; k++ )
-        {
-            const uchar* ptr = ptr0 + ofs[k];
-            int Ix = (ptr[1] - ptr[-1])*2 + (ptr[-step+1] - ptr[-step-1]) + (ptr[step+1] - ptr[step-1]);
-            int Iy = (ptr[step] - ptr[-step])*2 + (ptr[step-1] - ptr[-step-1]) + (ptr[step+1] - ptr[-step+1]);
-            a += Ix*Ix;
-            b += Iy*Iy;
-            c += Ix*Iy;
+            for( int k = 0; k < blockSize*blockSize; k++ )
+            {
+                const uchar* ptr = ptr0 + ofs[k];
+                int Ix = (ptr[1] - ptr[-1])*2 + (ptr[-step+1] - ptr[-step-1]) + (ptr[step+1] - ptr[step-1]);
+                int Iy = (ptr[step] - ptr[-step])*2 + (ptr[step-1] - ptr[-step-1]) + (ptr[step+1] - ptr[-step+1]);
+                a += Ix*Ix;
+                b += Iy*Iy;
+                c += Ix*Iy;
+            }
+            pts[ptidx].response = ((float)a * b - (float)c * c -
+                                   harris_k * ((float)a + b) * ((float)a + b))*scale_sq_sq;
         }
-        pts[ptidx].response = ((float)a * b - (float)c * c -
-                               harris_k * ((float)a + b) * ((float)a + b))*scale_sq_sq;
-    }
+    }, ptsize / (double)ORB_POINTS_PER_STRIPE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -177,36 +182,39 @@ static void ICAngles(const Mat& img, const std::vector<Rect>& layerinfo,
                      std::vector<KeyPoint>& pts, const std::vector<int> & u_max, int half_k)
 {
     int step = (int)img.step1();
-    size_t ptidx, ptsize = pts.size();
+    int ptsize = (int)pts.size();
 
-    for( ptidx = 0; ptidx < ptsize; ptidx++ )
+    parallel_for_(Range(0, ptsize), [&](const Range& range)
     {
-        const Rect& layer = layerinfo[pts[ptidx].octave];
-        const uchar* center = &img.at<uchar>(cvRound(pts[ptidx].pt.y) + layer.y, cvRound(pts[ptidx].pt.x) + layer.x);
+        for( int ptidx = range.start; ptidx < range.end; ptidx++ )
+        {
+            const Rect& layer = layerinfo[pts[ptidx].octave];
+            const uchar* center = &img.at<uchar>(cvRound(pts[ptidx].pt.y) + layer.y, cvRound(pts[ptidx].pt.x) + layer.x);
 
-        int m_01 = 0, m_10 = 0;
+            int m_01 = 0, m_10 = 0;
 
-        // Treat the center line differently, v=0
-        for (int u = -half_k; u <= half_k; ++u)
-            m_10 += u * center[u];
+            // Treat the center line differently, v=0
+            for (int u = -half_k; u <= half_k; ++u)
+                m_10 += u * center[u];
 
-        // Go line by line in the circular patch
-        for (int v = 1; v <= half_k; ++v)
-        {
-            // Proceed over the two lines
-            int v_sum = 0;
-            int d = u_max[v];
-            for (int u = -d; u <= d; ++u)
+            // Go line by line in the circular patch
+            for (int v = 1; v <= half_k; ++v)
             {
-                int val_plus = center[u + v*step], val_minus = center[u - v*step];
-                v_sum += (val_plus - val_minus);
-                m_10 += u * (val_plus + val_minus);
+                // Proceed over the two lines
+                int v_sum = 0;
+                int d = u_max[v];
+                for (int u = -d; u <= d; ++u)
+                {
+                    int val_plus = center[u + v*step], val_minus = center[u - v*step];
+                    v_sum += (val_plus - val_minus);
+                    m_10 += u * (val_plus + val_minus);
+                }
+                m_01 += v * v_sum;
             }
-            m_01 += v * v_sum;
-        }
 
-        pts[ptidx].angle = fastAtan2((float)m_01, (float)m_10);
-    }
+            pts[ptidx].angle = fastAtan2((float)m_01, (float)m_10);
+        }
+    }, ptsize / (double)ORB_POINTS_PER_STRIPE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -217,131 +225,134 @@ computeOrbDescriptors( const Mat& imagePyramid, const std::vector<Rect>& layerIn
                        Mat& descriptors, const std::vector<Point>& _pattern, int dsize, int wta_k )
 {
     int step = (int)imagePyramid.step;
-    int j, i, nkeypoints = (int)keypoints.size();
+    int nkeypoints = (int)keypoints.size();
 
-    for( j = 0; j < nkeypoints; j++ )
+    parallel_for_(Range(0, nkeypoints), [&](const Range& range)
     {
-        const KeyPoint& kpt = keypoints[j];
-        const Rect& layer = layerInfo[kpt.octave];
-        float scale = 1.f/layerScale[kpt.octave];
-        float angle = kpt.angle;
+        for( int j = range.start; j < range.end; j++ )
+        {
+            const KeyPoint& kpt = keypoints[j];
+            const Rect& layer = layerInfo[kpt.octave];
+            float scale = 1.f/layerScale[kpt.octave];
+            float angle = kpt.angle;
 
-        angle *= (float)(CV_PI/180.f);
-        float a = (float)cos(angle), b = (float)sin(angle);
+            angle *= (float)(CV_PI/180.f);
+            float a = (float)cos(angle), b = (float)sin(angle);
 
-        const uchar* center = &imagePyramid.at<uchar>(cvRound(kpt.pt.y*scale) + layer.y,
-                                                      cvRound(kpt.pt.x*scale) + layer.x);
-        float x, y;
-        int ix, iy;
-        const Point* pattern = &_pattern[0];
-        uchar* desc = descriptors.ptr<uchar>(j);
+            const uchar* center = &imagePyramid.at<uchar>(cvRound(kpt.pt.y*scale) + layer.y,
+                                                          cvRound(kpt.pt.x*scale) + layer.x);
+            float x, y;
+            int i, ix, iy;
+            const Point* pattern = &_pattern[0];
+            uchar* desc = descriptors.ptr<uchar>(j);
 
     #if 1
         #define GET_VALUE(idx) \
-               (x = pattern[idx].x*a - pattern[idx].y*b, \
-                y = pattern[idx].x*b + pattern[idx].y*a, \
-                ix = cvRound(x), \
-                iy = cvRound(y), \
-                *(center + iy*step + ix) )
+                   (x = pattern[idx].x*a - pattern[idx].y*b, \
+                    y = pattern[idx].x*b + pattern[idx].y*a, \
+                    ix = cvRound(x), \
+                    iy = cvRound(y), \
+                    *(center + iy*step + ix) )
     #else
         #define GET_VALUE(idx) \
-            (x = pattern[idx].x*a - pattern[idx].y*b, \
-            y = pattern[idx].x*b + pattern[idx].y*a, \
-            ix = cvFloor(x), iy = cvFloor(y), \
-            x -= ix, y -= iy, \
-            cvRound(center[iy*step + ix]*(1-x)*(1-y) + center[(iy+1)*step + ix]*(1-x)*y + \
-                    center[iy*step + ix+1]*x*(1-y) + center[(iy+1)*step + ix+1]*x*y))
+                (x = pattern[idx].x*a - pattern[idx].y*b, \
+                y = pattern[idx].x*b + pattern[idx].y*a, \
+                ix = cvFloor(x), iy = cvFloor(y), \
+                x -= ix, y -= iy, \
+                cvRound(center[iy*step + ix]*(1-x)*(1-y) + center[(iy+1)*step + ix]*(1-x)*y + \
+                        center[iy*step + ix+1]*x*(1-y) + center[(iy+1)*step + ix+1]*x*y))
     #endif
 
-        if( wta_k == 2 )
-        {
-            for (i = 0; i < dsize; ++i, pattern += 16)
+            if( wta_k == 2 )
             {
-                int t0, t1, val;
-                t0 = GET_VALUE(0); t1 = GET_VALUE(1);
-                val = t0 < t1;
-                t0 = GET_VALUE(2); t1 = GET_VALUE(3);
-                val |= (t0 < t1) << 1;
-                t0 = GET_VALUE(4); t1 = GET_VALUE(5);
-                val |= (t0 < t1) << 2;
-                t0 = GET_VALUE(6); t1 = GET_VALUE(7);
-                val |= (t0 < t1) << 3;
-                t0 = GET_VALUE(8); t1 = GET_VALUE(9);
-                val |= (t0 < t1) << 4;
-                t0 = GET_VALUE(10); t1 = GET_VALUE(11);
-                val |= (t0 < t1) << 5;
-                t0 = GET_VALUE(12); t1 = GET_VALUE(13);
-                val |= (t0 < t1) << 6;
-                t0 = GET_VALUE(14); t1 = GET_VALUE(15);
-                val |= (t0 < t1) << 7;
-
-                desc[i] = (uchar)val;
+                for (i = 0; i < dsize; ++i, pattern += 16)
+                {
+                    int t0, t1, val;
+                    t0 = GET_VALUE(0); t1 = GET_VALUE(1);
+                    val = t0 < t1;
+                    t0 = GET_VALUE(2); t1 = GET_VALUE(3);
+                    val |= (t0 < t1) << 1;
+                    t0 = GET_VALUE(4); t1 = GET_VALUE(5);
+                    val |= (t0 < t1) << 2;
+                    t0 = GET_VALUE(6); t1 = GET_VALUE(7);
+                    val |= (t0 < t1) << 3;
+                    t0 = GET_VALUE(8); t1 = GET_VALUE(9);
+                    val |= (t0 < t1) << 4;
+                    t0 = GET_VALUE(10); t1 = GET_VALUE(11);
+                    val |= (t0 < t1) << 5;
+                    t0 = GET_VALUE(12); t1 = GET_VALUE(13);
+                    val |= (t0 < t1) << 6;
+                    t0 = GET_VALUE(14); t1 = GET_VALUE(15);
+                    val |= (t0 < t1) << 7;
+
+                    desc[i] = (uchar)val;
+                }
             }
-        }
-        else if( wta_k == 3 )
-        {
-            for (i = 0; i < dsize; ++i, pattern += 12)
+            else if( wta_k == 3 )
             {
-                int t0, t1, t2, val;
-                t0 = GET_VALUE(0); t1 = GET_VALUE(1); t2 = GET_VALUE(2);
-                val = t2 > t1 ? (t2 > t0 ? 2 : 0) : (t1 > t0);
+                for (i = 0; i < dsize; ++i, pattern += 12)
+                {
+                    int t0, t1, t2, val;
+                    t0 = GET_VALUE(0); t1 = GET_VALUE(1); t2 = GET_VALUE(2);
+                    val = t2 > t1 ? (t2 > t0 ? 2 : 0) : (t1 > t0);
 
-                t0 = GET_VALUE(3); t1 = GET_VALUE(4); t2 = GET_VALUE(5);
-                val |= (t2 > t1 ? (t2 > t0 ? 2 : 0) : (t1 > t0)) << 2;
+                    t0 = GET_VALUE(3); t1 = GET_VALUE(4); t2 = GET_VALUE(5);
+                    val |= (t2 > t1 ? (t2 > t0 ? 2 : 0) : (t1 > t0)) << 2;
 
-                t0 = GET_VALUE(6); t1 = GET_VALUE(7); t2 = GET_VALUE(8);
-                val |= (t2 > t1 ? (t2 > t0 ? 2 : 0) : (t1 > t0)) << 4;
+                    t0 = GET_VALUE(6); t1 = GET_VALUE(7); t2 = GET_VALUE(8);
+                    val |= (t2 > t1 ? (t2 > t0 ? 2 : 0) : (t1 > t0)) << 4;
 
-                t0 = GET_VALUE(9); t1 = GET_VALUE(10); t2 = GET_VALUE(11);
-                val |= (t2 > t1 ? (t2 > t0 ? 2 : 0) : (t1 > t0)) << 6;
+                    t0 = GET_VALUE(9); t1 = GET_VALUE(10); t2 = GET_VALUE(11);
+                    val |= (t2 > t1 ? (t2 > t0 ? 2 : 0) : (t1 > t0)) << 6;
 
-                desc[i] = (uchar)val;
+                    desc[i] = (uchar)val;
+                }
             }
-        }
-        else if( wta_k == 4 )
-        {
-            for (i = 0; i < dsize; ++i, pattern += 16)
+            else if( wta_k == 4 )
             {
-                int t0, t1, t2, t3, u, v, k, val;
-                t0 = GET_VALUE(0); t1 = GET_VALUE(1);
-                t2 = GET_VALUE(2); t3 = GET_VALUE(3);
-                u = 0, v = 2;
-                if( t1 > t0 ) t0 = t1, u = 1;
-                if( t3 > t2 ) t2 = t3, v = 3;
-                k = t0 > t2 ? u : v;
-                val = k;
-
-                t0 = GET_VALUE(4); t1 = GET_VALUE(5);
-                t2 = GET_VALUE(6); t3 = GET_VALUE(7);
-                u = 0, v = 2;
-                if( t1 > t0 ) t0 = t1, u = 1;
-                if( t3 > t2 ) t2 = t3, v = 3;
-                k = t0 > t2 ? u : v;
-                val |= k << 2;
-
-                t0 = GET_VALUE(8); t1 = GET_VALUE(9);
-                t2 = GET_VALUE(10); t3 = GET_VALUE(11);
-                u = 0, v = 2;
-                if( t1 > t0 ) t0 = t1, u = 1;
-                if( t3 > t2 ) t2 = t3, v = 3;
-                k = t0 > t2 ? u : v;
-                val |= k << 4;
-
-                t0 = GET_VALUE(12); t1 = GET_VALUE(13);
-                t2 = GET_VALUE(14); t3 = GET_VALUE(15);
-                u = 0, v = 2;
-                if( t1 > t0 ) t0 = t1, u = 1;
-                if( t3 > t2 ) t2 = t3, v = 3;
-                k = t0 > t2 ? u : v;
-                val |= k << 6;
-
-                desc[i] = (uchar)val;
+                for (i = 0; i < dsize; ++i, pattern += 16)
+                {
+                    int t0, t1, t2, t3, u, v, k, val;
+                    t0 = GET_VALUE(0); t1 = GET_VALUE(1);
+                    t2 = GET_VALUE(2); t3 = GET_VALUE(3);
+                    u = 0, v = 2;
+                    if( t1 > t0 ) t0 = t1, u = 1;
+                    if( t3 > t2 ) t2 = t3, v = 3;
+                    k = t0 > t2 ? u : v;
+                    val = k;
+
+                    t0 = GET_VALUE(4); t1 = GET_VALUE(5);
+                    t2 = GET_VALUE(6); t3 = GET_VALUE(7);
+                    u = 0, v = 2;
+                    if( t1 > t0 ) t0 = t1, u = 1;
+                    if( t3 > t2 ) t2 = t3, v = 3;
+                    k = t0 > t2 ? u : v;
+                    val |= k << 2;
+
+                    t0 = GET_VALUE(8); t1 = GET_VALUE(9);
+                    t2 = GET_VALUE(10); t3 = GET_VALUE(11);
+                    u = 0, v = 2;
+                    if( t1 > t0 ) t0 = t1, u = 1;
+                    if( t3 > t2 ) t2 = t3, v = 3;
+                    k = t0 > t2 ? u : v;
+                    val |= k << 4;
+
+                    t0 = GET_VALUE(12); t1 = GET_VALUE(13);
+                    t2 = GET_VALUE(14); t3 = GET_VALUE(15);
+                    u = 0, v = 2;
+                    if( t1 > t0 ) t0 = t1, u = 1;
+                    if( t3 > t2 ) t2 = t3, v = 3;
+                    k = t0 > t2 ? u : v;
+                    val |= k << 6;
+
+                    desc[i] = (uchar)val;
+                }
             }
-        }
-        else
-            CV_Error( Error::StsBadSize, "Wrong wta_k. It can be only 2, 3 or 4." );
+            else
+                CV_Error( Error::StsBadSize, "Wrong wta_k. It can be only 2, 3 or 4." );
         #undef GET_VALUE
-    }
+        }
+    }, nkeypoints / (double)ORB_POINTS_PER_STRIPE);
 }
 
 
@@ -831,37 +842,49 @@ static void computeKeyPoints(const Mat& imagePyramid,
     allKeypoints.clear();
     std::vector<KeyPoint> keypoints;
     std::vector<int> counters(nlevels);
-    keypoints.reserve(nfeaturesPerLevel[0]*2);
+    std::vector<std::vector<KeyPoint> > levelKeypoints(nlevels);
 
-    for( level = 0; level < nlevels; level++ )
+    auto detectLevel = [&](int l)
     {
-        int featuresNum = nfeaturesPerLevel[level];
-        Mat img = imagePyramid(layerInfo[level]);
-        Mat mask = maskPyramid.empty() ? Mat() : maskPyramid(layerInfo[level]);
+        int featuresNum = nfeaturesPerLevel[l];
+        Mat img = imagePyramid(layerInfo[l]);
+        Mat mask = maskPyramid.empty() ? Mat() : maskPyramid(layerInfo[l]);
+        std::vector<KeyPoint>& kpts = levelKeypoints[l];
 
         // Detect FAST features, 20 is a good threshold
         {
         Ptr<FastFeatureDetector> fd = FastFeatureDetector::create(fastThreshold, true);
-        fd->detect(img, keypoints, mask);
+        fd->detect(img, kpts, mask);
         }
 
         // Remove keypoints very close to the border
-        KeyPointsFilter::runByImageBorder(keypoints, img.size(), edgeThreshold);
+        KeyPointsFilter::runByImageBorder(kpts, img.size(), edgeThreshold);
 
         // Keep more points than necessary as FAST does not give amazing corners
-        KeyPointsFilter::retainBest(keypoints, scoreType == ORB_Impl::HARRIS_SCORE ? 2 * featuresNum : featuresNum);
-
-        nkeypoints = (int)keypoints.size();
-        counters[level] = nkeypoints;
+        KeyPointsFilter::retainBest(kpts, scoreType == ORB_Impl::HARRIS_SCORE ? 2 * featuresNum : featuresNum);
 
-        float sf = layerScale[level];
-        for( i = 0; i < nkeypoints; i++ )
+        float sf = layerScale[l];
+        for( size_t k = 0; k < kpts.size(); k++ )
         {
-            keypoints[i].octave = level;
-            keypoints[i].size = patchSize*sf;
+            kpts[k].octave = l;
+            kpts[k].size = patchSize*sf;
         }
+    };
+
+    // The first level is the largest one, it is detected alone so that FAST splits it among
+    // all the threads; the other levels are detected in parallel. The levels are concatenated
+    // in the level order, so the keypoints do not depend on the number of threads
+    detectLevel(0);
+    parallel_for_(Range(1, nlevels), [&](const Range& range)
+    {
+        for( int l = range.start; l < range.end; l++ )
+            detectLevel(l);
+    }, nlevels - 1);
 
-        std::copy(keypoints.begin(), keypoints.end(), std::back_inserter(allKeypoints));
+    for( level = 0; level < nlevels; level++ )
+    {
+        counters[level] = (int)levelKeypoints[level].size();
+        std::copy(levelKeypoints[level].begin(), levelKeypoints[level].end(), std::back_inserter(allKeypoints));
     }
 
     std::vector<Vec3i> ukeypoints_buf;
@@ -1169,14 +1192,21 @@ void ORB_Impl::detectAndCompute( InputArray _image, InputArray _mask,
             initializeOrbPattern(pattern0, pattern, ntuples, wta_k, npoints);
         }
 
-        for( level = 0; level < nLevels; level++ )
+        // preprocess the resized images; the levels and their borders do not overlap in the pyramid,
+        // so the smaller levels are blurred in parallel, after the first one is blurred by all the threads
+        auto blurLevel = [&](int l)
         {
-            // preprocess the resized image
-            Mat workingMat = imagePyramid(layerInfo[level]);
+            Mat workingMat = imagePyramid(layerInfo[l]);
 
             //boxFilter(working_mat, working_mat, working_mat.depth(), Size(5,5), Point(-1,-1), true, BORDER_REFLECT_101);
             GaussianBlur(workingMat, workingMat, Size(7, 7), 2, 2, BORDER_REFLECT_101);
-        }
+        };
+        blurLevel(0);
+        parallel_for_(Range(1, nLevels), [&](const Range& range)
+        {
+            for( int l = range.start; l < range.end; l++ )
+                blurLevel(l);
+        }, nLevels - 1);
 
 #ifdef HAVE_OPENCL
         if( useOCL )
@@ -1215,6 +1245,11 @@ Ptr<ORB> ORB::create(int nfeatures, float scaleFactor, int nlevels, int edgeThre
                              firstLevel, wta_k, scoreType, patchSize, fastThreshold);
 }
 
+bool isORBImpl(const Feature2D* f)
+{
+    return dynamic_cast<const ORB_Impl*>(f) != NULL;
+}
+
 String ORB::getDefaultName() const
 {
     return (Feature2D::getDefaultName() + ".ORB");
@@ -53,4 +53,16 @@
 
 #include <algorithm>
 
+namespace cv
+{
+
+// whether the algorithm is the built-in implementation and not a user class derived from the interface
+bool isORBImpl(const Feature2D* f);
+bool isSIFTImpl(const Feature2D* f);
+bool isAKAZEImpl(const Feature2D* f);
+bool isKAZEImpl(const Feature2D* f);
+bool isBRISKImpl(const Feature2D* f);
+
+}
+
 #endif
@@ -133,11 +133,16 @@ Ptr<SIFT> SIFT::create( int _nfeatures, int _nOctaveLayers,
 {
     CV_TRACE_FUNCTION();
 
-    // SIFT descriptor supports 32bit floating point and 8bit unsigned int.
-    CV_Assert(_descriptorType == CV_32F || _descriptorType == CV_8U);
+    // SIFT descriptor supports 32bit and 16bit floating point and 8bit unsigned int.
+    CV_Assert(_descriptorType == CV_32F || _descriptorType == CV_16F || _descriptorType == CV_8U);
     return makePtr<SIFT_Impl>(_nfeatures, _nOctaveLayers, _contrastThreshold, _edgeThreshold, _sigma, _descriptorType);
 }
 
+bool isSIFTImpl(const Feature2D* f)
+{
+    return dynamic_cast<const SIFT_Impl*>(f) != NULL;
+}
+
 String SIFT::getDefaultName() const
 {
     return (Feature2D::getDefaultName() + ".SIFT");
@@ -278,36 +283,42 @@ void SIFT_Impl::buildDoGPyramid( const std::vector<Mat>& gpyr, std::vector<Mat>&
     parallel_for_(Range(0, nOctaves * (nOctaveLayers + 2)), buildDoGPyramidComputer(nOctaveLayers, gpyr, dogpyr));
 }
 
+static
+void findScaleSpaceExtrema(
+        int o, int i, int threshold, int idx, int step, int cols,
+        int nOctaveLayers, double contrastThreshold, double edgeThreshold, double sigma,
+        const std::vector<Mat>& gauss_pyr, const std::vector<Mat>& dog_pyr,
+        std::vector<KeyPoint>& kpts, const Range& range
+)
+{
+    CV_TRACE_FUNCTION();
+
+    CV_CPU_DISPATCH(findScaleSpaceExtrema, (o, i, threshold, idx, step, cols, nOctaveLayers, contrastThreshold, edgeThreshold, sigma, gauss_pyr, dog_pyr, kpts, range),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
 class findScaleSpaceExtremaComputer : public ParallelLoopBody
 {
 public:
     findScaleSpaceExtremaComputer(
-        int _o,
-        int _i,
         int _threshold,
-        int _idx,
-        int _step,
-        int _cols,
         int _nOctaveLayers,
         double _contrastThreshold,
         double _edgeThreshold,
         double _sigma,
         const std::vector<Mat>& _gauss_pyr,
         const std::vector<Mat>& _dog_pyr,
+        const std::vector<int>& _layer_ofs,
         TLSData<std::vector<KeyPoint> > &_tls_kpts_struct)
 
-        : o(_o),
-          i(_i),
-          threshold(_threshold),
-          idx(_idx),
-          step(_step),
-          cols(_cols),
+        : threshold(_threshold),
           nOctaveLayers(_nOctaveLayers),
           contrastThreshold(_contrastThreshold),
           edgeThreshold(_edgeThreshold),
           sigma(_sigma),
           gauss_pyr(_gauss_pyr),
           dog_pyr(_dog_pyr),
+          layer_ofs(_layer_ofs),
           tls_kpts_struct(_tls_kpts_struct) { }
     void operator()( const cv::Range& range ) const CV_OVERRIDE
     {
@@ -315,19 +326,32 @@ public:
 
         std::vector<KeyPoint>& kpts = tls_kpts_struct.getRef();
 
-        CV_CPU_DISPATCH(findScaleSpaceExtrema, (o, i, threshold, idx, step, cols, nOctaveLayers, contrastThreshold, edgeThreshold, sigma, gauss_pyr, dog_pyr, kpts, range),
-            CV_CPU_DISPATCH_MODES_ALL);
+        // the range enumerates the inner rows of all the layers one after another,
+        // layer_ofs[l] is the index of the first row of the l-th layer
+        int l = (int)(std::upper_bound(layer_ofs.begin(), layer_ofs.end(), range.start) - layer_ofs.begin()) - 1;
+        for( int r = range.start; r < range.end; l++ )
+        {
+            const int o = l / nOctaveLayers, i = l % nOctaveLayers + 1;
+            const int idx = o*(nOctaveLayers+2)+i;
+            const Mat& img = dog_pyr[idx];
+            const int step = (int)img.step1();
+            const int cols = img.cols;
+            const int rend = std::min(range.end, layer_ofs[l+1]);
+            const Range rows(r - layer_ofs[l] + SIFT_IMG_BORDER, rend - layer_ofs[l] + SIFT_IMG_BORDER);
+
+            findScaleSpaceExtrema(o, i, threshold, idx, step, cols, nOctaveLayers, contrastThreshold, edgeThreshold, sigma, gauss_pyr, dog_pyr, kpts, rows);
+            r = rend;
+        }
     }
 private:
-    int o, i;
     int threshold;
-    int idx, step, cols;
     int nOctaveLayers;
     double contrastThreshold;
     double edgeThreshold;
     double sigma;
     const std::vector<Mat>& gauss_pyr;
     const std::vector<Mat>& dog_pyr;
+    const std::vector<int>& layer_ofs;
     TLSData<std::vector<KeyPoint> > &tls_kpts_struct;
 };
 
@@ -345,24 +369,25 @@ void SIFT_Impl::findScaleSpaceExtrema( const std::vector<Mat>& gauss_pyr, const
     keypoints.clear();
     TLSDataAccumulator<std::vector<KeyPoint> > tls_kpts_struct;
 
+    // all the layers are searched in a single parallel loop over their inner rows,
+    // so the small layers of the upper octaves do not leave the threads idle
+    std::vector<int> layer_ofs(1, 0);
     for( int o = 0; o < nOctaves; o++ )
         for( int i = 1; i <= nOctaveLayers; i++ )
         {
-            const int idx = o*(nOctaveLayers+2)+i;
-            const Mat& img = dog_pyr[idx];
-            const int step = (int)img.step1();
-            const int rows = img.rows, cols = img.cols;
-
-            parallel_for_(Range(SIFT_IMG_BORDER, rows-SIFT_IMG_BORDER),
-                findScaleSpaceExtremaComputer(
-                    o, i, threshold, idx, step, cols,
-                    nOctaveLayers,
-                    contrastThreshold,
-                    edgeThreshold,
-                    sigma,
-                    gauss_pyr, dog_pyr, tls_kpts_struct));
+            const Mat& img = dog_pyr[o*(nOctaveLayers+2)+i];
+            layer_ofs.push_back(layer_ofs.back() + std::max(img.rows - 2*SIFT_IMG_BORDER, 0));
         }
 
+    parallel_for_(Range(0, layer_ofs.back()),
+        findScaleSpaceExtremaComputer(
+            threshold,
+            nOctaveLayers,
+            contrastThreshold,
+            edgeThreshold,
+            sigma,
+            gauss_pyr, dog_pyr, layer_ofs, tls_kpts_struct));
+
     std::vector<std::vector<KeyPoint>*> kpt_vecs;
     tls_kpts_struct.gather(kpt_vecs);
     for (size_t i = 0; i < kpt_vecs.size(); ++i) {
@@ -374,12 +399,12 @@ void SIFT_Impl::findScaleSpaceExtrema( const std::vector<Mat>& gauss_pyr, const
 static
 void calcSIFTDescriptor(
         const Mat& img, Point2f ptf, float ori, float scl,
-        int d, int n, Mat& dst, int row
+        int d, int n, Mat& dst, int row, AutoBuffer<float>& scratch
 )
 {
     CV_TRACE_FUNCTION();
 
-    CV_CPU_DISPATCH(calcSIFTDescriptor, (img, ptf, ori, scl, d, n, dst, row),
+    CV_CPU_DISPATCH(calcSIFTDescriptor, (img, ptf, ori, scl, d, n, dst, row, scratch),
         CV_CPU_DISPATCH_MODES_ALL);
 }
 
@@ -390,12 +415,14 @@ public:
                             const std::vector<KeyPoint>& _keypoints,
                             Mat& _descriptors,
                             int _nOctaveLayers,
-                            int _firstOctave)
+                            int _firstOctave,
+                            TLSData<AutoBuffer<float> >& _tls_scratch)
         : gpyr(_gpyr),
           keypoints(_keypoints),
           descriptors(_descriptors),
           nOctaveLayers(_nOctaveLayers),
-          firstOctave(_firstOctave) { }
+          firstOctave(_firstOctave),
+          tls_scratch(_tls_scratch) { }
 
     void operator()( const cv::Range& range ) const CV_OVERRIDE
     {
@@ -405,6 +432,7 @@ public:
         const int end = range.end;
 
         static const int d = SIFT_DESCR_WIDTH, n = SIFT_DESCR_HIST_BINS;
+        AutoBuffer<float>& scratch = tls_scratch.getRef();
 
         for ( int i = begin; i<end; i++ )
         {
@@ -420,7 +448,7 @@ public:
             float angle = 360.f - kpt.angle;
             if(std::abs(angle - 360.f) < FLT_EPSILON)
                 angle = 0.f;
-            calcSIFTDescriptor(img, ptf, angle, size*0.5f, d, n, descriptors, i);
+            calcSIFTDescriptor(img, ptf, angle, size*0.5f, d, n, descriptors, i, scratch);
         }
     }
 private:
@@ -429,13 +457,15 @@ private:
     Mat& descriptors;
     int nOctaveLayers;
     int firstOctave;
+    TLSData<AutoBuffer<float> >& tls_scratch;
 };
 
 static void calcDescriptors(const std::vector<Mat>& gpyr, const std::vector<KeyPoint>& keypoints,
                             Mat& descriptors, int nOctaveLayers, int firstOctave )
 {
     CV_TRACE_FUNCTION();
-    parallel_for_(Range(0, static_cast<int>(keypoints.size())), calcDescriptorsComputer(gpyr, keypoints, descriptors, nOctaveLayers, firstOctave));
+    TLSData<AutoBuffer<float> > tls_scratch;
+    parallel_for_(Range(0, static_cast<int>(keypoints.size())), calcDescriptorsComputer(gpyr, keypoints, descriptors, nOctaveLayers, firstOctave, tls_scratch));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
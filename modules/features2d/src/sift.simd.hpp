@@ -150,7 +150,7 @@ void findScaleSpaceExtrema(
 
 void calcSIFTDescriptor(
         const Mat& img, Point2f ptf, float ori, float scl,
-        int d, int n, Mat& dst, int row
+        int d, int n, Mat& dst, int row, AutoBuffer<float>& scratch
 );
 
 
@@ -555,7 +555,7 @@ void findScaleSpaceExtrema(
 
 void calcSIFTDescriptor(
         const Mat& img, Point2f ptf, float ori, float scl,
-        int d, int n, Mat& dstMat, int row
+        int d, int n, Mat& dstMat, int row, AutoBuffer<float>& scratch
 )
 {
     CV_TRACE_FUNCTION();
@@ -575,17 +575,16 @@ void calcSIFTDescriptor(
     int i, j, k, len = (radius*2+1)*(radius*2+1), histlen = (d+2)*(d+2)*(n+2);
     int rows = img.rows, cols = img.cols;
 
-    cv::utils::BufferArea area;
-    float *X = 0, *Y = 0, *Mag, *Ori = 0, *W = 0, *RBin = 0, *CBin = 0, *hist = 0, *rawDst = 0;
-    area.allocate(X, len, CV_SIMD_WIDTH);
-    area.allocate(Y, len, CV_SIMD_WIDTH);
-    area.allocate(Ori, len, CV_SIMD_WIDTH);
-    area.allocate(W, len, CV_SIMD_WIDTH);
-    area.allocate(RBin, len, CV_SIMD_WIDTH);
-    area.allocate(CBin, len, CV_SIMD_WIDTH);
-    area.allocate(hist, histlen, CV_SIMD_WIDTH);
-    area.allocate(rawDst, len, CV_SIMD_WIDTH);
-    area.commit();
+    // the scratch buffer is kept by the caller and only grows, so the descriptors
+    // of a thread reuse the same memory instead of allocating it per keypoint
+    const int alignStep = (int)(CV_SIMD_WIDTH/sizeof(float));
+    const int alignedLen = alignSize(len, alignStep);
+    const size_t scratchSize = (size_t)alignedLen*6 + alignSize(histlen, alignStep) + alignSize(d*d*n, alignStep) + alignStep;
+    if( scratch.size() < scratchSize )
+        scratch.allocate(scratchSize);
+    float *X = alignPtr(scratch.data(), CV_SIMD_WIDTH), *Y = X + alignedLen, *Mag;
+    float *Ori = Y + alignedLen, *W = Ori + alignedLen, *RBin = W + alignedLen, *CBin = RBin + alignedLen;
+    float *hist = CBin + alignedLen, *rawDst = hist + alignSize(histlen, alignStep);
     Mag = Y;
 
     for( i = 0; i < d+2; i++ )
@@ -813,6 +812,27 @@ if( dstMat.type() == CV_32F )
         dst[k] = saturate_cast<uchar>(rawDst[k]*nrm2);
     }
 }
+else if( dstMat.type() == CV_16F )
+{
+    // the values are integers in [0, 255], so they are exact in half precision
+    float16_t* dst = dstMat.ptr<float16_t>(row);
+#if CV_SIMD
+    v_float32 __dst;
+    v_float32 __min = vx_setzero_f32();
+    v_float32 __max = vx_setall_f32(255.0f); // max of uchar
+    v_float32 __nrm2 = vx_setall_f32(nrm2);
+    for( k = 0; k <= len - v_float32::nlanes; k += v_float32::nlanes )
+    {
+        __dst = vx_load_aligned(rawDst + k);
+        __dst = v_min(v_max(v_cvt_f32(v_round(__dst * __nrm2)), __min), __max);
+        v_pack_store(dst + k, __dst);
+    }
+#endif
+    for( ; k < len; k++ )
+    {
+        dst[k] = float16_t((float)saturate_cast<uchar>(rawDst[k]*nrm2));
+    }
+}
 else // CV_8U
 {
     uint8_t* dst = dstMat.ptr<uint8_t>(row);
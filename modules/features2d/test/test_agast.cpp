@@ -135,4 +135,44 @@ void CV_AgastTest::run( int )
 
 TEST(Features2d_AGAST, regression) { CV_AgastTest test; test.safe_run(); }
 
+TEST(Features2d_AGAST, parallel_matches_serial)
+{
+    Mat image(Size(1280, 720), CV_8UC1);
+    RNG& rng = theRNG();
+    rng.fill(image, RNG::UNIFORM, 0, 80);
+    for (int i = 0; i < 500; i++)
+    {
+        Point center(rng.uniform(0, image.cols), rng.uniform(0, image.rows));
+        circle(image, center, rng.uniform(2, 30), Scalar(rng.uniform(64, 256)), -1);
+    }
+    GaussianBlur(image, image, Size(3, 3), 0);
+
+    const int nthreads = cv::getNumThreads();
+    const AgastFeatureDetector::DetectorType types[] = {
+        AgastFeatureDetector::AGAST_5_8, AgastFeatureDetector::AGAST_7_12d,
+        AgastFeatureDetector::AGAST_7_12s, AgastFeatureDetector::OAST_9_16
+    };
+    for (int t = 0; t < 4; t++)
+    {
+        for (int nms = 0; nms < 2; nms++)
+        {
+            SCOPED_TRACE(cv::format("type=%d nonmax=%d", (int)types[t], nms));
+            std::vector<KeyPoint> keypoints1, keypoints4;
+            cv::setNumThreads(1);
+            AGAST(image, keypoints1, 20, nms != 0, types[t]);
+            cv::setNumThreads(4);
+            AGAST(image, keypoints4, 20, nms != 0, types[t]);
+            cv::setNumThreads(nthreads);
+
+            ASSERT_FALSE(keypoints1.empty());
+            ASSERT_EQ(keypoints1.size(), keypoints4.size());
+            for (size_t i = 0; i < keypoints1.size(); i++)
+            {
+                ASSERT_EQ(keypoints1[i].pt, keypoints4[i].pt) << i;
+                ASSERT_EQ(keypoints1[i].response, keypoints4[i].response) << i;
+            }
+        }
+    }
+}
+
 }} // namespace
@@ -0,0 +1,47 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "test_precomp.hpp"
+#include "test_parallel_utils.hpp"
+
+namespace opencv_test { namespace {
+
+TEST(Features2d_SimpleBlobDetector, threads)
+{
+    Mat image(240, 320, CV_8U, Scalar::all(255));
+    vector<Point> centers;
+    for (int y = 30; y < image.rows; y += 60)
+        for (int x = 30; x < image.cols; x += 60)
+        {
+            centers.push_back(Point(x, y));
+            circle(image, centers.back(), 8 + (x + y) % 12, Scalar::all((x * 7 + y * 3) % 150), FILLED);
+        }
+    GaussianBlur(image, image, Size(), 1.5);
+
+    NumThreadsGuard threadsGuard;
+    Ptr<SimpleBlobDetector> detector = SimpleBlobDetector::create();
+    vector<KeyPoint> expected;
+    setNumThreads(1);
+    detector->detect(image, expected);
+    ASSERT_EQ(centers.size(), expected.size());
+    for (size_t i = 0; i < centers.size(); i++)
+    {
+        double minDist = DBL_MAX;
+        for (size_t j = 0; j < expected.size(); j++)
+            minDist = std::min(minDist, cv::norm(Point2f(centers[i]) - expected[j].pt));
+        EXPECT_LT(minDist, 1.) << "blob " << centers[i];
+    }
+
+    setNumThreads(4);
+    vector<KeyPoint> keypoints;
+    detector->detect(image, keypoints);
+    ASSERT_EQ(expected.size(), keypoints.size());
+    for (size_t i = 0; i < keypoints.size(); i++)
+    {
+        EXPECT_EQ(expected[i].pt, keypoints[i].pt);
+        EXPECT_EQ(expected[i].size, keypoints[i].size);
+    }
+}
+
+}} // namespace
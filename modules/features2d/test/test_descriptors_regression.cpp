@@ -3,6 +3,7 @@
 // of this distribution and at http://opencv.org/license.html
 
 #include "test_precomp.hpp"
+#include "test_parallel_utils.hpp"
 
 namespace opencv_test { namespace {
 const string FEATURES2D_DIR = "features2d";
@@ -127,6 +128,82 @@ TEST( Features2d_DescriptorExtractor, batch_SIFT )
     }
 }
 
+TEST( Features2d_DescriptorExtractor, batch_detectAndCompute )
+{
+    RNG rng((uint64)12345);
+    vector<Mat> imgs(7), masks(imgs.size());
+    for( size_t i = 0; i < imgs.size(); i++ )
+    {
+        imgs[i] = generateCirclesImage(rng, Size(200, 160 + 16*(int)i), CV_8U, 40, 15, 64, 1.);
+        masks[i] = Mat(imgs[i].size(), CV_8U, Scalar::all(255));
+        masks[i].rowRange(0, masks[i].rows/2) = Scalar::all(0);
+    }
+    imgs[3] = Scalar::all(0);  // no keypoints
+
+    Ptr<Feature2D> features[] = { ORB::create(), SIFT::create(), AKAZE::create() };
+    NumThreadsGuard threadsGuard;
+    for( size_t f = 0; f < sizeof(features)/sizeof(features[0]); f++ )
+    {
+        vector<vector<KeyPoint> > expectedKeypoints(imgs.size());
+        vector<Mat> expected(imgs.size());
+        for( size_t i = 0; i < imgs.size(); i++ )
+            features[f]->detectAndCompute(imgs[i], masks[i], expectedKeypoints[i], expected[i]);
+
+        for( int threads = 1; threads <= 4; threads += 3 )
+        {
+            setNumThreads(threads);
+            vector<vector<KeyPoint> > keypoints;
+            vector<int> offsets;
+            Mat descriptors;
+            features[f]->detectAndCompute(imgs, masks, keypoints, descriptors, offsets);
+            ASSERT_EQ(imgs.size(), keypoints.size());
+            ASSERT_EQ(imgs.size() + 1, offsets.size());
+            EXPECT_EQ(features[f]->descriptorType(), descriptors.type());
+            EXPECT_EQ(0, offsets[0]);
+            EXPECT_EQ(descriptors.rows, offsets.back());
+            EXPECT_EQ(offsets[3], offsets[4]);
+            for( size_t i = 0; i < imgs.size(); i++ )
+            {
+                ASSERT_EQ(expectedKeypoints[i].size(), keypoints[i].size()) << "image " << i;
+                ASSERT_EQ(expected[i].rows, offsets[i+1] - offsets[i]) << "image " << i;
+                if( expected[i].empty() )
+                    continue;
+                EXPECT_EQ(0, cvtest::norm(expected[i], descriptors.rowRange(offsets[i], offsets[i+1]), NORM_INF))
+                    << features[f]->getDefaultName() << ", image " << i << ", threads " << threads;
+            }
+
+            // the descriptors of the provided keypoints
+            vector<int> offsets2;
+            Mat descriptors2;
+            features[f]->detectAndCompute(imgs, noArray(), keypoints, descriptors2, offsets2, true);
+            ASSERT_EQ(imgs.size() + 1, offsets2.size());
+            for( size_t i = 0; i < imgs.size(); i++ )
+            {
+                Mat single;
+                vector<KeyPoint> singleKeypoints = expectedKeypoints[i];
+                features[f]->compute(imgs[i], singleKeypoints, single);
+                ASSERT_EQ(single.rows, offsets2[i+1] - offsets2[i]) << "image " << i;
+                if( single.empty() )
+                    continue;
+                EXPECT_EQ(0, cvtest::norm(single, descriptors2.rowRange(offsets2[i], offsets2[i+1]), NORM_INF));
+            }
+        }
+    }
+
+    // the detectors without descriptors
+    Ptr<Feature2D> fast = FastFeatureDetector::create();
+    vector<vector<KeyPoint> > keypoints;
+    vector<int> offsets;
+    fast->detectAndCompute(imgs, masks, keypoints, noArray(), offsets);
+    ASSERT_EQ(imgs.size(), keypoints.size());
+    EXPECT_EQ(vector<int>(imgs.size() + 1, 0), offsets);
+    for( size_t i = 0; i < imgs.size(); i++ )
+    {
+        vector<KeyPoint> expectedKeypoints;
+        fast->detect(imgs[i], expectedKeypoints, masks[i]);
+        EXPECT_EQ(expectedKeypoints.size(), keypoints[i].size()) << "image " << i;
+    }
+}
 
 class DescriptorImage : public TestWithParam<std::string>
 {
@@ -135,4 +135,43 @@ void CV_FastTest::run( int )
 
 TEST(Features2d_FAST, regression) { CV_FastTest test; test.safe_run(); }
 
+TEST(Features2d_FAST, parallel_matches_serial)
+{
+    Mat image(Size(1280, 720), CV_8UC1);
+    RNG& rng = theRNG();
+    rng.fill(image, RNG::UNIFORM, 0, 80);
+    for (int i = 0; i < 500; i++)
+    {
+        Point center(rng.uniform(0, image.cols), rng.uniform(0, image.rows));
+        circle(image, center, rng.uniform(2, 30), Scalar(rng.uniform(64, 256)), -1);
+    }
+    GaussianBlur(image, image, Size(3, 3), 0);
+
+    const int nthreads = cv::getNumThreads();
+    const FastFeatureDetector::DetectorType types[] = {
+        FastFeatureDetector::TYPE_5_8, FastFeatureDetector::TYPE_7_12, FastFeatureDetector::TYPE_9_16
+    };
+    for (int t = 0; t < 3; t++)
+    {
+        for (int nms = 0; nms < 2; nms++)
+        {
+            SCOPED_TRACE(cv::format("type=%d nonmax=%d", (int)types[t], nms));
+            std::vector<KeyPoint> keypoints1, keypoints4;
+            cv::setNumThreads(1);
+            FAST(image, keypoints1, 20, nms != 0, types[t]);
+            cv::setNumThreads(4);
+            FAST(image, keypoints4, 20, nms != 0, types[t]);
+            cv::setNumThreads(nthreads);
+
+            ASSERT_FALSE(keypoints1.empty());
+            ASSERT_EQ(keypoints1.size(), keypoints4.size());
+            for (size_t i = 0; i < keypoints1.size(); i++)
+            {
+                ASSERT_EQ(keypoints1[i].pt, keypoints4[i].pt) << i;
+                ASSERT_EQ(keypoints1[i].response, keypoints4[i].response) << i;
+            }
+        }
+    }
+}
+
 }} // namespace
@@ -599,6 +599,38 @@ TEST( Features2d_FlannBasedMatcher, read_write )
 
     EXPECT_EQ(ymlfile, out);
 }
+
+TEST( Features2d_FlannBasedMatcher, hnsw )
+{
+    RNG& rng = theRNG();
+    Mat train(2000, 32, CV_32F), query(200, 32, CV_32F);
+    rng.fill(train, RNG::UNIFORM, 0.f, 1.f);
+    rng.fill(query, RNG::UNIFORM, 0.f, 1.f);
+
+    FlannBasedMatcher flann(makePtr<flann::HNSWIndexParams>(16, 100), makePtr<flann::SearchParams>(128));
+    flann.add(train);
+    flann.train();
+    vector<DMatch> expected, actual;
+    BFMatcher(NORM_L2).match(query, train, expected);
+    flann.match(query, actual);
+
+    ASSERT_EQ(expected.size(), actual.size());
+    int same = 0;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_EQ(expected[i].queryIdx, actual[i].queryIdx);
+        EXPECT_GE(actual[i].distance, expected[i].distance * (1 - FLT_EPSILON));
+        same += actual[i].distance <= expected[i].distance * (1 + FLT_EPSILON);
+    }
+    EXPECT_GE(same, query.rows * 9 / 10);
+
+    // 8-bit descriptors are not matched with a guessed distance
+    FlannBasedMatcher binary(makePtr<flann::HNSWIndexParams>(16, 100));
+    Mat train8u;
+    train.convertTo(train8u, CV_8U, 255);
+    binary.add(train8u);
+    EXPECT_THROW(binary.train(), cv::Exception);
+}
 #endif
 
 TEST(Features2d_DMatch, issue_11855)
@@ -632,4 +664,125 @@ TEST(Features2d_DMatch, issue_17771)
     EXPECT_NO_THROW(ubf->knnMatch(usources, utargets, match, 1, mask, true));
 }
 
+static void expectSameMatches(const vector<vector<DMatch> >& expected, const vector<vector<DMatch> >& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        ASSERT_EQ(expected[i].size(), actual[i].size()) << "query " << i;
+        for (size_t j = 0; j < expected[i].size(); j++)
+        {
+            EXPECT_EQ(expected[i][j].queryIdx, actual[i][j].queryIdx);
+            EXPECT_EQ(expected[i][j].trainIdx, actual[i][j].trainIdx) << "query " << i << " match " << j;
+            EXPECT_EQ(expected[i][j].imgIdx, actual[i][j].imgIdx) << "query " << i << " match " << j;
+            EXPECT_EQ(expected[i][j].distance, actual[i][j].distance);
+        }
+    }
+}
+
+typedef testing::TestWithParam<tuple<int, int> > Features2d_PackedBFMatcher;
+
+TEST_P(Features2d_PackedBFMatcher, matches_BFMatcher)
+{
+    const int normType = get<0>(GetParam()), descSize = get<1>(GetParam());
+    RNG& rng = theRNG();
+    const int nthreads = getNumThreads();
+
+    // few distinct values, so there are a lot of equal distances
+    vector<Mat> train(4);
+    for (size_t i = 0; i < train.size(); i++)
+    {
+        train[i].create(300 + 100*(int)i, descSize, CV_8U);
+        rng.fill(train[i], RNG::UNIFORM, 0, 4);
+    }
+    Mat query(150, descSize, CV_8U);
+    rng.fill(query, RNG::UNIFORM, 0, 4);
+
+    vector<Mat> masks(train.size());
+    for (size_t i = 0; i < train.size(); i++)
+    {
+        if (i == 1)
+            continue;  // an empty mask allows all the descriptors
+        masks[i].create(query.rows, train[i].rows, CV_8U);
+        rng.fill(masks[i], RNG::UNIFORM, 0, 2);
+    }
+
+    Ptr<PackedBFMatcher> packed = PackedBFMatcher::create(normType);
+    packed->add(vector<Mat>(train.begin(), train.begin() + 2));
+    packed->add(train[2]);
+    packed->add(vector<Mat>(1, train[3]));
+    EXPECT_EQ(1800, packed->getDescriptorCount());
+
+    Ptr<BFMatcher> bf = BFMatcher::create(normType);
+    bf->add(train);
+
+    for (int threads = 1; threads <= 4; threads += 3)
+    {
+        setNumThreads(threads);
+        for (int k = 1; k <= 5; k += 2)
+        {
+            vector<vector<DMatch> > expected, actual, expectedMasked, actualMasked;
+            bf->knnMatch(query, expected, k);
+            packed->knnMatch(query, actual, k);
+            expectSameMatches(expected, actual);
+
+            bf->knnMatch(query, expectedMasked, k, masks);
+            packed->knnMatch(query, actualMasked, k, masks);
+            expectSameMatches(expectedMasked, actualMasked);
+        }
+
+        const float radius = descSize*0.9f;
+        vector<vector<DMatch> > expected, actual;
+        bf->radiusMatch(query, expected, radius, masks, true);
+        packed->radiusMatch(query, actual, radius, masks, true);
+        // BFMatcher orders the equal distances of a radius match arbitrarily
+        for (size_t i = 0; i < expected.size(); i++)
+            std::stable_sort(expected[i].begin(), expected[i].end(), [](const DMatch& a, const DMatch& b)
+            { return a.distance < b.distance || (a.distance == b.distance && (a.imgIdx < b.imgIdx ||
+                     (a.imgIdx == b.imgIdx && a.trainIdx < b.trainIdx))); });
+        expectSameMatches(expected, actual);
+    }
+
+    // the removed collection stays as an empty one, so the rest keep their indices
+    packed->remove(1);
+    EXPECT_EQ(1400, packed->getDescriptorCount());
+    EXPECT_TRUE(packed->getTrainDescriptors()[1].empty());
+    // BFMatcher skips the removed collection by its mask
+    vector<Mat> restMasks = masks;
+    restMasks[1] = Mat::zeros(query.rows, train[1].rows, CV_8U);
+    for (int threads = 1; threads <= 4; threads += 3)
+    {
+        setNumThreads(threads);
+        vector<vector<DMatch> > expected, actual, actualCopy;
+        bf->knnMatch(query, expected, 3, restMasks);
+        packed->knnMatch(query, actual, 3, masks);
+        expectSameMatches(expected, actual);
+
+        Ptr<DescriptorMatcher> copy = packed->clone();
+        copy->knnMatch(query, actualCopy, 3, masks);
+        expectSameMatches(expected, actualCopy);
+
+        // the mask of the removed collection is ignored, whatever its size
+        vector<Mat> removedMasks = masks;
+        removedMasks[1].create(query.rows, train[1].rows, CV_8U);
+        rng.fill(removedMasks[1], RNG::UNIFORM, 0, 2);
+        vector<vector<DMatch> > actualRemoved, expectedRadius, actualRadius;
+        packed->knnMatch(query, actualRemoved, 3, removedMasks);
+        expectSameMatches(expected, actualRemoved);
+        removedMasks[1] = Mat::ones(1, 7, CV_8U);
+        packed->radiusMatch(query, expectedRadius, descSize*0.9f, masks);
+        packed->radiusMatch(query, actualRadius, descSize*0.9f, removedMasks);
+        expectSameMatches(expectedRadius, actualRadius);
+    }
+    setNumThreads(nthreads);
+
+    packed->clear();
+    EXPECT_TRUE(packed->empty());
+    EXPECT_EQ(0, packed->getDescriptorCount());
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Features2d_PackedBFMatcher, testing::Combine(
+    testing::Values((int)NORM_HAMMING, (int)NORM_HAMMING2),
+    testing::Values(5, 32, 61)));
+
 }} // namespace
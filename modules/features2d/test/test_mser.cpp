@@ -41,6 +41,7 @@
 //M*/
 
 #include "test_precomp.hpp"
+#include "test_parallel_utils.hpp"
 
 namespace opencv_test { namespace {
 
@@ -179,4 +180,35 @@ TEST(Features2d_MSER, history_update_regression)
     }
 }
 
+TEST(Features2d_MSER, threads)
+{
+    RNG rng((uint64)7);
+    Mat gray = generateCirclesImage(rng, Size(320, 240), CV_8U, 60, 25, 100, 2);
+    Mat color = generateCirclesImage(rng, Size(200, 160), CV_8UC3, 60, 25, 100, 1);
+
+    NumThreadsGuard threadsGuard;
+    const Mat* images[] = { &gray, &gray, &color };
+    for( int k = 0; k < 3; k++ )
+    {
+        Ptr<MSER> mser = MSER::create(5, 30, 8000);
+        mser->setPass2Only(k == 1);
+        vector<vector<Point> > expected, msers;
+        vector<Rect> expectedBoxes, boxes;
+        setNumThreads(1);
+        mser->detectRegions(*images[k], expected, expectedBoxes);
+        EXPECT_LT(10u, expected.size());
+
+        setNumThreads(4);
+        // the second call reuses the buffers of the first one
+        for( int iter = 0; iter < 2; iter++ )
+        {
+            mser->detectRegions(*images[k], msers, boxes);
+            ASSERT_EQ(expected.size(), msers.size()) << "case " << k;
+            EXPECT_EQ(expectedBoxes, boxes);
+            for( size_t i = 0; i < msers.size(); i++ )
+                EXPECT_EQ(expected[i], msers[i]) << "case " << k << ", region " << i;
+        }
+    }
+}
+
 }} // namespace
@@ -123,4 +123,47 @@ TEST(Features2D_ORB, crash)
     ASSERT_NO_THROW(orb->compute(image, keypoints, descriptors));
 }
 
+TEST(Features2D_ORB, parallel_matches_serial)
+{
+    Mat image(Size(1280, 720), CV_8UC1);
+    RNG& rng = theRNG();
+    rng.fill(image, RNG::UNIFORM, 0, 64);
+    for (int i = 0; i < 400; i++)
+    {
+        Point center(rng.uniform(0, image.cols), rng.uniform(0, image.rows));
+        circle(image, center, rng.uniform(3, 40), Scalar(rng.uniform(64, 256)), -1);
+        rectangle(image, Rect(center, Size(rng.uniform(5, 60), rng.uniform(5, 60))), Scalar(rng.uniform(0, 256)), -1);
+    }
+    GaussianBlur(image, image, Size(3, 3), 0);
+
+    Mat mask(image.size(), CV_8UC1, Scalar(255));
+    mask(Rect(0, 0, 300, 200)).setTo(0);
+
+    const int nthreads = cv::getNumThreads();
+    for (int scoreType = ORB::HARRIS_SCORE; scoreType <= ORB::FAST_SCORE; scoreType++)
+    {
+        SCOPED_TRACE(scoreType == ORB::HARRIS_SCORE ? "HARRIS_SCORE" : "FAST_SCORE");
+        Ptr<ORB> orb = ORB::create(3000, 1.2f, 8, 31, 0, 2, (ORB::ScoreType)scoreType);
+
+        std::vector<KeyPoint> keypoints1, keypoints4;
+        Mat descriptors1, descriptors4;
+        cv::setNumThreads(1);
+        orb->detectAndCompute(image, mask, keypoints1, descriptors1);
+        cv::setNumThreads(4);
+        orb->detectAndCompute(image, mask, keypoints4, descriptors4);
+        cv::setNumThreads(nthreads);
+
+        ASSERT_GT(keypoints1.size(), 1000u);
+        ASSERT_EQ(keypoints1.size(), keypoints4.size());
+        for (size_t i = 0; i < keypoints1.size(); i++)
+        {
+            ASSERT_EQ(keypoints1[i].pt, keypoints4[i].pt) << i;
+            ASSERT_EQ(keypoints1[i].octave, keypoints4[i].octave) << i;
+            ASSERT_EQ(keypoints1[i].response, keypoints4[i].response) << i;
+            ASSERT_EQ(keypoints1[i].angle, keypoints4[i].angle) << i;
+        }
+        EXPECT_EQ(0, cvtest::norm(descriptors1, descriptors4, NORM_INF));
+    }
+}
+
 }} // namespace
@@ -0,0 +1,40 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#ifndef __OPENCV_TEST_PARALLEL_UTILS_HPP__
+#define __OPENCV_TEST_PARALLEL_UTILS_HPP__
+
+namespace opencv_test { namespace {
+
+// restores the number of threads at the end of the scope, also when an ASSERT fails
+class NumThreadsGuard
+{
+public:
+    NumThreadsGuard() : nthreads(getNumThreads()) {}
+    ~NumThreadsGuard() { setNumThreads(nthreads); }
+
+private:
+    int nthreads;
+};
+
+// a noisy background below the given level with random filled circles above it, blurred
+inline Mat generateCirclesImage(RNG& rng, Size size, int type, int ncircles, int maxRadius, int background, double sigma)
+{
+    Mat image(size, type);
+    rng.fill(image, RNG::UNIFORM, 0, background);
+    for( int i = 0; i < ncircles; i++ )
+    {
+        Point center(rng.uniform(0, size.width), rng.uniform(0, size.height));
+        int radius = rng.uniform(3, maxRadius);
+        Scalar color = image.channels() == 1 ? Scalar::all(rng.uniform(background, 256)) :
+            Scalar(rng.uniform(background, 256), rng.uniform(background, 256), rng.uniform(background, 256));
+        circle(image, center, radius, color, FILLED);
+    }
+    GaussianBlur(image, image, Size(), sigma);
+    return image;
+}
+
+}} // namespace
+
+#endif
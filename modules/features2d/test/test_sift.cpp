@@ -3,6 +3,7 @@
 // of this distribution and at http://opencv.org/license.html
 
 #include "test_precomp.hpp"
+#include "test_parallel_utils.hpp"
 
 namespace opencv_test { namespace {
 
@@ -28,6 +29,50 @@ TEST(Features2d_SIFT, descriptor_type)
     descriptorsUchar.assignTo(descriptorsFloat2, CV_32F);
     Mat diff = descriptorsFloat != descriptorsFloat2;
     ASSERT_EQ(countNonZero(diff), 0) << "descriptors are not identical";
+
+    Mat descriptorsHalf;
+    Ptr<SIFT> siftHalf = cv::SIFT::create(0, 3, 0.04, 10, 1.6, CV_16F);
+    siftHalf->detectAndCompute(gray, Mat(), keypoints, descriptorsHalf, false);
+    ASSERT_EQ(descriptorsHalf.type(), CV_16F) << "type mismatch";
+
+    descriptorsHalf.convertTo(descriptorsFloat2, CV_32F);
+    diff = descriptorsFloat != descriptorsFloat2;
+    ASSERT_EQ(countNonZero(diff), 0) << "descriptors are not identical";
+}
+
+TEST(Features2d_SIFT, compact_descriptors_and_threads)
+{
+    RNG rng(12345);
+    Mat image = generateCirclesImage(rng, Size(320, 240), CV_8U, 60, 20, 64, 1.5);
+
+    NumThreadsGuard threadsGuard;
+    vector<KeyPoint> expectedKeypoints;
+    Mat expected;
+    setNumThreads(1);
+    SIFT::create()->detectAndCompute(image, noArray(), expectedKeypoints, expected);
+    ASSERT_GT(expectedKeypoints.size(), 50u);
+
+    const int types[] = { CV_32F, CV_16F, CV_8U };
+    for (int threads = 1; threads <= 4; threads += 3)
+    {
+        setNumThreads(threads);
+        for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++)
+        {
+            vector<KeyPoint> keypoints;
+            Mat descriptors, descriptorsFloat;
+            Ptr<SIFT> sift = SIFT::create(0, 3, 0.04, 10, 1.6, types[t]);
+            sift->detectAndCompute(image, noArray(), keypoints, descriptors);
+            ASSERT_EQ(types[t], descriptors.type());
+            ASSERT_EQ(expectedKeypoints.size(), keypoints.size());
+            for (size_t i = 0; i < keypoints.size(); i++)
+            {
+                EXPECT_EQ(expectedKeypoints[i].pt, keypoints[i].pt);
+                EXPECT_EQ(expectedKeypoints[i].angle, keypoints[i].angle);
+            }
+            descriptors.convertTo(descriptorsFloat, CV_32F);
+            EXPECT_EQ(0, cvtest::norm(expected, descriptorsFloat, NORM_INF)) << "type " << types[t] << ", threads " << threads;
+        }
+    }
 }
 
 
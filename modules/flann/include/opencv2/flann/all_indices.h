@@ -42,6 +42,8 @@
 #include "linear_index.h"
 #include "hierarchical_clustering_index.h"
 #include "lsh_index.h"
+#include "ivfpq_index.h"
+#include "hnsw_index.h"
 #include "autotuned_index.h"
 
 
@@ -81,6 +83,12 @@ struct index_creator
         case FLANN_INDEX_LSH:
             nnIndex = new LshIndex<Distance>(dataset, params, distance);
             break;
+        case FLANN_INDEX_HNSW:
+            nnIndex = new HNSWIndex<Distance>(dataset, params, distance);
+            break;
+        case FLANN_INDEX_IVFPQ:
+            nnIndex = new IVFPQIndex<Distance>(dataset, params, distance);
+            break;
         default:
             throw FLANNException("Unknown index type");
         }
@@ -110,6 +118,9 @@ struct index_creator<False,VectorSpace,Distance>
         case FLANN_INDEX_LSH:
             nnIndex = new LshIndex<Distance>(dataset, params, distance);
             break;
+        case FLANN_INDEX_HNSW:
+            nnIndex = new HNSWIndex<Distance>(dataset, params, distance);
+            break;
         default:
             throw FLANNException("Unknown index type");
         }
@@ -118,6 +129,33 @@ struct index_creator<False,VectorSpace,Distance>
     }
 };
 
+/* The inner product is not a metric, the indices that prune with the triangle
+ * inequality or cluster around centers would miss the neighbors. */
+template<typename T>
+struct index_creator<False,True,InnerProductDistance<T> >
+{
+    typedef InnerProductDistance<T> Distance;
+
+    static NNIndex<Distance>* create(const Matrix<typename Distance::ElementType>& dataset, const IndexParams& params, const Distance& distance)
+    {
+        flann_algorithm_t index_type = get_param<flann_algorithm_t>(params, "algorithm");
+
+        NNIndex<Distance>* nnIndex;
+        switch (index_type) {
+        case FLANN_INDEX_LINEAR:
+            nnIndex = new LinearIndex<Distance>(dataset, params, distance);
+            break;
+        case FLANN_INDEX_HNSW:
+            nnIndex = new HNSWIndex<Distance>(dataset, params, distance);
+            break;
+        default:
+            throw FLANNException("Unsupported index type for the inner product distance");
+        }
+
+        return nnIndex;
+    }
+};
+
 template<typename Distance>
 struct index_creator<False,False,Distance>
 {
@@ -139,6 +177,9 @@ struct index_creator<False,False,Distance>
         case FLANN_INDEX_LSH:
             nnIndex = new LshIndex<Distance>(dataset, params, distance);
             break;
+        case FLANN_INDEX_HNSW:
+            nnIndex = new HNSWIndex<Distance>(dataset, params, distance);
+            break;
         default:
             throw FLANNException("Unknown index type");
         }
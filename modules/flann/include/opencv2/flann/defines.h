@@ -76,6 +76,8 @@ enum flann_algorithm_t
     FLANN_INDEX_KDTREE_SINGLE = 4,
     FLANN_INDEX_HIERARCHICAL = 5,
     FLANN_INDEX_LSH = 6,
+    FLANN_INDEX_IVFPQ = 7,
+    FLANN_INDEX_HNSW = 8,
     FLANN_INDEX_SAVED = 254,
     FLANN_INDEX_AUTOTUNED = 255,
 
@@ -129,6 +131,7 @@ enum flann_distance_t
     FLANN_DIST_KL                = 8,
     FLANN_DIST_HAMMING          = 9,
     FLANN_DIST_DNAMMING          = 10,
+    FLANN_DIST_INNER_PRODUCT     = 11,
 
     // deprecated constants, should use the FLANN_DIST_* ones instead
     EUCLIDEAN = 1,
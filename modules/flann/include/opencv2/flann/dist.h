@@ -43,7 +43,10 @@ typedef unsigned __int64 uint64_t;
 #include <stdint.h>
 #endif
 
+#include <type_traits>
+
 #include "defines.h"
+#include "opencv2/core/hal/intrin.hpp"
 
 #if defined _WIN32 && (defined(_M_ARM) || defined(_M_ARM64))
 # include <Intrin.h>
@@ -59,6 +62,74 @@ namespace cvflann
 template<typename T>
 inline T abs(T x) { return (x<0) ? -x : x; }
 
+/**
+ * True if both iterators are pointers to float, the distances of float
+ * vectors can be computed with SIMD instructions.
+ */
+template <typename Iterator1, typename Iterator2>
+struct is_float_pointers
+{
+    typedef typename std::remove_cv<typename std::remove_pointer<Iterator1>::type>::type Element1;
+    typedef typename std::remove_cv<typename std::remove_pointer<Iterator2>::type>::type Element2;
+    typedef std::integral_constant<bool, std::is_pointer<Iterator1>::value && std::is_pointer<Iterator2>::value &&
+                                   std::is_same<Element1, float>::value && std::is_same<Element2, float>::value> type;
+};
+
+template <typename Iterator1, typename Iterator2, typename ResultType>
+inline bool simd_l2_sqr(Iterator1, Iterator2, size_t, ResultType&, std::false_type)
+{
+    return false;
+}
+
+inline bool simd_l2_sqr(const float* a, const float* b, size_t size, float& result, std::true_type)
+{
+    size_t i = 0;
+    result = 0;
+#if CV_SIMD
+    const size_t step = cv::v_float32::nlanes;
+    cv::v_float32 s0 = cv::vx_setzero_f32(), s1 = cv::vx_setzero_f32();
+    for (; i + 2*step <= size; i += 2*step) {
+        cv::v_float32 d0 = cv::vx_load(a + i) - cv::vx_load(b + i);
+        cv::v_float32 d1 = cv::vx_load(a + i + step) - cv::vx_load(b + i + step);
+        s0 = cv::v_muladd(d0, d0, s0);
+        s1 = cv::v_muladd(d1, d1, s1);
+    }
+    result = cv::v_reduce_sum(s0 + s1);
+    cv::vx_cleanup();
+#endif
+    for (; i < size; ++i) {
+        float d = a[i] - b[i];
+        result += d * d;
+    }
+    return true;
+}
+
+template <typename Iterator1, typename Iterator2, typename ResultType>
+inline bool simd_dot(Iterator1, Iterator2, size_t, ResultType&, std::false_type)
+{
+    return false;
+}
+
+inline bool simd_dot(const float* a, const float* b, size_t size, float& result, std::true_type)
+{
+    size_t i = 0;
+    result = 0;
+#if CV_SIMD
+    const size_t step = cv::v_float32::nlanes;
+    cv::v_float32 s0 = cv::vx_setzero_f32(), s1 = cv::vx_setzero_f32();
+    for (; i + 2*step <= size; i += 2*step) {
+        s0 = cv::v_muladd(cv::vx_load(a + i), cv::vx_load(b + i), s0);
+        s1 = cv::v_muladd(cv::vx_load(a + i + step), cv::vx_load(b + i + step), s1);
+    }
+    result = cv::v_reduce_sum(s0 + s1);
+    cv::vx_cleanup();
+#endif
+    for (; i < size; ++i) {
+        result += a[i] * b[i];
+    }
+    return true;
+}
+
 template<>
 inline int abs<int>(int x) { return ::abs(x); }
 
@@ -299,6 +370,46 @@ struct L2
 };
 
 
+/**
+ * Inner product distance functor, 1 - a.b. For vectors normalized to unit
+ * length it is the cosine distance, it is not a metric though, so only the
+ * linear and the graph-based indices search with it.
+ */
+template<class T>
+struct InnerProductDistance
+{
+    typedef False is_kdtree_distance;
+    typedef True is_vector_space_distance;
+
+    typedef T ElementType;
+    typedef typename Accumulator<T>::Type ResultType;
+    typedef ResultType CentersType;
+
+    template <typename Iterator1, typename Iterator2>
+    ResultType operator()(Iterator1 a, Iterator2 b, size_t size, ResultType /*worst_dist*/ = -1) const
+    {
+        ResultType result = ResultType();
+        if (simd_dot(a, b, size, result, typename is_float_pointers<Iterator1, Iterator2>::type())) {
+            return 1 - result;
+        }
+
+        ResultType dot0 = 0, dot1 = 0, dot2 = 0, dot3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            dot0 += (ResultType)a[i] * b[i];
+            dot1 += (ResultType)a[i+1] * b[i+1];
+            dot2 += (ResultType)a[i+2] * b[i+2];
+            dot3 += (ResultType)a[i+3] * b[i+3];
+        }
+        result = dot0 + dot1 + dot2 + dot3;
+        for (; i < size; ++i) {
+            result += (ResultType)a[i] * b[i];
+        }
+        return 1 - result;
+    }
+};
+
+
 /*
  * Manhattan distance functor, optimized version
  */
@@ -165,6 +165,22 @@ public:
         nnIndex_->loadIndex(stream);
     }
 
+    virtual void addPoints(const Matrix<ElementType>& points) CV_OVERRIDE
+    {
+        nnIndex_->addPoints(points);
+    }
+
+    virtual void saveFlatIndex(FILE* stream) CV_OVERRIDE
+    {
+        nnIndex_->saveFlatIndex(stream);
+    }
+
+    virtual void attachFlatIndex(const cv::Ptr<FlatBuffer>& buffer, const FlatIndexHeader& header) CV_OVERRIDE
+    {
+        nnIndex_->attachFlatIndex(buffer, header);
+        loaded_ = true;
+    }
+
     /**
      * \returns number of features in this index.
      */
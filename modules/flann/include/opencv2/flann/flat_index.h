@@ -0,0 +1,106 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_FLANN_FLAT_INDEX_H_
+#define OPENCV_FLANN_FLAT_INDEX_H_
+
+//! @cond IGNORED
+
+#include <cstdio>
+
+#include "general.h"
+
+#ifdef FLANN_FLAT_SIGNATURE_
+#undef FLANN_FLAT_SIGNATURE_
+#endif
+#define FLANN_FLAT_SIGNATURE_ "FLANN_FLAT"
+
+namespace cvflann
+{
+
+/**
+ * Version of the flat layout, incremented on every incompatible change.
+ */
+const int FLANN_FLAT_VERSION = 1;
+
+/**
+ * The parts of the flat layout start at the multiples of this many bytes.
+ */
+const size_t FLANN_FLAT_ALIGNMENT = 64;
+
+/**
+ * Header of an index saved in the flat layout.
+ *
+ * The header is followed by the dataset (rows x cols elements) and by the
+ * index section, both starting at a multiple of FLANN_FLAT_ALIGNMENT bytes.
+ * The index section refers to its parts by offsets rather than pointers, so
+ * the whole layout can be mapped into memory read-only and searched in place.
+ * The layout uses the native byte order and type sizes, the header records
+ * its own size to reject the files of an incompatible platform.
+ */
+struct FlatIndexHeader
+{
+    char signature[16];
+    int version;
+    int header_size;
+    int data_type;
+    int index_type;
+    int distance_type;
+    int reserved;
+    uint64 rows;
+    uint64 cols;
+    uint64 data_offset;
+    uint64 index_offset;
+    uint64 index_size;
+};
+
+/**
+ * Read-only memory holding an index in the flat layout, e.g. a mapped file.
+ * The index searched in place keeps the buffer as long as it exists.
+ */
+class FlatBuffer
+{
+public:
+    virtual ~FlatBuffer() {}
+
+    virtual const unsigned char* data() const = 0;
+
+    virtual size_t size() const = 0;
+};
+
+/**
+ * Returns the position in the stream, the files of the flat layout may exceed 2GB.
+ */
+inline int64 flat_stream_position(FILE* stream)
+{
+#ifdef _WIN32
+    return _ftelli64(stream);
+#else
+    return ftello(stream);
+#endif
+}
+
+/**
+ * Pads the stream with zeros to the next multiple of FLANN_FLAT_ALIGNMENT bytes.
+ * @return The padded position
+ */
+inline uint64 align_flat_stream(FILE* stream)
+{
+    static const char zeros[FLANN_FLAT_ALIGNMENT] = {};
+    int64 pos = flat_stream_position(stream);
+    if (pos < 0) {
+        throw FLANNException("Cannot write the flat index");
+    }
+    size_t padding = (FLANN_FLAT_ALIGNMENT - (size_t)pos % FLANN_FLAT_ALIGNMENT) % FLANN_FLAT_ALIGNMENT;
+    if (fwrite(zeros, 1, padding, stream) != padding) {
+        throw FLANNException("Cannot write the flat index");
+    }
+    return (uint64)pos + padding;
+}
+
+}
+
+//! @endcond
+
+#endif /* OPENCV_FLANN_FLAT_INDEX_H_ */
@@ -649,22 +649,39 @@ private:
 
     void computeLabels(int* dsindices, int indices_length,  int* centers, int centers_length, int* labels, DistanceType& cost)
     {
-        cost = 0;
-        for (int i=0; i<indices_length; ++i) {
-            ElementType* point = dataset[dsindices[i]];
-            DistanceType dist = distance(point, dataset[centers[0]], veclen_);
-            labels[i] = 0;
-            for (int j=1; j<centers_length; ++j) {
-                DistanceType new_dist = distance(point, dataset[centers[j]], veclen_);
-                if (dist>new_dist) {
-                    labels[i] = j;
-                    dist = new_dist;
+        // the points of the large nodes are labeled in parallel, the cost is summed up in the original order
+        std::vector<DistanceType> dists(indices_length);
+        cv::parallel_for_(cv::Range(0, indices_length), [&](const cv::Range& range) {
+            for (int i=range.start; i<range.end; ++i) {
+                ElementType* point = dataset[dsindices[i]];
+                DistanceType dist = distance(point, dataset[centers[0]], veclen_);
+                labels[i] = 0;
+                for (int j=1; j<centers_length; ++j) {
+                    DistanceType new_dist = distance(point, dataset[centers[j]], veclen_);
+                    if (dist>new_dist) {
+                        labels[i] = j;
+                        dist = new_dist;
+                    }
                 }
+                dists[i] = dist;
             }
-            cost += dist;
+        }, indices_length >= MIN_PARALLEL_SIZE ? -1. : 1.);
+        cost = 0;
+        for (int i=0; i<indices_length; ++i) {
+            cost += dists[i];
         }
     }
 
+    /**
+     * Allocates memory from the pool, the clusters of a node may be split by several threads.
+     */
+    template <typename T>
+    T* allocateShared(size_t count = 1)
+    {
+        cv::AutoLock lock(pool_mutex);
+        return pool.allocate<T>(count);
+    }
+
     /**
      * The method responsible with actually doing the recursive hierarchical
      * clustering
@@ -706,9 +723,9 @@ private:
         DistanceType cost;
         computeLabels(dsindices, indices_length, &centers[0], centers_length, &labels[0], cost);
 
-        node->childs = pool.allocate<NodePtr>(branching);
-        int start = 0;
-        int end = start;
+        node->childs = allocateShared<NodePtr>(branching);
+        std::vector<int> starts(branching+1, 0);
+        int end = 0;
         for (int i=0; i<branching; ++i) {
             for (int j=0; j<indices_length; ++j) {
                 if (labels[j]==i) {
@@ -718,12 +735,16 @@ private:
                 }
             }
 
-            node->childs[i] = pool.allocate<Node>();
+            node->childs[i] = allocateShared<Node>();
             node->childs[i]->pivot = centers[i];
             node->childs[i]->indices = NULL;
-            computeClustering(node->childs[i],dsindices+start, end-start, branching, level+1);
-            start=end;
+            starts[i+1] = end;
         }
+
+        // the clusters are independent, the clusters of the large nodes are split in parallel
+        parallel_for_seeded(branching, indices_length >= MIN_PARALLEL_SIZE, [&](int i) {
+            computeClustering(node->childs[i],dsindices+starts[i], starts[i+1]-starts[i], branching, level+1);
+        });
     }
 
 
@@ -827,11 +848,24 @@ private:
      */
     PooledAllocator pool;
 
+    /**
+     * Guards the pool while the clusters are split in parallel.
+     */
+    cv::Mutex pool_mutex;
+
     /**
      * Memory occupied by the index.
      */
     int memoryCounter;
 
+    enum
+    {
+        /**
+         * The nodes with at least this many points are split in parallel.
+         */
+        MIN_PARALLEL_SIZE = 4096
+    };
+
     /** index parameters */
     int branching_;
     int trees_;
@@ -0,0 +1,718 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_FLANN_HNSW_INDEX_H_
+#define OPENCV_FLANN_HNSW_INDEX_H_
+
+//! @cond IGNORED
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "opencv2/core/utility.hpp"
+#include "opencv2/core/utils/tls.hpp"
+
+#include "general.h"
+#include "dist.h"
+#include "nn_index.h"
+#include "matrix.h"
+#include "result_set.h"
+#include "params.h"
+#include "random.h"
+#include "saving.h"
+
+namespace cvflann
+{
+
+struct HNSWIndexParams : public IndexParams
+{
+    HNSWIndexParams(int M = 16, int ef_construction = 200)
+    {
+        (*this)["algorithm"] = FLANN_INDEX_HNSW;
+        // number of links of a point on the upper layers, twice as many on the bottom one
+        (*this)["M"] = M;
+        // number of candidates the links of a new point are chosen from
+        (*this)["ef_construction"] = ef_construction;
+    }
+};
+
+
+/**
+ * The distance the graph is built and searched with. The squared Euclidean
+ * distance of float vectors is computed with SIMD instructions, the L2
+ * functor shared with the other indices keeps its own order of the additions.
+ */
+template <typename Distance>
+struct HNSWDistance : public Distance
+{
+    HNSWDistance(const Distance& d) : Distance(d) {}
+};
+
+template <>
+struct HNSWDistance<L2<float> > : public L2<float>
+{
+    HNSWDistance(const L2<float>& d) : L2<float>(d) {}
+
+    template <typename Iterator1, typename Iterator2>
+    ResultType operator()(Iterator1 a, Iterator2 b, size_t size, ResultType worst_dist = -1) const
+    {
+        ResultType result = ResultType();
+        if (simd_l2_sqr(a, b, size, result, typename is_float_pointers<Iterator1, Iterator2>::type())) {
+            return result;
+        }
+        return L2<float>::operator()(a, b, size, worst_dist);
+    }
+};
+
+
+/**
+ * Hierarchical Navigable Small World graph index
+ *
+ * Every point is linked to its close neighbours on the layers from 0 to its
+ * randomly drawn level, the upper layers hold exponentially fewer points. A
+ * search descends greedily from the top layer and explores the bottom layer
+ * with a list of the "checks" closest points found (the ef parameter of HNSW,
+ * it should not be less than the number of neighbours searched).
+ *
+ * The points are inserted in batches: the links of the points of a batch are
+ * searched in parallel on the graph built so far, then the points are linked
+ * in, the lists of links that overflow are pruned in parallel as well. The
+ * graph thus depends neither on the number of threads nor on the order of
+ * the threads. addPoints() inserts more points in the same way.
+ *
+ * The links are stored in flat arrays, so the graph can be saved in the flat
+ * layout and searched in place.
+ */
+template <typename Distance>
+class HNSWIndex : public NNIndex<Distance>
+{
+public:
+    typedef typename Distance::ElementType ElementType;
+    typedef typename Distance::ResultType DistanceType;
+
+    HNSWIndex(const Matrix<ElementType>& inputData, const IndexParams& params = HNSWIndexParams(),
+              Distance d = Distance()) :
+        dataset_(inputData), index_params_(params), distance_(d)
+    {
+        veclen_ = dataset_.cols;
+        M_ = get_param(params, "M", 16);
+        ef_construction_ = get_param(params, "ef_construction", 200);
+        if (M_ < 2 || M_ > MAX_M || ef_construction_ < 1) {
+            throw FLANNException("Invalid HNSW index parameters");
+        }
+        clear();
+    }
+
+    HNSWIndex(const HNSWIndex&);
+    HNSWIndex& operator=(const HNSWIndex&);
+
+    flann_algorithm_t getType() const CV_OVERRIDE
+    {
+        return FLANN_INDEX_HNSW;
+    }
+
+    size_t size() const CV_OVERRIDE
+    {
+        return size_;
+    }
+
+    size_t veclen() const CV_OVERRIDE
+    {
+        return veclen_;
+    }
+
+    int usedMemory() const CV_OVERRIDE
+    {
+        return int((levels_.size()+links0_.size()+upper_links_.size())*sizeof(int) +
+                   upper_offsets_.size()*sizeof(uint64) + added_.size()*sizeof(ElementType*));
+    }
+
+    IndexParams getParameters() const CV_OVERRIDE
+    {
+        return index_params_;
+    }
+
+    void buildIndex() CV_OVERRIDE
+    {
+        clear();
+        insert(dataset_.rows);
+    }
+
+    /**
+     * Inserts the points in the graph, they get the indices following the
+     * ones of the points already indexed. The memory of the points must
+     * outlive the index.
+     */
+    void addPoints(const Matrix<ElementType>& points) CV_OVERRIDE
+    {
+        if (points.cols != veclen_) {
+            throw FLANNException("The points must have the dimension of the dataset");
+        }
+        for (size_t i = 0; i < points.rows; ++i) {
+            added_.push_back(points[i]);
+        }
+        insert(points.rows);
+    }
+
+    void saveIndex(FILE* stream) CV_OVERRIDE
+    {
+        uint64 size = size_, upper_size = upper_links_size_;
+        save_value(stream, M_);
+        save_value(stream, size);
+        save_value(stream, upper_size);
+        save_value(stream, entry_point_);
+        save_value(stream, max_level_);
+        if (size_ > 0) {
+            save_value(stream, levels_data_[0], size_);
+            save_value(stream, links0_data_[0], size_*(2*M_+1));
+            save_value(stream, upper_offsets_data_[0], size_+1);
+        }
+        if (upper_size > 0) {
+            save_value(stream, upper_links_data_[0], upper_size);
+        }
+    }
+
+    void loadIndex(FILE* stream) CV_OVERRIDE
+    {
+        uint64 size, upper_size;
+        load_value(stream, M_);
+        load_value(stream, size);
+        load_value(stream, upper_size);
+        clear();
+        if (M_ < 2 || M_ > MAX_M || size != dataset_.rows) {
+            throw FLANNException("Invalid index file, wrong HNSW parameters");
+        }
+        load_value(stream, entry_point_);
+        load_value(stream, max_level_);
+        size_ = dataset_.rows;
+        levels_.resize(size_);
+        links0_.resize(size_*(2*M_+1));
+        upper_offsets_.resize(size_+1);
+        upper_links_.resize((size_t)upper_size);
+        if (size_ > 0) {
+            load_value(stream, levels_[0], size_);
+            load_value(stream, links0_[0], links0_.size());
+            load_value(stream, upper_offsets_[0], size_+1);
+        }
+        if (upper_size > 0) {
+            load_value(stream, upper_links_[0], upper_links_.size());
+        }
+        syncPointers();
+        validate();
+
+        index_params_["algorithm"] = getType();
+        index_params_["M"] = M_;
+    }
+
+    /**
+     * The flat index section holds M, the entry point, the top level, the
+     * number of points and of upper layer links, followed by the offsets of
+     * the upper layer links of every point, the levels of the points, the
+     * bottom layer links and the upper layer links.
+     */
+    void saveFlatIndex(FILE* stream) CV_OVERRIDE
+    {
+        int prefix[4] = { M_, entry_point_, max_level_, 0 };
+        uint64 counts[2] = { size_, upper_links_size_ };
+        save_value(stream, prefix[0], 4);
+        save_value(stream, counts[0], 2);
+        if (size_ > 0) {
+            save_value(stream, upper_offsets_data_[0], size_+1);
+            save_value(stream, levels_data_[0], size_);
+            save_value(stream, links0_data_[0], size_*(2*M_+1));
+        }
+        if (upper_links_size_ > 0) {
+            save_value(stream, upper_links_data_[0], upper_links_size_);
+        }
+    }
+
+    void attachFlatIndex(const cv::Ptr<FlatBuffer>& buffer, const FlatIndexHeader& header) CV_OVERRIDE
+    {
+        const size_t prefix_size = 4*sizeof(int)+2*sizeof(uint64);
+        const unsigned char* section = buffer->data()+header.index_offset;
+        if (header.index_size < prefix_size) {
+            throw FLANNException("Invalid flat index, truncated file");
+        }
+        int prefix[4];
+        uint64 counts[2];
+        memcpy(prefix, section, sizeof(prefix));
+        memcpy(counts, section+sizeof(prefix), sizeof(counts));
+        M_ = prefix[0];
+        const uint64 n = counts[0], upper_size = counts[1];
+        if (M_ < 2 || M_ > MAX_M || n != dataset_.rows || upper_size > header.index_size ||
+            header.index_size-prefix_size < (n > 0 ? (n+1)*sizeof(uint64)+n*(2*M_+2)*sizeof(int) : 0)+upper_size*sizeof(int)) {
+            throw FLANNException("Invalid flat index, wrong HNSW section");
+        }
+
+        clear();
+        size_ = dataset_.rows;
+        entry_point_ = prefix[1];
+        max_level_ = prefix[2];
+        const unsigned char* ptr = section+prefix_size;
+        if (size_ > 0) {
+            upper_offsets_data_ = (const uint64*)ptr;
+            ptr += (size_+1)*sizeof(uint64);
+            levels_data_ = (const int*)ptr;
+            ptr += size_*sizeof(int);
+            links0_data_ = (const int*)ptr;
+            ptr += size_*(2*M_+1)*sizeof(int);
+        }
+        upper_links_data_ = (const int*)ptr;
+        upper_links_size_ = (size_t)upper_size;
+        flat_ = buffer;
+        validate();
+
+        index_params_["algorithm"] = getType();
+        index_params_["M"] = M_;
+    }
+
+    void findNeighbors(ResultSet<DistanceType>& result, const ElementType* vec, const SearchParams& searchParams) CV_OVERRIDE
+    {
+        if (size_ == 0) {
+            return;
+        }
+        const int checks = get_param(searchParams, "checks", 32);
+        const int ef = checks < 0 ? (int)size_ : std::max(checks, 1);
+
+        int entry = entry_point_;
+        DistanceType entry_dist = distance_(vec, point(entry), veclen_);
+        for (int level = max_level_; level > 0; --level) {
+            greedySearch(vec, level, entry, entry_dist);
+        }
+
+        std::vector<Candidate> found;
+        searchLayer(vec, std::vector<Candidate>(1, Candidate(entry_dist, entry)), ef, 0, found);
+        for (size_t i = 0; i < found.size(); ++i) {
+            result.addPoint(found[i].first, found[i].second);
+        }
+    }
+
+private:
+    typedef std::pair<DistanceType, int> Candidate;
+
+    /**
+     * Marks of the points visited by a search, reset by a new tag.
+     */
+    struct VisitedSet
+    {
+        VisitedSet() : tag(0) {}
+
+        void reset(size_t size)
+        {
+            if (marks.size() < size) {
+                marks.resize(size, 0);
+            }
+            if (++tag == 0) {
+                std::fill(marks.begin(), marks.end(), 0u);
+                tag = 1;
+            }
+        }
+
+        bool visit(int id)
+        {
+            if (marks[id] == tag) {
+                return false;
+            }
+            marks[id] = tag;
+            return true;
+        }
+
+        std::vector<unsigned> marks;
+        unsigned tag;
+    };
+
+    void clear()
+    {
+        size_ = 0;
+        entry_point_ = -1;
+        max_level_ = -1;
+        levels_.clear();
+        links0_.clear();
+        upper_offsets_.assign(1, 0);
+        upper_links_.clear();
+        added_.clear();
+        flat_.release();
+        syncPointers();
+    }
+
+    /**
+     * Points the arrays searched to the ones owned by the index.
+     */
+    void syncPointers()
+    {
+        levels_data_ = levels_.empty() ? NULL : &levels_[0];
+        links0_data_ = links0_.empty() ? NULL : &links0_[0];
+        upper_offsets_data_ = &upper_offsets_[0];
+        upper_links_data_ = upper_links_.empty() ? NULL : &upper_links_[0];
+        upper_links_size_ = upper_links_.size();
+    }
+
+    /**
+     * Copies the arrays of a flat index searched in place, before they are modified.
+     */
+    void detachFlat()
+    {
+        if (!flat_) {
+            return;
+        }
+        levels_.assign(levels_data_, levels_data_+size_);
+        links0_.assign(links0_data_, links0_data_+size_*(2*M_+1));
+        upper_offsets_.assign(upper_offsets_data_, upper_offsets_data_+size_+1);
+        upper_links_.assign(upper_links_data_, upper_links_data_+upper_links_size_);
+        flat_.release();
+        syncPointers();
+    }
+
+    /**
+     * Checks that the links of a loaded graph refer to its points.
+     */
+    void validate() const
+    {
+        bool ok = (size_ == 0) == (entry_point_ < 0) && entry_point_ < (int)size_ &&
+                  upper_offsets_data_[0] == 0 && upper_offsets_data_[size_] == upper_links_size_;
+        for (size_t i = 0; ok && i < size_; ++i) {
+            ok = levels_data_[i] >= 0 && levels_data_[i] <= max_level_ && upper_offsets_data_[i+1] ==
+                 upper_offsets_data_[i]+(uint64)levels_data_[i]*(M_+1);
+        }
+        for (size_t i = 0; ok && i < size_; ++i) {
+            for (int level = 0; ok && level <= levels_data_[i]; ++level) {
+                const int* list = links((int)i, level);
+                ok = list[0] >= 0 && list[0] <= maxLinks(level);
+                for (int j = 1; ok && j <= list[0]; ++j) {
+                    ok = list[j] >= 0 && list[j] < (int)size_ && levels_data_[list[j]] >= level;
+                }
+            }
+        }
+        if (!ok) {
+            throw FLANNException("Invalid HNSW index, wrong links");
+        }
+    }
+
+    const ElementType* point(int id) const
+    {
+        return (size_t)id < dataset_.rows ? dataset_[id] : added_[id-dataset_.rows];
+    }
+
+    int maxLinks(int level) const
+    {
+        return level == 0 ? 2*M_ : M_;
+    }
+
+    /**
+     * The links of a point on a layer: their number followed by the indices of the points.
+     */
+    const int* links(int id, int level) const
+    {
+        return level == 0 ? links0_data_+(size_t)id*(2*M_+1)
+                          : upper_links_data_+upper_offsets_data_[id]+(size_t)(level-1)*(M_+1);
+    }
+
+    int* mutableLinks(int id, int level)
+    {
+        return const_cast<int*>(links(id, level));
+    }
+
+    /**
+     * Moves to the closest neighbour on a layer until no neighbour is closer.
+     */
+    void greedySearch(const ElementType* vec, int level, int& entry, DistanceType& entry_dist) const
+    {
+        for (bool changed = true; changed; ) {
+            changed = false;
+            const int* list = links(entry, level);
+            for (int j = 1; j <= list[0]; ++j) {
+                DistanceType dist = distance_(vec, point(list[j]), veclen_);
+                if (dist < entry_dist) {
+                    entry_dist = dist;
+                    entry = list[j];
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    /**
+     * Finds the ef closest points on a layer, starting from the entry points.
+     * The points found are sorted by their distance.
+     */
+    void searchLayer(const ElementType* vec, const std::vector<Candidate>& entries, int ef, int level,
+                     std::vector<Candidate>& found) const
+    {
+        VisitedSet& visited = visited_.getRef();
+        visited.reset(size_);
+
+        // closest candidates first, the farthest point found on top
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > candidates;
+        std::priority_queue<Candidate> best;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            visited.visit(entries[i].second);
+            candidates.push(entries[i]);
+            best.push(entries[i]);
+        }
+        while ((int)best.size() > ef) {
+            best.pop();
+        }
+
+        while (!candidates.empty()) {
+            const Candidate current = candidates.top();
+            if (current.first > best.top().first && (int)best.size() >= ef) {
+                break;
+            }
+            candidates.pop();
+            const int* list = links(current.second, level);
+            for (int j = 1; j <= list[0]; ++j) {
+                const int id = list[j];
+                if (!visited.visit(id)) {
+                    continue;
+                }
+                DistanceType dist = distance_(vec, point(id), veclen_);
+                if ((int)best.size() < ef || dist < best.top().first) {
+                    candidates.push(Candidate(dist, id));
+                    best.push(Candidate(dist, id));
+                    if ((int)best.size() > ef) {
+                        best.pop();
+                    }
+                }
+            }
+        }
+
+        found.resize(best.size());
+        for (size_t i = found.size(); i > 0; --i) {
+            found[i-1] = best.top();
+            best.pop();
+        }
+    }
+
+    /**
+     * Chooses at most count of the candidates sorted by distance: a candidate
+     * closer to an already chosen one than to the base point is skipped, so
+     * the links spread in all the directions.
+     */
+    void selectNeighbors(const std::vector<Candidate>& candidates, int count, std::vector<int>& selected) const
+    {
+        selected.clear();
+        for (size_t i = 0; i < candidates.size() && (int)selected.size() < count; ++i) {
+            const ElementType* vec = point(candidates[i].second);
+            bool good = true;
+            for (size_t j = 0; j < selected.size() && good; ++j) {
+                good = distance_(vec, point(selected[j]), veclen_) >= candidates[i].first;
+            }
+            if (good) {
+                selected.push_back(candidates[i].second);
+            }
+        }
+    }
+
+    /**
+     * Inserts the last count points of the index in the graph.
+     */
+    void insert(size_t count)
+    {
+        detachFlat();
+        const size_t first = size_, total = size_+count;
+        if (total > (size_t)INT_MAX) {
+            throw FLANNException("Too many points for the HNSW index");
+        }
+
+        /* Draw the levels of the new points and allocate their links. */
+        const double level_mult = 1/std::log((double)M_);
+        levels_.resize(total);
+        links0_.resize(total*(2*M_+1), 0);
+        upper_offsets_.resize(total+1);
+        for (size_t i = first; i < total; ++i) {
+            int level = (int)(-std::log(1-rand_double())*level_mult);
+            levels_[i] = std::min(level, (int)MAX_LEVEL);
+            upper_offsets_[i+1] = upper_offsets_[i]+(uint64)levels_[i]*(M_+1);
+        }
+        upper_links_.resize((size_t)upper_offsets_[total], 0);
+        syncPointers();
+
+        size_t start = first;
+        if (start == 0 && total > 0) {
+            entry_point_ = 0;
+            max_level_ = levels_[0];
+            size_ = 1;
+            start = 1;
+        }
+
+        std::vector<std::vector<std::vector<int> > > selected;
+        while (start < total) {
+            /* A batch sees the points inserted before it, it is small compared to them. */
+            const size_t end = std::min(total, start+std::max<size_t>(1, std::min<size_t>(start/BATCH_RATIO, MAX_BATCH)));
+            const int batch = int(end-start);
+            selected.assign(batch, std::vector<std::vector<int> >());
+
+            cv::parallel_for_(cv::Range(0, batch), [&](const cv::Range& range) {
+                std::vector<Candidate> found;
+                for (int b = range.start; b < range.end; ++b) {
+                    findLinks(int(start+b), found, selected[b]);
+                }
+            });
+
+            /* Link the new points, then add the reverse links grouped by the points they start from. */
+            std::vector<std::pair<std::pair<int, int>, int> > reverse;
+            for (int b = 0; b < batch; ++b) {
+                const int id = int(start+b);
+                for (int level = 0; level < (int)selected[b].size(); ++level) {
+                    int* list = mutableLinks(id, level);
+                    list[0] = (int)selected[b][level].size();
+                    std::copy(selected[b][level].begin(), selected[b][level].end(), list+1);
+                    for (size_t j = 0; j < selected[b][level].size(); ++j) {
+                        reverse.push_back(std::make_pair(std::make_pair(selected[b][level][j], level), id));
+                    }
+                }
+            }
+            std::sort(reverse.begin(), reverse.end());
+            std::vector<size_t> groups;
+            for (size_t i = 0; i < reverse.size(); ++i) {
+                if (i == 0 || reverse[i].first != reverse[i-1].first) {
+                    groups.push_back(i);
+                }
+            }
+            groups.push_back(reverse.size());
+            cv::parallel_for_(cv::Range(0, (int)groups.size()-1), [&](const cv::Range& range) {
+                std::vector<Candidate> candidates;
+                std::vector<int> kept;
+                for (int g = range.start; g < range.end; ++g) {
+                    addReverseLinks(&reverse[groups[g]], &reverse[groups[g+1]], candidates, kept);
+                }
+            });
+
+            size_ = end;
+            for (int b = 0; b < batch; ++b) {
+                if (levels_[start+b] > max_level_) {
+                    max_level_ = levels_[start+b];
+                    entry_point_ = int(start+b);
+                }
+            }
+            start = end;
+        }
+        size_ = total;
+    }
+
+    /**
+     * Chooses the links of a new point on every layer below its level, in the graph of the points before it.
+     */
+    void findLinks(int id, std::vector<Candidate>& found, std::vector<std::vector<int> >& selected) const
+    {
+        const ElementType* vec = point(id);
+        const int level = levels_[id];
+        int entry = entry_point_;
+        DistanceType entry_dist = distance_(vec, point(entry), veclen_);
+        for (int l = max_level_; l > level; --l) {
+            greedySearch(vec, l, entry, entry_dist);
+        }
+
+        selected.resize(std::min(level, max_level_)+1);
+        std::vector<Candidate> entries(1, Candidate(entry_dist, entry));
+        for (int l = (int)selected.size()-1; l >= 0; --l) {
+            searchLayer(vec, entries, ef_construction_, l, found);
+            selectNeighbors(found, M_, selected[l]);
+            entries.swap(found);
+        }
+    }
+
+    /**
+     * Adds the links from a point to the new points of a group, the closest
+     * ones are kept if the list overflows.
+     */
+    void addReverseLinks(const std::pair<std::pair<int, int>, int>* first, const std::pair<std::pair<int, int>, int>* last,
+                         std::vector<Candidate>& candidates, std::vector<int>& kept)
+    {
+        const int id = first->first.first, level = first->first.second;
+        int* list = mutableLinks(id, level);
+        const int capacity = maxLinks(level);
+        if (list[0]+int(last-first) <= capacity) {
+            for (; first != last; ++first) {
+                list[++list[0]] = first->second;
+            }
+            return;
+        }
+
+        const ElementType* vec = point(id);
+        candidates.clear();
+        for (int j = 1; j <= list[0]; ++j) {
+            candidates.push_back(Candidate(distance_(vec, point(list[j]), veclen_), list[j]));
+        }
+        for (; first != last; ++first) {
+            candidates.push_back(Candidate(distance_(vec, point(first->second), veclen_), first->second));
+        }
+        std::sort(candidates.begin(), candidates.end());
+        selectNeighbors(candidates, capacity, kept);
+        list[0] = (int)kept.size();
+        std::copy(kept.begin(), kept.end(), list+1);
+    }
+
+private:
+    enum
+    {
+        /**
+         * The points of a batch are at most this fraction of the points inserted before it.
+         */
+        BATCH_RATIO = 8,
+        MAX_BATCH = 4096,
+        MAX_LEVEL = 30,
+        MAX_M = 4096
+    };
+
+    /**
+     * The dataset used by this index
+     */
+    const Matrix<ElementType> dataset_;
+
+    IndexParams index_params_;
+
+    size_t size_;
+    size_t veclen_;
+
+    int M_;
+    int ef_construction_;
+
+    int entry_point_;
+    int max_level_;
+
+    /**
+     * The graph: the level of every point, its bottom layer links (2*M+1
+     * values per point) and its upper layer links (M+1 values per point and
+     * layer, from the offset of the point).
+     */
+    std::vector<int> levels_;
+    std::vector<int> links0_;
+    std::vector<uint64> upper_offsets_;
+    std::vector<int> upper_links_;
+
+    /**
+     * The arrays searched, either the ones above or the ones of a flat index searched in place.
+     */
+    const int* levels_data_;
+    const int* links0_data_;
+    const uint64* upper_offsets_data_;
+    const int* upper_links_data_;
+    size_t upper_links_size_;
+
+    /**
+     * Memory holding the flat index searched in place.
+     */
+    cv::Ptr<FlatBuffer> flat_;
+
+    /**
+     * The points added after the index was built.
+     */
+    std::vector<const ElementType*> added_;
+
+    mutable cv::TLSData<VisitedSet> visited_;
+
+    HNSWDistance<Distance> distance_;
+};
+
+}
+
+//! @endcond
+
+#endif /* OPENCV_FLANN_HNSW_INDEX_H_ */
@@ -0,0 +1,478 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_FLANN_IVFPQ_INDEX_H_
+#define OPENCV_FLANN_IVFPQ_INDEX_H_
+
+//! @cond IGNORED
+
+#include <algorithm>
+#include <vector>
+
+#include "opencv2/core/hal/intrin.hpp"
+#include "opencv2/core/utils/tls.hpp"
+
+#include "general.h"
+#include "nn_index.h"
+#include "matrix.h"
+#include "result_set.h"
+#include "params.h"
+#include "random.h"
+#include "saving.h"
+
+namespace cvflann
+{
+
+struct IVFPQIndexParams : public IndexParams
+{
+    IVFPQIndexParams(int lists = 256, int subquantizers = 16, int iterations = 10, int train_size = 65536)
+    {
+        (*this)["algorithm"] = FLANN_INDEX_IVFPQ;
+        // number of inverted lists (coarse clusters)
+        (*this)["lists"] = lists;
+        // number of sub-vectors a vector is split into, every one encoded in a byte
+        (*this)["subquantizers"] = subquantizers;
+        // max iterations of the kmeans clusterings
+        (*this)["iterations"] = iterations;
+        // max number of vectors the quantizers are trained on
+        (*this)["train_size"] = train_size;
+    }
+};
+
+
+/**
+ * Fills dists with the sums of the table entries picked by the codes of count
+ * encoded vectors, table holds ksub entries for every one of the M bytes of a code.
+ */
+template <typename T>
+inline void ivfpq_decode_distances(const T* table, int ksub, int M, const uchar* codes, int count, T* dists)
+{
+    for (int i = 0; i < count; ++i, codes += M) {
+        T d0 = 0, d1 = 0;
+        int m = 0;
+        for (; m+1 < M; m += 2) {
+            d0 += table[m*ksub+codes[m]];
+            d1 += table[(m+1)*ksub+codes[m+1]];
+        }
+        if (m < M) {
+            d0 += table[m*ksub+codes[m]];
+        }
+        dists[i] = d0+d1;
+    }
+}
+
+#if CV_SIMD
+/**
+ * The float tables are looked up a vector of bytes of a code at a time, the
+ * bytes are widened to the indices of the entries in their own rows of the table.
+ */
+inline void ivfpq_decode_distances(const float* table, int ksub, int M, const uchar* codes, int count, float* dists)
+{
+    const int VECSZ = cv::v_float32::nlanes;
+    int CV_DECL_ALIGNED(CV_SIMD_WIDTH) offsets[VECSZ];
+    for (int j = 0; j < VECSZ; ++j) {
+        offsets[j] = j*ksub;
+    }
+    const cv::v_int32 v_offsets = cv::vx_load_aligned(offsets), v_step = cv::vx_setall_s32(VECSZ*ksub);
+    for (int i = 0; i < count; ++i, codes += M) {
+        cv::v_float32 vsum = cv::vx_setzero_f32();
+        cv::v_int32 base = v_offsets;
+        int m = 0;
+        for (; m+VECSZ <= M; m += VECSZ, base += v_step) {
+            cv::v_int32 idx = cv::v_reinterpret_as_s32(cv::vx_load_expand_q(codes+m)) + base;
+            vsum += cv::v_lut(table, idx);
+        }
+        float d = cv::v_reduce_sum(vsum);
+        for (; m < M; ++m) {
+            d += table[m*ksub+codes[m]];
+        }
+        dists[i] = d;
+    }
+}
+#endif
+
+/**
+ * Inverted file index with product quantization (IVF-PQ)
+ *
+ * The vectors are assigned to the closest of a set of coarse centroids, the
+ * residual to the centroid is split into sub-vectors and every sub-vector is
+ * replaced by the index of the closest of 256 centroids trained for it. A
+ * vector thus takes a byte per sub-vector plus its index, the dataset is not
+ * needed after the index is built.
+ *
+ * The distances are computed asymmetrically: for every list searched, the
+ * distances of the sub-vectors of the query residual to all the centroids of
+ * the sub-quantizers are put in a table, the distance to an encoded vector is
+ * the sum of a table entry per sub-vector. The distances returned are these
+ * approximations, computed with Distance::accum_dist. The float tables are
+ * summed with the vector instructions, in an order of their own.
+ *
+ * The "checks" search parameter is the minimum number of the encoded vectors
+ * compared to the query: the closest lists are searched until they held that
+ * many vectors, a negative value searches all the lists.
+ */
+template <typename Distance>
+class IVFPQIndex : public NNIndex<Distance>
+{
+public:
+    typedef typename Distance::ElementType ElementType;
+    typedef typename Distance::ResultType DistanceType;
+
+    IVFPQIndex(const Matrix<ElementType>& inputData, const IndexParams& params = IVFPQIndexParams(),
+               Distance d = Distance()) :
+        dataset_(inputData), index_params_(params), distance_(d)
+    {
+        size_ = dataset_.rows;
+        veclen_ = dataset_.cols;
+
+        lists_ = get_param(params, "lists", 256);
+        subquantizers_ = get_param(params, "subquantizers", 16);
+        iterations_ = get_param(params, "iterations", 10);
+        train_size_ = get_param(params, "train_size", 65536);
+        if (lists_ < 1 || subquantizers_ < 1 || iterations_ < 1 || train_size_ < 1) {
+            throw FLANNException("Invalid IVF-PQ index parameters");
+        }
+        subquantizers_ = std::max(std::min(subquantizers_, (int)veclen_), 1);
+        centers_ = 0;
+        ksub_ = 0;
+    }
+
+    IVFPQIndex(const IVFPQIndex&);
+    IVFPQIndex& operator=(const IVFPQIndex&);
+
+    flann_algorithm_t getType() const CV_OVERRIDE
+    {
+        return FLANN_INDEX_IVFPQ;
+    }
+
+    size_t size() const CV_OVERRIDE
+    {
+        return size_;
+    }
+
+    size_t veclen() const CV_OVERRIDE
+    {
+        return veclen_;
+    }
+
+    int usedMemory() const CV_OVERRIDE
+    {
+        size_t memory = (coarse_centroids_.size()+pq_centroids_.size())*sizeof(DistanceType);
+        for (size_t i = 0; i < list_ids_.size(); ++i) {
+            memory += list_ids_[i].size()*sizeof(int)+list_codes_[i].size();
+        }
+        return int(memory);
+    }
+
+    IndexParams getParameters() const CV_OVERRIDE
+    {
+        return index_params_;
+    }
+
+    /**
+     * Trains the coarse quantizer and the product quantizer on a sample of the
+     * dataset and encodes the dataset.
+     */
+    void buildIndex() CV_OVERRIDE
+    {
+        list_ids_.clear();
+        list_codes_.clear();
+        coarse_centroids_.clear();
+        pq_centroids_.clear();
+        centers_ = 0;
+        if (size_ == 0 || veclen_ == 0) {
+            return;
+        }
+
+        /* Train on a random vector of every one of ntrain equal parts of the dataset. */
+        const int ntrain = (int)std::min(size_, (size_t)train_size_);
+        cv::Mat train(ntrain, (int)veclen_, CV_32F);
+        for (int i = 0; i < ntrain; ++i) {
+            size_t first = size_*i/ntrain, last = size_*(i+1)/ntrain;
+            const ElementType* vec = dataset_[first+rand_int(int(last-first))];
+            float* row = train.ptr<float>(i);
+            for (size_t k = 0; k < veclen_; ++k) {
+                row[k] = (float)vec[k];
+            }
+        }
+        const cv::TermCriteria criteria(cv::TermCriteria::MAX_ITER+cv::TermCriteria::EPS, iterations_, 1e-4);
+
+        cv::Mat labels, centers;
+        centers_ = std::min(lists_, ntrain);
+        cv::kmeans(train, centers_, labels, criteria, 1, cv::KMEANS_PP_CENTERS, centers);
+        coarse_centroids_.assign(centers.ptr<float>(), centers.ptr<float>()+centers.total());
+
+        /* The sub-quantizers are trained in parallel on the residuals of the sample. */
+        for (int i = 0; i < ntrain; ++i) {
+            float* row = train.ptr<float>(i);
+            const float* center = centers.ptr<float>(labels.at<int>(i));
+            for (size_t k = 0; k < veclen_; ++k) {
+                row[k] -= center[k];
+            }
+        }
+        ksub_ = std::min(256, ntrain);
+        pq_centroids_.resize(veclen_*ksub_);
+        parallel_for_seeded(subquantizers_, true, [&](int m) {
+            const int first = subvectorStart(m), last = subvectorStart(m+1);
+            cv::Mat sublabels, subcenters;
+            cv::kmeans(train.colRange(first, last).clone(), ksub_, sublabels, criteria, 1,
+                       cv::KMEANS_PP_CENTERS, subcenters);
+            // stored by dimension, the distances to all the centroids are computed in contiguous loops
+            for (int k = 0; k < ksub_; ++k) {
+                for (int j = first; j < last; ++j) {
+                    pq_centroids_[j*ksub_+k] = subcenters.at<float>(k, j-first);
+                }
+            }
+        });
+
+        /* Encode the dataset in parallel, then put the codes in the lists. */
+        std::vector<int> assignment(size_);
+        std::vector<uchar> codes(size_*subquantizers_);
+        cv::parallel_for_(cv::Range(0, (int)size_), [&](const cv::Range& range) {
+            std::vector<DistanceType> residual(veclen_), table(subquantizers_*ksub_);
+            for (int i = range.start; i < range.end; ++i) {
+                assignment[i] = findClosestList(dataset_[i]);
+                computeTable(dataset_[i], assignment[i], &residual[0], &table[0]);
+                for (int m = 0; m < subquantizers_; ++m) {
+                    const DistanceType* dists = &table[m*ksub_];
+                    codes[(size_t)i*subquantizers_+m] = (uchar)(std::min_element(dists, dists+ksub_)-dists);
+                }
+            }
+        });
+
+        list_ids_.resize(centers_);
+        list_codes_.resize(centers_);
+        std::vector<size_t> counts(centers_, 0);
+        for (size_t i = 0; i < size_; ++i) {
+            counts[assignment[i]]++;
+        }
+        for (int l = 0; l < centers_; ++l) {
+            list_ids_[l].reserve(counts[l]);
+            list_codes_[l].reserve(counts[l]*subquantizers_);
+        }
+        for (size_t i = 0; i < size_; ++i) {
+            list_ids_[assignment[i]].push_back(int(i));
+            list_codes_[assignment[i]].insert(list_codes_[assignment[i]].end(),
+                                              &codes[i*subquantizers_], &codes[i*subquantizers_]+subquantizers_);
+        }
+    }
+
+    void saveIndex(FILE* stream) CV_OVERRIDE
+    {
+        save_value(stream, centers_);
+        save_value(stream, subquantizers_);
+        save_value(stream, ksub_);
+        if (centers_ == 0) {
+            return;
+        }
+        save_value(stream, coarse_centroids_[0], coarse_centroids_.size());
+        save_value(stream, pq_centroids_[0], pq_centroids_.size());
+        for (int l = 0; l < centers_; ++l) {
+            int count = (int)list_ids_[l].size();
+            save_value(stream, count);
+            if (count > 0) {
+                save_value(stream, list_ids_[l][0], count);
+                save_value(stream, list_codes_[l][0], list_codes_[l].size());
+            }
+        }
+    }
+
+    void loadIndex(FILE* stream) CV_OVERRIDE
+    {
+        load_value(stream, centers_);
+        load_value(stream, subquantizers_);
+        load_value(stream, ksub_);
+        if (centers_ < 0 || subquantizers_ < 1 || subquantizers_ > std::max((int)veclen_, 1) ||
+            ksub_ < 0 || ksub_ > 256) {
+            throw FLANNException("Invalid index file, wrong IVF-PQ parameters");
+        }
+        coarse_centroids_.resize(centers_*veclen_);
+        pq_centroids_.resize(ksub_*veclen_);
+        list_ids_.assign(centers_, std::vector<int>());
+        list_codes_.assign(centers_, std::vector<uchar>());
+        if (centers_ == 0) {
+            return;
+        }
+        load_value(stream, coarse_centroids_[0], coarse_centroids_.size());
+        load_value(stream, pq_centroids_[0], pq_centroids_.size());
+        for (int l = 0; l < centers_; ++l) {
+            int count;
+            load_value(stream, count);
+            if (count < 0) {
+                throw FLANNException("Invalid index file, wrong list size");
+            }
+            list_ids_[l].resize(count);
+            list_codes_[l].resize((size_t)count*subquantizers_);
+            if (count > 0) {
+                load_value(stream, list_ids_[l][0], count);
+                load_value(stream, list_codes_[l][0], list_codes_[l].size());
+            }
+        }
+
+        index_params_["algorithm"] = getType();
+        index_params_["lists"] = lists_;
+        index_params_["subquantizers"] = subquantizers_;
+    }
+
+    void findNeighbors(ResultSet<DistanceType>& result, const ElementType* vec, const SearchParams& searchParams) CV_OVERRIDE
+    {
+        if (centers_ == 0) {
+            return;
+        }
+        const int checks = get_param(searchParams, "checks", 32);
+        SearchBuffers& buffers = search_buffers_.getRef();
+
+        /* The lists are searched from the one with the closest centroid. */
+        std::vector<std::pair<DistanceType, int> >& order = buffers.order;
+        order.resize(centers_);
+        for (int l = 0; l < centers_; ++l) {
+            order[l] = std::make_pair(distance_(vec, &coarse_centroids_[l*veclen_], veclen_), l);
+        }
+        buffers.residual.resize(veclen_);
+        buffers.table.resize(subquantizers_*ksub_);
+
+        /* Only the lists expected to hold the checked vectors are sorted, more when they run out. */
+        int sorted = 0;
+        const int expected = checks < 0 || size_ == 0 ? centers_ :
+            (int)std::min((size_t)centers_, (size_t)checks*centers_/size_+1);
+        int checked = 0;
+        for (int p = 0; p < centers_ && (checks < 0 || checked < checks || !result.full()); ++p) {
+            if (p == sorted) {
+                sorted = std::min(centers_, std::max(sorted*2, expected));
+                std::partial_sort(order.begin()+p, order.begin()+sorted, order.end());
+            }
+            const int l = order[p].second;
+            const int count = (int)list_ids_[l].size();
+            if (count == 0) {
+                continue;
+            }
+            computeTable(vec, l, &buffers.residual[0], &buffers.table[0]);
+            scanList(result, &buffers.table[0], list_ids_[l], list_codes_[l], buffers.dists);
+            checked += count;
+        }
+    }
+
+private:
+    /**
+     * First dimension of the m-th sub-vector, the dimensions are split evenly.
+     */
+    int subvectorStart(int m) const
+    {
+        return int(veclen_*m/subquantizers_);
+    }
+
+    int findClosestList(const ElementType* vec) const
+    {
+        int best = 0;
+        DistanceType best_dist = distance_(vec, &coarse_centroids_[0], veclen_);
+        for (int l = 1; l < centers_; ++l) {
+            DistanceType dist = distance_(vec, &coarse_centroids_[l*veclen_], veclen_, best_dist);
+            if (dist < best_dist) {
+                best = l;
+                best_dist = dist;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Fills table[m*ksub_+k] with the distance of the m-th sub-vector of the
+     * residual of vec to the list centroid to the k-th centroid of the m-th
+     * sub-quantizer.
+     */
+    void computeTable(const ElementType* vec, int list, DistanceType* residual, DistanceType* table) const
+    {
+        const DistanceType* centroid = &coarse_centroids_[list*veclen_];
+        for (size_t j = 0; j < veclen_; ++j) {
+            residual[j] = (DistanceType)vec[j]-centroid[j];
+        }
+        for (int m = 0; m < subquantizers_; ++m) {
+            DistanceType* dists = table+m*ksub_;
+            std::fill(dists, dists+ksub_, DistanceType());
+            for (int j = subvectorStart(m), last = subvectorStart(m+1); j < last; ++j) {
+                const DistanceType* centroids = &pq_centroids_[j*ksub_];
+                const DistanceType r = residual[j];
+                for (int k = 0; k < ksub_; ++k) {
+                    dists[k] += distance_.accum_dist(r, centroids[k], j);
+                }
+            }
+        }
+    }
+
+    /**
+     * Adds the vectors of a list to the result set, their distances are sums
+     * of the table entries picked by their codes.
+     */
+    void scanList(ResultSet<DistanceType>& result, const DistanceType* table,
+                  const std::vector<int>& ids, const std::vector<uchar>& codes,
+                  std::vector<DistanceType>& dists) const
+    {
+        const int count = (int)ids.size();
+        if (dists.size() < (size_t)count) {
+            dists.resize(count);
+        }
+        ivfpq_decode_distances(table, ksub_, subquantizers_, &codes[0], count, &dists[0]);
+        for (int i = 0; i < count; ++i) {
+            result.addPoint(dists[i], ids[i]);
+        }
+    }
+
+private:
+    /**
+     * The dataset used by this index, only while it is built.
+     */
+    const Matrix<ElementType> dataset_;
+
+    IndexParams index_params_;
+
+    size_t size_;
+    size_t veclen_;
+
+    int lists_;
+    int subquantizers_;
+    int iterations_;
+    int train_size_;
+
+    /**
+     * Number of lists and of centroids of every sub-quantizer, after the training.
+     */
+    int centers_;
+    int ksub_;
+
+    /**
+     * Coarse centroids, centers_ rows of veclen_ values.
+     */
+    std::vector<DistanceType> coarse_centroids_;
+
+    /**
+     * Centroids of the sub-quantizers, ksub_ values for every dimension.
+     */
+    std::vector<DistanceType> pq_centroids_;
+
+    /**
+     * Indices and codes of the vectors of every list.
+     */
+    std::vector<std::vector<int> > list_ids_;
+    std::vector<std::vector<uchar> > list_codes_;
+
+    /**
+     * The buffers of the searches, reused by the queries of a thread.
+     */
+    struct SearchBuffers
+    {
+        std::vector<std::pair<DistanceType, int> > order;
+        std::vector<DistanceType> residual;
+        std::vector<DistanceType> table;
+        std::vector<DistanceType> dists;
+    };
+    mutable cv::TLSData<SearchBuffers> search_buffers_;
+
+    Distance distance_;
+};
+
+}
+
+//! @endcond
+
+#endif /* OPENCV_FLANN_IVFPQ_INDEX_H_ */
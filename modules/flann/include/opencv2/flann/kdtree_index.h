@@ -90,16 +90,8 @@ public:
         veclen_ = dataset_.cols;
 
         trees_ = get_param(index_params_,"trees",4);
-        tree_roots_ = new NodePtr[trees_];
-
-        // Create a permutable array of indices to the input vectors.
-        vind_.resize(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            vind_[i] = int(i);
-        }
-
-        mean_ = new DistanceType[veclen_];
-        var_ = new DistanceType[veclen_];
+        tree_size_ = size_ > 0 ? 2*size_-1 : 0;
+        tree_nodes_ = NULL;
     }
 
 
@@ -111,11 +103,6 @@ public:
      */
     ~KDTreeIndex()
     {
-        if (tree_roots_!=NULL) {
-            delete[] tree_roots_;
-        }
-        delete[] mean_;
-        delete[] var_;
     }
 
     /**
@@ -123,17 +110,31 @@ public:
      */
     void buildIndex() CV_OVERRIDE
     {
-        /* Construct the randomized trees. */
-        for (int i = 0; i < trees_; i++) {
-            /* Randomize the order of vectors to allow for unbiased sampling. */
+        /* Construct the randomized trees. The trees are independent, so they are
+           built in parallel, every one into its own part of the node array with
+           its own order of the vectors and scratch buffers. */
+        nodes_.resize(trees_*tree_size_);
+        tree_nodes_ = nodes_.empty() ? NULL : &nodes_[0];
+        flat_.release();
+        if (size_ == 0) {
+            return;
+        }
+        parallel_for_seeded(trees_, true, [&](int i) {
+            /* Create a permutable array of indices to the input vectors and
+               randomize their order to allow for unbiased sampling. */
+            std::vector<int> vind(size_);
+            for (size_t j = 0; j < size_; ++j) {
+                vind[j] = int(j);
+            }
 #ifndef OPENCV_FLANN_USE_STD_RAND
-            cv::randShuffle(vind_);
+            cv::randShuffle(vind);
 #else
-            std::random_shuffle(vind_.begin(), vind_.end());
+            std::random_shuffle(vind.begin(), vind.end());
 #endif
 
-            tree_roots_[i] = divideTree(&vind_[0], int(size_) );
-        }
+            std::vector<DistanceType> mean(veclen_), var(veclen_);
+            divideTree(&nodes_[i*tree_size_], &vind[0], int(size_), &mean[0], &var[0]);
+        });
     }
 
 
@@ -147,7 +148,7 @@ public:
     {
         save_value(stream, trees_);
         for (int i=0; i<trees_; ++i) {
-            save_tree(stream, tree_roots_[i]);
+            save_tree(stream, tree_nodes_+i*tree_size_);
         }
     }
 
@@ -156,16 +157,78 @@ public:
     void loadIndex(FILE* stream) CV_OVERRIDE
     {
         load_value(stream, trees_);
-        if (tree_roots_!=NULL) {
-            delete[] tree_roots_;
+        if (trees_ < 0) {
+            throw FLANNException("Invalid index file, wrong number of trees");
         }
-        tree_roots_ = new NodePtr[trees_];
+        nodes_.resize(trees_*tree_size_);
+        tree_nodes_ = nodes_.empty() ? NULL : &nodes_[0];
+        flat_.release();
         for (int i=0; i<trees_; ++i) {
-            load_tree(stream,tree_roots_[i]);
+            if (load_tree(stream, &nodes_[i*tree_size_], 0) != tree_size_) {
+                throw FLANNException("Invalid index file, wrong tree size");
+            }
+        }
+
+        index_params_["algorithm"] = getType();
+        index_params_["trees"] = trees_;
+    }
+
+
+    /**
+     * The flat index section holds the number of trees, the size of a node and
+     * the number of nodes in a tree, followed by the node arrays of the trees.
+     */
+    void saveFlatIndex(FILE* stream) CV_OVERRIDE
+    {
+        int node_size = (int)sizeof(Node);
+        uint64 tree_size = tree_size_;
+        save_value(stream, trees_);
+        save_value(stream, node_size);
+        save_value(stream, tree_size);
+        if (trees_*tree_size_ > 0) {
+            save_value(stream, *tree_nodes_, trees_*tree_size_);
         }
+    }
+
+
+    void attachFlatIndex(const cv::Ptr<FlatBuffer>& buffer, const FlatIndexHeader& header) CV_OVERRIDE
+    {
+        const size_t prefix_size = 2*sizeof(int)+sizeof(uint64);
+        const unsigned char* section = buffer->data()+header.index_offset;
+        if (header.index_size < prefix_size) {
+            throw FLANNException("Invalid flat index, truncated file");
+        }
+        int trees, node_size;
+        uint64 tree_size;
+        memcpy(&trees, section, sizeof(int));
+        memcpy(&node_size, section+sizeof(int), sizeof(int));
+        memcpy(&tree_size, section+2*sizeof(int), sizeof(uint64));
+        if (trees < 0 || node_size != (int)sizeof(Node) || tree_size != tree_size_ ||
+            (header.index_size-prefix_size)/sizeof(Node) < trees*tree_size_) {
+            throw FLANNException("Invalid flat index, wrong kd-tree section");
+        }
+
+        // the searches follow the offsets and the indices of the nodes unchecked
+        const Node* nodes = (const Node*)(section+prefix_size);
+        for (size_t i=0; i<trees*tree_size_; ++i) {
+            const Node& node = nodes[i];
+            size_t pos = i % tree_size_;
+            bool valid = node.child2 == 0 ?
+                node.divfeat >= 0 && size_t(node.divfeat) < size_ :
+                node.child2 > 1 && pos + size_t(node.child2) < tree_size_ &&
+                node.divfeat >= 0 && size_t(node.divfeat) < veclen_;
+            if (!valid) {
+                throw FLANNException("Invalid flat index, wrong kd-tree node");
+            }
+        }
+
+        trees_ = trees;
+        nodes_.clear();
+        tree_nodes_ = nodes;
+        flat_ = buffer;
 
         index_params_["algorithm"] = getType();
-        index_params_["trees"] = tree_roots_;
+        index_params_["trees"] = trees_;
     }
 
     /**
@@ -190,7 +253,7 @@ public:
      */
     int usedMemory() const CV_OVERRIDE
     {
-        return int(pool_.usedMemory+pool_.wastedMemory+dataset_.rows*sizeof(int));  // pool memory and vind array memory
+        return int(nodes_.size()*sizeof(Node));  // the memory of a mapped flat index is shared, not counted
     }
 
     /**
@@ -208,6 +271,10 @@ public:
         const float epsError = 1+get_param(searchParams,"eps",0.0f);
         const bool explore_all_trees = get_param(searchParams,"explore_all_trees",false);
 
+        if (tree_size_==0) {
+            return;
+        }
+
         if (maxChecks==FLANN_CHECKS_UNLIMITED) {
             getExactNeighbors(result, vec, epsError);
         }
@@ -225,83 +292,118 @@ private:
 
 
     /*--------------------- Internal Data Structures --------------------------*/
+
+    /**
+     * The nodes of a tree are stored in preorder in an array, a tree over n
+     * vectors always has 2n-1 nodes. The first child of a node follows it,
+     * the second one is found by its offset, so the trees hold no pointers and
+     * can be searched in place in a mapped file.
+     */
     struct Node
     {
-        /**
-         * Dimension used for subdivision.
-         */
-        int divfeat;
         /**
          * The values used for subdivision.
          */
         DistanceType divval;
         /**
-         * The child nodes.
+         * Dimension used for subdivision, the index of the vector in a leaf.
          */
-        Node* child1, * child2;
+        int divfeat;
+        /**
+         * Offset of the second child node, 0 in a leaf.
+         */
+        int child2;
     };
-    typedef Node* NodePtr;
+    typedef const Node* NodePtr;
     typedef BranchStruct<NodePtr, DistanceType> BranchSt;
     typedef BranchSt* Branch;
 
+    /**
+     * Node of the pointer-based trees of the saveIndex() format.
+     */
+    struct SavedNode
+    {
+        int divfeat;
+        DistanceType divval;
+        void* child1, * child2;
+    };
 
 
     void save_tree(FILE* stream, NodePtr tree)
     {
-        save_value(stream, *tree);
-        if (tree->child1!=NULL) {
-            save_tree(stream, tree->child1);
+        SavedNode saved;
+        memset(&saved, 0, sizeof(saved));
+        saved.divfeat = tree->divfeat;
+        if (tree->child2!=0) {
+            saved.divval = tree->divval;
+            saved.child1 = (void*)(tree+1);
+            saved.child2 = (void*)(tree+tree->child2);
         }
-        if (tree->child2!=NULL) {
-            save_tree(stream, tree->child2);
+        save_value(stream, saved);
+        if (tree->child2!=0) {
+            save_tree(stream, tree+1);
+            save_tree(stream, tree+tree->child2);
         }
     }
 
 
-    void load_tree(FILE* stream, NodePtr& tree)
+    /**
+     * Loads the subtree stored at position pos of the node array of a tree.
+     * Returns the position following the subtree.
+     */
+    size_t load_tree(FILE* stream, Node* nodes, size_t pos)
     {
-        tree = pool_.allocate<Node>();
-        load_value(stream, *tree);
-        if (tree->child1!=NULL) {
-            load_tree(stream, tree->child1);
+        if (pos>=tree_size_) {
+            throw FLANNException("Invalid index file, wrong tree size");
         }
-        if (tree->child2!=NULL) {
-            load_tree(stream, tree->child2);
+        SavedNode saved;
+        load_value(stream, saved);
+        Node& node = nodes[pos];
+        node.divfeat = saved.divfeat;
+        node.divval = saved.divval;
+        if (saved.child1==NULL || saved.child2==NULL) {
+            if (saved.divfeat<0 || size_t(saved.divfeat)>=size_) {
+                throw FLANNException("Invalid index file, wrong point index");
+            }
+            node.child2 = 0;
+            return pos+1;
         }
+        size_t next = load_tree(stream, nodes, pos+1);
+        node.child2 = int(next-pos);
+        return load_tree(stream, nodes, next);
     }
 
 
     /**
      * Create a tree node that subdivides the list of vecs from vind[first]
      * to vind[last].  The routine is called recursively on each sublist.
-     * Place a pointer to this new tree node in the location pTree.
+     * The 2*count-1 nodes of the subtree are stored from node on.
      *
-     * Params: pTree = the new node to create
-     *                  first = index of the first vector
-     *                  last = index of the last vector
+     * Params: node = the new node to create
+     *                  ind = the indices of the vectors
+     *                  count = the number of the vectors
+     *                  mean, var = scratch buffers of veclen_ values
      */
-    NodePtr divideTree(int* ind, int count)
+    void divideTree(Node* node, int* ind, int count, DistanceType* mean, DistanceType* var)
     {
-        NodePtr node = pool_.allocate<Node>(); // allocate memory
-
         /* If too few exemplars remain, then make this a leaf node. */
         if ( count == 1) {
-            node->child1 = node->child2 = NULL;    /* Mark as leaf node. */
+            node->child2 = 0;    /* Mark as leaf node. */
             node->divfeat = *ind;    /* Store index of this vec. */
+            node->divval = 0;
         }
         else {
             int idx;
             int cutfeat;
             DistanceType cutval;
-            meanSplit(ind, count, idx, cutfeat, cutval);
+            meanSplit(ind, count, idx, cutfeat, cutval, mean, var);
 
             node->divfeat = cutfeat;
             node->divval = cutval;
-            node->child1 = divideTree(ind, idx);
-            node->child2 = divideTree(ind+idx, count-idx);
+            node->child2 = 2*idx;
+            divideTree(node+1, ind, idx, mean, var);
+            divideTree(node+node->child2, ind+idx, count-idx, mean, var);
         }
-
-        return node;
     }
 
 
@@ -310,10 +412,11 @@ private:
      * Make a random choice among those with the highest variance, and use
      * its variance as the threshold value.
      */
-    void meanSplit(int* ind, int count, int& index, int& cutfeat, DistanceType& cutval)
+    void meanSplit(int* ind, int count, int& index, int& cutfeat, DistanceType& cutval,
+                   DistanceType* mean, DistanceType* var)
     {
-        memset(mean_,0,veclen_*sizeof(DistanceType));
-        memset(var_,0,veclen_*sizeof(DistanceType));
+        memset(mean,0,veclen_*sizeof(DistanceType));
+        memset(var,0,veclen_*sizeof(DistanceType));
 
         /* Compute mean values.  Only the first SAMPLE_MEAN values need to be
             sampled to get a good estimate.
@@ -322,24 +425,24 @@ private:
         for (int j = 0; j < cnt; ++j) {
             ElementType* v = dataset_[ind[j]];
             for (size_t k=0; k<veclen_; ++k) {
-                mean_[k] += v[k];
+                mean[k] += v[k];
             }
         }
         for (size_t k=0; k<veclen_; ++k) {
-            mean_[k] /= cnt;
+            mean[k] /= cnt;
         }
 
         /* Compute variances (no need to divide by count). */
         for (int j = 0; j < cnt; ++j) {
             ElementType* v = dataset_[ind[j]];
             for (size_t k=0; k<veclen_; ++k) {
-                DistanceType dist = v[k] - mean_[k];
-                var_[k] += dist * dist;
+                DistanceType dist = v[k] - mean[k];
+                var[k] += dist * dist;
             }
         }
         /* Select one of the highest variance indices at random. */
-        cutfeat = selectDivision(var_);
-        cutval = mean_[cutfeat];
+        cutfeat = selectDivision(var);
+        cutval = mean[cutfeat];
 
         int lim1, lim2;
         planeSplit(ind, count, cutfeat, cutval, lim1, lim2);
@@ -431,7 +534,7 @@ private:
             fprintf(stderr,"It doesn't make any sense to use more than one tree for exact search");
         }
         if (trees_>0) {
-            searchLevelExact(result, vec, tree_roots_[0], 0.0, epsError);
+            searchLevelExact(result, vec, tree_nodes_, 0.0, epsError);
         }
         CV_Assert(result.full());
     }
@@ -453,7 +556,7 @@ private:
 
         /* Search once through each tree down to root. */
         for (i = 0; i < trees_; ++i) {
-            searchLevel(result, vec, tree_roots_[i], 0, checkCount, maxCheck,
+            searchLevel(result, vec, tree_nodes_+i*tree_size_, 0, checkCount, maxCheck,
                         epsError, heap, checked, explore_all_trees);
             if (!explore_all_trees && (checkCount >= maxCheck) && result.full())
                 break;
@@ -485,7 +588,7 @@ private:
         }
 
         /* If this is a leaf node, then do check and return. */
-        if ((node->child1 == NULL)&&(node->child2 == NULL)) {
+        if (node->child2 == 0) {
             /*  Do not check same node more than once when searching multiple trees.
                 Once a vector is checked, we set its location in vind to the
                 current checkID.
@@ -507,8 +610,8 @@ private:
         /* Which child branch should be taken first? */
         ElementType val = vec[node->divfeat];
         DistanceType diff = val - node->divval;
-        NodePtr bestChild = (diff < 0) ? node->child1 : node->child2;
-        NodePtr otherChild = (diff < 0) ? node->child2 : node->child1;
+        NodePtr bestChild = (diff < 0) ? node+1 : node+node->child2;
+        NodePtr otherChild = (diff < 0) ? node+node->child2 : node+1;
 
         /* Create a branch record for the branch not taken.  Add distance
             of this feature boundary (we don't attempt to correct for any
@@ -534,7 +637,7 @@ private:
     void searchLevelExact(ResultSet<DistanceType>& result_set, const ElementType* vec, const NodePtr node, DistanceType mindist, const float epsError)
     {
         /* If this is a leaf node, then do check and return. */
-        if ((node->child1 == NULL)&&(node->child2 == NULL)) {
+        if (node->child2 == 0) {
             int index = node->divfeat;
             DistanceType dist = distance_(dataset_[index], vec, veclen_);
             result_set.addPoint(dist,index);
@@ -544,8 +647,8 @@ private:
         /* Which child branch should be taken first? */
         ElementType val = vec[node->divfeat];
         DistanceType diff = val - node->divval;
-        NodePtr bestChild = (diff < 0) ? node->child1 : node->child2;
-        NodePtr otherChild = (diff < 0) ? node->child2 : node->child1;
+        NodePtr bestChild = (diff < 0) ? node+1 : node+node->child2;
+        NodePtr otherChild = (diff < 0) ? node+node->child2 : node+1;
 
         /* Create a branch record for the branch not taken.  Add distance
             of this feature boundary (we don't attempt to correct for any
@@ -592,11 +695,6 @@ private:
      */
     int trees_;
 
-    /**
-     *  Array of indices to vectors in the dataset.
-     */
-    std::vector<int> vind_;
-
     /**
      * The dataset used by this index
      */
@@ -608,23 +706,26 @@ private:
     size_t veclen_;
 
 
-    DistanceType* mean_;
-    DistanceType* var_;
+    /**
+     * Number of nodes of every k-d tree.
+     */
+    size_t tree_size_;
 
+    /**
+     * The nodes of the k-d trees built or loaded, tree after tree.
+     */
+    std::vector<Node> nodes_;
 
     /**
-     * Array of k-d trees used to find neighbours.
+     * The nodes of the k-d trees used to find neighbours, either nodes_
+     * or the nodes of a flat index searched in place.
      */
-    NodePtr* tree_roots_;
+    NodePtr tree_nodes_;
 
     /**
-     * Pooled memory allocator.
-     *
-     * Using a pooled memory allocator is more efficient
-     * than allocating memory directly when there is a large
-     * number small of memory allocations.
+     * Memory holding the flat index searched in place.
      */
-    PooledAllocator pool_;
+    cv::Ptr<FlatBuffer> flat_;
 
     Distance distance_;
 
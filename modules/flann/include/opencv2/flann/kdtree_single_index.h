@@ -219,11 +219,13 @@ public:
         CV_Assert(int(indices.cols) >= knn);
         CV_Assert(int(dists.cols) >= knn);
 
-        KNNSimpleResultSet<DistanceType> resultSet(knn);
-        for (size_t i = 0; i < queries.rows; i++) {
-            resultSet.init(indices[i], dists[i]);
-            findNeighbors(resultSet, queries[i], params);
-        }
+        cv::parallel_for_(cv::Range(0, (int)queries.rows), [&](const cv::Range& range) {
+            KNNSimpleResultSet<DistanceType> resultSet(knn);
+            for (int i = range.start; i < range.end; i++) {
+                resultSet.init(indices[i], dists[i]);
+                findNeighbors(resultSet, queries[i], params);
+            }
+        });
     }
 
     IndexParams getParameters() const CV_OVERRIDE
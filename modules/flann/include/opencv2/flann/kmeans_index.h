@@ -1014,7 +1014,7 @@ private:
 
        for (int i=0; i<branching; ++i) {
            centers[i] = new CentersType[veclen_];
-           memoryCounter_ += (int)(veclen_*sizeof(CentersType));
+           addMemory((int)(veclen_*sizeof(CentersType)));
            for (size_t k=0; k<veclen_; ++k) {
                centers[i][k] = (CentersType)dcenters[i][k];
            }
@@ -1027,7 +1027,7 @@ private:
     {
         for (int i=0; i<branching; ++i) {
             centers[i] = new CentersType[veclen_];
-            memoryCounter_ += (int)(veclen_*sizeof(CentersType));
+            addMemory((int)(veclen_*sizeof(CentersType)));
         }
 
         const unsigned int accumulator_veclen = static_cast<unsigned int>(
@@ -1131,7 +1131,7 @@ private:
     {
         for (int i=0; i<branching; ++i) {
             centers[i] = new CentersType[veclen_];
-            memoryCounter_ += (int)(veclen_*sizeof(CentersType));
+            addMemory((int)(veclen_*sizeof(CentersType)));
         }
 
         const unsigned int histos_veclen = static_cast<unsigned int>(
@@ -1237,9 +1237,9 @@ private:
                               std::vector<DistanceType>& radiuses, int* belongs_to, int* count)
     {
         // compute kmeans clustering for each of the resulting clusters
-        node->childs = pool_.allocate<KMeansNodePtr>(branching);
-        int start = 0;
-        int end = start;
+        node->childs = allocateShared<KMeansNodePtr>(branching);
+        std::vector<int> starts(branching+1, 0);
+        int end = 0;
         for (int c=0; c<branching; ++c) {
             int s = count[c];
 
@@ -1259,15 +1259,16 @@ private:
             mean_radius /= s;
             variance -= distance_(centers[c], ZeroIterator<ElementType>(), veclen_);
 
-            node->childs[c] = pool_.allocate<KMeansNode>();
+            node->childs[c] = allocateShared<KMeansNode>();
             std::memset(node->childs[c], 0, sizeof(KMeansNode));
             node->childs[c]->radius = radiuses[c];
             node->childs[c]->pivot = centers[c];
             node->childs[c]->variance = variance;
             node->childs[c]->mean_radius = mean_radius;
-            computeClustering(node->childs[c],indices+start, end-start, branching, level+1);
-            start=end;
+            starts[c+1] = end;
         }
+
+        computeChildClustering(node, indices, indices_length, branching, level, starts);
     }
 
 
@@ -1276,9 +1277,9 @@ private:
                               std::vector<DistanceType>& radiuses, int* belongs_to, int* count)
     {
         // compute kmeans clustering for each of the resulting clusters
-        node->childs = pool_.allocate<KMeansNodePtr>(branching);
-        int start = 0;
-        int end = start;
+        node->childs = allocateShared<KMeansNodePtr>(branching);
+        std::vector<int> starts(branching+1, 0);
+        int end = 0;
         for (int c=0; c<branching; ++c) {
             int s = count[c];
 
@@ -1302,15 +1303,46 @@ private:
                         ensureSquareDistance<Distance>(
                             distance_(centers[c], ZeroIterator<ElementType>(), veclen_)));
 
-            node->childs[c] = pool_.allocate<KMeansNode>();
+            node->childs[c] = allocateShared<KMeansNode>();
             std::memset(node->childs[c], 0, sizeof(KMeansNode));
             node->childs[c]->radius = radiuses[c];
             node->childs[c]->pivot = centers[c];
             node->childs[c]->variance = static_cast<DistanceType>(variance);
             node->childs[c]->mean_radius = mean_radius;
-            computeClustering(node->childs[c],indices+start, end-start, branching, level+1);
-            start=end;
+            starts[c+1] = end;
         }
+
+        computeChildClustering(node, indices, indices_length, branching, level, starts);
+    }
+
+
+    /**
+     * Clusters the children of a node, the points of child c are indices[starts[c]..starts[c+1]).
+     * The children are independent, the children of the large nodes are clustered in parallel.
+     */
+    void computeChildClustering(KMeansNodePtr node, int* indices, int indices_length, int branching, int level,
+                                const std::vector<int>& starts)
+    {
+        parallel_for_seeded(branching, indices_length >= MIN_PARALLEL_SIZE, [&](int c) {
+            computeClustering(node->childs[c], indices+starts[c], starts[c+1]-starts[c], branching, level+1);
+        });
+    }
+
+
+    /**
+     * Allocates memory from the pool, the children of a node may be clustered by several threads.
+     */
+    template <typename T>
+    T* allocateShared(size_t count = 1)
+    {
+        cv::AutoLock lock(pool_mutex_);
+        return pool_.allocate<T>(count);
+    }
+
+    void addMemory(int size)
+    {
+        cv::AutoLock lock(pool_mutex_);
+        memoryCounter_ += size;
     }
 
 
@@ -1808,10 +1840,23 @@ private:
      */
     PooledAllocator pool_;
 
+    /**
+     * Guards the pool and the memory counter while the children are clustered in parallel.
+     */
+    cv::Mutex pool_mutex_;
+
     /**
      * Memory occupied by the index.
      */
     int memoryCounter_;
+
+    enum
+    {
+        /**
+         * The children of the nodes with at least this many points are clustered in parallel.
+         */
+        MIN_PARALLEL_SIZE = 4096
+    };
 };
 
 }
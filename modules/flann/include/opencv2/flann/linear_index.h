@@ -105,6 +105,17 @@ public:
         index_params_["algorithm"] = getType();
     }
 
+    void saveFlatIndex(FILE*) CV_OVERRIDE
+    {
+        /* the dataset is all there is to save for linear search */
+    }
+
+    void attachFlatIndex(const cv::Ptr<FlatBuffer>& buffer, const FlatIndexHeader&) CV_OVERRIDE
+    {
+        flat_ = buffer;
+        index_params_["algorithm"] = getType();
+    }
+
     void findNeighbors(ResultSet<DistanceType>& resultSet, const ElementType* vec, const SearchParams& /*searchParams*/) CV_OVERRIDE
     {
         ElementType* data = dataset_.data;
@@ -126,6 +137,8 @@ private:
     IndexParams index_params_;
     /** Index distance */
     Distance distance_;
+    /** Memory holding the dataset of a flat index searched in place */
+    cv::Ptr<FlatBuffer> flat_;
 
 };
 
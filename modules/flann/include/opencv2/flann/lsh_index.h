@@ -116,13 +116,14 @@ public:
     void buildIndex() CV_OVERRIDE
     {
         tables_.resize(table_number_);
-        for (int i = 0; i < table_number_; ++i) {
+        // the tables are independent, so they are built in parallel
+        parallel_for_seeded(table_number_, true, [&](int i) {
             lsh::LshTable<ElementType>& table = tables_[i];
             table = lsh::LshTable<ElementType>(feature_size_, key_size_);
 
             // Add the features to the table
             table.add(dataset_);
-        }
+        });
     }
 
     flann_algorithm_t getType() const CV_OVERRIDE
@@ -202,15 +203,18 @@ public:
         CV_Assert(int(dists.cols) >= knn);
 
 
-        KNNUniqueResultSet<DistanceType> resultSet(knn);
-        for (size_t i = 0; i < queries.rows; i++) {
-            resultSet.clear();
-            std::fill_n(indices[i], knn, -1);
-            std::fill_n(dists[i], knn, std::numeric_limits<DistanceType>::max());
-            findNeighbors(resultSet, queries[i], params);
-            if (get_param(params,"sorted",true)) resultSet.sortAndCopy(indices[i], dists[i], knn);
-            else resultSet.copy(indices[i], dists[i], knn);
-        }
+        const bool sorted = get_param(params,"sorted",true);
+        cv::parallel_for_(cv::Range(0, (int)queries.rows), [&](const cv::Range& range) {
+            KNNUniqueResultSet<DistanceType> resultSet(knn);
+            for (int i = range.start; i < range.end; i++) {
+                resultSet.clear();
+                std::fill_n(indices[i], knn, -1);
+                std::fill_n(dists[i], knn, std::numeric_limits<DistanceType>::max());
+                findNeighbors(resultSet, queries[i], params);
+                if (sorted) resultSet.sortAndCopy(indices[i], dists[i], knn);
+                else resultSet.copy(indices[i], dists[i], knn);
+            }
+        });
     }
 
 
@@ -136,6 +136,16 @@ struct CV_EXPORTS LshIndexParams : public IndexParams
     LshIndexParams(int table_number, int key_size, int multi_probe_level);
 };
 
+struct CV_EXPORTS IVFPQIndexParams : public IndexParams
+{
+    IVFPQIndexParams(int lists = 256, int subquantizers = 16, int iterations = 10, int train_size = 65536);
+};
+
+struct CV_EXPORTS HNSWIndexParams : public IndexParams
+{
+    HNSWIndexParams(int M = 16, int ef_construction = 200);
+};
+
 struct CV_EXPORTS SavedIndexParams : public IndexParams
 {
     SavedIndexParams(const String& filename);
@@ -162,8 +172,21 @@ public:
                              OutputArray dists, double radius, int maxResults,
                              const SearchParams& params=SearchParams());
 
+    /** @brief Adds features to an index that supports it (HNSW), they get the indices following the ones of the indexed features.
+    The index uses the memory of the features, as the one of the features it was built on.
+    */
+    CV_WRAP void addPoints(InputArray features);
+
     CV_WRAP virtual void save(const String& filename) const;
     CV_WRAP virtual bool load(InputArray features, const String& filename);
+    /** @brief Saves the index together with its features in a flat layout that loadMapped() searches in place.
+    Only the linear and kd-tree indices support the layout, the file is specific to the platform.
+    */
+    CV_WRAP void saveFlat(InputArray features, const String& filename) const;
+    /** @brief Maps a file written by saveFlat() into memory read-only and searches it in place.
+    The processes mapping the same file share its pages. Returns false if the file cannot be opened.
+    */
+    CV_WRAP bool loadMapped(const String& filename);
     CV_WRAP virtual void release();
     CV_WRAP cvflann::flann_distance_t getDistance() const;
     CV_WRAP cvflann::flann_algorithm_t getAlgorithm() const;
@@ -35,6 +35,7 @@
 #include "matrix.h"
 #include "result_set.h"
 #include "params.h"
+#include "flat_index.h"
 
 //! @cond IGNORED
 
@@ -61,6 +62,8 @@ public:
 
     /**
      * \brief Perform k-nearest neighbor search
+     *
+     * The queries are searched in parallel, so findNeighbors() must not modify the index.
      * \param[in] queries The query points for which to find the nearest neighbors
      * \param[out] indices The indices of the nearest neighbors found
      * \param[out] dists Distances to the nearest neighbors found
@@ -82,13 +85,17 @@ public:
             findNeighbors(resultSet, queries[i], params);
         }
 #else
-        KNNUniqueResultSet<DistanceType> resultSet(knn);
-        for (size_t i = 0; i < queries.rows; i++) {
-            resultSet.clear();
-            findNeighbors(resultSet, queries[i], params);
-            if (get_param(params,"sorted",true)) resultSet.sortAndCopy(indices[i], dists[i], knn);
-            else resultSet.copy(indices[i], dists[i], knn);
-        }
+        // the queries are searched in parallel, every stripe with its own result set
+        const bool sorted = get_param(params,"sorted",true);
+        cv::parallel_for_(cv::Range(0, (int)queries.rows), [&](const cv::Range& range) {
+            KNNUniqueResultSet<DistanceType> resultSet(knn);
+            for (int i = range.start; i < range.end; i++) {
+                resultSet.clear();
+                findNeighbors(resultSet, queries[i], params);
+                if (sorted) resultSet.sortAndCopy(indices[i], dists[i], knn);
+                else resultSet.copy(indices[i], dists[i], knn);
+            }
+        });
 #endif
     }
 
@@ -130,6 +137,16 @@ public:
         return (int)resultSet.size();
     }
 
+    /**
+     * \brief Adds points to the index, they get the indices following the ones of the dataset
+     * \param points The points to add, their memory must outlive the index
+     */
+    virtual void addPoints(const Matrix<ElementType>& points)
+    {
+        (void)points;
+        throw FLANNException("The index type does not support adding points");
+    }
+
     /**
      * \brief Saves the index to a stream
      * \param stream The stream to save the index to
@@ -142,6 +159,27 @@ public:
      */
     virtual void loadIndex(FILE* stream) = 0;
 
+    /**
+     * \brief Saves the index section of the flat layout, see FlatIndexHeader
+     * \param stream The stream to save the index to, positioned at the start of the section
+     */
+    virtual void saveFlatIndex(FILE* stream)
+    {
+        (void)stream;
+        throw FLANNException("The index type does not support the flat layout");
+    }
+
+    /**
+     * \brief Makes the index search the index section of the flat layout in place
+     * \param buffer The memory holding the flat layout, kept by the index
+     * \param header The validated header of the flat layout
+     */
+    virtual void attachFlatIndex(const cv::Ptr<FlatBuffer>& buffer, const FlatIndexHeader& header)
+    {
+        (void)buffer; (void)header;
+        throw FLANNException("The index type does not support the flat layout");
+    }
+
     /**
      * \returns number of features in this index.
      */
@@ -69,6 +69,50 @@ inline void seed_random(unsigned int seed)
 #endif
 }
 
+/**
+ * Calls body(i) for every i in [0,n), in parallel if requested.
+ *
+ * Every call draws its random numbers from its own generator, seeded from the
+ * generator of the calling thread before the loop, so the results depend
+ * neither on the number of threads nor on the order of the calls.
+ * With OPENCV_FLANN_USE_STD_RAND the calls are made one by one.
+ */
+template <typename Body>
+void parallel_for_seeded(int n, bool parallel, const Body& body)
+{
+#ifndef OPENCV_FLANN_USE_STD_RAND
+    std::vector<unsigned> seeds(n);
+    for (int i = 0; i < n; ++i) {
+        seeds[i] = cv::theRNG().next();
+    }
+
+    struct SeedScope
+    {
+        explicit SeedScope(unsigned seed) : saved(cv::theRNG()) { cv::theRNG() = cv::RNG(seed); }
+        ~SeedScope() { cv::theRNG() = saved; }
+        cv::RNG saved;
+    };
+
+    auto run = [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) {
+            SeedScope scope(seeds[i]);
+            body(i);
+        }
+    };
+    if (parallel) {
+        cv::parallel_for_(cv::Range(0, n), run, n);
+    }
+    else {
+        run(cv::Range(0, n));
+    }
+#else
+    CV_UNUSED(parallel);
+    for (int i = 0; i < n; ++i) {
+        body(i);
+    }
+#endif
+}
+
 /*
  * Generates a random double value.
  */
@@ -184,6 +184,94 @@ void load_value(FILE* stream, std::vector<T>& value)
     }
 }
 
+
+/**
+ * Saves an index together with its dataset in the flat layout
+ *
+ * @param stream - Stream to save to, positioned at its start
+ * @param index - The index to save
+ * @param dataset - The dataset the index was built on
+ * @param distance_type - The flann_distance_t of the index
+ */
+template<typename Distance>
+void save_flat_index(FILE* stream, NNIndex<Distance>& index, const Matrix<typename Distance::ElementType>& dataset, int distance_type)
+{
+    typedef typename Distance::ElementType ElementType;
+
+    FlatIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    strcpy(header.signature, FLANN_FLAT_SIGNATURE_);
+    header.version = FLANN_FLAT_VERSION;
+    header.header_size = (int)sizeof(header);
+    header.data_type = Datatype<ElementType>::type();
+    header.index_type = index.getType();
+    header.distance_type = distance_type;
+    header.rows = dataset.rows;
+    header.cols = dataset.cols;
+
+    // the header is written again once the offsets are known
+    std::fwrite(&header, sizeof(header), 1, stream);
+    header.data_offset = align_flat_stream(stream);
+    for (size_t i = 0; i < dataset.rows; ++i) {
+        std::fwrite(dataset[i], sizeof(ElementType), dataset.cols, stream);
+    }
+    header.index_offset = align_flat_stream(stream);
+    index.saveFlatIndex(stream);
+    header.index_size = (uint64)flat_stream_position(stream) - header.index_offset;
+
+    if (fseek(stream, 0, SEEK_SET) != 0 || std::fwrite(&header, sizeof(header), 1, stream) != 1 ||
+        fseek(stream, 0, SEEK_END) != 0 || ferror(stream)) {
+        throw FLANNException("Cannot write the flat index");
+    }
+}
+
+/**
+ * Validates the header of an index saved in the flat layout
+ *
+ * @param buffer - Memory holding the flat layout
+ * @return Index header
+ */
+inline FlatIndexHeader load_flat_header(const FlatBuffer& buffer)
+{
+    FlatIndexHeader header;
+    if (buffer.size() < sizeof(header)) {
+        throw FLANNException("Invalid flat index, cannot read");
+    }
+    memcpy(&header, buffer.data(), sizeof(header));
+
+    if (strncmp(header.signature, FLANN_FLAT_SIGNATURE_, sizeof(header.signature)) != 0) {
+        throw FLANNException("Invalid flat index, wrong signature");
+    }
+    if (header.version != FLANN_FLAT_VERSION || header.header_size != (int)sizeof(header)) {
+        throw FLANNException("Invalid flat index, unsupported version or platform");
+    }
+    if (header.index_offset % FLANN_FLAT_ALIGNMENT != 0 || header.index_offset > buffer.size() ||
+        header.index_size > buffer.size() - header.index_offset) {
+        throw FLANNException("Invalid flat index, truncated file");
+    }
+    return header;
+}
+
+/**
+ * Returns the dataset stored in the flat layout, without copying it
+ *
+ * @param buffer - Memory holding the flat layout
+ * @param header - The validated header
+ */
+template<typename T>
+Matrix<T> get_flat_dataset(const FlatBuffer& buffer, const FlatIndexHeader& header)
+{
+    if (header.data_type != Datatype<T>::type()) {
+        throw FLANNException("Invalid flat index, wrong data type");
+    }
+    if (header.data_offset % FLANN_FLAT_ALIGNMENT != 0 || header.data_offset > buffer.size() ||
+        (header.cols != 0 && header.rows > (buffer.size() - header.data_offset) / sizeof(T) / header.cols)) {
+        throw FLANNException("Invalid flat index, truncated file");
+    }
+    // the indices never write to the dataset, the memory may be mapped read-only
+    return Matrix<T>((T*)(buffer.data() + header.data_offset), (size_t)header.rows, (size_t)header.cols);
+}
+
 }
 
 //! @endcond
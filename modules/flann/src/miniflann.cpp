@@ -1,5 +1,18 @@
 #include "precomp.hpp"
 
+#if defined _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined __unix__ || defined __APPLE__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAVE_FLANN_MMAP 1
+#endif
+
 #define MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES 0
 
 static cvflann::IndexParams& get_params(const cv::flann::IndexParams& p)
@@ -285,6 +298,30 @@ LshIndexParams::LshIndexParams(int table_number, int key_size, int multi_probe_l
     p["multi_probe_level"] = multi_probe_level;
 }
 
+IVFPQIndexParams::IVFPQIndexParams(int lists, int subquantizers, int iterations, int train_size)
+{
+    ::cvflann::IndexParams& p = get_params(*this);
+    p["algorithm"] = FLANN_INDEX_IVFPQ;
+    // number of inverted lists (coarse clusters)
+    p["lists"] = lists;
+    // number of sub-vectors a vector is split into, every one encoded in a byte
+    p["subquantizers"] = subquantizers;
+    // max iterations of the kmeans clusterings
+    p["iterations"] = iterations;
+    // max number of vectors the quantizers are trained on
+    p["train_size"] = train_size;
+}
+
+HNSWIndexParams::HNSWIndexParams(int M, int ef_construction)
+{
+    ::cvflann::IndexParams& p = get_params(*this);
+    p["algorithm"] = FLANN_INDEX_HNSW;
+    // number of links of a point on the upper layers, twice as many on the bottom one
+    p["M"] = M;
+    // number of candidates the links of a new point are chosen from
+    p["ef_construction"] = ef_construction;
+}
+
 SavedIndexParams::SavedIndexParams(const String& _filename)
 {
     String filename = _filename;
@@ -406,6 +443,12 @@ void Index::build(InputArray _data, const IndexParams& params, flann_distance_t
     {
         distType = FLANN_DIST_HAMMING;
     }
+    // 8-bit vectors may be binary descriptors or quantized ones, the graph index does not guess the distance
+    if ( algo == FLANN_INDEX_HNSW && featureType == CV_8U && distType != FLANN_DIST_HAMMING )
+    {
+        CV_Error(Error::StsBadArg, "The HNSW index searches CV_8U data with FLANN_DIST_HAMMING only, "
+                 "convert the vectors to CV_32F for the other distances");
+    }
 
     switch( distType )
     {
@@ -418,6 +461,9 @@ void Index::build(InputArray _data, const IndexParams& params, flann_distance_t
     case FLANN_DIST_L1:
         buildIndex< ::cvflann::L1<float> >(index, data, params);
         break;
+    case FLANN_DIST_INNER_PRODUCT:
+        buildIndex< ::cvflann::InnerProductDistance<float> >(index, data, params);
+        break;
 #if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
     case FLANN_DIST_DNAMMING:
         buildIndex< DNAmmingDistance >(index, data, params);
@@ -443,6 +489,65 @@ void Index::build(InputArray _data, const IndexParams& params, flann_distance_t
     }
 }
 
+template<typename Distance> void addIndexPoints(void* index, const Mat& data)
+{
+    typedef typename Distance::ElementType ElementType;
+    if(DataType<ElementType>::type != data.type())
+        CV_Error_(Error::StsUnsupportedFormat, ("type=%d\n", data.type()));
+    if(!data.isContinuous())
+        CV_Error(Error::StsBadArg, "Only continuous arrays are supported");
+
+    ::cvflann::Matrix<ElementType> points((ElementType*)data.data, data.rows, data.cols);
+    ((::cvflann::Index<Distance>*)index)->addPoints(points);
+}
+
+void Index::addPoints(InputArray _data)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat data = _data.getMat();
+    if( !index )
+        CV_Error(Error::StsError, "The index is not built");
+
+    switch( distType )
+    {
+    case FLANN_DIST_HAMMING:
+        addIndexPoints< HammingDistance >(index, data);
+        break;
+    case FLANN_DIST_L2:
+        addIndexPoints< ::cvflann::L2<float> >(index, data);
+        break;
+    case FLANN_DIST_L1:
+        addIndexPoints< ::cvflann::L1<float> >(index, data);
+        break;
+    case FLANN_DIST_INNER_PRODUCT:
+        addIndexPoints< ::cvflann::InnerProductDistance<float> >(index, data);
+        break;
+#if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
+    case FLANN_DIST_DNAMMING:
+        addIndexPoints< DNAmmingDistance >(index, data);
+        break;
+    case FLANN_DIST_MAX:
+        addIndexPoints< ::cvflann::MaxDistance<float> >(index, data);
+        break;
+    case FLANN_DIST_HIST_INTERSECT:
+        addIndexPoints< ::cvflann::HistIntersectionDistance<float> >(index, data);
+        break;
+    case FLANN_DIST_HELLINGER:
+        addIndexPoints< ::cvflann::HellingerDistance<float> >(index, data);
+        break;
+    case FLANN_DIST_CHI_SQUARE:
+        addIndexPoints< ::cvflann::ChiSquareDistance<float> >(index, data);
+        break;
+    case FLANN_DIST_KL:
+        addIndexPoints< ::cvflann::KL_Divergence<float> >(index, data);
+        break;
+#endif
+    default:
+        CV_Error(Error::StsBadArg, "Unknown/unsupported distance type");
+    }
+}
+
 template<typename IndexType> void deleteIndex_(void* index)
 {
     delete (IndexType*)index;
@@ -476,6 +581,9 @@ void Index::release()
         case FLANN_DIST_L1:
             deleteIndex< ::cvflann::L1<float> >(index);
             break;
+        case FLANN_DIST_INNER_PRODUCT:
+            deleteIndex< ::cvflann::InnerProductDistance<float> >(index);
+            break;
 #if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
         case FLANN_DIST_DNAMMING:
             deleteIndex< DNAmmingDistance >(index);
@@ -617,6 +725,9 @@ void Index::knnSearch(InputArray _query, OutputArray _indices,
     case FLANN_DIST_L1:
         runKnnSearch< ::cvflann::L1<float> >(index, query, indices, dists, knn, params);
         break;
+    case FLANN_DIST_INNER_PRODUCT:
+        runKnnSearch< ::cvflann::InnerProductDistance<float> >(index, query, indices, dists, knn, params);
+        break;
 #if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
     case FLANN_DIST_DNAMMING:
         runKnnSearch<DNAmmingDistance>(index, query, indices, dists, knn, params);
@@ -666,6 +777,8 @@ int Index::radiusSearch(InputArray _query, OutputArray _indices,
         return runRadiusSearch< ::cvflann::L2<float> >(index, query, indices, dists, radius, params);
     case FLANN_DIST_L1:
         return runRadiusSearch< ::cvflann::L1<float> >(index, query, indices, dists, radius, params);
+    case FLANN_DIST_INNER_PRODUCT:
+        return runRadiusSearch< ::cvflann::InnerProductDistance<float> >(index, query, indices, dists, radius, params);
 #if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
     case FLANN_DIST_DNAMMING:
         return runRadiusSearch< DNAmmingDistance >(index, query, indices, dists, radius, params);
@@ -731,6 +844,9 @@ void Index::save(const String& filename) const
     case FLANN_DIST_L1:
         saveIndex< ::cvflann::L1<float> >(this, index, fout);
         break;
+    case FLANN_DIST_INNER_PRODUCT:
+        saveIndex< ::cvflann::InnerProductDistance<float> >(this, index, fout);
+        break;
 #if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
     case FLANN_DIST_DNAMMING:
         saveIndex< DNAmmingDistance >(this, index, fout);
@@ -761,6 +877,17 @@ void Index::save(const String& filename) const
 }
 
 
+static int getFeatureType(int data_type)
+{
+    return data_type == FLANN_UINT8 ? CV_8U :
+           data_type == FLANN_INT8 ? CV_8S :
+           data_type == FLANN_UINT16 ? CV_16U :
+           data_type == FLANN_INT16 ? CV_16S :
+           data_type == FLANN_INT32 ? CV_32S :
+           data_type == FLANN_FLOAT32 ? CV_32F :
+           data_type == FLANN_FLOAT64 ? CV_64F : -1;
+}
+
 template<typename Distance, typename IndexType>
 bool loadIndex_(Index* index0, void*& index, const Mat& data, FILE* fin, const Distance& dist=Distance())
 {
@@ -794,13 +921,7 @@ bool Index::load(InputArray _data, const String& filename)
 
     ::cvflann::IndexHeader header = ::cvflann::load_header(fin);
     algo = header.index_type;
-    featureType = header.data_type == FLANN_UINT8 ? CV_8U :
-                  header.data_type == FLANN_INT8 ? CV_8S :
-                  header.data_type == FLANN_UINT16 ? CV_16U :
-                  header.data_type == FLANN_INT16 ? CV_16S :
-                  header.data_type == FLANN_INT32 ? CV_32S :
-                  header.data_type == FLANN_FLOAT32 ? CV_32F :
-                  header.data_type == FLANN_FLOAT64 ? CV_64F : -1;
+    featureType = getFeatureType(header.data_type);
 
     if( (int)header.rows != data.rows || (int)header.cols != data.cols ||
         featureType != data.type() )
@@ -835,6 +956,9 @@ bool Index::load(InputArray _data, const String& filename)
     case FLANN_DIST_L1:
         loadIndex< ::cvflann::L1<float> >(this, index, data, fin);
         break;
+    case FLANN_DIST_INNER_PRODUCT:
+        loadIndex< ::cvflann::InnerProductDistance<float> >(this, index, data, fin);
+        break;
 #if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
     case FLANN_DIST_DNAMMING:
         loadIndex< DNAmmingDistance >(this, index, data, fin);
@@ -865,6 +989,255 @@ bool Index::load(InputArray _data, const String& filename)
     return ok;
 }
 
+
+template<typename Distance> void saveFlatIndex(const Index* index0, void* index, const Mat& data, FILE* fout)
+{
+    typedef typename Distance::ElementType ElementType;
+    ::cvflann::Index<Distance>* _index = (::cvflann::Index<Distance>*)index;
+    if( DataType<ElementType>::type != data.type() || !data.isContinuous() ||
+        (size_t)data.rows != _index->size() || (size_t)data.cols != _index->veclen() )
+        CV_Error(Error::StsBadArg, "The features are not the ones the index was built on");
+
+    ::cvflann::Matrix<ElementType> dataset((ElementType*)data.data, data.rows, data.cols);
+    ::cvflann::save_flat_index(fout, *_index, dataset, (int)index0->getDistance());
+}
+
+void Index::saveFlat(InputArray _data, const String& filename) const
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat data = _data.getMat();
+    if( !index )
+        CV_Error(Error::StsError, "The index is not built");
+
+    FILE* fout = fopen(filename.c_str(), "wb");
+    if (fout == NULL)
+        CV_Error_( Error::StsError, ("Can not open file %s for writing FLANN index\n", filename.c_str()) );
+
+    try
+    {
+        switch( distType )
+        {
+        case FLANN_DIST_HAMMING:
+            saveFlatIndex< HammingDistance >(this, index, data, fout);
+            break;
+        case FLANN_DIST_L2:
+            saveFlatIndex< ::cvflann::L2<float> >(this, index, data, fout);
+            break;
+        case FLANN_DIST_L1:
+            saveFlatIndex< ::cvflann::L1<float> >(this, index, data, fout);
+            break;
+        case FLANN_DIST_INNER_PRODUCT:
+            saveFlatIndex< ::cvflann::InnerProductDistance<float> >(this, index, data, fout);
+            break;
+#if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
+        case FLANN_DIST_DNAMMING:
+            saveFlatIndex< DNAmmingDistance >(this, index, data, fout);
+            break;
+        case FLANN_DIST_MAX:
+            saveFlatIndex< ::cvflann::MaxDistance<float> >(this, index, data, fout);
+            break;
+        case FLANN_DIST_HIST_INTERSECT:
+            saveFlatIndex< ::cvflann::HistIntersectionDistance<float> >(this, index, data, fout);
+            break;
+        case FLANN_DIST_HELLINGER:
+            saveFlatIndex< ::cvflann::HellingerDistance<float> >(this, index, data, fout);
+            break;
+        case FLANN_DIST_CHI_SQUARE:
+            saveFlatIndex< ::cvflann::ChiSquareDistance<float> >(this, index, data, fout);
+            break;
+        case FLANN_DIST_KL:
+            saveFlatIndex< ::cvflann::KL_Divergence<float> >(this, index, data, fout);
+            break;
+#endif
+        default:
+            CV_Error(Error::StsBadArg, "Unknown/unsupported distance type");
+        }
+    }
+    catch (...)
+    {
+        fclose(fout);
+        remove(filename.c_str());
+        throw;
+    }
+    fclose(fout);
+}
+
+
+/**
+ * A file mapped into memory read-only, or read into memory where mapping is not available.
+ */
+class MappedFile : public ::cvflann::FlatBuffer
+{
+public:
+    MappedFile() : data_(NULL), size_(0)
+#if defined _WIN32
+        , mapping_(NULL)
+#endif
+    {}
+
+    ~MappedFile()
+    {
+#if defined _WIN32
+        if( data_ )
+            UnmapViewOfFile(data_);
+        if( mapping_ )
+            CloseHandle(mapping_);
+#elif defined HAVE_FLANN_MMAP
+        if( data_ )
+            munmap((void*)data_, size_);
+#endif
+    }
+
+    bool open(const String& filename)
+    {
+#if defined _WIN32
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if( file == INVALID_HANDLE_VALUE )
+            return false;
+        LARGE_INTEGER fsize;
+        bool ok = GetFileSizeEx(file, &fsize) && (uint64)fsize.QuadPart <= (uint64)SIZE_MAX;
+        if( ok && fsize.QuadPart > 0 )
+        {
+            mapping_ = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            data_ = mapping_ ? (const uchar*)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : NULL;
+            size_ = (size_t)fsize.QuadPart;
+            ok = data_ != NULL;
+        }
+        CloseHandle(file);
+        return ok;
+#elif defined HAVE_FLANN_MMAP
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if( fd < 0 )
+            return false;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0 && (uint64)st.st_size <= (uint64)SIZE_MAX;
+        if( ok && st.st_size > 0 )
+        {
+            void* ptr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            ok = ptr != MAP_FAILED;
+            if( ok )
+            {
+                data_ = (const uchar*)ptr;
+                size_ = (size_t)st.st_size;
+            }
+        }
+        close(fd);
+        return ok;
+#else
+        FILE* fin = fopen(filename.c_str(), "rb");
+        if( !fin )
+            return false;
+        uchar chunk[1 << 16];
+        size_t n;
+        while( (n = fread(chunk, 1, sizeof(chunk), fin)) > 0 )
+            buf_.insert(buf_.end(), chunk, chunk + n);
+        fclose(fin);
+        data_ = buf_.empty() ? NULL : &buf_[0];
+        size_ = buf_.size();
+        return true;
+#endif
+    }
+
+    const uchar* data() const CV_OVERRIDE { return data_; }
+    size_t size() const CV_OVERRIDE { return size_; }
+
+private:
+    const uchar* data_;
+    size_t size_;
+#if defined _WIN32
+    HANDLE mapping_;
+#elif !defined HAVE_FLANN_MMAP
+    std::vector<uchar> buf_;
+#endif
+};
+
+template<typename Distance>
+void attachIndex(Index* index0, void*& index, const Ptr< ::cvflann::FlatBuffer>& buffer,
+                 const ::cvflann::FlatIndexHeader& header, const Distance& dist=Distance())
+{
+    typedef typename Distance::ElementType ElementType;
+    ::cvflann::Matrix<ElementType> dataset = ::cvflann::get_flat_dataset<ElementType>(*buffer, header);
+
+    ::cvflann::IndexParams params;
+    params["algorithm"] = index0->getAlgorithm();
+    ::cvflann::Index<Distance>* _index = new ::cvflann::Index<Distance>(dataset, params, dist);
+    try
+    {
+        _index->attachFlatIndex(buffer, header);
+    }
+    catch (...)
+    {
+        delete _index;
+        throw;
+    }
+    index = _index;
+}
+
+bool Index::loadMapped(const String& filename)
+{
+    CV_INSTRUMENT_REGION();
+
+    release();
+    Ptr<MappedFile> buffer = makePtr<MappedFile>();
+    if( !buffer->open(filename) )
+        return false;
+
+    ::cvflann::FlatIndexHeader header = ::cvflann::load_flat_header(*buffer);
+    algo = (flann_algorithm_t)header.index_type;
+    featureType = getFeatureType(header.data_type);
+    distType = (flann_distance_t)header.distance_type;
+
+    if( !((distType == FLANN_DIST_HAMMING && featureType == CV_8U) ||
+          (distType == FLANN_DIST_DNAMMING && featureType == CV_8U) ||
+          (distType != FLANN_DIST_HAMMING && featureType == CV_32F)) )
+    {
+        fprintf(stderr, "Reading FLANN index error: unsupported feature type %d for the index type %d\n", featureType, algo);
+        return false;
+    }
+
+    switch( distType )
+    {
+    case FLANN_DIST_HAMMING:
+        attachIndex< HammingDistance >(this, index, buffer, header);
+        break;
+    case FLANN_DIST_L2:
+        attachIndex< ::cvflann::L2<float> >(this, index, buffer, header);
+        break;
+    case FLANN_DIST_L1:
+        attachIndex< ::cvflann::L1<float> >(this, index, buffer, header);
+        break;
+    case FLANN_DIST_INNER_PRODUCT:
+        attachIndex< ::cvflann::InnerProductDistance<float> >(this, index, buffer, header);
+        break;
+#if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
+    case FLANN_DIST_DNAMMING:
+        attachIndex< DNAmmingDistance >(this, index, buffer, header);
+        break;
+    case FLANN_DIST_MAX:
+        attachIndex< ::cvflann::MaxDistance<float> >(this, index, buffer, header);
+        break;
+    case FLANN_DIST_HIST_INTERSECT:
+        attachIndex< ::cvflann::HistIntersectionDistance<float> >(this, index, buffer, header);
+        break;
+    case FLANN_DIST_HELLINGER:
+        attachIndex< ::cvflann::HellingerDistance<float> >(this, index, buffer, header);
+        break;
+    case FLANN_DIST_CHI_SQUARE:
+        attachIndex< ::cvflann::ChiSquareDistance<float> >(this, index, buffer, header);
+        break;
+    case FLANN_DIST_KL:
+        attachIndex< ::cvflann::KL_Divergence<float> >(this, index, buffer, header);
+        break;
+#endif
+    default:
+        fprintf(stderr, "Reading FLANN index error: unsupported distance type %d\n", distType);
+        return false;
+    }
+    return true;
+}
+
 }
 
 }
@@ -0,0 +1,346 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+typedef testing::TestWithParam<int> Flann_Index;
+
+static Ptr<flann::IndexParams> createIndexParams(int algorithm)
+{
+    switch (algorithm)
+    {
+    case cvflann::FLANN_INDEX_KDTREE: return makePtr<flann::KDTreeIndexParams>(4);
+    case cvflann::FLANN_INDEX_KMEANS: return makePtr<flann::KMeansIndexParams>(8, 5);
+    case cvflann::FLANN_INDEX_HIERARCHICAL: return makePtr<flann::HierarchicalClusteringIndexParams>(8);
+    case cvflann::FLANN_INDEX_LSH: return makePtr<flann::LshIndexParams>(6, 12, 1);
+    case cvflann::FLANN_INDEX_IVFPQ: return makePtr<flann::IVFPQIndexParams>(32, 4, 5, 2000);
+    case cvflann::FLANN_INDEX_HNSW: return makePtr<flann::HNSWIndexParams>(8, 64);
+    default: CV_Error(Error::StsBadArg, "unknown algorithm");
+    }
+}
+
+// the index is built and searched in parallel, the results must not depend on the number of threads
+TEST_P(Flann_Index, parallel_matches_serial)
+{
+    const int algorithm = GetParam();
+    const bool binary = algorithm == cvflann::FLANN_INDEX_LSH || algorithm == cvflann::FLANN_INDEX_HIERARCHICAL;
+    const cvflann::flann_distance_t distType = binary ? cvflann::FLANN_DIST_HAMMING : cvflann::FLANN_DIST_L2;
+    const int knn = 5;
+
+    // large enough for the clusters of the root to be split in parallel
+    RNG& rng = theRNG();
+    Mat data(6000, binary ? 32 : 16, binary ? CV_8U : CV_32F), query(300, data.cols, data.type());
+    rng.fill(data, RNG::UNIFORM, 0, binary ? 256 : 100);
+    rng.fill(query, RNG::UNIFORM, 0, binary ? 256 : 100);
+    Ptr<flann::IndexParams> params = createIndexParams(algorithm);
+
+    const int nthreads = getNumThreads();
+    Mat indices[2], dists[2];
+    for (int i = 0; i < 2; i++)
+    {
+        setNumThreads(i == 0 ? 1 : 4);
+        theRNG() = RNG(12345);
+        flann::Index index(data, *params, distType);
+        index.knnSearch(query, indices[i], dists[i], knn, flann::SearchParams(64));
+    }
+    EXPECT_EQ(0, cvtest::norm(indices[0], indices[1], NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(dists[0], dists[1], NORM_INF));
+
+    // the batched search gives the same results as the queries searched one by one
+    theRNG() = RNG(12345);
+    flann::Index index(data, *params, distType);
+    for (int i = 0; i < query.rows; i += 37)
+    {
+        Mat qindices, qdists;
+        index.knnSearch(query.row(i), qindices, qdists, knn, flann::SearchParams(64));
+        EXPECT_EQ(0, cvtest::norm(indices[1].row(i), qindices, NORM_INF)) << "query " << i;
+        EXPECT_EQ(0, cvtest::norm(dists[1].row(i), qdists, NORM_INF)) << "query " << i;
+    }
+    setNumThreads(nthreads);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Flann_Index, testing::Values(
+    (int)cvflann::FLANN_INDEX_KDTREE, (int)cvflann::FLANN_INDEX_KMEANS,
+    (int)cvflann::FLANN_INDEX_HIERARCHICAL, (int)cvflann::FLANN_INDEX_LSH, (int)cvflann::FLANN_INDEX_IVFPQ,
+    (int)cvflann::FLANN_INDEX_HNSW));
+
+// most nearest neighbours are found from the encoded vectors, the saved index gives the same results
+TEST(Flann_IVFPQIndex, recall_and_save)
+{
+    RNG& rng = theRNG();
+    const int clusters = 20, dims = 32, knn = 10;
+    Mat centers(clusters, dims, CV_32F), data(8000, dims, CV_32F), query(200, dims, CV_32F);
+    rng.fill(centers, RNG::UNIFORM, 0, 100);
+    for (int i = 0; i < data.rows + query.rows; i++)
+    {
+        Mat row = i < data.rows ? data.row(i) : query.row(i - data.rows);
+        rng.fill(row, RNG::NORMAL, 0, 5);
+        row += centers.row(rng.uniform(0, clusters));
+    }
+
+    flann::Index exact(data, flann::LinearIndexParams(), cvflann::FLANN_DIST_L2);
+    Mat gtIndices, gtDists;
+    exact.knnSearch(query, gtIndices, gtDists, 1);
+
+    flann::Index index(data, flann::IVFPQIndexParams(64, 8, 10, 4000), cvflann::FLANN_DIST_L2);
+    const String filename = cv::tempfile(".flann");
+    index.save(filename);
+    Mat indices[2], dists[2];
+    for (int i = 0; i < 2; i++)
+    {
+        flann::Index loaded;
+        if (i == 1)
+        {
+            ASSERT_TRUE(loaded.load(data, filename));
+        }
+        (i == 0 ? index : loaded).knnSearch(query, indices[i], dists[i], knn, flann::SearchParams(1000));
+    }
+    remove(filename.c_str());
+    EXPECT_EQ(0, cvtest::norm(indices[0], indices[1], NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(dists[0], dists[1], NORM_INF));
+
+    int found = 0;
+    for (int i = 0; i < query.rows; i++)
+    {
+        const int* row = indices[0].ptr<int>(i);
+        found += std::find(row, row + knn, gtIndices.at<int>(i)) != row + knn;
+    }
+    EXPECT_GE(found, query.rows * 9 / 10);
+
+    // the dataset is not used any more
+    data.release();
+    Mat again, againDists;
+    index.knnSearch(query, again, againDists, knn, flann::SearchParams(1000));
+    EXPECT_EQ(0, cvtest::norm(indices[0], again, NORM_INF));
+
+}
+
+// 8 bytes of code and 4 bytes of index instead of 128 bytes per vector, besides the centroids
+TEST(Flann_IVFPQIndex, memory)
+{
+    Mat data(20000, 32, CV_32F);
+    theRNG().fill(data, RNG::UNIFORM, 0, 100);
+    cvflann::Index<cvflann::L2<float> > index(cvflann::Matrix<float>(data.ptr<float>(), data.rows, data.cols),
+                                               cvflann::IVFPQIndexParams(16, 8, 5, 2000));
+    index.buildIndex();
+    EXPECT_LT(index.usedMemory(), (int)(data.total() * sizeof(float) / 8));
+}
+
+// the flat layout is mapped and searched in place with the results of the index it was saved from
+TEST(Flann_FlatIndex, saveFlat_loadMapped)
+{
+    RNG& rng = theRNG();
+    Mat data(3000, 16, CV_32F), query(100, data.cols, data.type());
+    rng.fill(data, RNG::UNIFORM, 0, 100);
+    rng.fill(query, RNG::UNIFORM, 0, 100);
+    const int knn = 5;
+
+    const int algorithms[] = { cvflann::FLANN_INDEX_LINEAR, cvflann::FLANN_INDEX_KDTREE };
+    for (size_t a = 0; a < sizeof(algorithms)/sizeof(algorithms[0]); a++)
+    {
+        SCOPED_TRACE(algorithms[a]);
+        Ptr<flann::IndexParams> params = algorithms[a] == cvflann::FLANN_INDEX_LINEAR ?
+            Ptr<flann::IndexParams>(makePtr<flann::LinearIndexParams>()) : createIndexParams(algorithms[a]);
+        Mat features = data.clone();
+        flann::Index index(features, *params, cvflann::FLANN_DIST_L2);
+        Mat indices, dists;
+        index.knnSearch(query, indices, dists, knn, flann::SearchParams(64));
+
+        const String flatName = cv::tempfile(".flann"), savedName = cv::tempfile(".flann");
+        index.saveFlat(features, flatName);
+        index.save(savedName);
+        index.release();
+
+        // the mapped index does not need the features any more
+        features.release();
+        flann::Index mapped;
+        ASSERT_TRUE(mapped.loadMapped(flatName));
+        EXPECT_EQ(algorithms[a], mapped.getAlgorithm());
+        EXPECT_EQ(cvflann::FLANN_DIST_L2, mapped.getDistance());
+        Mat mindices, mdists;
+        mapped.knnSearch(query, mindices, mdists, knn, flann::SearchParams(64));
+        EXPECT_EQ(0, cvtest::norm(indices, mindices, NORM_INF));
+        EXPECT_EQ(0, cvtest::norm(dists, mdists, NORM_INF));
+
+        // the original format still loads the same trees
+        flann::Index loaded;
+        ASSERT_TRUE(loaded.load(data, savedName));
+        Mat lindices, ldists;
+        loaded.knnSearch(query, lindices, ldists, knn, flann::SearchParams(64));
+        EXPECT_EQ(0, cvtest::norm(indices, lindices, NORM_INF));
+        EXPECT_EQ(0, cvtest::norm(dists, ldists, NORM_INF));
+
+        mapped.release();
+        loaded.release();
+        EXPECT_EQ(0, remove(flatName.c_str()));
+        EXPECT_EQ(0, remove(savedName.c_str()));
+    }
+}
+
+TEST(Flann_FlatIndex, unsupported_and_truncated)
+{
+    Mat data(500, 8, CV_32F);
+    theRNG().fill(data, RNG::UNIFORM, 0, 100);
+    flann::Index index(data, *createIndexParams(cvflann::FLANN_INDEX_KMEANS), cvflann::FLANN_DIST_L2);
+    const String flatName = cv::tempfile(".flann");
+    EXPECT_ANY_THROW(index.saveFlat(data, flatName));
+    EXPECT_ANY_THROW(index.saveFlat(data.rowRange(0, 100), flatName));
+
+    // a truncated file is rejected
+    flann::Index kdtree(data, *createIndexParams(cvflann::FLANN_INDEX_KDTREE), cvflann::FLANN_DIST_L2);
+    kdtree.saveFlat(data, flatName);
+    FILE* f = fopen(flatName.c_str(), "r+b");
+    ASSERT_TRUE(f != NULL);
+    ASSERT_EQ(0, fseek(f, 0, SEEK_END));
+    const long size = ftell(f);
+    fclose(f);
+    std::vector<char> buf(size / 2);
+    f = fopen(flatName.c_str(), "rb");
+    ASSERT_EQ(buf.size(), fread(&buf[0], 1, buf.size(), f));
+    fclose(f);
+    f = fopen(flatName.c_str(), "wb");
+    ASSERT_EQ(buf.size(), fwrite(&buf[0], 1, buf.size(), f));
+    fclose(f);
+    flann::Index mapped;
+    EXPECT_ANY_THROW(mapped.loadMapped(flatName));
+    remove(flatName.c_str());
+}
+
+TEST(Flann_FlatIndex, corrupted_kdtree_nodes)
+{
+    Mat data(500, 8, CV_32F);
+    theRNG().fill(data, RNG::UNIFORM, 0, 100);
+    flann::Index kdtree(data, *createIndexParams(cvflann::FLANN_INDEX_KDTREE), cvflann::FLANN_DIST_L2);
+    const String flatName = cv::tempfile(".flann");
+    kdtree.saveFlat(data, flatName);
+
+    // the nodes end the file, the last one is a leaf that gets an offset out of the tree
+    FILE* f = fopen(flatName.c_str(), "r+b");
+    ASSERT_TRUE(f != NULL);
+    ASSERT_EQ(0, fseek(f, -(long)sizeof(int), SEEK_END));
+    const int child2 = 1 << 20;
+    ASSERT_EQ(1u, fwrite(&child2, sizeof(child2), 1, f));
+    fclose(f);
+    flann::Index mapped;
+    EXPECT_ANY_THROW(mapped.loadMapped(flatName));
+    remove(flatName.c_str());
+}
+
+static int countFound(const Mat& gtIndices, const Mat& indices)
+{
+    int found = 0;
+    for (int i = 0; i < gtIndices.rows; i++)
+    {
+        const int* row = indices.ptr<int>(i);
+        for (int j = 0; j < gtIndices.cols; j++)
+            found += std::find(row, row + indices.cols, gtIndices.at<int>(i, j)) != row + indices.cols;
+    }
+    return found;
+}
+
+// the points added to the graph are found as well, the saved and the mapped graphs give the same results
+TEST(Flann_HNSWIndex, addPoints_save_loadMapped)
+{
+    RNG& rng = theRNG();
+    const int knn = 5;
+    Mat data(5000, 32, CV_32F), query(200, data.cols, data.type());
+    rng.fill(data, RNG::UNIFORM, 0, 100);
+    rng.fill(query, RNG::UNIFORM, 0, 100);
+
+    flann::Index exact(data, flann::LinearIndexParams(), cvflann::FLANN_DIST_L2);
+    Mat gtIndices, gtDists;
+    exact.knnSearch(query, gtIndices, gtDists, knn);
+
+    flann::Index index(data.rowRange(0, 4000), flann::HNSWIndexParams(16, 100), cvflann::FLANN_DIST_L2);
+    index.addPoints(data.rowRange(4000, data.rows));
+    Mat indices, dists;
+    index.knnSearch(query, indices, dists, knn, flann::SearchParams(64));
+    EXPECT_GE(countFound(gtIndices, indices), (int)gtIndices.total() * 9 / 10);
+    EXPECT_GT(countNonZero(indices >= 4000), 0);
+
+    const String flatName = cv::tempfile(".flann"), savedName = cv::tempfile(".flann");
+    index.saveFlat(data, flatName);
+    index.save(savedName);
+    for (int i = 0; i < 2; i++)
+    {
+        flann::Index loaded;
+        if (i == 0)
+        {
+            ASSERT_TRUE(loaded.loadMapped(flatName));
+        }
+        else
+        {
+            ASSERT_TRUE(loaded.load(data, savedName));
+        }
+        Mat lindices, ldists;
+        loaded.knnSearch(query, lindices, ldists, knn, flann::SearchParams(64));
+        EXPECT_EQ(0, cvtest::norm(indices, lindices, NORM_INF)) << i;
+        EXPECT_EQ(0, cvtest::norm(dists, ldists, NORM_INF)) << i;
+    }
+    remove(flatName.c_str());
+    remove(savedName.c_str());
+}
+
+TEST(Flann_HNSWIndex, inner_product)
+{
+    RNG& rng = theRNG();
+    const int knn = 5;
+    Mat data(3000, 64, CV_32F), query(100, data.cols, data.type());
+    rng.fill(data, RNG::NORMAL, 0, 1);
+    rng.fill(query, RNG::NORMAL, 0, 1);
+    for (int i = 0; i < data.rows; i++)
+        normalize(data.row(i), data.row(i));
+    for (int i = 0; i < query.rows; i++)
+        normalize(query.row(i), query.row(i));
+
+    flann::Index exact(data, flann::LinearIndexParams(), cvflann::FLANN_DIST_INNER_PRODUCT);
+    Mat gtIndices, gtDists;
+    exact.knnSearch(query, gtIndices, gtDists, knn);
+    Mat products = query * data.t();
+    for (int i = 0; i < query.rows; i++)
+        EXPECT_NEAR(1 - products.at<float>(i, gtIndices.at<int>(i, 0)), gtDists.at<float>(i, 0), 1e-5);
+
+    flann::Index index(data, flann::HNSWIndexParams(16, 100), cvflann::FLANN_DIST_INNER_PRODUCT);
+    Mat indices, dists;
+    index.knnSearch(query, indices, dists, knn, flann::SearchParams(64));
+    EXPECT_GE(countFound(gtIndices, indices), (int)gtIndices.total() * 9 / 10);
+
+    // the clustering indices need a metric
+    EXPECT_ANY_THROW(flann::Index(data, flann::KMeansIndexParams(), cvflann::FLANN_DIST_INNER_PRODUCT));
+    EXPECT_ANY_THROW(flann::Index(data, flann::HierarchicalClusteringIndexParams(), cvflann::FLANN_DIST_INNER_PRODUCT));
+}
+
+TEST(Flann_HNSWIndex, binary_descriptors)
+{
+    // clusters of descriptors, every query is a descriptor with two flipped bits
+    RNG& rng = theRNG();
+    Mat centers(50, 32, CV_8U), data(2000, centers.cols, CV_8U), query(100, data.cols, data.type());
+    rng.fill(centers, RNG::UNIFORM, 0, 256);
+    for (int i = 0; i < data.rows; i++)
+    {
+        centers.row(i % centers.rows).copyTo(data.row(i));
+        for (int k = 0; k < 8; k++)
+            data.at<uchar>(i, rng.uniform(0, data.cols)) ^= (uchar)(1 << rng.uniform(0, 8));
+    }
+    Mat gtIndices(query.rows, 1, CV_32S);
+    for (int i = 0; i < query.rows; i++)
+    {
+        gtIndices.at<int>(i) = rng.uniform(0, data.rows);
+        data.row(gtIndices.at<int>(i)).copyTo(query.row(i));
+        query.at<uchar>(i, 0) ^= 1;
+        query.at<uchar>(i, 1) ^= 2;
+    }
+
+    flann::Index index(data, flann::HNSWIndexParams(16, 100), cvflann::FLANN_DIST_HAMMING);
+    Mat indices, dists;
+    index.knnSearch(query, indices, dists, 1, flann::SearchParams(64));
+    EXPECT_GE(countFound(gtIndices, indices), query.rows * 9 / 10);
+
+    // the distance of 8-bit vectors is not guessed
+    EXPECT_ANY_THROW(flann::Index(data, flann::HNSWIndexParams(16, 100), cvflann::FLANN_DIST_L2));
+}
+
+}} // namespace
@@ -2415,6 +2415,83 @@ CV_EXPORTS_W void convertMaps( InputArray map1, InputArray map2,
                                OutputArray dstmap1, OutputArray dstmap2,
                                int dstmap1type, bool nninterpolation = false );
 
+/** @brief Precomputed geometric transformation that is applied repeatedly to images of the same size.
+
+The plan is built once from the transformation matrix or from the maps, and keeps the fixed-point maps
+(CV_16SC2 coordinates and CV_16UC1 interpolation table indices, see #convertMaps) together with the
+schedule of destination tiles. Applying the plan does not compute or convert any coordinates, the tiles
+are processed in parallel, and with #BORDER_CONSTANT the tiles that map entirely outside of the source
+image are just filled with the border value. The result is the same as the one of #remap,
+#warpAffine or #warpPerspective called with the same parameters.
+
+@sa createRemapPlan, createWarpAffinePlan, createWarpPerspectivePlan
+ */
+class CV_EXPORTS_W WarpPlan : public Algorithm
+{
+public:
+    /** @brief Applies the transformation to the image.
+
+    @param src Source image, its size must be equal to the size the plan was built for.
+    @param dst Destination image of the plan destination size and the same type as src.
+     */
+    CV_WRAP virtual void warp(InputArray src, OutputArray dst) const = 0;
+
+    //! Returns the size of the source images the plan was built for.
+    CV_WRAP virtual Size getSrcSize() const = 0;
+
+    //! Returns the size of the destination images.
+    CV_WRAP virtual Size getDstSize() const = 0;
+
+    /** @brief Returns the fixed-point maps of the plan.
+
+    @param map1 CV_16SC2 integer source coordinates.
+    @param map2 CV_16UC1 interpolation table indices, empty for #INTER_NEAREST.
+     */
+    CV_WRAP virtual void getMaps(OutputArray map1, OutputArray map2) const = 0;
+};
+
+/** @brief Creates a plan that applies the generic geometrical transformation of #remap.
+
+@param map1 The first map, see #remap. Floating-point maps are converted to the fixed-point
+representation once, when the plan is built.
+@param map2 The second map, see #remap.
+@param srcSize Size of the source images.
+@param interpolation Interpolation method (see #InterpolationFlags).
+@param borderMode Pixel extrapolation method (see #BorderTypes).
+@param borderValue Value used in case of a constant border.
+ */
+CV_EXPORTS_W Ptr<WarpPlan> createRemapPlan( InputArray map1, InputArray map2, Size srcSize,
+                                            int interpolation, int borderMode = BORDER_CONSTANT,
+                                            const Scalar& borderValue = Scalar());
+
+/** @brief Creates a plan that applies the affine transformation of #warpAffine.
+
+@param M \f$2\times 3\f$ transformation matrix.
+@param srcSize Size of the source images.
+@param dsize Size of the destination images, the source size is used when it is empty.
+@param flags Combination of interpolation methods (see #InterpolationFlags) and the optional
+flag #WARP_INVERSE_MAP.
+@param borderMode Pixel extrapolation method (see #BorderTypes).
+@param borderValue Value used in case of a constant border.
+ */
+CV_EXPORTS_W Ptr<WarpPlan> createWarpAffinePlan( InputArray M, Size srcSize, Size dsize = Size(),
+                                                 int flags = INTER_LINEAR, int borderMode = BORDER_CONSTANT,
+                                                 const Scalar& borderValue = Scalar());
+
+/** @brief Creates a plan that applies the perspective transformation of #warpPerspective.
+
+@param M \f$3\times 3\f$ transformation matrix.
+@param srcSize Size of the source images.
+@param dsize Size of the destination images, the source size is used when it is empty.
+@param flags Combination of interpolation methods (see #InterpolationFlags) and the optional
+flag #WARP_INVERSE_MAP.
+@param borderMode Pixel extrapolation method (see #BorderTypes).
+@param borderValue Value used in case of a constant border.
+ */
+CV_EXPORTS_W Ptr<WarpPlan> createWarpPerspectivePlan( InputArray M, Size srcSize, Size dsize = Size(),
+                                                      int flags = INTER_LINEAR, int borderMode = BORDER_CONSTANT,
+                                                      const Scalar& borderValue = Scalar());
+
 /** @brief Calculates an affine matrix of 2D rotation.
 
 The function calculates the following matrix:
@@ -3017,6 +3094,141 @@ same as src. dst[1] is the next pyramid layer, a smoothed and down-sized src, an
 CV_EXPORTS void buildPyramid( InputArray src, OutputArrayOfArrays dst,
                               int maxlevel, int borderType = BORDER_DEFAULT );
 
+/** @brief Builds Gaussian and Laplacian pyramids, reusing its level buffers from call to call.
+
+All the levels of a Gaussian pyramid are produced in a single pass over the source image: each
+horizontal stripe of the first level is carried down to the deeper levels while it is still in
+cache, and the stripes are processed in parallel. The result is identical to buildPyramid.
+
+The Laplacian pyramid is computed as \f$L_i = G_i - \texttt{pyrUp}(G_{i+1})\f$ for
+\f$i < \texttt{maxlevel}\f$, and its last level is \f$G_{\texttt{maxlevel}}\f$. The intermediate
+Gaussian and upsampled levels are kept inside the object, so when the same builder is used for a
+sequence of frames of the same size no memory is reallocated.
+ */
+class CV_EXPORTS_W PyramidBuilder : public Algorithm
+{
+public:
+    /** @brief Constructs the Gaussian pyramid of an image, see buildPyramid.
+
+    @param src Source image. Check pyrDown for the list of supported types.
+    @param dst Destination vector of maxlevel+1 images of the same type as src. dst[0] will be the
+    same as src. The vector may be passed again with the next frame to reuse its buffers.
+     */
+    CV_WRAP virtual void buildGaussian(InputArray src, OutputArrayOfArrays dst) = 0;
+
+    /** @brief Constructs the Laplacian pyramid of an image.
+
+    @param src Source image. Check pyrDown for the list of supported types.
+    @param dst Destination vector of maxlevel+1 images.
+    @param ddepth Depth of the destination images. When it is negative, CV_16S is used for 8-bit
+    sources, the source depth is used for floating-point ones and CV_32F is used otherwise.
+     */
+    CV_WRAP virtual void buildLaplacian(InputArray src, OutputArrayOfArrays dst, int ddepth = -1) = 0;
+
+    /** @brief Sets 0-based index of the last (the smallest) pyramid layer. */
+    CV_WRAP virtual void setMaxLevel(int maxlevel) = 0;
+    CV_WRAP virtual int getMaxLevel() const = 0;
+
+    /** @brief Sets the pixel extrapolation method used by the Gaussian levels (#BORDER_CONSTANT isn't supported). */
+    CV_WRAP virtual void setBorderType(int borderType) = 0;
+    CV_WRAP virtual int getBorderType() const = 0;
+
+    /** @brief Releases the internal level buffers. */
+    CV_WRAP virtual void collectGarbage() = 0;
+};
+
+/** @brief Creates a smart pointer to a cv::PyramidBuilder class and initializes it.
+
+@param maxlevel 0-based index of the last (the smallest) pyramid layer. It must be non-negative.
+@param borderType Pixel extrapolation method, see #BorderTypes (#BORDER_CONSTANT isn't supported)
+ */
+CV_EXPORTS_W Ptr<PyramidBuilder> createPyramidBuilder(int maxlevel = 3, int borderType = BORDER_DEFAULT);
+
+/** @brief Applies a chain of local operations to an image that is processed tile by tile.
+
+The image is never held in memory as a whole. The source pixels of every tile, extended by the
+total halo of the chain and clipped to the image, are requested from a reader callback; the
+operations run on that region as on a standalone image, and the tile is handed to a writer
+callback. Every operation can only spoil a margin as wide as its own halo, while at the image
+boundary the regions end exactly where the image does, so the result is the same as running the
+chain on the whole image (floating-point filters may differ in the last bits, as their vectorized
+and scalar code paths round differently). The tiles are processed in parallel, so the peak memory is about the
+number of worker threads times the size of a tile region, whatever the size of the image.
+
+The reader and the writer calls are serialized, and the tiles are written in arbitrary order.
+#BORDER_WRAP is not supported by the predefined operations.
+ */
+class CV_EXPORTS TiledExecutor : public Algorithm
+{
+public:
+    /** Fills `tile` with the source pixels of `roi`, given in the image coordinates. */
+    typedef std::function<void(const Rect& roi, OutputArray tile)> TileReader;
+    /** Receives the result for `roi`, given in the image coordinates. */
+    typedef std::function<void(const Rect& roi, InputArray tile)> TileWriter;
+    /** A local operation. It must produce an output of the same size as the input. */
+    typedef std::function<void(InputArray src, OutputArray dst)> TileOperation;
+
+    /** @brief Appends an operation to the chain.
+
+    @param op The operation.
+    @param halo The distance, in each direction, from which the input pixels affect an output pixel.
+     */
+    virtual void add(const TileOperation& op, Size halo) = 0;
+
+    /** @brief Appends filter2D with the given parameters, see cv::filter2D. */
+    virtual void addFilter2D(int ddepth, InputArray kernel, Point anchor = Point(-1,-1),
+                             double delta = 0, int borderType = BORDER_DEFAULT) = 0;
+
+    /** @brief Appends GaussianBlur with the given parameters, see cv::GaussianBlur. */
+    virtual void addGaussianBlur(Size ksize, double sigmaX, double sigmaY = 0,
+                                 int borderType = BORDER_DEFAULT) = 0;
+
+    /** @brief Appends morphologyEx with the given parameters, see cv::morphologyEx. */
+    virtual void addMorphologyEx(int op, InputArray kernel, Point anchor = Point(-1,-1), int iterations = 1,
+                                 int borderType = BORDER_CONSTANT,
+                                 const Scalar& borderValue = morphologyDefaultBorderValue()) = 0;
+
+    /** @brief Appends threshold with the given parameters, see cv::threshold.
+
+    #THRESH_OTSU and #THRESH_TRIANGLE need the whole image and are not supported.
+     */
+    virtual void addThreshold(double thresh, double maxval, int type) = 0;
+
+    /** @brief Appends cvtColor with the given parameters, see cv::cvtColor.
+
+    Bayer demosaicing and the conversions from and to the subsampled YUV formats are not supported.
+     */
+    virtual void addCvtColor(int code, int dstCn = 0) = 0;
+
+    /** @brief Removes all the operations. */
+    virtual void clear() CV_OVERRIDE = 0;
+
+    virtual int getOperationsCount() const = 0;
+
+    /** @brief Returns the total halo of the chain, the margin read around every tile. */
+    virtual Size getHalo() const = 0;
+
+    virtual void setTileSize(Size tileSize) = 0;
+    virtual Size getTileSize() const = 0;
+
+    /** @brief Processes an image of the given size.
+
+    @param imageSize Size of the source image.
+    @param reader Callback that provides the source regions.
+    @param writer Callback that consumes the result tiles.
+     */
+    virtual void run(Size imageSize, const TileReader& reader, const TileWriter& writer) = 0;
+
+    /** @brief Processes an image held in memory, mostly useful for testing the chain. */
+    virtual void apply(InputArray src, OutputArray dst) = 0;
+};
+
+/** @brief Creates a smart pointer to a cv::TiledExecutor class and initializes it.
+
+@param tileSize Size of the output tiles.
+ */
+CV_EXPORTS Ptr<TiledExecutor> createTiledExecutor(Size tileSize = Size(512, 512));
+
 //! @} imgproc_filter
 
 //! @addtogroup imgproc_hist
@@ -3735,6 +3947,67 @@ is \f$W \times H\f$ and templ is \f$w \times h\f$ , then result is \f$(W-w+1) \t
 CV_EXPORTS_W void matchTemplate( InputArray image, InputArray templ,
                                  OutputArray result, int method, InputArray mask = noArray() );
 
+/** @brief Compares a set of templates against images, reusing the template spectra between calls.
+
+The class computes the same result as #matchTemplate without a mask. The DFT of every template is computed
+once and is reused while the size and type of the matched images stay the same, which is the typical case
+when the same template library is matched against every frame of a video stream. When several templates are
+matched against one image, the DFT of each image block is computed once and shared by all the templates,
+so the templates of similar sizes benefit the most.
+
+@sa matchTemplate, createTemplateMatcher
+ */
+class CV_EXPORTS_W TemplateMatcher : public Algorithm
+{
+public:
+    /** @brief Adds a template to the set.
+
+    @param templ Template of type CV_8U or CV_32F. All the templates must have the same type, and the
+    matched images must have the same type as the templates.
+    @return Index of the template in the set.
+     */
+    CV_WRAP virtual int add(InputArray templ) = 0;
+
+    //! Removes all the templates and the cached spectra.
+    CV_WRAP virtual void clear() CV_OVERRIDE = 0;
+
+    //! Returns the number of templates in the set.
+    CV_WRAP virtual int getTemplatesCount() const = 0;
+
+    /** @brief Sets the comparison method, see #TemplateMatchModes.
+
+    @param method Comparison method.
+    */
+    CV_WRAP virtual void setMethod(int method) = 0;
+
+    //! Returns the comparison method, see #TemplateMatchModes.
+    CV_WRAP virtual int getMethod() const = 0;
+
+    /** @brief Compares a single template of the set against the image.
+
+    @param image Image where the search is running. It must not be smaller than any template in the set.
+    @param result Map of comparison results, see #matchTemplate.
+    @param templIdx Index of the template returned by add.
+     */
+    CV_WRAP virtual void match(InputArray image, OutputArray result, int templIdx = 0) = 0;
+
+    /** @brief Compares all the templates of the set against the image.
+
+    @param image Image where the search is running. It must not be smaller than any template in the set.
+    @param results Vector of comparison result maps, one per template, in the order the templates were added.
+     */
+    CV_WRAP virtual void matchAll(InputArray image, OutputArrayOfArrays results) = 0;
+
+    //! Releases the cached template spectra.
+    CV_WRAP virtual void collectGarbage() = 0;
+};
+
+/** @brief Creates a smart pointer to a cv::TemplateMatcher class and initializes it.
+
+@param method Parameter specifying the comparison method, see #TemplateMatchModes.
+ */
+CV_EXPORTS_W Ptr<TemplateMatcher> createTemplateMatcher(int method = TM_CCOEFF_NORMED);
+
 //! @}
 
 //! @addtogroup imgproc_shape
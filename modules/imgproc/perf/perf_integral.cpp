@@ -136,4 +136,26 @@ PERF_TEST_P( Size_MatType_OutMatDepth, integral_sqsum_tilted,
     SANITY_CHECK(tilted, 1e-6, tilted.depth() > CV_32S ? ERROR_RELATIVE : ERROR_ABSOLUTE);
 }
 
+PERF_TEST_P(Size_MatType_OutMatDepth, integral_large,
+            testing::Combine(
+                testing::Values(sz2160p, sz4320p),
+                testing::Values(CV_8UC1, CV_8UC3),
+                testing::Values(CV_32S, CV_64F)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+    int sdepth = get<2>(GetParam());
+
+    Mat src(sz, matType);
+    Mat sum, sqsum;
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() integral(src, sum, sqsum, sdepth, CV_64F);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -81,4 +81,40 @@ PERF_TEST_P(ImgSize_TmplSize_Method, matchTemplateBig,
     SANITY_CHECK(result, eps);
 }
 
+typedef tuple<Size, int, MethodType> ImgSize_TmplCount_Method_t;
+typedef perf::TestBaseWithParam<ImgSize_TmplCount_Method_t> ImgSize_TmplCount_Method;
+
+PERF_TEST_P(ImgSize_TmplCount_Method, TemplateMatcher_matchAll,
+            testing::Combine(
+                testing::Values(cv::Size(640, 480), cv::Size(1920, 1080)),
+                testing::Values(1, 8),
+                testing::Values(TM_CCORR, TM_CCOEFF_NORMED)
+                )
+    )
+{
+    Size imgSz = get<0>(GetParam());
+    int count = get<1>(GetParam());
+    int method = get<2>(GetParam());
+
+    Mat img(imgSz, CV_8UC1);
+    declare.in(img, WARMUP_RNG);
+
+    Ptr<TemplateMatcher> matcher = createTemplateMatcher(method);
+    for (int i = 0; i < count; i++)
+    {
+        Mat tmpl(Size(32, 32), CV_8UC1);
+        declare.in(tmpl, WARMUP_RNG);
+        matcher->add(tmpl);
+    }
+
+    std::vector<Mat> results;
+    matcher->matchAll(img, results);
+
+    declare.time(30);
+
+    TEST_CYCLE() matcher->matchAll(img, results);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -38,4 +38,24 @@ PERF_TEST_P(MomentsFixture_val, Moments1,
     SANITY_CHECK_MOMENTS(m, 2e-4, ERROR_RELATIVE);
 }
 
+PERF_TEST_P(MomentsFixture_val, Moments_large,
+    ::testing::Combine(
+    testing::Values(sz2160p, sz4320p),
+    testing::Values(CV_8U, CV_32F),
+    testing::Bool()))
+{
+    const MomentsParams_t params = GetParam();
+    const Size srcSize = get<0>(params);
+    const MatDepth srcDepth = get<1>(params);
+    const bool binaryImage = get<2>(params);
+
+    cv::Moments m;
+    Mat src(srcSize, srcDepth);
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() m = cv::moments(src, binaryImage);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -95,4 +95,42 @@ PERF_TEST_P(Size_MatType, buildPyramid, testing::Combine(
     SANITY_CHECK(dst4, eps, error_type);
 }
 
+PERF_TEST_P(Size_MatType, PyramidBuilder_gaussian, testing::Combine(
+                testing::Values(sz2160p, sz1080p, szVGA),
+                testing::Values(CV_8UC1, CV_8UC3, CV_32FC1)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+    Mat src(sz, matType);
+    std::vector<Mat> dst;
+    Ptr<PyramidBuilder> builder = createPyramidBuilder(5);
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() builder->buildGaussian(src, dst);
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Size_MatType, PyramidBuilder_laplacian, testing::Combine(
+                testing::Values(sz1080p, szVGA),
+                testing::Values(CV_8UC1, CV_8UC3, CV_32FC1)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+    Mat src(sz, matType);
+    std::vector<Mat> dst;
+    Ptr<PyramidBuilder> builder = createPyramidBuilder(5);
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() builder->buildLaplacian(src, dst);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -0,0 +1,28 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "perf_precomp.hpp"
+
+namespace opencv_test {
+
+typedef perf::TestBaseWithParam<Size> TiledExecutor_Size;
+
+PERF_TEST_P(TiledExecutor_Size, TiledExecutor_chain,
+            testing::Values(Size(256, 256), Size(512, 512), Size(1024, 1024)))
+{
+    Size tileSize = GetParam();
+    Mat src(sz2160p, CV_8UC3), dst;
+    Ptr<TiledExecutor> executor = createTiledExecutor(tileSize);
+    executor->addCvtColor(COLOR_BGR2GRAY);
+    executor->addGaussianBlur(Size(5, 5), 1.2);
+    executor->addMorphologyEx(MORPH_CLOSE, getStructuringElement(MORPH_ELLIPSE, Size(5, 5)));
+    executor->addThreshold(128, 255, THRESH_BINARY);
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() executor->apply(src, dst);
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
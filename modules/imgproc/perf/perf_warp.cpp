@@ -154,6 +154,41 @@ PERF_TEST_P(TestWarpPerspective, DISABLED_WarpPerspective_ovx,
 #endif
 }
 
+PERF_TEST_P( TestWarpPerspective, WarpPerspectivePlan,
+             Combine(
+                Values( szVGA, sz720p, sz1080p ),
+                InterType::all(),
+                BorderMode::all()
+             )
+)
+{
+    Size sz, szSrc(512, 512);
+    int borderMode, interType;
+    sz         = get<0>(GetParam());
+    interType  = get<1>(GetParam());
+    borderMode = get<2>(GetParam());
+    Scalar borderColor = Scalar::all(150);
+
+    Mat src(szSrc,CV_8UC4), dst(sz, CV_8UC4);
+    cvtest::fillGradient(src);
+    if(borderMode == BORDER_CONSTANT) cvtest::smoothBorder(src, borderColor, 1);
+    Mat rotMat = getRotationMatrix2D(Point2f(src.cols/2.f, src.rows/2.f), 30., 2.2);
+    Mat warpMat(3, 3, CV_64FC1);
+    for(int r=0; r<2; r++)
+        for(int c=0; c<3; c++)
+            warpMat.at<double>(r, c) = rotMat.at<double>(r, c);
+    warpMat.at<double>(2, 0) = .3/sz.width;
+    warpMat.at<double>(2, 1) = .3/sz.height;
+    warpMat.at<double>(2, 2) = 1;
+
+    Ptr<WarpPlan> plan = createWarpPerspectivePlan(warpMat, szSrc, sz, interType, borderMode, borderColor);
+    declare.in(src).out(dst);
+
+    TEST_CYCLE() plan->warp( src, dst );
+
+    SANITY_CHECK_NOTHING();
+}
+
 PERF_TEST_P( TestWarpPerspectiveNear_t, WarpPerspectiveNear,
              Combine(
                  Values( Size(640,480), Size(1920,1080), Size(2592,1944) ),
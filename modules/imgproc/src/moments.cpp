@@ -357,6 +357,95 @@ static void momentsInTile( const Mat& img, double* moments )
 
 typedef void (*MomentsInTileFunc)(const Mat& img, double* moments);
 
+// Computes the spatial moments of the rows of tiles; rowMoments[i] accumulates the tiles of the i-th row
+class MomentsInTileRows : public ParallelLoopBody
+{
+public:
+    enum { TILE_SIZE = 32 };
+
+    MomentsInTileRows(const Mat& _src, MomentsInTileFunc _func, bool _binary, std::vector<Moments>& _rowMoments) :
+        src0(_src), func(_func), binary(_binary), rowMoments(&_rowMoments[0])
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        uchar nzbuf[TILE_SIZE*TILE_SIZE];
+        Size size = src0.size();
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int y = i*TILE_SIZE;
+            Moments& m = rowMoments[i];
+            Size tileSize;
+            tileSize.height = std::min((int)TILE_SIZE, size.height - y);
+
+            for( int x = 0; x < size.width; x += TILE_SIZE )
+            {
+                tileSize.width = std::min((int)TILE_SIZE, size.width - x);
+                Mat src(src0, cv::Rect(x, y, tileSize.width, tileSize.height));
+
+                if( binary )
+                {
+                    cv::Mat tmp(tileSize, CV_8U, nzbuf);
+                    cv::compare( src, 0, tmp, CV_CMP_NE );
+                    src = tmp;
+                }
+
+                double mom[10];
+                func( src, mom );
+
+                if(binary)
+                {
+                    double s = 1./255;
+                    for( int k = 0; k < 10; k++ )
+                        mom[k] *= s;
+                }
+
+                double xm = x * mom[0], ym = y * mom[0];
+
+                // accumulate moments computed in each tile
+
+                // + m00 ( = m00' )
+                m.m00 += mom[0];
+
+                // + m10 ( = m10' + x*m00' )
+                m.m10 += mom[1] + xm;
+
+                // + m01 ( = m01' + y*m00' )
+                m.m01 += mom[2] + ym;
+
+                // + m20 ( = m20' + 2*x*m10' + x*x*m00' )
+                m.m20 += mom[3] + x * (mom[1] * 2 + xm);
+
+                // + m11 ( = m11' + x*m01' + y*m10' + x*y*m00' )
+                m.m11 += mom[4] + x * (mom[2] + ym) + y * mom[1];
+
+                // + m02 ( = m02' + 2*y*m01' + y*y*m00' )
+                m.m02 += mom[5] + y * (mom[2] * 2 + ym);
+
+                // + m30 ( = m30' + 3*x*m20' + 3*x*x*m10' + x*x*x*m00' )
+                m.m30 += mom[6] + x * (3. * mom[3] + x * (3. * mom[1] + xm));
+
+                // + m21 ( = m21' + x*(2*m11' + 2*y*m10' + x*m01' + x*y*m00') + y*m20')
+                m.m21 += mom[7] + x * (2 * (mom[4] + y * mom[1]) + x * (mom[2] + ym)) + y * mom[3];
+
+                // + m12 ( = m12' + y*(2*m11' + 2*x*m01' + y*m10' + x*y*m00') + x*m02')
+                m.m12 += mom[8] + y * (2 * (mom[4] + x * mom[2]) + y * (mom[1] + xm)) + x * mom[5];
+
+                // + m03 ( = m03' + 3*y*m02' + 3*y*y*m01' + y*y*y*m00' )
+                m.m03 += mom[9] + y * (3. * mom[5] + y * (3. * mom[2] + ym));
+            }
+        }
+    }
+
+private:
+    Mat src0;
+    MomentsInTileFunc func;
+    bool binary;
+    Moments* rowMoments;
+};
+
 Moments::Moments()
 {
     m00 = m10 = m01 = m20 = m11 = m02 = m30 = m21 = m12 = m03 =
@@ -565,9 +654,7 @@ cv::Moments cv::moments( InputArray _src, bool binary )
 {
     CV_INSTRUMENT_REGION();
 
-    const int TILE_SIZE = 32;
     MomentsInTileFunc func = 0;
-    uchar nzbuf[TILE_SIZE*TILE_SIZE];
     Moments m;
     int type = _src.type(), depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
     Size size = _src.size();
@@ -601,69 +688,19 @@ cv::Moments cv::moments( InputArray _src, bool binary )
     else
         CV_Error( CV_StsUnsupportedFormat, "" );
 
-    Mat src0(mat);
+    // the rows of tiles are processed in parallel, each one accumulates its own moments,
+    // then they are summed in a fixed order, so the result does not depend on the number of threads
+    int nrows = (size.height + MomentsInTileRows::TILE_SIZE - 1)/MomentsInTileRows::TILE_SIZE;
+    std::vector<Moments> rowMoments(nrows);
+    parallel_for_(Range(0, nrows), MomentsInTileRows(mat, func, binary, rowMoments),
+                  (double)size.area()/(1 << 16));
 
-    for( int y = 0; y < size.height; y += TILE_SIZE )
+    for( int i = 0; i < nrows; i++ )
     {
-        Size tileSize;
-        tileSize.height = std::min(TILE_SIZE, size.height - y);
-
-        for( int x = 0; x < size.width; x += TILE_SIZE )
-        {
-            tileSize.width = std::min(TILE_SIZE, size.width - x);
-            Mat src(src0, cv::Rect(x, y, tileSize.width, tileSize.height));
-
-            if( binary )
-            {
-                cv::Mat tmp(tileSize, CV_8U, nzbuf);
-                cv::compare( src, 0, tmp, CV_CMP_NE );
-                src = tmp;
-            }
-
-            double mom[10];
-            func( src, mom );
-
-            if(binary)
-            {
-                double s = 1./255;
-                for( int k = 0; k < 10; k++ )
-                    mom[k] *= s;
-            }
-
-            double xm = x * mom[0], ym = y * mom[0];
-
-            // accumulate moments computed in each tile
-
-            // + m00 ( = m00' )
-            m.m00 += mom[0];
-
-            // + m10 ( = m10' + x*m00' )
-            m.m10 += mom[1] + xm;
-
-            // + m01 ( = m01' + y*m00' )
-            m.m01 += mom[2] + ym;
-
-            // + m20 ( = m20' + 2*x*m10' + x*x*m00' )
-            m.m20 += mom[3] + x * (mom[1] * 2 + xm);
-
-            // + m11 ( = m11' + x*m01' + y*m10' + x*y*m00' )
-            m.m11 += mom[4] + x * (mom[2] + ym) + y * mom[1];
-
-            // + m02 ( = m02' + 2*y*m01' + y*y*m00' )
-            m.m02 += mom[5] + y * (mom[2] * 2 + ym);
-
-            // + m30 ( = m30' + 3*x*m20' + 3*x*x*m10' + x*x*x*m00' )
-            m.m30 += mom[6] + x * (3. * mom[3] + x * (3. * mom[1] + xm));
-
-            // + m21 ( = m21' + x*(2*m11' + 2*y*m10' + x*m01' + x*y*m00') + y*m20')
-            m.m21 += mom[7] + x * (2 * (mom[4] + y * mom[1]) + x * (mom[2] + ym)) + y * mom[3];
-
-            // + m12 ( = m12' + y*(2*m11' + 2*x*m01' + y*m10' + x*y*m00') + x*m02')
-            m.m12 += mom[8] + y * (2 * (mom[4] + x * mom[2]) + y * (mom[1] + xm)) + x * mom[5];
-
-            // + m03 ( = m03' + 3*y*m02' + 3*y*y*m01' + y*y*y*m00' )
-            m.m03 += mom[9] + y * (3. * mom[5] + y * (3. * mom[2] + ym));
-        }
+        const Moments& rm = rowMoments[i];
+        m.m00 += rm.m00; m.m10 += rm.m10; m.m01 += rm.m01;
+        m.m20 += rm.m20; m.m11 += rm.m11; m.m02 += rm.m02;
+        m.m30 += rm.m30; m.m21 += rm.m21; m.m12 += rm.m12; m.m03 += rm.m03;
     }
 
     completeMomentState( &m );
@@ -743,7 +743,7 @@ struct PyrDownInvoker : ParallelLoopBody
 };
 
 template<class CastOp> void
-pyrDown_( const Mat& _src, Mat& _dst, int borderType )
+pyrDown_( const Mat& _src, Mat& _dst, int borderType, const Range& rows, bool parallel )
 {
     const int PD_SZ = 5;
     CV_Assert( !_src.empty() );
@@ -776,7 +776,17 @@ pyrDown_( const Mat& _src, Mat& _dst, int borderType )
     int *tabLPtr = tabL;
     int *tabRPtr = tabR;
 
-    cv::parallel_for_(Range(0,dsize.height), cv::PyrDownInvoker<CastOp>(_src, _dst, borderType, &tabRPtr, &tabM, &tabLPtr), cv::getNumThreads());
+    cv::PyrDownInvoker<CastOp> invoker(_src, _dst, borderType, &tabRPtr, &tabM, &tabLPtr);
+    if( parallel )
+        cv::parallel_for_(rows, invoker, cv::getNumThreads());
+    else
+        invoker(rows);
+}
+
+template<class CastOp> void
+pyrDown_( const Mat& _src, Mat& _dst, int borderType )
+{
+    pyrDown_<CastOp>(_src, _dst, borderType, Range(0, _dst.rows), true);
 }
 
 template<class CastOp>
@@ -900,39 +910,80 @@ void PyrDownInvoker<CastOp>::operator()(const Range& range) const
 }
 
 
+template<class CastOp>
+struct PyrUpInvoker : ParallelLoopBody
+{
+    PyrUpInvoker(const Mat& src, const Mat& dst, const int* dtab)
+    {
+        _src = &src;
+        _dst = &dst;
+        _dtab = dtab;
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE;
+
+    const int *_dtab;
+    const Mat *_src;
+    const Mat *_dst;
+};
+
 template<class CastOp> void
 pyrUp_( const Mat& _src, Mat& _dst, int)
 {
-    const int PU_SZ = 3;
-    typedef typename CastOp::type1 WT;
     typedef typename CastOp::rtype T;
 
     Size ssize = _src.size(), dsize = _dst.size();
     int cn = _src.channels();
+    AutoBuffer<int> _dtab(ssize.width*cn);
+    int* dtab = _dtab.data();
+
+    CV_Assert( std::abs(dsize.width - ssize.width*2) == dsize.width % 2 &&
+               std::abs(dsize.height - ssize.height*2) == dsize.height % 2);
+
+    for( int x = 0; x < ssize.width*cn; x++ )
+        dtab[x] = (x/cn)*2*cn + x % cn;
+
+    cv::parallel_for_(Range(0, ssize.height), cv::PyrUpInvoker<CastOp>(_src, _dst, dtab), cv::getNumThreads());
+
+    if (dsize.height > ssize.height*2)
+    {
+        const T* dst0 = _dst.ptr<T>(ssize.height*2-2);
+        T* dst2 = _dst.ptr<T>(ssize.height*2);
+
+        for( int x = 0; x < dsize.width*cn; x++ )
+        {
+            dst2[x] = dst0[x];
+        }
+    }
+}
+
+template<class CastOp>
+void PyrUpInvoker<CastOp>::operator()(const Range& range) const
+{
+    const int PU_SZ = 3;
+    typedef typename CastOp::type1 WT;
+    typedef typename CastOp::rtype T;
+
+    Size ssize = _src->size(), dsize = _dst->size();
+    int cn = _src->channels();
     int bufstep = (int)alignSize((dsize.width+1)*cn, 16);
     AutoBuffer<WT> _buf(bufstep*PU_SZ + 16);
     WT* buf = alignPtr((WT*)_buf.data(), 16);
-    AutoBuffer<int> _dtab(ssize.width*cn);
-    int* dtab = _dtab.data();
+    const int* dtab = _dtab;
     WT* rows[PU_SZ];
     T* dsts[2];
     CastOp castOp;
-    //PyrUpVecH<T, WT> vecOpH;
 
-    CV_Assert( std::abs(dsize.width - ssize.width*2) == dsize.width % 2 &&
-               std::abs(dsize.height - ssize.height*2) == dsize.height % 2);
-    int k, x, sy0 = -PU_SZ/2, sy = sy0;
+    // every stripe starts with its own ring buffer one source row above the first output row
+    int k, x, sy0 = -PU_SZ/2, sy = range.start + sy0;
 
     ssize.width *= cn;
     dsize.width *= cn;
 
-    for( x = 0; x < ssize.width; x++ )
-        dtab[x] = (x/cn)*2*cn + x % cn;
-
-    for( int y = 0; y < ssize.height; y++ )
+    for( int y = range.start; y < range.end; y++ )
     {
-        T* dst0 = _dst.ptr<T>(y*2);
-        T* dst1 = _dst.ptr<T>(std::min(y*2+1, dsize.height-1));
+        T* dst0 = (T*)_dst->ptr<T>(y*2);
+        T* dst1 = (T*)_dst->ptr<T>(std::min(y*2+1, dsize.height-1));
         WT *row0, *row1, *row2;
 
         // fill the ring buffer (horizontal convolution and decimation)
@@ -940,12 +991,12 @@ pyrUp_( const Mat& _src, Mat& _dst, int)
         {
             WT* row = buf + ((sy - sy0) % PU_SZ)*bufstep;
             int _sy = borderInterpolate(sy*2, ssize.height*2, BORDER_REFLECT_101)/2;
-            const T* src = _src.ptr<T>(_sy);
+            const T* src = _src->ptr<T>(_sy);
 
             if( ssize.width == cn )
             {
                 for( x = 0; x < cn; x++ )
-                    row[x] = row[x + cn] = src[x]*8;
+                    row[x] = row[x + cn] = row[x + cn*2] = src[x]*8;
                 continue;
             }
 
@@ -963,7 +1014,7 @@ pyrUp_( const Mat& _src, Mat& _dst, int)
 
                 if (dsize.width > ssize.width*2)
                 {
-                    row[(_dst.cols-1) + x] = row[dx + cn];
+                    row[(_dst->cols-1)*cn + x] = row[dx + cn];
                 }
             }
 
@@ -991,17 +1042,6 @@ pyrUp_( const Mat& _src, Mat& _dst, int)
             dst1[x] = t1; dst0[x] = t0;
         }
     }
-
-    if (dsize.height > ssize.height*2)
-    {
-        T* dst0 = _dst.ptr<T>(ssize.height*2-2);
-        T* dst2 = _dst.ptr<T>(ssize.height*2);
-
-        for(x = 0; x < dsize.width ; x++ )
-        {
-            dst2[x] = dst0[x];
-        }
-    }
 }
 
 typedef void (*PyrFunc)(const Mat&, Mat&, int);
@@ -1521,6 +1561,173 @@ static bool ipp_buildpyramid( InputArray _src, OutputArrayOfArrays _dst, int max
 }
 #endif
 
+namespace cv
+{
+
+typedef void (*PyrDownRowsFunc)(const Mat&, Mat&, int, const Range&, bool);
+
+static PyrDownRowsFunc getPyrDownRowsFunc(int depth)
+{
+    PyrDownRowsFunc func = 0;
+    if( depth == CV_8U )
+        func = pyrDown_< FixPtCast<uchar, 8> >;
+    else if( depth == CV_16S )
+        func = pyrDown_< FixPtCast<short, 8> >;
+    else if( depth == CV_16U )
+        func = pyrDown_< FixPtCast<ushort, 8> >;
+    else if( depth == CV_32F )
+        func = pyrDown_< FltCast<float, 8> >;
+    else if( depth == CV_64F )
+        func = pyrDown_< FltCast<double, 8> >;
+    else
+        CV_Error( CV_StsUnsupportedFormat, "" );
+    return func;
+}
+
+static bool pyrDownHal( const Mat& src, Mat& dst, int borderType )
+{
+    int res = cv_hal_pyrdown(src.data, src.step, src.cols, src.rows, dst.data, dst.step, dst.cols, dst.rows,
+                             src.depth(), src.channels(), borderType);
+    if( res == CV_HAL_ERROR_OK )
+        return true;
+    if( res != CV_HAL_ERROR_NOT_IMPLEMENTED )
+        CV_Error_(cv::Error::StsInternal,
+            ("HAL implementation pyrDown ==> " CVAUX_STR(cv_hal_pyrdown) " returned %d (0x%08x)", res, res));
+    return false;
+}
+
+// Returns the rows of the next level whose whole vertical 5-tap support
+// lies within the already computed rows 'prev' of a level with 'srows' rows.
+static Range pyrDownReadyRows( const Range& prev, int srows, int drows, int borderType )
+{
+    Range r(0, 0);
+    int y0 = std::max(prev.start/2 - 2, 0), y1 = std::min((prev.end + 1)/2 + 2, drows);
+    for( int y = y0; y < y1; y++ )
+    {
+        bool ready = true;
+        for( int k = -2; k <= 2 && ready; k++ )
+        {
+            int sy = borderInterpolate(y*2 + k, srows, borderType);
+            ready = prev.start <= sy && sy < prev.end;
+        }
+        if( ready )
+        {
+            if( r.empty() )
+                r.start = y;
+            r.end = y + 1;
+        }
+        else if( !r.empty() )
+            break;
+    }
+    return r;
+}
+
+// Each stripe of the first level is pushed down the pyramid as far as its own rows allow,
+// so the deeper levels are computed while the rows they are built from are still in cache.
+class PyramidStripesInvoker : public ParallelLoopBody
+{
+public:
+    PyramidStripesInvoker(std::vector<Mat>& levels, std::vector<std::vector<uchar> >& done,
+                          int stripeRows, int borderType, PyrDownRowsFunc func)
+        : levels_(&levels), done_(&done), stripeRows_(stripeRows), borderType_(borderType), func_(func)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        std::vector<Mat>& levels = *levels_;
+        int maxlevel = (int)levels.size() - 1;
+
+        for( int s = range.start; s < range.end; s++ )
+        {
+            Range rows(s*stripeRows_, std::min((s + 1)*stripeRows_, levels[1].rows));
+            for( int l = 1; l <= maxlevel && !rows.empty(); l++ )
+            {
+                func_(levels[l-1], levels[l], borderType_, rows, false);
+                std::fill((*done_)[l].begin() + rows.start, (*done_)[l].begin() + rows.end, (uchar)1);
+                if( l < maxlevel )
+                    rows = pyrDownReadyRows(rows, levels[l].rows, levels[l+1].rows, borderType_);
+            }
+        }
+    }
+
+private:
+    std::vector<Mat>* levels_;
+    std::vector<std::vector<uchar> >* done_;
+    int stripeRows_;
+    int borderType_;
+    PyrDownRowsFunc func_;
+};
+
+class PyramidGapsInvoker : public ParallelLoopBody
+{
+public:
+    PyramidGapsInvoker(const Mat& src, Mat& dst, const std::vector<Range>& gaps, int borderType, PyrDownRowsFunc func)
+        : src_(&src), dst_(&dst), gaps_(&gaps), borderType_(borderType), func_(func)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        for( int i = range.start; i < range.end; i++ )
+            func_(*src_, *dst_, borderType_, (*gaps_)[i], false);
+    }
+
+private:
+    const Mat* src_;
+    Mat* dst_;
+    const std::vector<Range>* gaps_;
+    int borderType_;
+    PyrDownRowsFunc func_;
+};
+
+// Builds levels[1..] from levels[0] with the same result as the repeated pyrDown() calls.
+static void buildPyramidFused( std::vector<Mat>& levels, int borderType )
+{
+    const int STRIPE_ROWS = 64;
+    int maxlevel = (int)levels.size() - 1;
+    if( maxlevel < 1 )
+        return;
+
+    const Mat& src = levels[0];
+    CV_Assert( !src.empty() );
+    PyrDownRowsFunc func = getPyrDownRowsFunc(src.depth());
+
+    std::vector<std::vector<uchar> > done(maxlevel + 1);
+    for( int l = 1; l <= maxlevel; l++ )
+    {
+        levels[l].create(Size((levels[l-1].cols + 1)/2, (levels[l-1].rows + 1)/2), src.type());
+        done[l].assign(levels[l].rows, (uchar)0);
+    }
+
+    int nstripes = (levels[1].rows + STRIPE_ROWS - 1)/STRIPE_ROWS;
+    parallel_for_(Range(0, nstripes), PyramidStripesInvoker(levels, done, STRIPE_ROWS, borderType, func));
+
+    // the rows between the stripes of the deeper levels need rows of two stripes, do them level by level
+    std::vector<Range> gaps;
+    for( int l = 2; l <= maxlevel; l++ )
+    {
+        gaps.clear();
+        for( int y = 0; y < levels[l].rows; )
+        {
+            if( done[l][y] )
+            {
+                y++;
+                continue;
+            }
+            int y1 = y;
+            while( y1 < levels[l].rows && !done[l][y1] )
+                y1++;
+            gaps.push_back(Range(y, y1));
+            y = y1;
+        }
+        if( !gaps.empty() )
+            parallel_for_(Range(0, (int)gaps.size()), PyramidGapsInvoker(levels[l-1], levels[l], gaps, borderType, func));
+    }
+}
+
+}
+
 void cv::buildPyramid( InputArray _src, OutputArrayOfArrays _dst, int maxlevel, int borderType )
 {
     CV_INSTRUMENT_REGION();
@@ -1546,10 +1753,125 @@ void cv::buildPyramid( InputArray _src, OutputArrayOfArrays _dst, int maxlevel,
     CV_IPP_RUN(((IPP_VERSION_X100 >= 810) && ((borderType & ~BORDER_ISOLATED) == BORDER_DEFAULT && (!_src.isSubmatrix() || ((borderType & BORDER_ISOLATED) != 0)))),
         ipp_buildpyramid( _src,  _dst,  maxlevel,  borderType));
 
+    if( maxlevel > 0 && !useOpenVX() )
+    {
+        Mat& dst1 = _dst.getMatRef(1);
+        dst1.create( Size((src.cols + 1)/2, (src.rows + 1)/2), src.type() );
+
+        // an external HAL keeps handling the levels one by one
+        if( pyrDownHal(src, dst1, borderType) )
+            i = 2;
+        else
+        {
+            std::vector<Mat> levels(maxlevel + 1);
+            for( int l = 0; l <= maxlevel; l++ )
+                levels[l] = _dst.getMatRef(l);
+            buildPyramidFused(levels, borderType);
+            for( int l = 1; l <= maxlevel; l++ )
+                _dst.getMatRef(l) = levels[l];
+            return;
+        }
+    }
+
     for( ; i <= maxlevel; i++ )
         pyrDown( _dst.getMatRef(i-1), _dst.getMatRef(i), Size(), borderType );
 }
 
+namespace cv
+{
+
+class PyramidBuilderImpl CV_FINAL : public PyramidBuilder
+{
+public:
+    PyramidBuilderImpl(int maxlevel, int borderType)
+    {
+        setMaxLevel(maxlevel);
+        setBorderType(borderType);
+    }
+
+    void buildGaussian(InputArray _src, OutputArrayOfArrays _dst) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        Mat src = _src.getMat();
+        CV_Assert( !src.empty() && src.dims <= 2 );
+
+        _dst.create( maxlevel_ + 1, 1, 0 );
+        std::vector<Mat> levels(maxlevel_ + 1);
+        levels[0] = src;
+        for( int l = 1; l <= maxlevel_; l++ )
+            levels[l] = _dst.getMatRef(l);
+
+        buildPyramidFused(levels, borderType_);
+
+        for( int l = 0; l <= maxlevel_; l++ )
+            _dst.getMatRef(l) = levels[l];
+    }
+
+    void buildLaplacian(InputArray _src, OutputArrayOfArrays _dst, int ddepth) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        Mat src = _src.getMat();
+        CV_Assert( !src.empty() && src.dims <= 2 );
+
+        int sdepth = src.depth();
+        if( ddepth < 0 )
+            ddepth = sdepth == CV_8U ? CV_16S : sdepth == CV_32F || sdepth == CV_64F ? sdepth : CV_32F;
+
+        gaussian_.resize(maxlevel_ + 1);
+        up_.resize(maxlevel_);
+        gaussian_[0] = src;
+        buildPyramidFused(gaussian_, borderType_);
+
+        _dst.create( maxlevel_ + 1, 1, 0 );
+        for( int l = 0; l < maxlevel_; l++ )
+        {
+            // pyrUp supports the default border only, as the expansion step is fixed by definition
+            pyrUp(gaussian_[l+1], up_[l], gaussian_[l].size());
+            subtract(gaussian_[l], up_[l], _dst.getMatRef(l), noArray(), ddepth);
+        }
+        gaussian_[maxlevel_].convertTo(_dst.getMatRef(maxlevel_), ddepth);
+        gaussian_[0].release();
+    }
+
+    void setMaxLevel(int maxlevel) CV_OVERRIDE
+    {
+        CV_Assert( maxlevel >= 0 );
+        maxlevel_ = maxlevel;
+    }
+
+    int getMaxLevel() const CV_OVERRIDE { return maxlevel_; }
+
+    void setBorderType(int borderType) CV_OVERRIDE
+    {
+        CV_Assert( borderType != BORDER_CONSTANT );
+        borderType_ = borderType;
+    }
+
+    int getBorderType() const CV_OVERRIDE { return borderType_; }
+
+    void collectGarbage() CV_OVERRIDE
+    {
+        gaussian_.clear();
+        up_.clear();
+    }
+
+private:
+    int maxlevel_;
+    int borderType_;
+
+    std::vector<Mat> gaussian_;
+    std::vector<Mat> up_;
+};
+
+}
+
+cv::Ptr<cv::PyramidBuilder> cv::createPyramidBuilder(int maxlevel, int borderType)
+{
+    return makePtr<PyramidBuilderImpl>(maxlevel, borderType);
+}
+
 CV_IMPL void cvPyrDown( const void* srcarr, void* dstarr, int _filter )
 {
     cv::Mat src = cv::cvarrToMat(srcarr), dst = cv::cvarrToMat(dstarr);
@@ -362,7 +362,7 @@ static bool integral_SIMD(
         CV_CPU_DISPATCH_MODES_ALL);
 }
 
-void integral(
+static void integral_serial(
         int depth, int sdepth, int sqdepth,
         const uchar* src, size_t srcstep,
         uchar* sum, size_t sumstep,
@@ -370,11 +370,6 @@ void integral(
         uchar* tilted, size_t tstep,
         int width, int height, int cn)
 {
-    CV_INSTRUMENT_REGION();
-
-    CALL_HAL(integral, cv_hal_integral, depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, tilted, tstep, width, height, cn);
-    CV_IPP_RUN_FAST(ipp_integral(depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, tilted, tstep, width, height, cn));
-
     if (integral_SIMD(depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, tilted, tstep, width, height, cn))
         return;
 
@@ -410,6 +405,175 @@ void integral(
 #undef ONE_CALL
 }
 
+// Parallel integral image is computed in two passes over horizontal stripes of the image.
+// The first pass computes the integral of every stripe independently; the second pass adds
+// the bottom row of all the previous stripes (the carry) to each row of the stripe.
+// The first output row of a stripe is the last row of the previous one, so the even and the odd
+// stripes are processed in two waves to avoid writing that row concurrently.
+class IntegralStripesInvoker : public ParallelLoopBody
+{
+public:
+    IntegralStripesInvoker(int _depth, int _sdepth, int _sqdepth, const Mat& _src,
+                           Mat& _sum, Mat& _sqsum, const std::vector<int>& _rows, int _first) :
+        depth(_depth), sdepth(_sdepth), sqdepth(_sqdepth), src(&_src), sum(&_sum), sqsum(&_sqsum),
+        rows(_rows), first(_first)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        for (int i = range.start; i < range.end; i++)
+        {
+            int s = first + i*2;
+            int y0 = rows[s], y1 = rows[s + 1];
+            integral_serial(depth, sdepth, sqdepth,
+                            src->ptr(y0), src->step,
+                            sum->ptr(y0), sum->step,
+                            sqsum->empty() ? 0 : sqsum->ptr(y0), sqsum->step,
+                            0, 0, src->cols, y1 - y0, src->channels());
+        }
+    }
+
+private:
+    int depth, sdepth, sqdepth;
+    const Mat* src;
+    Mat* sum;
+    Mat* sqsum;
+    const std::vector<int>& rows;
+    int first;
+};
+
+// dst = a + b; the CV_32S sums wrap around like the ones of integral_serial instead of saturating
+static void addIntegralRows(const Mat& a, const Mat& b, Mat dst)
+{
+    if (a.depth() != CV_32S)
+    {
+        add(a, b, dst);
+        return;
+    }
+    const unsigned* pa = a.ptr<unsigned>();
+    const unsigned* pb = b.ptr<unsigned>();
+    unsigned* pd = dst.ptr<unsigned>();
+    for (int i = 0, n = a.cols*a.channels(); i < n; i++)
+        pd[i] = pa[i] + pb[i];
+}
+
+class IntegralCarryInvoker : public ParallelLoopBody
+{
+public:
+    IntegralCarryInvoker(const Mat& _sum, const Mat& _sumCarry, const Mat& _sqsum, const Mat& _sqsumCarry,
+                         const std::vector<int>& _rows) :
+        sum(_sum), sumCarry(_sumCarry), sqsum(_sqsum), sqsumCarry(_sqsumCarry), rows(_rows)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int nstripes = (int)rows.size() - 1;
+        for (int s = range.start; s < range.end; s++)
+        {
+            // the bottom row of a stripe belongs to the next stripe, except for the last one
+            int y0 = rows[s], y1 = s == nstripes - 1 ? rows[s + 1] + 1 : rows[s + 1];
+            sumCarry.row(s).copyTo(sum.row(y0));
+            for (int y = y0 + 1; y < y1; y++)
+                addIntegralRows(sum.row(y), sumCarry.row(s), sum.row(y));
+            if (!sqsum.empty())
+            {
+                sqsumCarry.row(s).copyTo(sqsum.row(y0));
+                for (int y = y0 + 1; y < y1; y++)
+                    addIntegralRows(sqsum.row(y), sqsumCarry.row(s), sqsum.row(y));
+            }
+        }
+    }
+
+private:
+    Mat sum, sumCarry, sqsum, sqsumCarry;
+    const std::vector<int>& rows;
+};
+
+static bool integral_parallel(
+        int depth, int sdepth, int sqdepth,
+        const uchar* src, size_t srcstep,
+        uchar* sum, size_t sumstep,
+        uchar* sqsum, size_t sqsumstep,
+        uchar* tilted,
+        int width, int height, int cn)
+{
+    // the stripes depend only on the image size, so the rounding of the floating-point sums
+    // does not change with the number of threads
+    const int stripeHeight = 128;
+    if (tilted || (double)width*height*cn < (1 << 18))
+        return false;
+    int nstripes = height/stripeHeight;
+    if (nstripes < 2)
+        return false;
+
+    Mat srcMat(height, width, CV_MAKETYPE(depth, cn), (void*)src, srcstep);
+    Mat sumMat(height + 1, width + 1, CV_MAKETYPE(sdepth, cn), sum, sumstep);
+    Mat sqsumMat;
+    if (sqsum)
+        sqsumMat = Mat(height + 1, width + 1, CV_MAKETYPE(sqdepth, cn), sqsum, sqsumstep);
+
+    std::vector<int> rows(nstripes + 1);
+    for (int s = 0; s <= nstripes; s++)
+        rows[s] = (int)((int64)height*s/nstripes);
+
+    // the bottom rows of the even stripes are overwritten by the odd stripes, so they are saved in between
+    Mat sumLast(nstripes, width + 1, sumMat.type()), sqsumLast;
+    if (sqsum)
+        sqsumLast.create(nstripes, width + 1, sqsumMat.type());
+
+    parallel_for_(Range(0, (nstripes + 1)/2), IntegralStripesInvoker(depth, sdepth, sqdepth, srcMat, sumMat, sqsumMat, rows, 0));
+    for (int s = 0; s < nstripes; s += 2)
+    {
+        sumMat.row(rows[s + 1]).copyTo(sumLast.row(s));
+        if (sqsum)
+            sqsumMat.row(rows[s + 1]).copyTo(sqsumLast.row(s));
+    }
+    parallel_for_(Range(0, nstripes/2), IntegralStripesInvoker(depth, sdepth, sqdepth, srcMat, sumMat, sqsumMat, rows, 1));
+    for (int s = 1; s < nstripes; s += 2)
+    {
+        sumMat.row(rows[s + 1]).copyTo(sumLast.row(s));
+        if (sqsum)
+            sqsumMat.row(rows[s + 1]).copyTo(sqsumLast.row(s));
+    }
+
+    // the carry of a stripe is the sum of the bottom rows of all the previous stripes
+    Mat sumCarry(nstripes, width + 1, sumMat.type()), sqsumCarry;
+    sumCarry.row(0) = Scalar::all(0);
+    for (int s = 1; s < nstripes; s++)
+        addIntegralRows(sumCarry.row(s - 1), sumLast.row(s - 1), sumCarry.row(s));
+    if (sqsum)
+    {
+        sqsumCarry.create(nstripes, width + 1, sqsumMat.type());
+        sqsumCarry.row(0) = Scalar::all(0);
+        for (int s = 1; s < nstripes; s++)
+            addIntegralRows(sqsumCarry.row(s - 1), sqsumLast.row(s - 1), sqsumCarry.row(s));
+    }
+
+    parallel_for_(Range(1, nstripes), IntegralCarryInvoker(sumMat, sumCarry, sqsumMat, sqsumCarry, rows));
+    return true;
+}
+
+void integral(
+        int depth, int sdepth, int sqdepth,
+        const uchar* src, size_t srcstep,
+        uchar* sum, size_t sumstep,
+        uchar* sqsum, size_t sqsumstep,
+        uchar* tilted, size_t tstep,
+        int width, int height, int cn)
+{
+    CV_INSTRUMENT_REGION();
+
+    CALL_HAL(integral, cv_hal_integral, depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, tilted, tstep, width, height, cn);
+    CV_IPP_RUN_FAST(ipp_integral(depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, tilted, tstep, width, height, cn));
+
+    if (integral_parallel(depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, tilted, width, height, cn))
+        return;
+
+    integral_serial(depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, tilted, tstep, width, height, cn);
+}
+
 } // namespace hal
 
 void integral(InputArray _src, OutputArray _sum, OutputArray _sqsum, OutputArray _tilted, int sdepth, int sqdepth )
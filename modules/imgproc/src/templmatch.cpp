@@ -41,6 +41,7 @@
 
 #include "precomp.hpp"
 #include "opencl_kernels_imgproc.hpp"
+#include "opencv2/core/utils/tls.hpp"
 
 ////////////////////////////////////////////////// matchTemplate //////////////////////////////////////////////////////////
 
@@ -563,73 +564,61 @@ static bool ocl_matchTemplate( InputArray _img, InputArray _templ, OutputArray _
 
 #include "opencv2/core/hal/hal.hpp"
 
-void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
-                Point anchor, double delta, int borderType )
+struct CrossCorrLayout
+{
+    Size blocksize;
+    Size dftsize;
+    int maxDepth;
+};
+
+static CrossCorrLayout computeCrossCorrLayout( Size corrSize, Size templSize,
+                                               int depth, int tdepth, int cdepth )
 {
     const double blockScale = 4.5;
     const int minBlockSize = 256;
-    std::vector<uchar> buf;
-
-    Mat templ = _templ;
-    int depth = img.depth(), cn = img.channels();
-    int tdepth = templ.depth(), tcn = templ.channels();
-    int cdepth = corr.depth(), ccn = corr.channels();
-
-    CV_Assert( img.dims <= 2 && templ.dims <= 2 && corr.dims <= 2 );
-
-    if( depth != tdepth && tdepth != std::max(CV_32F, depth) )
-    {
-        _templ.convertTo(templ, std::max(CV_32F, depth));
-        tdepth = templ.depth();
-    }
-
-    CV_Assert( depth == tdepth || tdepth == CV_32F);
-    CV_Assert( corr.rows <= img.rows + templ.rows - 1 &&
-               corr.cols <= img.cols + templ.cols - 1 );
-
-    CV_Assert( ccn == 1 || delta == 0 );
 
-    int maxDepth = depth > CV_8S ? CV_64F : std::max(std::max(CV_32F, tdepth), cdepth);
-    Size blocksize, dftsize;
+    CrossCorrLayout layout;
+    Size& blocksize = layout.blocksize;
+    Size& dftsize = layout.dftsize;
+    layout.maxDepth = depth > CV_8S ? CV_64F : std::max(std::max(CV_32F, tdepth), cdepth);
 
-    blocksize.width = cvRound(templ.cols*blockScale);
-    blocksize.width = std::max( blocksize.width, minBlockSize - templ.cols + 1 );
-    blocksize.width = std::min( blocksize.width, corr.cols );
-    blocksize.height = cvRound(templ.rows*blockScale);
-    blocksize.height = std::max( blocksize.height, minBlockSize - templ.rows + 1 );
-    blocksize.height = std::min( blocksize.height, corr.rows );
+    blocksize.width = cvRound(templSize.width*blockScale);
+    blocksize.width = std::max( blocksize.width, minBlockSize - templSize.width + 1 );
+    blocksize.width = std::min( blocksize.width, corrSize.width );
+    blocksize.height = cvRound(templSize.height*blockScale);
+    blocksize.height = std::max( blocksize.height, minBlockSize - templSize.height + 1 );
+    blocksize.height = std::min( blocksize.height, corrSize.height );
 
-    dftsize.width = std::max(getOptimalDFTSize(blocksize.width + templ.cols - 1), 2);
-    dftsize.height = getOptimalDFTSize(blocksize.height + templ.rows - 1);
+    dftsize.width = std::max(getOptimalDFTSize(blocksize.width + templSize.width - 1), 2);
+    dftsize.height = getOptimalDFTSize(blocksize.height + templSize.height - 1);
     if( dftsize.width <= 0 || dftsize.height <= 0 )
         CV_Error( CV_StsOutOfRange, "the input arrays are too big" );
 
     // recompute block size
-    blocksize.width = dftsize.width - templ.cols + 1;
-    blocksize.width = MIN( blocksize.width, corr.cols );
-    blocksize.height = dftsize.height - templ.rows + 1;
-    blocksize.height = MIN( blocksize.height, corr.rows );
+    blocksize.width = dftsize.width - templSize.width + 1;
+    blocksize.width = MIN( blocksize.width, corrSize.width );
+    blocksize.height = dftsize.height - templSize.height + 1;
+    blocksize.height = MIN( blocksize.height, corrSize.height );
 
-    Mat dftTempl( dftsize.height*tcn, dftsize.width, maxDepth );
-    Mat dftImg( dftsize, maxDepth );
-
-    int i, k, bufSize = 0;
-    if( tcn > 1 && tdepth != maxDepth )
-        bufSize = templ.cols*templ.rows*CV_ELEM_SIZE(tdepth);
+    return layout;
+}
 
-    if( cn > 1 && depth != maxDepth )
-        bufSize = std::max( bufSize, (blocksize.width + templ.cols - 1)*
-            (blocksize.height + templ.rows - 1)*CV_ELEM_SIZE(depth));
+// computes DFT of each template plane, the spectra of the planes are stacked vertically
+static void dftTemplate( const Mat& templ, const CrossCorrLayout& layout, Mat& dftTempl )
+{
+    Size dftsize = layout.dftsize;
+    int maxDepth = layout.maxDepth;
+    int tdepth = templ.depth(), tcn = templ.channels();
 
-    if( (ccn > 1 || cn > 1) && cdepth != maxDepth )
-        bufSize = std::max( bufSize, blocksize.width*blocksize.height*CV_ELEM_SIZE(cdepth));
+    dftTempl.create( dftsize.height*tcn, dftsize.width, maxDepth );
 
-    buf.resize(bufSize);
+    std::vector<uchar> buf;
+    if( tcn > 1 && tdepth != maxDepth )
+        buf.resize(templ.cols*templ.rows*CV_ELEM_SIZE(tdepth));
 
-    Ptr<hal::DFT2D> c = hal::DFT2D::create(dftsize.width, dftsize.height, dftTempl.depth(), 1, 1, CV_HAL_DFT_IS_INPLACE, templ.rows);
+    Ptr<hal::DFT2D> c = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, CV_HAL_DFT_IS_INPLACE, templ.rows);
 
-    // compute DFT of each template plane
-    for( k = 0; k < tcn; k++ )
+    for( int k = 0; k < tcn; k++ )
     {
         int yofs = k*dftsize.height;
         Mat src = templ;
@@ -653,110 +642,239 @@ void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
         }
         c->apply(dst.data, (int)dst.step, dst.data, (int)dst.step);
     }
+}
 
-    int tileCountX = (corr.cols + blocksize.width - 1)/blocksize.width;
-    int tileCountY = (corr.rows + blocksize.height - 1)/blocksize.height;
-    int tileCount = tileCountX * tileCountY;
+// Computes the correlation of the image with one or more templates block by block.
+// The DFT of every image block is computed once and multiplied by the spectra of all the templates,
+// the blocks are processed in parallel. templSize is the largest template size; layout and
+// the block grid are computed for it, so every template fits into the DFT of the block.
+class CrossCorrInvoker CV_FINAL : public ParallelLoopBody
+{
+public:
+    CrossCorrInvoker( const Mat& _img0, Point _roiofs, Point _anchor,
+                      const CrossCorrLayout& _layout, Size _templSize,
+                      const std::vector<Mat>& _dftTempls, const std::vector<Mat>& _corrs,
+                      double _delta, int _borderType ) :
+        img0(_img0), roiofs(_roiofs), anchor(_anchor), layout(_layout), templSize(_templSize),
+        dftTempls(_dftTempls), corrs(_corrs), delta(_delta), borderType(_borderType)
+    {
+        CV_Assert( !corrs.empty() && dftTempls.size() == corrs.size() );
 
-    Size wholeSize = img.size();
-    Point roiofs(0,0);
-    Mat img0 = img;
+        int depth = img0.depth(), cn = img0.channels();
+        Size blocksize = layout.blocksize;
 
-    if( !(borderType & BORDER_ISOLATED) )
-    {
-        img.locateROI(wholeSize, roiofs);
-        img0.adjustROI(roiofs.y, wholeSize.height-img.rows-roiofs.y,
-                       roiofs.x, wholeSize.width-img.cols-roiofs.x);
+        corrSize = Size(0, 0);
+        bufSize = 0;
+        if( cn > 1 && depth != layout.maxDepth )
+            bufSize = (blocksize.width + templSize.width - 1)*
+                (blocksize.height + templSize.height - 1)*CV_ELEM_SIZE(depth);
+
+        for( size_t j = 0; j < corrs.size(); j++ )
+        {
+            const Mat& corr = corrs[j];
+            int cdepth = corr.depth(), ccn = corr.channels();
+            if( (ccn > 1 || cn > 1) && cdepth != layout.maxDepth )
+                bufSize = std::max( bufSize, blocksize.width*blocksize.height*CV_ELEM_SIZE(cdepth));
+            corrSize.width = std::max(corrSize.width, corr.cols);
+            corrSize.height = std::max(corrSize.height, corr.rows);
+        }
+
+        tileCountX = (corrSize.width + blocksize.width - 1)/blocksize.width;
+        int tileCountY = (corrSize.height + blocksize.height - 1)/blocksize.height;
+        tileCount = tileCountX * tileCountY;
     }
-    borderType |= BORDER_ISOLATED;
 
-    Ptr<hal::DFT2D> cF, cR;
-    int f = CV_HAL_DFT_IS_INPLACE;
-    int f_inv = f | CV_HAL_DFT_INVERSE | CV_HAL_DFT_SCALE;
-    cF = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f, blocksize.height + templ.rows - 1);
-    cR = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f_inv, blocksize.height);
+    int getTileCount() const { return tileCount; }
 
-    // calculate correlation by blocks
-    for( i = 0; i < tileCount; i++ )
+    void operator()( const Range& range ) const CV_OVERRIDE
     {
-        int x = (i%tileCountX)*blocksize.width;
-        int y = (i/tileCountX)*blocksize.height;
-
-        Size bsz(std::min(blocksize.width, corr.cols - x),
-                 std::min(blocksize.height, corr.rows - y));
-        Size dsz(bsz.width + templ.cols - 1, bsz.height + templ.rows - 1);
-        int x0 = x - anchor.x + roiofs.x, y0 = y - anchor.y + roiofs.y;
-        int x1 = std::max(0, x0), y1 = std::max(0, y0);
-        int x2 = std::min(img0.cols, x0 + dsz.width);
-        int y2 = std::min(img0.rows, y0 + dsz.height);
-        Mat src0(img0, Range(y1, y2), Range(x1, x2));
-        Mat dst(dftImg, Rect(0, 0, dsz.width, dsz.height));
-        Mat dst1(dftImg, Rect(x1-x0, y1-y0, x2-x1, y2-y1));
-        Mat cdst(corr, Rect(x, y, bsz.width, bsz.height));
-
-        for( k = 0; k < cn; k++ )
+        int depth = img0.depth(), cn = img0.channels();
+        int maxDepth = layout.maxDepth;
+        Size blocksize = layout.blocksize, dftsize = layout.dftsize;
+        int ntempl = (int)corrs.size();
+
+        // the DFT contexts keep internal buffers, so each thread needs its own copies;
+        // they are created once per thread rather than per range, as every tile may be a range of its own
+        Scratch& scratch = tlsScratch.getRef();
+        if( !scratch.cF )
         {
-            Mat src = src0;
-            dftImg = Scalar::all(0);
+            int f = CV_HAL_DFT_IS_INPLACE;
+            int f_inv = f | CV_HAL_DFT_INVERSE | CV_HAL_DFT_SCALE;
+            scratch.buf.resize(bufSize);
+            scratch.dftImg.create( dftsize, maxDepth );
+            scratch.dftProd = ntempl > 1 ? Mat( dftsize, maxDepth ) : scratch.dftImg;
+            scratch.cF = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f, blocksize.height + templSize.height - 1);
+            scratch.cR = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f_inv, blocksize.height);
+        }
+        std::vector<uchar>& buf = scratch.buf;
+        Mat dftImg = scratch.dftImg, dftProd = scratch.dftProd;
+        hal::DFT2D* cF = scratch.cF.get();
+        hal::DFT2D* cR = scratch.cR.get();
 
-            if( cn > 1 )
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int x = (i%tileCountX)*blocksize.width;
+            int y = (i/tileCountX)*blocksize.height;
+
+            Size bsz(std::min(blocksize.width, corrSize.width - x),
+                     std::min(blocksize.height, corrSize.height - y));
+            Size dsz(bsz.width + templSize.width - 1, bsz.height + templSize.height - 1);
+            int x0 = x - anchor.x + roiofs.x, y0 = y - anchor.y + roiofs.y;
+            int x1 = std::max(0, x0), y1 = std::max(0, y0);
+            int x2 = std::min(img0.cols, x0 + dsz.width);
+            int y2 = std::min(img0.rows, y0 + dsz.height);
+            Mat src0(img0, Range(y1, y2), Range(x1, x2));
+            Mat dst(dftImg, Rect(0, 0, dsz.width, dsz.height));
+            Mat dst1(dftImg, Rect(x1-x0, y1-y0, x2-x1, y2-y1));
+
+            for( int k = 0; k < cn; k++ )
             {
-                src = depth == maxDepth ? dst1 : Mat(y2-y1, x2-x1, depth, &buf[0]);
-                int pairs[] = {k, 0};
-                mixChannels(&src0, 1, &src, 1, pairs, 1);
-            }
-
-            if( dst1.data != src.data )
-                src.convertTo(dst1, dst1.depth());
-
-            if( x2 - x1 < dsz.width || y2 - y1 < dsz.height )
-                copyMakeBorder(dst1, dst, y1-y0, dst.rows-dst1.rows-(y1-y0),
-                               x1-x0, dst.cols-dst1.cols-(x1-x0), borderType);
-
-            if (bsz.height == blocksize.height)
-                cF->apply(dftImg.data, (int)dftImg.step, dftImg.data, (int)dftImg.step);
-            else
-                dft( dftImg, dftImg, 0, dsz.height );
+                Mat src = src0;
+                dftImg = Scalar::all(0);
 
-            Mat dftTempl1(dftTempl, Rect(0, tcn > 1 ? k*dftsize.height : 0,
-                                         dftsize.width, dftsize.height));
-            mulSpectrums(dftImg, dftTempl1, dftImg, 0, true);
+                if( cn > 1 )
+                {
+                    src = depth == maxDepth ? dst1 : Mat(y2-y1, x2-x1, depth, &buf[0]);
+                    int pairs[] = {k, 0};
+                    mixChannels(&src0, 1, &src, 1, pairs, 1);
+                }
 
-            if (bsz.height == blocksize.height)
-                cR->apply(dftImg.data, (int)dftImg.step, dftImg.data, (int)dftImg.step);
-            else
-                dft( dftImg, dftImg, DFT_INVERSE + DFT_SCALE, bsz.height );
+                if( dst1.data != src.data )
+                    src.convertTo(dst1, dst1.depth());
 
-            src = dftImg(Rect(0, 0, bsz.width, bsz.height));
+                if( x2 - x1 < dsz.width || y2 - y1 < dsz.height )
+                    copyMakeBorder(dst1, dst, y1-y0, dst.rows-dst1.rows-(y1-y0),
+                                   x1-x0, dst.cols-dst1.cols-(x1-x0), borderType);
 
-            if( ccn > 1 )
-            {
-                if( cdepth != maxDepth )
-                {
-                    Mat plane(bsz, cdepth, &buf[0]);
-                    src.convertTo(plane, cdepth, 1, delta);
-                    src = plane;
-                }
-                int pairs[] = {0, k};
-                mixChannels(&src, 1, &cdst, 1, pairs, 1);
-            }
-            else
-            {
-                if( k == 0 )
-                    src.convertTo(cdst, cdepth, 1, delta);
+                if (bsz.height == blocksize.height)
+                    cF->apply(dftImg.data, (int)dftImg.step, dftImg.data, (int)dftImg.step);
                 else
+                    dft( dftImg, dftImg, 0, dsz.height );
+
+                for( int j = 0; j < ntempl; j++ )
                 {
-                    if( maxDepth != cdepth )
+                    Mat corr = corrs[j];
+                    int cdepth = corr.depth(), ccn = corr.channels();
+                    Size csz(std::min(blocksize.width, corr.cols - x),
+                             std::min(blocksize.height, corr.rows - y));
+                    if( csz.width <= 0 || csz.height <= 0 )
+                        continue;
+                    Mat cdst(corr, Rect(x, y, csz.width, csz.height));
+
+                    const Mat& dftTempl = dftTempls[j];
+                    int tcn = dftTempl.rows/dftsize.height;
+                    Mat dftTempl1(dftTempl, Rect(0, tcn > 1 ? k*dftsize.height : 0,
+                                                 dftsize.width, dftsize.height));
+                    mulSpectrums(dftImg, dftTempl1, dftProd, 0, true);
+
+                    if (csz.height == blocksize.height)
+                        cR->apply(dftProd.data, (int)dftProd.step, dftProd.data, (int)dftProd.step);
+                    else
+                        dft( dftProd, dftProd, DFT_INVERSE + DFT_SCALE, csz.height );
+
+                    src = dftProd(Rect(0, 0, csz.width, csz.height));
+
+                    if( ccn > 1 )
+                    {
+                        if( cdepth != maxDepth )
+                        {
+                            Mat plane(csz, cdepth, &buf[0]);
+                            src.convertTo(plane, cdepth, 1, delta);
+                            src = plane;
+                        }
+                        int pairs[] = {0, k};
+                        mixChannels(&src, 1, &cdst, 1, pairs, 1);
+                    }
+                    else
                     {
-                        Mat plane(bsz, cdepth, &buf[0]);
-                        src.convertTo(plane, cdepth);
-                        src = plane;
+                        if( k == 0 )
+                            src.convertTo(cdst, cdepth, 1, delta);
+                        else
+                        {
+                            if( maxDepth != cdepth )
+                            {
+                                Mat plane(csz, cdepth, &buf[0]);
+                                src.convertTo(plane, cdepth);
+                                src = plane;
+                            }
+                            add(src, cdst, cdst);
+                        }
                     }
-                    add(src, cdst, cdst);
                 }
             }
         }
     }
+
+private:
+    struct Scratch
+    {
+        std::vector<uchar> buf;
+        Mat dftImg;
+        Mat dftProd;
+        Ptr<hal::DFT2D> cF;
+        Ptr<hal::DFT2D> cR;
+    };
+
+    Mat img0;
+    Point roiofs;
+    Point anchor;
+    CrossCorrLayout layout;
+    Size templSize;
+    std::vector<Mat> dftTempls;
+    std::vector<Mat> corrs;
+    double delta;
+    int borderType;
+
+    Size corrSize;
+    int bufSize;
+    int tileCountX;
+    int tileCount;
+    TLSData<Scratch> tlsScratch;
+};
+
+void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
+                Point anchor, double delta, int borderType )
+{
+    Mat templ = _templ;
+    int depth = img.depth();
+    int tdepth = templ.depth();
+    int cdepth = corr.depth(), ccn = corr.channels();
+
+    CV_Assert( img.dims <= 2 && templ.dims <= 2 && corr.dims <= 2 );
+
+    if( depth != tdepth && tdepth != std::max(CV_32F, depth) )
+    {
+        _templ.convertTo(templ, std::max(CV_32F, depth));
+        tdepth = templ.depth();
+    }
+
+    CV_Assert( depth == tdepth || tdepth == CV_32F);
+    CV_Assert( corr.rows <= img.rows + templ.rows - 1 &&
+               corr.cols <= img.cols + templ.cols - 1 );
+
+    CV_Assert( ccn == 1 || delta == 0 );
+
+    CrossCorrLayout layout = computeCrossCorrLayout(corr.size(), templ.size(), depth, tdepth, cdepth);
+
+    std::vector<Mat> dftTempls(1);
+    dftTemplate(templ, layout, dftTempls[0]);
+
+    Size wholeSize = img.size();
+    Point roiofs(0,0);
+    Mat img0 = img;
+
+    if( !(borderType & BORDER_ISOLATED) )
+    {
+        img.locateROI(wholeSize, roiofs);
+        img0.adjustROI(roiofs.y, wholeSize.height-img.rows-roiofs.y,
+                       roiofs.x, wholeSize.width-img.cols-roiofs.x);
+    }
+    borderType |= BORDER_ISOLATED;
+
+    // calculate correlation by blocks
+    CrossCorrInvoker invoker(img0, roiofs, anchor, layout, templ.size(),
+                             dftTempls, std::vector<Mat>(1, corr), delta, borderType);
+    parallel_for_(Range(0, invoker.getTileCount()), invoker);
 }
 
 static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _result, int method, InputArray _mask )
@@ -903,7 +1021,8 @@ static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _
     }
 }
 
-static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+static void common_matchTemplate( const Mat& sum, const Mat& sqsum, const Mat& templ,
+                                  Mat& result, int method, int cn )
 {
     if( method == CV_TM_CCORR )
         return;
@@ -916,19 +1035,16 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
 
     double invArea = 1./((double)templ.rows * templ.cols);
 
-    Mat sum, sqsum;
     Scalar templMean, templSdv;
     double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
     double templNorm = 0, templSum2 = 0;
 
     if( method == CV_TM_CCOEFF )
     {
-        integral(img, sum, CV_64F);
         templMean = mean(templ);
     }
     else
     {
-        integral(img, sum, sqsum, CV_64F);
         meanStdDev( templ, templMean, templSdv );
 
         templNorm = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
@@ -1027,6 +1143,23 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
         }
     }
 }
+
+static void matchTemplateIntegrals( const Mat& img, int method, Mat& sum, Mat& sqsum )
+{
+    if( method == CV_TM_CCORR )
+        return;
+    if( method == CV_TM_CCOEFF )
+        integral(img, sum, CV_64F);
+    else
+        integral(img, sum, sqsum, CV_64F);
+}
+
+static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+{
+    Mat sum, sqsum;
+    matchTemplateIntegrals(img, method, sum, sqsum);
+    common_matchTemplate(sum, sqsum, templ, result, method, cn);
+}
 }
 
 
@@ -1192,6 +1325,164 @@ void cv::matchTemplate( InputArray _img, InputArray _templ, OutputArray _result,
     common_matchTemplate(img, templ, result, method, cn);
 }
 
+////////////////////////////////////////////////// TemplateMatcher //////////////////////////////////////////////////////////
+
+namespace cv
+{
+
+class TemplateMatcherImpl CV_FINAL : public TemplateMatcher
+{
+public:
+    explicit TemplateMatcherImpl(int _method) : method(_method)
+    {
+        CV_Assert( CV_TM_SQDIFF <= method && method <= CV_TM_CCOEFF_NORMED );
+        layout.maxDepth = -1;
+    }
+
+    int add(InputArray _templ) CV_OVERRIDE
+    {
+        Mat templ = _templ.getMat();
+        int type = templ.type(), depth = CV_MAT_DEPTH(type);
+        CV_Assert( !templ.empty() && templ.dims <= 2 && (depth == CV_8U || depth == CV_32F) );
+        CV_Assert( templs.empty() || templs[0].type() == type );
+
+        templs.push_back(templ.clone());
+        spectra.push_back(Mat());
+        return (int)templs.size() - 1;
+    }
+
+    void clear() CV_OVERRIDE
+    {
+        templs.clear();
+        spectra.clear();
+        layout.maxDepth = -1;
+    }
+
+    bool empty() const CV_OVERRIDE { return templs.empty(); }
+
+    int getTemplatesCount() const CV_OVERRIDE { return (int)templs.size(); }
+
+    void setMethod(int _method) CV_OVERRIDE
+    {
+        CV_Assert( CV_TM_SQDIFF <= _method && _method <= CV_TM_CCOEFF_NORMED );
+        method = _method;
+    }
+
+    int getMethod() const CV_OVERRIDE { return method; }
+
+    void match(InputArray _img, OutputArray _result, int templIdx) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        CV_Assert( 0 <= templIdx && templIdx < (int)templs.size() );
+
+        Mat img = _img.getMat();
+        prepare(img);
+
+        const Mat& templ = templs[templIdx];
+        _result.create(img.rows - templ.rows + 1, img.cols - templ.cols + 1, CV_32F);
+        std::vector<Mat> dftTempls(1, spectra[templIdx]), results(1, _result.getMat());
+
+        run(img, dftTempls, results);
+
+        Mat sum, sqsum;
+        matchTemplateIntegrals(img, method, sum, sqsum);
+        common_matchTemplate(sum, sqsum, templ, results[0], method, img.channels());
+    }
+
+    void matchAll(InputArray _img, OutputArrayOfArrays _results) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        CV_Assert( !templs.empty() );
+
+        Mat img = _img.getMat();
+        prepare(img);
+
+        int ntempl = (int)templs.size();
+        std::vector<Mat> results(ntempl);
+        _results.create(ntempl, 1, CV_32F);
+        for( int j = 0; j < ntempl; j++ )
+        {
+            _results.create(img.rows - templs[j].rows + 1, img.cols - templs[j].cols + 1, CV_32F, j);
+            results[j] = _results.getMat(j);
+        }
+
+        run(img, spectra, results);
+
+        // the integral images are shared by all the templates too
+        Mat sum, sqsum;
+        matchTemplateIntegrals(img, method, sum, sqsum);
+        for( int j = 0; j < ntempl; j++ )
+            common_matchTemplate(sum, sqsum, templs[j], results[j], method, img.channels());
+    }
+
+    void collectGarbage() CV_OVERRIDE
+    {
+        for( size_t j = 0; j < spectra.size(); j++ )
+            spectra[j].release();
+        layout.maxDepth = -1;
+    }
+
+private:
+    // computes the common block layout for the image and (re)computes the template spectra if it has changed,
+    // the spectra depend only on the layout, so the images of different sizes with the same layout share them
+    void prepare(const Mat& img)
+    {
+        CV_Assert( !templs.empty() );
+        CV_Assert( img.type() == templs[0].type() && img.dims <= 2 );
+
+        Size minTemplSize = templs[0].size();
+        maxTemplSize = templs[0].size();
+        for( size_t j = 1; j < templs.size(); j++ )
+        {
+            Size sz = templs[j].size();
+            minTemplSize = Size(std::min(minTemplSize.width, sz.width), std::min(minTemplSize.height, sz.height));
+            maxTemplSize = Size(std::max(maxTemplSize.width, sz.width), std::max(maxTemplSize.height, sz.height));
+        }
+        CV_Assert( img.cols >= maxTemplSize.width && img.rows >= maxTemplSize.height );
+
+        Size corrSize(img.cols - minTemplSize.width + 1, img.rows - minTemplSize.height + 1);
+        CrossCorrLayout newLayout = computeCrossCorrLayout(corrSize, maxTemplSize, img.depth(), img.depth(), CV_32F);
+
+        bool changed = newLayout.dftsize != layout.dftsize || newLayout.blocksize != layout.blocksize ||
+                       newLayout.maxDepth != layout.maxDepth;
+        layout = newLayout;
+
+        for( size_t j = 0; j < templs.size(); j++ )
+            if( changed || spectra[j].empty() )
+                dftTemplate(templs[j], layout, spectra[j]);
+    }
+
+    void run(const Mat& img, const std::vector<Mat>& dftTempls, const std::vector<Mat>& results) const
+    {
+        Size wholeSize;
+        Point roiofs;
+        Mat img0 = img;
+        img.locateROI(wholeSize, roiofs);
+        img0.adjustROI(roiofs.y, wholeSize.height-img.rows-roiofs.y,
+                       roiofs.x, wholeSize.width-img.cols-roiofs.x);
+
+        CrossCorrInvoker invoker(img0, roiofs, Point(0, 0), layout, maxTemplSize,
+                                 dftTempls, results, 0, BORDER_CONSTANT | BORDER_ISOLATED);
+        parallel_for_(Range(0, invoker.getTileCount()), invoker);
+    }
+
+    int method;
+    std::vector<Mat> templs;
+    std::vector<Mat> spectra;
+
+    CrossCorrLayout layout;
+    Size maxTemplSize;
+};
+
+Ptr<TemplateMatcher> createTemplateMatcher(int method)
+{
+    return makePtr<TemplateMatcherImpl>(method);
+}
+
+}
+
 CV_IMPL void
 cvMatchTemplate( const CvArr* _img, const CvArr* _templ, CvArr* _result, int method )
 {
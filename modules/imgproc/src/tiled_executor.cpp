@@ -0,0 +1,245 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/utils/tls.hpp"
+
+namespace cv
+{
+
+// Conversions that read neighbouring pixels (demosaicing) or change the image geometry
+// (planar and packed YUV formats) cannot be applied tile by tile.
+static bool isTileLocalColorConversion(int code)
+{
+    return !((COLOR_BayerBG2BGR <= code && code <= COLOR_BayerGR2BGR) ||
+             (COLOR_BayerBG2BGR_VNG <= code && code <= COLOR_BayerGR2BGR_VNG) ||
+             (COLOR_BayerBG2GRAY <= code && code <= COLOR_BayerGR2GRAY) ||
+             (COLOR_YUV2RGB_NV12 <= code && code <= COLOR_YUV2GRAY_YUY2) ||
+             (COLOR_RGB2YUV_I420 <= code && code <= COLOR_BayerGR2BGRA));
+}
+
+// BORDER_WRAP would take the pixels from the opposite side of the region rather than of the image
+static void checkTileBorderType(int borderType)
+{
+    CV_Assert( (borderType & ~BORDER_ISOLATED) != BORDER_WRAP );
+}
+
+static Size filterHalo(Size ksize, Point anchor)
+{
+    if( anchor.x < 0 )
+        anchor.x = ksize.width/2;
+    if( anchor.y < 0 )
+        anchor.y = ksize.height/2;
+    return Size(std::max(anchor.x, ksize.width - anchor.x - 1),
+                std::max(anchor.y, ksize.height - anchor.y - 1));
+}
+
+class TiledExecutorInvoker : public ParallelLoopBody
+{
+public:
+    TiledExecutorInvoker(const std::vector<TiledExecutor::TileOperation>& ops, Size halo,
+                         Size imageSize, Size tileSize, const TiledExecutor::TileReader& reader,
+                         const TiledExecutor::TileWriter& writer, Mutex& readerMutex, Mutex& writerMutex)
+        : ops_(&ops), halo_(halo), imageSize_(imageSize), tileSize_(tileSize),
+          reader_(&reader), writer_(&writer), readerMutex_(&readerMutex), writerMutex_(&writerMutex)
+    {
+        tilesX_ = (imageSize.width + tileSize.width - 1)/tileSize.width;
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const std::vector<TiledExecutor::TileOperation>& ops = *ops_;
+        size_t nops = ops.size();
+        Rect image(Point(), imageSize_);
+
+        // the stage buffers are kept per thread, and most tiles have the same size
+        std::vector<Mat>& bufs = bufs_.getRef();
+        bufs.resize(nops + 1);
+
+        for( int t = range.start; t < range.end; t++ )
+        {
+            Rect tile = Rect(Point((t % tilesX_)*tileSize_.width, (t / tilesX_)*tileSize_.height), tileSize_) & image;
+            Rect region = Rect(tile.x - halo_.width, tile.y - halo_.height,
+                               tile.width + halo_.width*2, tile.height + halo_.height*2) & image;
+
+            {
+                AutoLock lock(*readerMutex_);
+                (*reader_)(region, bufs[0]);
+            }
+            CV_Assert( bufs[0].size() == region.size() );
+
+            // Each operation processes the whole region as a standalone image. Where the region
+            // ends at the image boundary the border is extrapolated exactly as for the whole image;
+            // elsewhere the extrapolated pixels only spoil a margin that the halo keeps out of the tile.
+            for( size_t k = 0; k < nops; k++ )
+            {
+                ops[k](bufs[k], bufs[k+1]);
+                CV_Assert( bufs[k+1].size() == region.size() );
+            }
+
+            {
+                AutoLock lock(*writerMutex_);
+                (*writer_)(tile, bufs[nops](tile - region.tl()));
+            }
+        }
+    }
+
+private:
+    const std::vector<TiledExecutor::TileOperation>* ops_;
+    Size halo_;
+    Size imageSize_;
+    Size tileSize_;
+    int tilesX_;
+    const TiledExecutor::TileReader* reader_;
+    const TiledExecutor::TileWriter* writer_;
+    Mutex* readerMutex_;
+    Mutex* writerMutex_;
+    TLSData<std::vector<Mat> > bufs_;
+};
+
+class TiledExecutorImpl CV_FINAL : public TiledExecutor
+{
+public:
+    TiledExecutorImpl(Size tileSize)
+    {
+        setTileSize(tileSize);
+    }
+
+    void add(const TileOperation& op, Size halo) CV_OVERRIDE
+    {
+        CV_Assert( op && halo.width >= 0 && halo.height >= 0 );
+        ops_.push_back(op);
+        halos_.push_back(halo);
+    }
+
+    void addFilter2D(int ddepth, InputArray _kernel, Point anchor, double delta, int borderType) CV_OVERRIDE
+    {
+        Mat kernel = _kernel.getMat().clone();
+        CV_Assert( !kernel.empty() );
+        checkTileBorderType(borderType);
+        add([=](InputArray src, OutputArray dst) { filter2D(src, dst, ddepth, kernel, anchor, delta, borderType); },
+            filterHalo(kernel.size(), anchor));
+    }
+
+    void addGaussianBlur(Size ksize, double sigmaX, double sigmaY, int borderType) CV_OVERRIDE
+    {
+        checkTileBorderType(borderType);
+        // an upper bound of the kernel size GaussianBlur derives from sigma when ksize is empty
+        if( ksize.width <= 0 || ksize.height <= 0 )
+        {
+            double sx = sigmaX, sy = sigmaY > 0 ? sigmaY : sigmaX;
+            CV_Assert( sx > 0 );
+            if( ksize.width <= 0 )
+                ksize.width = cvRound(sx*8 + 1) | 1;
+            if( ksize.height <= 0 )
+                ksize.height = cvRound(sy*8 + 1) | 1;
+        }
+        add([=](InputArray src, OutputArray dst) { GaussianBlur(src, dst, ksize, sigmaX, sigmaY, borderType); },
+            filterHalo(ksize, Point(-1, -1)));
+    }
+
+    void addMorphologyEx(int op, InputArray _kernel, Point anchor, int iterations,
+                         int borderType, const Scalar& borderValue) CV_OVERRIDE
+    {
+        Mat kernel = _kernel.getMat().clone();
+        if( kernel.empty() )
+            kernel = getStructuringElement(MORPH_RECT, Size(3, 3));
+        CV_Assert( iterations > 0 );
+        checkTileBorderType(borderType);
+
+        // opening, closing and the hats chain an erosion and a dilation, each of them iterated
+        int passes = op == MORPH_ERODE || op == MORPH_DILATE || op == MORPH_GRADIENT || op == MORPH_HITMISS ?
+            iterations : iterations*2;
+        Size h = filterHalo(kernel.size(), anchor);
+        add([=](InputArray src, OutputArray dst) { morphologyEx(src, dst, op, kernel, anchor, iterations, borderType, borderValue); },
+            Size(h.width*passes, h.height*passes));
+    }
+
+    void addThreshold(double thresh, double maxval, int type) CV_OVERRIDE
+    {
+        CV_Assert( (type & (THRESH_OTSU | THRESH_TRIANGLE)) == 0 );
+        add([=](InputArray src, OutputArray dst) { threshold(src, dst, thresh, maxval, type); }, Size());
+    }
+
+    void addCvtColor(int code, int dstCn) CV_OVERRIDE
+    {
+        CV_Assert( isTileLocalColorConversion(code) );
+        add([=](InputArray src, OutputArray dst) { cvtColor(src, dst, code, dstCn); }, Size());
+    }
+
+    void clear() CV_OVERRIDE
+    {
+        ops_.clear();
+        halos_.clear();
+    }
+
+    int getOperationsCount() const CV_OVERRIDE { return (int)ops_.size(); }
+
+    Size getHalo() const CV_OVERRIDE
+    {
+        Size halo;
+        for( size_t k = 0; k < halos_.size(); k++ )
+            halo += halos_[k];
+        return halo;
+    }
+
+    void setTileSize(Size tileSize) CV_OVERRIDE
+    {
+        CV_Assert( tileSize.width > 0 && tileSize.height > 0 );
+        tileSize_ = tileSize;
+    }
+
+    Size getTileSize() const CV_OVERRIDE { return tileSize_; }
+
+    void run(Size imageSize, const TileReader& reader, const TileWriter& writer) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        CV_Assert( imageSize.width > 0 && imageSize.height > 0 );
+        CV_Assert( reader && writer );
+
+        int tilesX = (imageSize.width + tileSize_.width - 1)/tileSize_.width;
+        int tilesY = (imageSize.height + tileSize_.height - 1)/tileSize_.height;
+        CV_Assert( (int64)tilesX*tilesY <= INT_MAX );
+
+        Mutex readerMutex, writerMutex;
+        parallel_for_(Range(0, tilesX*tilesY),
+                      TiledExecutorInvoker(ops_, getHalo(), imageSize, tileSize_, reader, writer, readerMutex, writerMutex));
+    }
+
+    void apply(InputArray _src, OutputArray _dst) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        Mat src = _src.getMat();
+        CV_Assert( !src.empty() && src.dims <= 2 );
+
+        Mat dst;
+        if( _dst.getObj() == _src.getObj() )
+            src = src.clone();
+        run(src.size(),
+            [&](const Rect& roi, OutputArray tile) { src(roi).copyTo(tile); },
+            [&](const Rect& roi, InputArray tile)
+            {
+                if( dst.empty() )
+                {
+                    _dst.create(src.size(), tile.type());
+                    dst = _dst.getMat();
+                }
+                tile.copyTo(dst(roi));
+            });
+    }
+
+private:
+    std::vector<TileOperation> ops_;
+    std::vector<Size> halos_;
+    Size tileSize_;
+};
+
+Ptr<TiledExecutor> createTiledExecutor(Size tileSize)
+{
+    return makePtr<TiledExecutorImpl>(tileSize);
+}
+
+}
@@ -0,0 +1,352 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+namespace cv
+{
+
+namespace
+{
+
+// The plan keeps the fixed-point maps in the layout consumed by remap directly: CV_16SC2 integer
+// source coordinates plus CV_16UC1 indices into the interpolation table (not used for INTER_NEAREST).
+// The coordinates are computed exactly as warpAffine/warpPerspective compute them block by block,
+// so applying the plan gives the same result as calling these functions.
+
+static void warpAffineMaps( const double* M, Size dsize, int interpolation, Mat& map1, Mat& map2 )
+{
+    const int AB_BITS = MAX(10, (int)INTER_BITS);
+    const int AB_SCALE = 1 << AB_BITS;
+    int round_delta = interpolation == INTER_NEAREST ? AB_SCALE/2 : AB_SCALE/INTER_TAB_SIZE/2;
+
+    map1.create(dsize, CV_16SC2);
+    if( interpolation == INTER_NEAREST )
+        map2.release();
+    else
+        map2.create(dsize, CV_16UC1);
+
+    AutoBuffer<int> _abdelta(dsize.width*2);
+    int* adelta = _abdelta.data(), *bdelta = adelta + dsize.width;
+    for( int x = 0; x < dsize.width; x++ )
+    {
+        adelta[x] = saturate_cast<int>(M[0]*x*AB_SCALE);
+        bdelta[x] = saturate_cast<int>(M[3]*x*AB_SCALE);
+    }
+
+    for( int y = 0; y < dsize.height; y++ )
+    {
+        short* xy = map1.ptr<short>(y);
+        int X0 = saturate_cast<int>((M[1]*y + M[2])*AB_SCALE) + round_delta;
+        int Y0 = saturate_cast<int>((M[4]*y + M[5])*AB_SCALE) + round_delta;
+
+        if( interpolation == INTER_NEAREST )
+        {
+            for( int x = 0; x < dsize.width; x++ )
+            {
+                int X = (X0 + adelta[x]) >> AB_BITS;
+                int Y = (Y0 + bdelta[x]) >> AB_BITS;
+                xy[x*2] = saturate_cast<short>(X);
+                xy[x*2+1] = saturate_cast<short>(Y);
+            }
+        }
+        else
+        {
+            ushort* alpha = map2.ptr<ushort>(y);
+            for( int x = 0; x < dsize.width; x++ )
+            {
+                int X = (X0 + adelta[x]) >> (AB_BITS - INTER_BITS);
+                int Y = (Y0 + bdelta[x]) >> (AB_BITS - INTER_BITS);
+                xy[x*2] = saturate_cast<short>(X >> INTER_BITS);
+                xy[x*2+1] = saturate_cast<short>(Y >> INTER_BITS);
+                alpha[x] = (ushort)((Y & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE +
+                                    (X & (INTER_TAB_SIZE-1)));
+            }
+        }
+    }
+}
+
+static void warpPerspectiveMaps( const double* M, Size dsize, int interpolation, Mat& map1, Mat& map2 )
+{
+    // warpPerspective restarts the accumulation of the coordinates at every block, the same is done here
+    const int BLOCK_SZ = 32;
+    int bh0 = std::min(BLOCK_SZ/2, dsize.height);
+    int bw0 = std::min(BLOCK_SZ*BLOCK_SZ/bh0, dsize.width);
+
+    map1.create(dsize, CV_16SC2);
+    if( interpolation == INTER_NEAREST )
+        map2.release();
+    else
+        map2.create(dsize, CV_16UC1);
+
+    for( int y = 0; y < dsize.height; y++ )
+    {
+        for( int x = 0; x < dsize.width; x += bw0 )
+        {
+            int bw = std::min(bw0, dsize.width - x);
+            short* xy = map1.ptr<short>(y) + x*2;
+            double X0 = M[0]*x + M[1]*y + M[2];
+            double Y0 = M[3]*x + M[4]*y + M[5];
+            double W0 = M[6]*x + M[7]*y + M[8];
+
+            if( interpolation == INTER_NEAREST )
+            {
+                for( int x1 = 0; x1 < bw; x1++ )
+                {
+                    double W = W0 + M[6]*x1;
+                    W = W ? 1./W : 0;
+                    double fX = std::max((double)INT_MIN, std::min((double)INT_MAX, (X0 + M[0]*x1)*W));
+                    double fY = std::max((double)INT_MIN, std::min((double)INT_MAX, (Y0 + M[3]*x1)*W));
+                    int X = saturate_cast<int>(fX);
+                    int Y = saturate_cast<int>(fY);
+                    xy[x1*2] = saturate_cast<short>(X);
+                    xy[x1*2+1] = saturate_cast<short>(Y);
+                }
+            }
+            else
+            {
+                ushort* alpha = map2.ptr<ushort>(y) + x;
+                for( int x1 = 0; x1 < bw; x1++ )
+                {
+                    double W = W0 + M[6]*x1;
+                    W = W ? INTER_TAB_SIZE/W : 0;
+                    double fX = std::max((double)INT_MIN, std::min((double)INT_MAX, (X0 + M[0]*x1)*W));
+                    double fY = std::max((double)INT_MIN, std::min((double)INT_MAX, (Y0 + M[3]*x1)*W));
+                    int X = saturate_cast<int>(fX);
+                    int Y = saturate_cast<int>(fY);
+                    xy[x1*2] = saturate_cast<short>(X >> INTER_BITS);
+                    xy[x1*2+1] = saturate_cast<short>(Y >> INTER_BITS);
+                    alpha[x1] = (ushort)((Y & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE +
+                                         (X & (INTER_TAB_SIZE-1)));
+                }
+            }
+        }
+    }
+}
+
+class WarpPlanImpl CV_FINAL : public WarpPlan
+{
+public:
+    WarpPlanImpl( const Mat& _map1, const Mat& _map2, Size _srcSize, int _interpolation,
+                  int _borderMode, const Scalar& _borderValue ) :
+        map1(_map1), map2(_map2), srcSize(_srcSize), interpolation(_interpolation),
+        borderMode(_borderMode), borderValue(_borderValue)
+    {
+        CV_Assert( map1.type() == CV_16SC2 && (map2.empty() || (map2.type() == CV_16UC1 && map2.size() == map1.size())) );
+        CV_Assert( srcSize.width > 0 && srcSize.height > 0 );
+        buildSchedule();
+    }
+
+    void warp( InputArray _src, OutputArray _dst ) const CV_OVERRIDE;
+
+    Size getSrcSize() const CV_OVERRIDE { return srcSize; }
+    Size getDstSize() const CV_OVERRIDE { return map1.size(); }
+
+    void getMaps( OutputArray _map1, OutputArray _map2 ) const CV_OVERRIDE
+    {
+        map1.copyTo(_map1);
+        map2.copyTo(_map2);
+    }
+
+    bool empty() const CV_OVERRIDE { return map1.empty(); }
+
+private:
+    void buildSchedule();
+
+    Mat map1, map2;
+    Size srcSize;
+    int interpolation, borderMode;
+    Scalar borderValue;
+
+    std::vector<Rect> tiles;
+    // the tiles that sample only outside of the source image and are filled with the border value
+    std::vector<uchar> borderTiles;
+};
+
+void WarpPlanImpl::buildSchedule()
+{
+    const int TILE_W = 128, TILE_H = 32;
+    Size dsize = map1.size();
+
+    // extent of the interpolation kernel around the integer source coordinate
+    int left = 0, right = 0;
+    if( interpolation == INTER_CUBIC )
+        left = 1, right = 2;
+    else if( interpolation == INTER_LANCZOS4 )
+        left = 3, right = 4;
+    else if( interpolation != INTER_NEAREST )
+        right = 1;
+
+    tiles.clear();
+    borderTiles.clear();
+    for( int y = 0; y < dsize.height; y += TILE_H )
+        for( int x = 0; x < dsize.width; x += TILE_W )
+        {
+            Rect tile(x, y, std::min(TILE_W, dsize.width - x), std::min(TILE_H, dsize.height - y));
+            bool outside = borderMode == BORDER_CONSTANT;
+            for( int ty = tile.y; outside && ty < tile.y + tile.height; ty++ )
+            {
+                const short* xy = map1.ptr<short>(ty);
+                for( int tx = tile.x; tx < tile.x + tile.width; tx++ )
+                {
+                    int sx = xy[tx*2], sy = xy[tx*2+1];
+                    if( !(sx + right < 0 || sx - left >= srcSize.width ||
+                          sy + right < 0 || sy - left >= srcSize.height) )
+                    {
+                        outside = false;
+                        break;
+                    }
+                }
+            }
+            tiles.push_back(tile);
+            borderTiles.push_back((uchar)outside);
+        }
+}
+
+class WarpPlanInvoker CV_FINAL : public ParallelLoopBody
+{
+public:
+    WarpPlanInvoker( const Mat& _src, Mat& _dst, const Mat& _map1, const Mat& _map2,
+                     const std::vector<Rect>& _tiles, const std::vector<uchar>& _borderTiles,
+                     int _interpolation, int _borderMode, const Scalar& _borderValue ) :
+        src(_src), dst(_dst), map1(_map1), map2(_map2), tiles(_tiles), borderTiles(_borderTiles),
+        interpolation(_interpolation), borderMode(_borderMode), borderValue(_borderValue)
+    {
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const Rect& tile = tiles[i];
+            Mat dpart(dst, tile);
+            if( borderTiles[i] )
+                dpart.setTo(borderValue);
+            else
+                remap(src, dpart, map1(tile), map2.empty() ? Mat() : map2(tile),
+                      interpolation, borderMode, borderValue);
+        }
+    }
+
+private:
+    Mat src;
+    Mat dst;
+    Mat map1, map2;
+    const std::vector<Rect>& tiles;
+    const std::vector<uchar>& borderTiles;
+    int interpolation, borderMode;
+    Scalar borderValue;
+};
+
+void WarpPlanImpl::warp( InputArray _src, OutputArray _dst ) const
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat();
+    CV_Assert( src.size() == srcSize );
+    CV_Assert( src.channels() <= 4 || (interpolation != INTER_LANCZOS4 &&
+                                       interpolation != INTER_CUBIC) );
+
+    _dst.create( map1.size(), src.type() );
+    Mat dst = _dst.getMat();
+    if( dst.data == src.data )
+        src = src.clone();
+
+    WarpPlanInvoker invoker(src, dst, map1, map2, tiles, borderTiles,
+                            interpolation, borderMode, borderValue);
+    parallel_for_(Range(0, (int)tiles.size()), invoker, dst.total()/(double)(1<<16));
+}
+
+static int warpPlanInterpolation( int flags )
+{
+    int interpolation = flags & INTER_MAX;
+    if( interpolation == INTER_AREA )
+        interpolation = INTER_LINEAR;
+    CV_Assert( interpolation == INTER_NEAREST || interpolation == INTER_LINEAR ||
+               interpolation == INTER_CUBIC || interpolation == INTER_LANCZOS4 );
+    return interpolation;
+}
+
+} // namespace
+
+Ptr<WarpPlan> createRemapPlan( InputArray _map1, InputArray _map2, Size srcSize,
+                               int interpolation, int borderMode, const Scalar& borderValue )
+{
+    CV_INSTRUMENT_REGION();
+
+    interpolation = warpPlanInterpolation(interpolation);
+
+    Mat map1, map2;
+    if( _map1.type() == CV_16SC2 )
+    {
+        map1 = _map1.getMat().clone();
+        if( interpolation != INTER_NEAREST )
+        {
+            // as in remap, a missing table means integer coordinates
+            if( _map2.empty() )
+                map2 = Mat::zeros(map1.size(), CV_16UC1);
+            else
+            {
+                CV_Assert( _map2.type() == CV_16UC1 || _map2.type() == CV_16SC1 );
+                _map2.getMat().convertTo(map2, CV_16U);
+            }
+        }
+    }
+    else
+        convertMaps(_map1, _map2, map1, map2, CV_16SC2, interpolation == INTER_NEAREST);
+
+    return makePtr<WarpPlanImpl>(map1, map2, srcSize, interpolation, borderMode, borderValue);
+}
+
+Ptr<WarpPlan> createWarpAffinePlan( InputArray _M0, Size srcSize, Size dsize,
+                                    int flags, int borderMode, const Scalar& borderValue )
+{
+    CV_INSTRUMENT_REGION();
+
+    int interpolation = warpPlanInterpolation(flags);
+    Mat M0 = _M0.getMat();
+    CV_Assert( (M0.type() == CV_32F || M0.type() == CV_64F) && M0.rows == 2 && M0.cols == 3 );
+
+    double M[6] = {0};
+    Mat matM(2, 3, CV_64F, M);
+    M0.convertTo(matM, matM.type());
+
+    if( !(flags & WARP_INVERSE_MAP) )
+    {
+        double D = M[0]*M[4] - M[1]*M[3];
+        D = D != 0 ? 1./D : 0;
+        double A11 = M[4]*D, A22=M[0]*D;
+        M[0] = A11; M[1] *= -D;
+        M[3] *= -D; M[4] = A22;
+        double b1 = -M[0]*M[2] - M[1]*M[5];
+        double b2 = -M[3]*M[2] - M[4]*M[5];
+        M[2] = b1; M[5] = b2;
+    }
+
+    Mat map1, map2;
+    warpAffineMaps(M, dsize.empty() ? srcSize : dsize, interpolation, map1, map2);
+    return makePtr<WarpPlanImpl>(map1, map2, srcSize, interpolation, borderMode, borderValue);
+}
+
+Ptr<WarpPlan> createWarpPerspectivePlan( InputArray _M0, Size srcSize, Size dsize,
+                                         int flags, int borderMode, const Scalar& borderValue )
+{
+    CV_INSTRUMENT_REGION();
+
+    int interpolation = warpPlanInterpolation(flags);
+    Mat M0 = _M0.getMat();
+    CV_Assert( (M0.type() == CV_32F || M0.type() == CV_64F) && M0.rows == 3 && M0.cols == 3 );
+
+    double M[9];
+    Mat matM(3, 3, CV_64F, M);
+    M0.convertTo(matM, matM.type());
+    if( !(flags & WARP_INVERSE_MAP) )
+        invert(matM, matM);
+
+    Mat map1, map2;
+    warpPerspectiveMaps(M, dsize.empty() ? srcSize : dsize, interpolation, map1, map2);
+    return makePtr<WarpPlanImpl>(map1, map2, srcSize, interpolation, borderMode, borderValue);
+}
+
+} // namespace cv
@@ -1865,6 +1865,163 @@ TEST(Imgproc_EigenValsVecs, accuracy) { CV_EigenValVecTest test; test.safe_run()
 TEST(Imgproc_PreCornerDetect, accuracy) { CV_PreCornerDetectTest test; test.safe_run(); }
 TEST(Imgproc_Integral, accuracy) { CV_IntegralTest test; test.safe_run(); }
 
+TEST(Imgproc_Integral, parallel_stripes)
+{
+    Mat img(1001, 700, CV_8UC3);
+    randu(img, 0, 256);
+
+    int threads = getNumThreads();
+    setNumThreads(1);
+    Mat ref_sum, ref_sqsum, ref_sum64, ref_sum32f, ref_sqsum32f;
+    integral(img, ref_sum, ref_sqsum, CV_32S, CV_64F);
+    integral(img, ref_sum64, CV_64F);
+    integral(img, ref_sum32f, ref_sqsum32f, CV_32F, CV_32F);
+    setNumThreads(4);
+    Mat sum, sqsum, sum64, sum32f, sqsum32f;
+    integral(img, sum, sqsum, CV_32S, CV_64F);
+    integral(img, sum64, CV_64F);
+    integral(img, sum32f, sqsum32f, CV_32F, CV_32F);
+    setNumThreads(threads);
+
+    EXPECT_EQ(0, cvtest::norm(ref_sum, sum, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(ref_sqsum, sqsum, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(ref_sum64, sum64, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(ref_sum32f, sum32f, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(ref_sqsum32f, sqsum32f, NORM_INF));
+}
+
+TEST(Imgproc_Integral, parallel_stripes_32s_overflow)
+{
+    // the sums exceed INT_MAX and must wrap around like in the serial code
+    Mat img(3000, 3000, CV_8UC1);
+    randu(img, 240, 256);
+
+    Mat sum, sqsum, sum64, sqsum64;
+    integral(img, sum, sqsum, CV_32S, CV_32S);
+    integral(img, sum64, sqsum64, CV_64F, CV_64F);
+
+    Mat ref_sum(sum64.size(), CV_32S), ref_sqsum(sqsum64.size(), CV_32S);
+    for (int y = 0; y < sum64.rows; y++)
+    {
+        for (int x = 0; x < sum64.cols; x++)
+        {
+            ref_sum.at<int>(y, x) = (int)(unsigned)(int64)sum64.at<double>(y, x);
+            ref_sqsum.at<int>(y, x) = (int)(unsigned)(int64)sqsum64.at<double>(y, x);
+        }
+    }
+    ASSERT_GT(sum64.at<double>(sum64.rows - 1, sum64.cols - 1), (double)INT_MAX);
+    EXPECT_EQ(0, cvtest::norm(ref_sum, sum, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(ref_sqsum, sqsum, NORM_INF));
+}
+
+TEST(Imgproc_PyramidUp, parallel_stripes)
+{
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16SC1, CV_32FC4 };
+    const Size sizes[] = { Size(321, 241), Size(1, 37), Size(160, 1) };
+    int threads = getNumThreads();
+    for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++)
+    {
+        for (size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+        {
+            Mat src(sizes[i], types[t]);
+            randu(src, 0, 256);
+            Size dsz(src.cols*2 + 1, src.rows*2 + 1);
+
+            setNumThreads(1);
+            Mat ref, ref_odd;
+            pyrUp(src, ref);
+            pyrUp(src, ref_odd, dsz);
+            setNumThreads(4);
+            Mat dst, dst_odd;
+            pyrUp(src, dst);
+            pyrUp(src, dst_odd, dsz);
+            setNumThreads(threads);
+
+            EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF)) << "type=" << types[t] << " size=" << sizes[i];
+            EXPECT_EQ(0, cvtest::norm(ref_odd, dst_odd, NORM_INF)) << "type=" << types[t] << " size=" << sizes[i];
+        }
+    }
+}
+
+typedef testing::TestWithParam<tuple<int, int, int> > Imgproc_PyramidBuilder;
+
+TEST_P(Imgproc_PyramidBuilder, same_as_pyrDown)
+{
+    const Size sizes[] = { Size(1001, 763), Size(640, 480), Size(7, 300), Size(3, 1) };
+    int type = get<0>(GetParam());
+    int borderType = get<1>(GetParam());
+    int maxlevel = get<2>(GetParam());
+
+    int threads = getNumThreads();
+    setNumThreads(4);
+    Ptr<PyramidBuilder> builder = createPyramidBuilder(maxlevel, borderType);
+    std::vector<Mat> gauss, built;
+    for (size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+    {
+        Mat src(sizes[i], type);
+        randu(src, 0, 256);
+
+        std::vector<Mat> ref(maxlevel + 1);
+        ref[0] = src;
+        for (int l = 1; l <= maxlevel; l++)
+            pyrDown(ref[l-1], ref[l], Size(), borderType);
+
+        buildPyramid(src, built, maxlevel, borderType);
+        builder->buildGaussian(src, gauss);
+        ASSERT_EQ(ref.size(), built.size());
+        ASSERT_EQ(ref.size(), gauss.size());
+        for (int l = 0; l <= maxlevel; l++)
+        {
+            ASSERT_EQ(ref[l].size(), gauss[l].size()) << "level=" << l;
+            EXPECT_EQ(0, cvtest::norm(ref[l], built[l], NORM_INF)) << "size=" << sizes[i] << " level=" << l;
+            EXPECT_EQ(0, cvtest::norm(ref[l], gauss[l], NORM_INF)) << "size=" << sizes[i] << " level=" << l;
+        }
+    }
+    setNumThreads(threads);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_PyramidBuilder, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_16UC1, CV_32FC1),
+    testing::Values(BORDER_REFLECT_101, BORDER_REPLICATE, BORDER_REFLECT),
+    testing::Values(1, 4, 8)));
+
+TEST(Imgproc_PyramidBuilderLaplacian, reconstruction)
+{
+    Mat src(480, 641, CV_8UC3);
+    randu(src, 0, 256);
+    const int maxlevel = 4;
+    Ptr<PyramidBuilder> builder = createPyramidBuilder(maxlevel);
+
+    std::vector<Mat> lap, gauss;
+    builder->buildLaplacian(src, lap);
+    buildPyramid(src, gauss, maxlevel);
+    ASSERT_EQ((size_t)maxlevel + 1, lap.size());
+    for (int l = 0; l <= maxlevel; l++)
+        EXPECT_EQ(CV_16SC3, lap[l].type());
+
+    // the 16-bit signed Laplacian levels are exact, so collapsing them gives back every Gaussian level
+    Mat cur;
+    lap[maxlevel].convertTo(cur, CV_8U);
+    EXPECT_EQ(0, cvtest::norm(gauss[maxlevel], cur, NORM_INF));
+    for (int l = maxlevel - 1; l >= 0; l--)
+    {
+        Mat up;
+        pyrUp(cur, up, lap[l].size());
+        cv::add(lap[l], up, cur, noArray(), CV_8U);
+        EXPECT_EQ(0, cvtest::norm(gauss[l], cur, NORM_INF)) << "level=" << l;
+    }
+
+    std::vector<Mat> lap32f;
+    builder->buildLaplacian(src, lap32f, CV_32F);
+    for (int l = 0; l <= maxlevel; l++)
+    {
+        EXPECT_EQ(CV_32FC3, lap32f[l].type());
+        Mat lap16s;
+        lap32f[l].convertTo(lap16s, CV_16S);
+        EXPECT_EQ(0, cvtest::norm(lap[l], lap16s, NORM_INF)) << "level=" << l;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 
 class CV_FilterSupportedFormatsTest : public cvtest::BaseTest
@@ -1639,5 +1639,117 @@ TEST(Imgproc_warpPolar, identity)
 #endif
 }
 
+typedef testing::TestWithParam<tuple<int, int, int> > Imgproc_WarpPlan;
+
+TEST_P(Imgproc_WarpPlan, same_as_warp_functions)
+{
+    const int type = get<0>(GetParam());
+    const int interpolation = get<1>(GetParam());
+    const int borderMode = get<2>(GetParam());
+    const Size srcSize(320, 240), dstSize(400, 300);
+    const Scalar borderValue(10, 20, 30, 40);
+
+    Mat src(srcSize, type);
+    randu(src, 0, 256);
+
+    Mat A = getRotationMatrix2D(Point2f(160.f, 120.f), 33., 0.7);
+    A.at<double>(0, 2) += 150;
+    Ptr<WarpPlan> affine = createWarpAffinePlan(A, srcSize, dstSize, interpolation, borderMode, borderValue);
+    ASSERT_EQ(dstSize, affine->getDstSize());
+    Mat ref, dst;
+    warpAffine(src, ref, A, dstSize, interpolation, borderMode, borderValue);
+    affine->warp(src, dst);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    Point2f srcQuad[] = { Point2f(0, 0), Point2f(319, 0), Point2f(319, 239), Point2f(0, 239) };
+    Point2f dstQuad[] = { Point2f(50, 20), Point2f(300, 60), Point2f(380, 290), Point2f(-40, 250) };
+    Mat P = getPerspectiveTransform(srcQuad, dstQuad);
+    Ptr<WarpPlan> perspective = createWarpPerspectivePlan(P, srcSize, dstSize, interpolation, borderMode, borderValue);
+    warpPerspective(src, ref, P, dstSize, interpolation, borderMode, borderValue);
+    perspective->warp(src, dst);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    Mat mapx(dstSize, CV_32FC1), mapy(dstSize, CV_32FC1);
+    for (int y = 0; y < dstSize.height; y++)
+        for (int x = 0; x < dstSize.width; x++)
+        {
+            mapx.at<float>(y, x) = (float)(x*0.9 - 20 + 5*sin(y*0.1));
+            mapy.at<float>(y, x) = (float)(y*0.85 - 10 + 5*cos(x*0.1));
+        }
+    Ptr<WarpPlan> generic = createRemapPlan(mapx, mapy, srcSize, interpolation, borderMode, borderValue);
+    remap(src, ref, mapx, mapy, interpolation, borderMode, borderValue);
+    generic->warp(src, dst);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    // the plan can be applied to many frames
+    randu(src, 0, 256);
+    remap(src, ref, mapx, mapy, interpolation, borderMode, borderValue);
+    generic->warp(src, dst);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_WarpPlan, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_16UC1, CV_32FC1),
+    testing::Values((int)INTER_NEAREST, (int)INTER_LINEAR, (int)INTER_CUBIC, (int)INTER_LANCZOS4),
+    testing::Values((int)BORDER_CONSTANT, (int)BORDER_REPLICATE, (int)BORDER_REFLECT_101)));
+
+TEST(Imgproc_WarpPerspectivePlan, maps_match_warpPerspective)
+{
+    // warping an image of its own coordinates recovers the fixed-point maps used by warpPerspective
+    const Size srcSize(640, 480), dstSize(600, 450);
+    Mat coords(srcSize, CV_32FC2);
+    for (int y = 0; y < srcSize.height; y++)
+        for (int x = 0; x < srcSize.width; x++)
+            coords.at<Vec2f>(y, x) = Vec2f((float)x, (float)y);
+
+    Point2f srcQuad[] = { Point2f(0, 0), Point2f(639, 0), Point2f(639, 479), Point2f(0, 479) };
+    Point2f dstQuad[] = { Point2f(30, 10), Point2f(570, 45), Point2f(590, 440), Point2f(-25, 400) };
+    Mat P = getPerspectiveTransform(srcQuad, dstQuad);
+
+    const int interpolations[] = { INTER_NEAREST, INTER_LINEAR };
+    for (size_t i = 0; i < sizeof(interpolations)/sizeof(interpolations[0]); i++)
+    {
+        const int interpolation = interpolations[i];
+        Ptr<WarpPlan> plan = createWarpPerspectivePlan(P, srcSize, dstSize, interpolation, BORDER_REPLICATE);
+        Mat map1, map2, ref;
+        plan->getMaps(map1, map2);
+        ASSERT_EQ(CV_16SC2, map1.type());
+        ASSERT_EQ(interpolation == INTER_NEAREST, map2.empty());
+        warpPerspective(coords, ref, P, dstSize, interpolation, BORDER_REPLICATE);
+
+        int checked = 0;
+        for (int y = 0; y < dstSize.height; y++)
+            for (int x = 0; x < dstSize.width; x++)
+            {
+                Vec2s xy = map1.at<Vec2s>(y, x);
+                if (xy[0] < 0 || xy[1] < 0 || xy[0] + 1 >= srcSize.width || xy[1] + 1 >= srcSize.height)
+                    continue;
+                int a = map2.empty() ? 0 : map2.at<ushort>(y, x);
+                Vec2f r = ref.at<Vec2f>(y, x);
+                ASSERT_EQ(xy[0]*INTER_TAB_SIZE + (a & (INTER_TAB_SIZE-1)), cvRound(r[0]*INTER_TAB_SIZE)) << "x=" << x << " y=" << y;
+                ASSERT_EQ(xy[1]*INTER_TAB_SIZE + (a >> INTER_BITS), cvRound(r[1]*INTER_TAB_SIZE)) << "x=" << x << " y=" << y;
+                checked++;
+            }
+        EXPECT_GT(checked, dstSize.area()/2);
+    }
+}
+
+TEST(Imgproc_RemapPlan, fixed_point_map_without_table)
+{
+    const Size size(200, 150);
+    Mat src(size, CV_8UC1), map1(size, CV_16SC2);
+    randu(src, 0, 256);
+    for (int y = 0; y < size.height; y++)
+        for (int x = 0; x < size.width; x++)
+            map1.at<Vec2s>(y, x) = Vec2s((short)(size.width - 1 - x), (short)(y/2));
+
+    // integer coordinates, the interpolation weights of the source pixels are exactly one
+    Mat ref, dst;
+    remap(src, ref, map1, Mat(), INTER_NEAREST, BORDER_CONSTANT);
+    Ptr<WarpPlan> plan = createRemapPlan(map1, noArray(), size, INTER_LINEAR, BORDER_CONSTANT);
+    plan->warp(src, dst);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+}
+
 }} // namespace
 /* End of file. */
@@ -440,4 +440,27 @@ protected:
 
 TEST(Imgproc_ContourMoment, small) { CV_SmallContourMomentTest test; test.safe_run(); }
 
+TEST(Imgproc_Moments, parallel_tiles)
+{
+    Mat img(1000, 1100, CV_8UC1);
+    randu(img, 0, 256);
+
+    int threads = getNumThreads();
+    setNumThreads(1);
+    Moments ref = moments(img, false), refBinary = moments(img, true);
+    setNumThreads(4);
+    Moments m = moments(img, false), mBinary = moments(img, true);
+    setNumThreads(threads);
+
+    const double* pref = &ref.m00;
+    const double* pm = &m.m00;
+    const double* prefBinary = &refBinary.m00;
+    const double* pmBinary = &mBinary.m00;
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_LE(fabs(pref[i] - pm[i]), fabs(pref[i])*1e-12) << "m[" << i << "]";
+        EXPECT_LE(fabs(prefBinary[i] - pmBinary[i]), fabs(prefBinary[i])*1e-12) << "binary m[" << i << "]";
+    }
+}
+
 }} // namespace
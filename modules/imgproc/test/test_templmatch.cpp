@@ -334,4 +334,56 @@ void CV_TemplMatchTest::prepare_to_validation( int /*test_case_idx*/ )
 
 TEST(Imgproc_MatchTemplate, accuracy) { CV_TemplMatchTest test; test.safe_run(); }
 
+typedef testing::TestWithParam<tuple<int, int> > Imgproc_TemplateMatcher;
+
+TEST_P(Imgproc_TemplateMatcher, matchAll_vs_matchTemplate)
+{
+    const int type = get<0>(GetParam());
+    const int method = get<1>(GetParam());
+    const Size templSizes[] = { Size(31, 17), Size(12, 40), Size(45, 45) };
+    const int ntempl = (int)(sizeof(templSizes)/sizeof(templSizes[0]));
+
+    RNG& rng = theRNG();
+    Ptr<TemplateMatcher> matcher = createTemplateMatcher(method);
+    std::vector<Mat> templs(ntempl);
+    for (int j = 0; j < ntempl; j++)
+    {
+        templs[j].create(templSizes[j], type);
+        rng.fill(templs[j], RNG::UNIFORM, 0, 255);
+        ASSERT_EQ(j, matcher->add(templs[j]));
+    }
+    ASSERT_EQ(ntempl, matcher->getTemplatesCount());
+
+    // repeated frames of the same size reuse the cached template spectra, the odd sizes change the DFT layout
+    const Size frameSizes[] = { Size(640, 480), Size(640, 480), Size(641, 479), Size(333, 217), Size(640, 480) };
+    for (int iter = 0; iter < (int)(sizeof(frameSizes)/sizeof(frameSizes[0])); iter++)
+    {
+        Mat big(700, 900, type);
+        rng.fill(big, RNG::UNIFORM, 0, 255);
+        Mat img = big(Rect(Point(5 + iter, 7), frameSizes[iter]));
+
+        std::vector<Mat> results;
+        matcher->matchAll(img, results);
+        ASSERT_EQ((size_t)ntempl, results.size());
+
+        for (int j = 0; j < ntempl; j++)
+        {
+            Mat ref;
+            matchTemplate(img, templs[j], ref, method);
+            ASSERT_EQ(ref.size(), results[j].size());
+            double eps = (method & 1) ? 1e-4 : 255. * 255. * templs[j].total() * 1e-6;
+            EXPECT_LE(cvtest::norm(ref, results[j], NORM_INF), eps) << "template " << j;
+
+            Mat single;
+            matcher->match(img, single, j);
+            EXPECT_LE(cvtest::norm(ref, single, NORM_INF), eps) << "template " << j;
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_TemplateMatcher, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_32FC1),
+    testing::Values((int)TM_SQDIFF, (int)TM_SQDIFF_NORMED, (int)TM_CCORR,
+                    (int)TM_CCORR_NORMED, (int)TM_CCOEFF, (int)TM_CCOEFF_NORMED)));
+
 }} // namespace
@@ -0,0 +1,106 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+static void addTestChain(TiledExecutor& executor, std::vector<std::function<void(const Mat&, Mat&)> >& reference)
+{
+    Mat kernel = (Mat_<float>(3, 4) << 1, -2, 0, 1,  2, 5, -1, 0,  0, 1, 3, -2);
+    Mat ellipse = getStructuringElement(MORPH_ELLIPSE, Size(5, 5));
+
+    executor.addCvtColor(COLOR_BGR2GRAY);
+    reference.push_back([](const Mat& src, Mat& dst) { cvtColor(src, dst, COLOR_BGR2GRAY); });
+    executor.addGaussianBlur(Size(), 1.5);
+    reference.push_back([](const Mat& src, Mat& dst) { GaussianBlur(src, dst, Size(), 1.5); });
+    executor.addMorphologyEx(MORPH_OPEN, ellipse, Point(-1, -1), 2);
+    reference.push_back([=](const Mat& src, Mat& dst) { morphologyEx(src, dst, MORPH_OPEN, ellipse, Point(-1, -1), 2); });
+    executor.add([](InputArray src, OutputArray dst) { medianBlur(src, dst, 5); }, Size(2, 2));
+    reference.push_back([](const Mat& src, Mat& dst) { medianBlur(src, dst, 5); });
+    executor.addFilter2D(CV_16S, kernel, Point(0, 2), 3, BORDER_REFLECT);
+    reference.push_back([=](const Mat& src, Mat& dst) { cv::filter2D(src, dst, CV_16S, kernel, Point(0, 2), 3, BORDER_REFLECT); });
+    executor.addThreshold(100, 1000, THRESH_TRUNC);
+    reference.push_back([](const Mat& src, Mat& dst) { cv::threshold(src, dst, 100, 1000, THRESH_TRUNC); });
+}
+
+TEST(Imgproc_TiledExecutor, same_as_whole_image)
+{
+    Mat src(777, 1001, CV_8UC3);
+    randu(src, 0, 256);
+
+    Ptr<TiledExecutor> executor = createTiledExecutor(Size(128, 96));
+    std::vector<std::function<void(const Mat&, Mat&)> > reference;
+    addTestChain(*executor, reference);
+    EXPECT_EQ((int)reference.size(), executor->getOperationsCount());
+
+    Mat ref = src;
+    for (size_t k = 0; k < reference.size(); k++)
+    {
+        Mat next;
+        reference[k](ref, next);
+        ref = next;
+    }
+
+    int threads = getNumThreads();
+    setNumThreads(4);
+    const Size tileSizes[] = { Size(128, 96), Size(33, 500), Size(2000, 2000) };
+    for (size_t i = 0; i < sizeof(tileSizes)/sizeof(tileSizes[0]); i++)
+    {
+        executor->setTileSize(tileSizes[i]);
+        Mat dst;
+        executor->apply(src, dst);
+        ASSERT_EQ(ref.type(), dst.type());
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF)) << "tile=" << tileSizes[i];
+    }
+    setNumThreads(threads);
+}
+
+TEST(Imgproc_TiledExecutor, reader_writer_callbacks)
+{
+    Size imageSize(1000, 300);
+    Ptr<TiledExecutor> executor = createTiledExecutor(Size(256, 128));
+    executor->addGaussianBlur(Size(7, 3), 0);
+    executor->addMorphologyEx(MORPH_DILATE, Mat(), Point(-1, -1), 2);
+    EXPECT_EQ(Size(5, 3), executor->getHalo());
+
+    Mat src(imageSize, CV_16U), dst(imageSize, CV_16U, Scalar::all(0)), covered(imageSize, CV_8U, Scalar::all(0));
+    randu(src, 0, 65536);
+    int reads = 0, writes = 0;
+    executor->run(imageSize,
+        [&](const Rect& roi, OutputArray tile)
+        {
+            ASSERT_EQ(roi, roi & Rect(Point(), imageSize));
+            src(roi).copyTo(tile);
+            reads++;
+        },
+        [&](const Rect& roi, InputArray tile)
+        {
+            ASSERT_LE(roi.width, 256);
+            ASSERT_LE(roi.height, 128);
+            tile.copyTo(dst(roi));
+            covered(roi) += 1;
+            writes++;
+        });
+
+    EXPECT_EQ(4*3, reads);
+    EXPECT_EQ(4*3, writes);
+    EXPECT_EQ(0, cvtest::norm(covered, Mat(imageSize, CV_8U, Scalar::all(1)), NORM_INF));
+
+    Mat ref;
+    GaussianBlur(src, ref, Size(7, 3), 0);
+    cv::dilate(ref, ref, Mat(), Point(-1, -1), 2);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+}
+
+TEST(Imgproc_TiledExecutor, wrap_border_is_rejected)
+{
+    Ptr<TiledExecutor> executor = createTiledExecutor();
+    EXPECT_THROW(executor->addGaussianBlur(Size(3, 3), 0, 0, BORDER_WRAP), cv::Exception);
+    EXPECT_THROW(executor->addFilter2D(-1, Mat::ones(3, 3, CV_32F), Point(-1, -1), 0, BORDER_WRAP), cv::Exception);
+    EXPECT_THROW(executor->addMorphologyEx(MORPH_ERODE, Mat(), Point(-1, -1), 1, BORDER_WRAP), cv::Exception);
+    EXPECT_EQ(0, executor->getOperationsCount());
+}
+
+}} // namespace